@@ -0,0 +1,73 @@
+## Measure the time per evaluation of binary operators in loops.
+##
+## Each binary expression remembers the operator function it used for
+## the types of its operands, and calls it directly the next time it is
+## evaluated with operands of the same types.  The loops below evaluate
+## the same expressions with operands of fixed types, and the last one
+## changes the types on every iteration, which always needs a lookup.
+## Compare the times with those of an Octave version without the cache.
+
+function t = binopbench (n = 1e6, nrep = 5)
+
+  t = zeros (1, 4);
+
+  t(1) = time_loop (@vector_loop, n, nrep);
+  t(2) = time_loop (@integer_loop, n, nrep);
+  t(3) = time_loop (@complex_loop, n, nrep);
+  t(4) = time_loop (@mixed_type_loop, n, nrep);
+
+  printf ("%12s %12s %12s %12s\n", "vector", "integer", "complex",
+          "mixed types");
+  printf ("%10.1fns %10.1fns %10.1fns %10.1fns\n", 1e9*t / n);
+
+endfunction
+
+function t = time_loop (f, n, nrep)
+
+  f (10);
+  t = Inf;
+  for k = 1:nrep
+    t0 = tic ();
+    f (n);
+    t = min (t, toc (t0));
+  endfor
+
+endfunction
+
+function x = vector_loop (n)
+
+  x = [1, 2, 3];
+  for i = 1:n
+    x = x * 0.5 + 1;
+  endfor
+
+endfunction
+
+function s = integer_loop (n)
+
+  s = int32 (0);
+  one = int32 (1);
+  for i = 1:n
+    s = s + one;
+  endfor
+
+endfunction
+
+function z = complex_loop (n)
+
+  z = 0;
+  for i = 1:n
+    z = z * 0.5 + 1i;
+  endfor
+
+endfunction
+
+function s = mixed_type_loop (n)
+
+  v = {1, int8(1), single(1), true};
+  s = 0;
+  for i = 1:n
+    s = double (v{mod (i, 4) + 1} + 1);
+  endfor
+
+endfunction
@@ -0,0 +1,54 @@
+## Measure the time to create and update many graphics objects in an
+## invisible figure, so that no graphics toolkit has to draw them.
+##
+## Each line object is a single marker, as in a scatter plot built from
+## separate objects.  The objects are updated with one call to set for
+## all of them, first with the same value for every object, and then
+## with a different value for each object.  Looking up a handle takes
+## constant time, so the time per object should not grow with N.
+
+function t = graphicsbench (nmax = 1e5)
+
+  n = 10 .^ (2:floor (log10 (nmax)));
+  t = zeros (numel (n), 4);
+
+  hf = figure ("visible", "off");
+  unwind_protect
+    for i = 1:numel (n)
+      clf (hf);
+      hax = axes ("parent", hf, "xlimmode", "manual", "ylimmode", "manual");
+
+      x = rand (n(i), 1);
+      y = rand (n(i), 1);
+      h = zeros (n(i), 1);
+
+      t0 = tic ();
+      for k = 1:n(i)
+        h(k) = line (x(k), y(k), "parent", hax, "marker", "o");
+      endfor
+      t(i,1) = toc (t0);
+
+      t0 = tic ();
+      for k = 1:n(i)
+        ishghandle (h(k));
+      endfor
+      t(i,2) = toc (t0);
+
+      t0 = tic ();
+      set (h, "color", "r", "markersize", 4);
+      t(i,3) = toc (t0);
+
+      t0 = tic ();
+      set (h, {"xdata", "ydata"}, num2cell ([y, x]));
+      t(i,4) = toc (t0);
+    endfor
+  unwind_protect_cleanup
+    close (hf);
+  end_unwind_protect
+
+  printf ("%10s %12s %12s %12s %12s\n", "n",
+          "create", "lookup", "set same", "set each");
+  printf ("%10d %10.2fus %10.2fus %10.2fus %10.2fus\n",
+          [n; 1e6*(t ./ n')']);
+
+endfunction
@@ -0,0 +1,82 @@
+## Measure the time to write and read HDF5 files with different layouts.
+##
+## A matrix of N-by-N doubles is saved contiguously, with "-chunked", and
+## with "-zip", which compresses the chunks with the deflate and shuffle
+## filters.  For each layout, the times to save and load the whole matrix
+## and to read 50 single rows through matfile are printed together with
+## the file size.  The rows are read once with the default chunk cache
+## and once with hdf5_chunk_cache_size set to 0, which decompresses a
+## chunk again for every row.
+
+function t = hdf5bench (n = 2000, nrep = 3)
+
+  ## A random walk compresses about as well as typical measured data.
+  x = reshape (cumsum (randn (n*n, 1)), n, n);
+
+  layouts = {{"-hdf5"}, {"-hdf5", "-chunked"}, {"-hdf5", "-zip"}};
+  names = {"contiguous", "chunked", "zip"};
+
+  nl = numel (layouts);
+  t = zeros (nl, 4);
+  bytes = zeros (nl, 1);
+
+  f = [tempname() ".h5"];
+  unwind_protect
+    for k = 1:nl
+      opts = layouts{k};
+      t(k,1) = time_op (@() save_x (opts, f, x), nrep);
+      t(k,2) = time_op (@() load_x (f), nrep);
+      t(k,3) = time_op (@() read_rows (f, 50), nrep);
+      old = hdf5_chunk_cache_size (0);
+      unwind_protect
+        t(k,4) = time_op (@() read_rows (f, 50), nrep);
+      unwind_protect_cleanup
+        hdf5_chunk_cache_size (old);
+      end_unwind_protect
+      bytes(k) = stat (f).size;
+    endfor
+  unwind_protect_cleanup
+    unlink (f);
+  end_unwind_protect
+
+  printf ("%12s %10s %10s %10s %12s %10s\n", "", "save", "load",
+          "rows", "rows,nocache", "size");
+  for k = 1:nl
+    printf ("%12s %8.1fms %8.1fms %8.1fms %10.1fms %8.1fMB\n", names{k},
+            1e3*t(k,:), bytes(k) / 2^20);
+  endfor
+
+endfunction
+
+function save_x (opts, f, x)
+
+  save (opts{:}, f, "x");
+
+endfunction
+
+function x = load_x (f)
+
+  x = load (f).x;
+
+endfunction
+
+function read_rows (f, nrows)
+
+  m = matfile (f);
+  for i = 1:nrows
+    r = m.x(i,:);
+  endfor
+
+endfunction
+
+function t = time_op (f, nrep)
+
+  f ();
+  t = Inf;
+  for r = 1:nrep
+    t0 = tic ();
+    f ();
+    t = min (t, toc (t0));
+  endfor
+
+endfunction
@@ -0,0 +1,45 @@
+## Measure the time of gathers through logical masks and index vectors.
+##
+## Logical masks over numeric data are gathered without a branch for
+## each element, and large index vectors, as well as the columns of
+## A(I,J), are gathered by several threads when Octave is built with
+## OpenMP.  The times of x(find (m)) are printed for comparison with
+## x(m).  Compare the times with those of an Octave version without
+## these changes, and with different values of OMP_NUM_THREADS.
+
+function t = indexbench (n = 2e7, nrep = 5)
+
+  x = rand (n, 1);
+  m = rand (n, 1) > 0.5;
+  k = randi (n, n / 4, 1);
+
+  nr = round (sqrt (n));
+  a = reshape (x(1:nr*nr), nr, nr);
+  i = randi (nr, nr, 1);
+  mc = rand (1, nr) > 0.5;
+
+  t = zeros (1, 5);
+
+  t(1) = time_op (@() x(m), nrep);
+  t(2) = time_op (@() x(find (m)), nrep);
+  t(3) = time_op (@() x(k), nrep);
+  t(4) = time_op (@() a(i,mc), nrep);
+  t(5) = time_op (@() a(i,find (mc)), nrep);
+
+  printf ("%12s %12s %12s %12s %12s\n",
+          "x(m)", "x(find(m))", "x(k)", "a(i,m)", "a(i,find(m))");
+  printf ("%10.1fms %10.1fms %10.1fms %10.1fms %10.1fms\n", 1e3*t);
+
+endfunction
+
+function t = time_op (f, nrep)
+
+  f ();
+  t = Inf;
+  for r = 1:nrep
+    t0 = tic ();
+    f ();
+    t = min (t, toc (t0));
+  endfor
+
+endfunction
@@ -0,0 +1,45 @@
+## Measure the overhead of calling a mex-file as the size of its
+## arguments grows.
+##
+## Build the two example mex-files first:
+##
+##   mkoctfile --mex mypow2.c
+##   mkoctfile --mex mypow2i.c
+##
+## mypow2 reads its input with mxGetPr and mxGetPi, mypow2i with the
+## typed accessors mxGetDoubles and mxGetComplexDoubles.  Real inputs
+## and all results are passed without copying, so the time per element
+## of both should approach that of the computation itself.  Complex
+## inputs must be split into separate real and imaginary parts for
+## mypow2, but not for mypow2i.
+
+function t = mexbench (nmax = 1e7, nrep = 10)
+
+  n = 10 .^ (0:floor (log10 (nmax)));
+  t = zeros (numel (n), 4);
+
+  for i = 1:numel (n)
+    x = rand (n(i), 1);
+    z = complex (x, x);
+    t(i,1) = time_mex (@mypow2, x, nrep);
+    t(i,2) = time_mex (@mypow2i, x, nrep);
+    t(i,3) = time_mex (@mypow2, z, nrep);
+    t(i,4) = time_mex (@mypow2i, z, nrep);
+  endfor
+
+  printf ("%10s %12s %12s %12s %12s\n", "n",
+          "real pr", "real typed", "cplx pr/pi", "cplx typed");
+  printf ("%10d %10.2fus %10.2fus %10.2fus %10.2fus\n", [n; 1e6*t']);
+
+endfunction
+
+function t = time_mex (f, x, nrep)
+
+  f (x);
+  t0 = tic ();
+  for k = 1:nrep
+    f (x);
+  endfor
+  t = toc (t0) / nrep;
+
+endfunction
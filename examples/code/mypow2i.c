@@ -0,0 +1,40 @@
+#include "mex.h"
+
+void
+mexFunction (int nlhs, mxArray* plhs[],
+             int nrhs, const mxArray* prhs[])
+{
+  mwSize n;
+  mwIndex i;
+
+  if (nrhs != 1 || ! mxIsDouble (prhs[0]))
+    mexErrMsgTxt ("ARG1 must be a double matrix");
+
+  n = mxGetNumberOfElements (prhs[0]);
+  plhs[0] = mxCreateUninitNumericArray (mxGetNumberOfDimensions (prhs[0]),
+                                        mxGetDimensions (prhs[0]),
+                                        mxDOUBLE_CLASS,
+                                        mxIsComplex (prhs[0]));
+
+  if (mxIsComplex (prhs[0]))
+    {
+      mxComplexDouble *vi, *vo;
+      vi = mxGetComplexDoubles (prhs[0]);
+      vo = mxGetComplexDoubles (plhs[0]);
+
+      for (i = 0; i < n; i++)
+        {
+          vo[i].real = vi[i].real * vi[i].real - vi[i].imag * vi[i].imag;
+          vo[i].imag = 2 * vi[i].real * vi[i].imag;
+        }
+    }
+  else
+    {
+      mxDouble *vi, *vo;
+      vi = mxGetDoubles (prhs[0]);
+      vo = mxGetDoubles (plhs[0]);
+
+      for (i = 0; i < n; i++)
+        vo[i] = vi[i] * vi[i];
+    }
+}
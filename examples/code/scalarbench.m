@@ -0,0 +1,72 @@
+## Measure the time per iteration of loops that do arithmetic on scalars.
+##
+## Every operation on scalars creates a new scalar value object.  These
+## objects are allocated from a free list, and +, -, *, .* and the
+## comparisons of two double scalars are evaluated without looking up
+## the operator function, so the time per iteration should mostly be
+## the cost of evaluating the statements.  Compare the times with those
+## of an Octave version without these changes.
+
+function t = scalarbench (n = 1e6, nrep = 5)
+
+  t = zeros (1, 4);
+
+  t(1) = time_loop (@add_loop, n, nrep);
+  t(2) = time_loop (@mixed_loop, n, nrep);
+  t(3) = time_loop (@compare_loop, n, nrep);
+  t(4) = time_loop (@single_loop, n, nrep);
+
+  printf ("%12s %12s %12s %12s\n", "add", "mixed", "compare", "single");
+  printf ("%10.1fns %10.1fns %10.1fns %10.1fns\n", 1e9*t / n);
+
+endfunction
+
+function t = time_loop (f, n, nrep)
+
+  f (10);
+  t = Inf;
+  for k = 1:nrep
+    t0 = tic ();
+    f (n);
+    t = min (t, toc (t0));
+  endfor
+
+endfunction
+
+function s = add_loop (n)
+
+  s = 0;
+  for i = 1:n
+    s = s + i;
+  endfor
+
+endfunction
+
+function s = mixed_loop (n)
+
+  s = 0;
+  for i = 1:n
+    s = 0.5 * s - i * 2 + 1;
+  endfor
+
+endfunction
+
+function c = compare_loop (n)
+
+  c = 0;
+  for i = 1:n
+    if (i < n / 2 && i != 7)
+      c = c + 1;
+    endif
+  endfor
+
+endfunction
+
+function s = single_loop (n)
+
+  s = single (0);
+  for i = 1:n
+    s = s + single (1);
+  endfor
+
+endfunction
@@ -0,0 +1,92 @@
+## Measure the time to lay out and draw text with the FreeType renderer.
+##
+## The glyphs that the FreeType renderer loads and rasterizes are kept in
+## a cache, which __ft_glyph_cache__ reports on and clears.  Changing the
+## string of a text object computes its extent, which loads the advance
+## of every glyph, and printing renders each glyph as a bitmap.  Each
+## step is timed once with the glyph cache emptied before every string
+## change or print, which loads every glyph again as was done before the
+## cache existed, and once with a warm cache.  The hit and miss counts of
+## the warm string changes are printed as well.
+
+function t = textbench (n = 200, nrep = 5)
+
+  str = cell (n, 1);
+  for k = 1:n
+    str{k} = sprintf ("x_{%d} = %.4f \\alpha^2", k, rand ());
+  endfor
+
+  t = zeros (2, 2);
+
+  hf = figure ("visible", "off");
+  unwind_protect
+    hax = axes ("parent", hf);
+    h = zeros (n, 1);
+    for k = 1:n
+      h(k) = text (rand (), rand (), "", "parent", hax);
+    endfor
+
+    t(1,1) = time_op (@() set_strings (h, str, true), nrep);
+    stats0 = __ft_glyph_cache__ ();
+    t(2,1) = time_op (@() set_strings (h, str, false), nrep);
+    stats1 = __ft_glyph_cache__ ();
+
+    set_strings (h, str, false);
+    f = [tempname() ".png"];
+    unwind_protect
+      t(1,2) = time_op (@() print_cold (hf, f), nrep);
+      t(2,2) = time_op (@() print (hf, "-dpng", f), nrep);
+    unwind_protect_cleanup
+      unlink (f);
+    end_unwind_protect
+  unwind_protect_cleanup
+    close (hf);
+  end_unwind_protect
+
+  printf ("%10s %12s %12s\n", "cache", "set string", "print");
+  printf ("%10s %10.1fms %10.1fms\n", "cleared", 1e3*t(1,:));
+  printf ("%10s %10.1fms %10.1fms\n", "warm", 1e3*t(2,:));
+  printf ("\nwarm layout: %d hits, %d misses, %d glyphs in %d bytes\n",
+          stats1.hits - stats0.hits, stats1.misses - stats0.misses,
+          stats1.glyphs, stats1.bytes);
+
+endfunction
+
+function set_strings (h, str, cold)
+
+  ## Alternate between two sets of strings so that every call changes
+  ## all of them.
+  persistent flip = false;
+  flip = ! flip;
+
+  for k = 1:numel (h)
+    if (cold)
+      __ft_glyph_cache__ ("clear");
+    endif
+    if (flip)
+      set (h(k), "string", str{k});
+    else
+      set (h(k), "string", [str{k} " "]);
+    endif
+  endfor
+
+endfunction
+
+function print_cold (hf, f)
+
+  __ft_glyph_cache__ ("clear");
+  print (hf, "-dpng", f);
+
+endfunction
+
+function t = time_op (f, nrep)
+
+  f ();
+  t = Inf;
+  for r = 1:nrep
+    t0 = tic ();
+    f ();
+    t = min (t, toc (t0));
+  endfor
+
+endfunction
@@ -0,0 +1,78 @@
+## Measure the time of transposes and N-d permutations.
+##
+## Transposes are done in square tiles of 16, 8, or 4 elements for
+## elements of up to 4, 8, or 16 bytes, so that each column of a tile
+## fills a 64-byte cache line.  The first table compares the time of a
+## transpose with that of a copy of the same bytes, A(:,end:-1:1), for
+## each element size.  A ratio close to 1 means that the transpose is
+## limited by memory bandwidth, as it is with tiles of the right size.
+##
+## With OpenMP, transposes and permutations of more than 65536 elements
+## are split over several threads.  The second table gives the time per
+## element for sizes from 2^12 to 2^22 elements.  Run the benchmark with
+## OMP_NUM_THREADS=1 and with the default number of threads: below the
+## threshold, the times are the same, and above it the threaded times
+## should be lower.  If the threaded times are higher just above the
+## threshold on some machine, the threshold is too low there.
+
+function [t1, t2] = transposebench (n = 2048, nrep = 5)
+
+  classes = {"int8", "single", "double", "complex"};
+  nc = numel (classes);
+
+  t1 = zeros (nc, 2);
+  for k = 1:nc
+    a = make_array (classes{k}, [n, n]);
+    t1(k,1) = time_op (@() full (a.'), nrep);
+    t1(k,2) = time_op (@() a(:,end:-1:1), nrep);
+  endfor
+
+  printf ("%10s %12s %12s %8s\n", "class", "transpose", "copy", "ratio");
+  for k = 1:nc
+    printf ("%10s %10.1fms %10.1fms %8.2f\n", classes{k}, 1e3*t1(k,:),
+            t1(k,1) / t1(k,2));
+  endfor
+
+  sizes = 2 .^ (12:2:22);
+  ns = numel (sizes);
+
+  t2 = zeros (ns, 2);
+  for k = 1:ns
+    m = sqrt (sizes(k));
+    a = make_array ("double", [m, m]);
+    b = make_array ("double", [m/4, 4, m]);
+    nr = max (nrep, round (2^22 / sizes(k)));
+    t2(k,1) = time_op (@() full (a.'), nr);
+    t2(k,2) = time_op (@() permute (b, [3, 1, 2]), nr);
+  endfor
+
+  printf ("\n%10s %12s %12s\n", "elements", "transpose", "permute");
+  for k = 1:ns
+    printf ("%10d %10.2fns %10.2fns\n", sizes(k), 1e9*t2(k,:) / sizes(k));
+  endfor
+
+endfunction
+
+function a = make_array (cls, sz)
+
+  if (strcmp (cls, "complex"))
+    a = complex (rand (sz), rand (sz));
+  elseif (strcmp (cls, "int8"))
+    a = int8 (randi ([-100, 100], sz));
+  else
+    a = rand (sz, cls);
+  endif
+
+endfunction
+
+function t = time_op (f, nrep)
+
+  f ();
+  t = Inf;
+  for r = 1:nrep
+    t0 = tic ();
+    f ();
+    t = min (t, toc (t0));
+  endfor
+
+endfunction
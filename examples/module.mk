@@ -31,21 +31,27 @@ examples_code_SRC = \
   examples/code/@polynomial/subsasgn.m \
   examples/code/@polynomial/subsref.m \
   examples/code/addtwomatrices.cc \
+  examples/code/binopbench.m \
   examples/code/celldemo.cc \
   examples/code/embedded.cc \
   examples/code/fortrandemo.cc \
   examples/code/fortransub.f \
   examples/code/funcdemo.cc \
   examples/code/globaldemo.cc \
+  examples/code/graphicsbench.m \
+  examples/code/hdf5bench.m \
   examples/code/helloworld.cc \
+  examples/code/indexbench.m \
   examples/code/make_int.cc \
   examples/code/mex_demo.c \
+  examples/code/mexbench.m \
   examples/code/mycell.c \
   examples/code/myfeval.c \
   examples/code/myfevalf.f \
   examples/code/myfunc.c \
   examples/code/myhello.c \
   examples/code/mypow2.c \
+  examples/code/mypow2i.c \
   examples/code/myprop.c \
   examples/code/myset.c \
   examples/code/mysparse.c \
@@ -55,10 +61,13 @@ examples_code_SRC = \
   examples/code/oregonator.cc \
   examples/code/oregonator.m \
   examples/code/paramdemo.cc \
+  examples/code/scalarbench.m \
   examples/code/standalone.cc \
   examples/code/standalonebuiltin.cc \
   examples/code/stringdemo.cc \
   examples/code/structdemo.cc \
+  examples/code/textbench.m \
+  examples/code/transposebench.m \
   examples/code/unwinddemo.cc
 
 examples_EXTRA_DIST += \
@@ -1538,6 +1538,19 @@ main_window::construct_octave_qt_link (void)
                       const QStringList&, const QStringList&,
                       const QStringList&, const QIntList&)));
 
+      connect (_octave_qt_link,
+               SIGNAL (update_workspace_signal
+                       (bool, bool, const QString&, const QStringList&,
+                        const QStringList&, const QStringList&,
+                        const QStringList&, const QIntList&,
+                        const QStringList&)),
+               _workspace_model,
+               SLOT (update_workspace
+                     (bool, bool, const QString&, const QStringList&,
+                      const QStringList&, const QStringList&,
+                      const QStringList&, const QIntList&,
+                      const QStringList&)));
+
       connect (_octave_qt_link, SIGNAL (clear_workspace_signal ()),
                _workspace_model, SLOT (clear_workspace ()));
 
@@ -492,6 +492,45 @@ octave_qt_link::do_set_workspace (bool top_level, bool debug,
                              dimensions, values, complex_flags);
 }
 
+void
+octave_qt_link::do_update_workspace (bool top_level, bool debug,
+                                     const std::list<workspace_element>& changed,
+                                     const std::list<std::string>& removed)
+{
+  if (! top_level && ! debug)
+    return;
+
+  if (_new_dir)
+    update_directory ();
+
+  QString scopes;
+  QStringList symbols;
+  QStringList class_names;
+  QStringList dimensions;
+  QStringList values;
+  QIntList complex_flags;
+  QStringList removed_symbols;
+
+  for (std::list<workspace_element>::const_iterator it = changed.begin ();
+       it != changed.end (); it++)
+    {
+      scopes.append (it->scope ());
+      symbols.append (QString::fromStdString (it->symbol ()));
+      class_names.append (QString::fromStdString (it->class_name ()));
+      dimensions.append (QString::fromStdString (it->dimension ()));
+      values.append (QString::fromStdString (it->value ()));
+      complex_flags.append (it->complex_flag ());
+    }
+
+  for (std::list<std::string>::const_iterator it = removed.begin ();
+       it != removed.end (); it++)
+    removed_symbols.append (QString::fromStdString (*it));
+
+  emit update_workspace_signal (top_level, debug, scopes, symbols,
+                                class_names, dimensions, values,
+                                complex_flags, removed_symbols);
+}
+
 void
 octave_qt_link::do_clear_workspace (void)
 {
@@ -112,6 +112,10 @@ public:
   void do_set_workspace (bool top_level, bool debug,
                          const std::list<workspace_element>& ws);
 
+  void do_update_workspace (bool top_level, bool debug,
+                            const std::list<workspace_element>& changed,
+                            const std::list<std::string>& removed);
+
   void do_clear_workspace (void);
 
   void do_set_history (const string_vector& hist);
@@ -185,6 +189,16 @@ signals:
                              const QStringList& values,
                              const QIntList& complex_flags);
 
+  void update_workspace_signal (bool top_level,
+                                bool debug,
+                                const QString& scopes,
+                                const QStringList& symbols,
+                                const QStringList& class_names,
+                                const QStringList& dimensions,
+                                const QStringList& values,
+                                const QIntList& complex_flags,
+                                const QStringList& removed);
+
   void clear_workspace_signal (void);
 
   void set_history_signal (const QStringList& hist);
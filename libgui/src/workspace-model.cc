@@ -25,6 +25,8 @@ along with Octave; see the file COPYING.  If not, see
 #  include "config.h"
 #endif
 
+#include <algorithm>
+
 #include <QTreeWidget>
 #include <QSettings>
 
@@ -245,6 +247,77 @@ workspace_model::set_workspace (bool top_level,
   update_table ();
 }
 
+// Replace, insert, or remove only the rows of the variables that
+// changed, so that the view keeps its selection and scroll position.
+// The rows are kept sorted by name, like the list sent by set_workspace.
+
+void
+workspace_model::update_workspace (bool top_level,
+                                   bool /* debug */,
+                                   const QString& scopes,
+                                   const QStringList& symbols,
+                                   const QStringList& class_names,
+                                   const QStringList& dimensions,
+                                   const QStringList& values,
+                                   const QIntList& complex_flags,
+                                   const QStringList& removed)
+{
+  _top_level = top_level;
+
+  for (int i = 0; i < removed.size (); i++)
+    {
+      int row = _symbols.indexOf (removed[i]);
+
+      if (row < 0)
+        continue;
+
+      beginRemoveRows (QModelIndex (), row, row);
+
+      _scopes.remove (row, 1);
+      _symbols.removeAt (row);
+      _class_names.removeAt (row);
+      _dimensions.removeAt (row);
+      _values.removeAt (row);
+      _complex_flags.removeAt (row);
+
+      endRemoveRows ();
+    }
+
+  for (int i = 0; i < symbols.size (); i++)
+    {
+      int row = _symbols.indexOf (symbols[i]);
+
+      if (row >= 0)
+        {
+          _scopes[row] = scopes[i];
+          _class_names[row] = class_names[i];
+          _dimensions[row] = dimensions[i];
+          _values[row] = values[i];
+          _complex_flags[row] = complex_flags[i];
+
+          emit dataChanged (index (row, 0), index (row, columnCount () - 1));
+        }
+      else
+        {
+          row = std::lower_bound (_symbols.begin (), _symbols.end (),
+                                  symbols[i]) - _symbols.begin ();
+
+          beginInsertRows (QModelIndex (), row, row);
+
+          _scopes.insert (row, scopes[i]);
+          _symbols.insert (row, symbols[i]);
+          _class_names.insert (row, class_names[i]);
+          _dimensions.insert (row, dimensions[i]);
+          _values.insert (row, values[i]);
+          _complex_flags.insert (row, complex_flags[i]);
+
+          endInsertRows ();
+        }
+    }
+
+  emit model_changed ();
+}
+
 void
 workspace_model::clear_workspace (void)
 {
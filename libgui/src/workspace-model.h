@@ -81,6 +81,16 @@ public slots:
                       const QStringList& values,
                       const QIntList& complex_flags);
 
+  void update_workspace (bool top_level,
+                         bool debug,
+                         const QString& scopes,
+                         const QStringList& symbols,
+                         const QStringList& class_names,
+                         const QStringList& dimensions,
+                         const QStringList& values,
+                         const QIntList& complex_flags,
+                         const QStringList& removed);
+
   void clear_workspace (void);
 
   void notice_settings (const QSettings *);
@@ -24,23 +24,34 @@ along with Octave; see the file COPYING.  If not, see
 #  include "config.h"
 #endif
 
-#include <iostream>
-#include <fstream>
+#include <cmath>
 #include <string>
+#include <vector>
 
-#include "lo-math.h"
+#include "lo-ieee.h"
+#include "oct-kdtree.h"
 
+#include "Cell.h"
 #include "defun.h"
 #include "error.h"
 #include "ovl.h"
 
 DEFUN (__dsearchn__, args, ,
        doc: /* -*- texinfo -*-
-@deftypefn {} {[@var{idx}, @var{d}] =} dsearch (@var{x}, @var{xi})
+@deftypefn  {} {[@var{idx}, @var{d}] =} __dsearchn__ (@var{x}, @var{xi})
+@deftypefnx {} {[@var{idx}, @var{d}] =} __dsearchn__ (@var{x}, @var{xi}, @var{k})
+@deftypefnx {} {[@var{idx}, @var{d}] =} __dsearchn__ (@var{x}, @var{xi}, "radius", @var{r})
 Undocumented internal function.
+
+With @var{k}, return the indices and distances of the @var{k} points
+closest to each row of @var{xi} in the rows of @var{idx} and @var{d}.
+With @qcode{"radius"}, return cell arrays with the indices and distances
+of the points within distance @var{r} of each row of @var{xi}.
 @end deftypefn */)
 {
-  if (args.length () != 2)
+  int nargin = args.length ();
+
+  if (nargin < 2 || nargin > 4)
     print_usage ();
 
   Matrix x = args(0).matrix_value ().transpose ();
@@ -50,53 +61,152 @@ Undocumented internal function.
     error ("__dsearch__: number of rows of X and XI must match");
 
   octave_idx_type n = x.rows ();
-  octave_idx_type nx = x.columns ();
   octave_idx_type nxi = xi.columns ();
 
-  ColumnVector idx (nxi);
-  double *pidx = idx.fortran_vec ();
-  ColumnVector dist (nxi);
-  double *pdist = dist.fortran_vec ();
+  const octave::math::kdtree tree (x);
 
-#define DIST(dd, y, yi, m)                      \
-  dd = 0.0;                                     \
-  for (octave_idx_type k = 0; k < m; k++)       \
-    {                                           \
-      double yd = y[k] - yi[k];                 \
-      dd += yd * yd;                            \
-    }                                           \
-  dd = sqrt (dd)
+  const double *pxi = xi.data ();
 
-  const double *pxi = xi.fortran_vec ();
-  for (octave_idx_type i = 0; i < nxi; i++)
+  if (nargin == 4)
+    {
+      std::string opt
+        = args(2).xstring_value ("__dsearchn__: third argument must be a string");
+
+      if (opt != "radius")
+        error ("__dsearchn__: unknown option '%s'", opt.c_str ());
+
+      double r = args(3).xdouble_value ("__dsearchn__: R must be a scalar");
+
+      Cell idx (nxi, 1);
+      Cell dist (nxi, 1);
+
+      for (octave_idx_type i = 0; i < nxi; i++)
+        {
+          const double *q = pxi + i*n;
+
+          std::vector<octave_idx_type> found = tree.within_radius (q, r);
+
+          octave_idx_type nfound = found.size ();
+
+          RowVector fidx (nfound);
+          RowVector fdist (nfound);
+
+          for (octave_idx_type j = 0; j < nfound; j++)
+            {
+              fidx(j) = found[j] + 1;
+
+              double d2 = 0;
+              for (octave_idx_type l = 0; l < n; l++)
+                {
+                  double diff = q[l] - x(l, found[j]);
+                  d2 += diff * diff;
+                }
+
+              fdist(j) = std::sqrt (d2);
+            }
+
+          idx(i) = fidx;
+          dist(i) = fdist;
+        }
+
+      return ovl (idx, dist);
+    }
+  else if (nargin == 3)
     {
-      double d0;
-      const double *px = x.fortran_vec ();
-      DIST(d0, px, pxi, n);
-      *pidx = 1.;
-      for (octave_idx_type j = 1; j < nx; j++)
+      octave_idx_type k
+        = args(2).xidx_type_value ("__dsearchn__: K must be an integer");
+
+      if (k < 0)
+        error ("__dsearchn__: K must be non-negative");
+
+      Matrix idx (nxi, k);
+      Matrix dist (nxi, k);
+
+      std::vector<octave_idx_type> kidx (k);
+      std::vector<double> kdist (k);
+
+      for (octave_idx_type i = 0; i < nxi; i++)
         {
-          px += n;
-          double d;
-          DIST (d, px, pxi, n);
-          if (d < d0)
+          tree.k_nearest (pxi + i*n, k, kidx.data (), kdist.data ());
+
+          // Points that are not found get the index NaN.
+          for (octave_idx_type j = 0; j < k; j++)
             {
-              d0 = d;
-              *pidx = static_cast<double>(j + 1);
+              idx(i,j) = (kidx[j] < 0 ? octave::numeric_limits<double>::NaN ()
+                                      : kidx[j] + 1);
+              dist(i,j) = kdist[j];
             }
-          octave_quit ();
         }
 
-      *pdist++ = d0;
-      pidx++;
-      pxi += n;
+      return ovl (idx, dist);
     }
 
+  ColumnVector idx (nxi);
+  double *pidx = idx.fortran_vec ();
+  ColumnVector dist (nxi);
+  double *pdist = dist.fortran_vec ();
+
+#if defined (HAVE_OPENMP)
+#  pragma omp parallel for if (nxi > 1000)
+#endif
+  for (octave_idx_type i = 0; i < nxi; i++)
+    pidx[i] = tree.nearest (pxi + i*n, pdist[i]) + 1;
+
   return ovl (idx, dist);
 }
 
 /*
-## No test needed for internal helper function.
-%!assert (1)
+%!test
+%! x = [0 0; 1 0; 0 1; 1 1; 0.5 0.5];
+%! [idx, d] = __dsearchn__ (x, [0.1 0.1; 0.9 0.2; 0.5 0.5; 2 2; 0.5 0]);
+%! assert (idx, [1; 2; 5; 4; 1]);
+%! assert (d, [sqrt(0.02); sqrt(0.05); 0; sqrt(2); 0.5], eps);
+
+%!test
+%! x = rand (500, 3);
+%! xi = rand (50, 3);
+%! [idx, d] = __dsearchn__ (x, xi);
+%! for i = 1:rows (xi)
+%!   [d0, i0] = min (sqrt (sumsq (x - xi(i,:), 2)));
+%!   assert (idx(i), i0);
+%!   assert (d(i), d0, 2*eps);
+%! endfor
+
+%!test
+%! x = rand (300, 2);
+%! xi = [rand(20, 2); NaN 0.5];
+%! [idx, d] = __dsearchn__ (x, xi, 4);
+%! assert (size (idx), [21, 4]);
+%! for i = 1:20
+%!   [d0, i0] = sort (sqrt (sumsq (x - xi(i,:), 2)));
+%!   assert (idx(i,:), i0(1:4).');
+%!   assert (d(i,:), d0(1:4).', 2*eps);
+%! endfor
+%! assert (idx(21,:), NaN (1, 4));
+%! assert (d(21,:), Inf (1, 4));
+
+%!test
+%! [idx, d] = __dsearchn__ ([0 0; 1 0; 0 1], [0 0], 5);
+%! assert (idx, [1 2 3 NaN NaN]);
+%! assert (d, [0 1 1 Inf Inf]);
+
+%!test
+%! x = rand (300, 3);
+%! xi = rand (20, 3);
+%! [idx, d] = __dsearchn__ (x, xi, "radius", 0.2);
+%! for i = 1:20
+%!   d0 = sqrt (sumsq (x - xi(i,:), 2));
+%!   i0 = find (d0 <= 0.2).';
+%!   assert (idx{i}, i0);
+%!   assert (d{i}, d0(i0).', 2*eps);
+%! endfor
+
+%!test
+%! [idx, d] = __dsearchn__ ([0 0; 1 0; 3 0], [0 0; 10 10], "radius", 1);
+%! assert (idx, {[1 2]; zeros(1, 0)});
+%! assert (d, {[0 1]; zeros(1, 0)});
+
+%!error <K must be non-negative> __dsearchn__ (1, 1, -1)
+%!error <unknown option> __dsearchn__ (1, 1, "foo", 1)
 */
 
@@ -0,0 +1,620 @@
+/*
+
+Copyright (C) 2016 The Octave Project Developers
+
+This file is part of Octave.
+
+Octave is free software; you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+Octave is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Octave; see the file COPYING.  If not, see
+<http://www.gnu.org/licenses/>.
+
+*/
+
+// Hash-based kernels for unique, ismember and friends.  Grouping the
+// elements (or rows) of an array through a hash table costs O(N) and
+// leaves only the distinct values to be sorted, instead of sorting the
+// whole array and comparing neighbors.
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Array.h"
+#include "lo-mappers.h"
+#include "oct-cmplx.h"
+#include "oct-inttypes.h"
+
+#include "defun.h"
+#include "error.h"
+#include "errwarn.h"
+#include "ovl.h"
+#include "ov.h"
+
+// Parallelize the lookup phases only when the work outweighs the cost
+// of starting the threads.
+static const octave_idx_type parallel_threshold = 65536;
+
+template <typename T>
+static inline bool
+set_isnan (const T&)
+{
+  return false;
+}
+
+template <>
+inline bool
+set_isnan (const double& x)
+{
+  return octave::math::isnan (x);
+}
+
+template <>
+inline bool
+set_isnan (const float& x)
+{
+  return octave::math::isnan (x);
+}
+
+template <>
+inline bool
+set_isnan (const Complex& x)
+{
+  return octave::math::isnan (x);
+}
+
+template <>
+inline bool
+set_isnan (const FloatComplex& x)
+{
+  return octave::math::isnan (x);
+}
+
+// Element hashes must agree with operator ==, so -0 and +0 are folded
+// together.  NaN values are never hashed.
+
+template <typename T>
+struct set_elem_hash
+{
+  size_t operator () (const T& x) const
+  { return std::hash<T> () (x); }
+};
+
+template <>
+struct set_elem_hash<double>
+{
+  size_t operator () (double x) const
+  { return std::hash<double> () (x == 0 ? 0.0 : x); }
+};
+
+template <>
+struct set_elem_hash<float>
+{
+  size_t operator () (float x) const
+  { return std::hash<float> () (x == 0 ? 0.0f : x); }
+};
+
+template <typename T>
+struct set_elem_hash<std::complex<T>>
+{
+  size_t operator () (const std::complex<T>& x) const
+  {
+    set_elem_hash<T> h;
+    return h (x.real ()) ^ (h (x.imag ()) << 1);
+  }
+};
+
+template <typename T>
+struct set_elem_hash<octave_int<T>>
+{
+  size_t operator () (const octave_int<T>& x) const
+  { return std::hash<T> () (x.value ()); }
+};
+
+// Rows of one or two column-major arrays with the same number of
+// columns.  Row keys are indices; nonnegative keys refer to rows of X
+// and negative keys K to row -K-1 of Y, which lets rows of Y be looked
+// up in a table built from rows of X without copying them.
+
+template <typename T>
+struct set_rows
+{
+  const T *x;
+  octave_idx_type xr;
+  const T *y;
+  octave_idx_type yr;
+  octave_idx_type nc;
+
+  const T& elem (octave_idx_type k, octave_idx_type j) const
+  { return k >= 0 ? x[k + j*xr] : y[-k-1 + j*yr]; }
+
+  bool any_nan (octave_idx_type k) const
+  {
+    for (octave_idx_type j = 0; j < nc; j++)
+      if (set_isnan (elem (k, j)))
+        return true;
+
+    return false;
+  }
+};
+
+template <typename T>
+struct set_row_hash
+{
+  const set_rows<T> *rows;
+
+  size_t operator () (octave_idx_type k) const
+  {
+    set_elem_hash<T> h;
+    size_t seed = 0;
+    for (octave_idx_type j = 0; j < rows->nc; j++)
+      seed ^= h (rows->elem (k, j)) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    return seed;
+  }
+};
+
+template <typename T>
+struct set_row_equal
+{
+  const set_rows<T> *rows;
+
+  bool operator () (octave_idx_type a, octave_idx_type b) const
+  {
+    for (octave_idx_type j = 0; j < rows->nc; j++)
+      if (! (rows->elem (a, j) == rows->elem (b, j)))
+        return false;
+
+    return true;
+  }
+};
+
+template <typename T>
+using set_row_map = std::unordered_map<octave_idx_type, octave_idx_type,
+                                       set_row_hash<T>, set_row_equal<T>>;
+
+// Assign each of the NR rows of X to a group of equal rows.  Rows
+// containing NaN are never equal to anything and form groups of their
+// own.  Groups are numbered in order of first appearance.  On return,
+// GRP holds the group of each row and FIRST and LAST the first and
+// last row of each group.
+
+template <typename T>
+static void
+group_rows (const Array<T>& x, octave_idx_type nr, octave_idx_type nc,
+            Array<octave_idx_type>& grp,
+            std::vector<octave_idx_type>& first,
+            std::vector<octave_idx_type>& last)
+{
+  set_rows<T> rows = { x.data (), nr, 0, 0, nc };
+  set_row_map<T> map (16, set_row_hash<T> { &rows },
+                      set_row_equal<T> { &rows });
+
+  grp.clear (dim_vector (nr, 1));
+  octave_idx_type *pgrp = grp.fortran_vec ();
+
+  for (octave_idx_type i = 0; i < nr; i++)
+    {
+      octave_idx_type g = first.size ();
+
+      if (rows.any_nan (i))
+        {
+          first.push_back (i);
+          last.push_back (i);
+        }
+      else
+        {
+          auto p = map.emplace (i, g);
+          if (p.second)
+            {
+              first.push_back (i);
+              last.push_back (i);
+            }
+          else
+            {
+              g = p.first->second;
+              last[g] = i;
+            }
+        }
+
+      pgrp[i] = g;
+    }
+}
+
+// For each of the NA rows of A, find the last equal row of S.  Return
+// its (zero-based) index in IDX, or -1 if there is none.
+
+template <typename T>
+static void
+match_rows (const Array<T>& a, octave_idx_type na,
+            const Array<T>& s, octave_idx_type ns, octave_idx_type nc,
+            Array<octave_idx_type>& idx)
+{
+  set_rows<T> rows = { s.data (), ns, a.data (), na, nc };
+  set_row_map<T> map (16, set_row_hash<T> { &rows },
+                      set_row_equal<T> { &rows });
+
+  for (octave_idx_type i = 0; i < ns; i++)
+    {
+      if (! rows.any_nan (i))
+        map[i] = i;
+    }
+
+  idx.clear (dim_vector (na, 1));
+  octave_idx_type *pidx = idx.fortran_vec ();
+
+  // Lookups do not modify the table, so they may run concurrently.
+
+#if defined (HAVE_OPENMP)
+#  pragma omp parallel for if (na > parallel_threshold)
+#endif
+  for (octave_idx_type i = 0; i < na; i++)
+    {
+      octave_idx_type k = -i-1;
+      pidx[i] = -1;
+
+      if (! rows.any_nan (k))
+        {
+          typename set_row_map<T>::const_iterator p = map.find (k);
+          if (p != map.end ())
+            pidx[i] = p->second;
+        }
+    }
+}
+
+static void
+group_rows (const octave_value& x, octave_idx_type nr, octave_idx_type nc,
+            Array<octave_idx_type>& grp,
+            std::vector<octave_idx_type>& first,
+            std::vector<octave_idx_type>& last)
+{
+  switch (x.builtin_type ())
+    {
+    case btyp_double:
+      group_rows (x.array_value (), nr, nc, grp, first, last);
+      break;
+
+    case btyp_complex:
+      group_rows (x.complex_array_value (), nr, nc, grp, first, last);
+      break;
+
+    case btyp_float:
+      group_rows (x.float_array_value (), nr, nc, grp, first, last);
+      break;
+
+    case btyp_float_complex:
+      group_rows (x.float_complex_array_value (), nr, nc, grp, first, last);
+      break;
+
+    case btyp_bool:
+      group_rows (x.bool_array_value (), nr, nc, grp, first, last);
+      break;
+
+    case btyp_char:
+      group_rows (x.char_array_value (), nr, nc, grp, first, last);
+      break;
+
+#define MAKE_INT_BRANCH(X)                                              \
+    case btyp_ ## X:                                                    \
+      group_rows (x.X ## _array_value (), nr, nc, grp, first, last);    \
+      break;
+
+    MAKE_INT_BRANCH (int8);
+    MAKE_INT_BRANCH (int16);
+    MAKE_INT_BRANCH (int32);
+    MAKE_INT_BRANCH (int64);
+    MAKE_INT_BRANCH (uint8);
+    MAKE_INT_BRANCH (uint16);
+    MAKE_INT_BRANCH (uint32);
+    MAKE_INT_BRANCH (uint64);
+
+#undef MAKE_INT_BRANCH
+
+    default:
+      if (x.is_cellstr ())
+        group_rows (x.cellstr_value (), nr, nc, grp, first, last);
+      else
+        err_wrong_type_arg ("unique", x);
+    }
+}
+
+static void
+match_rows (const octave_value& a, octave_idx_type na,
+            const octave_value& s, octave_idx_type ns, octave_idx_type nc,
+            Array<octave_idx_type>& idx)
+{
+  if (a.builtin_type () != s.builtin_type ())
+    error ("ismember: A and S must have the same class");
+
+  switch (a.builtin_type ())
+    {
+    case btyp_double:
+      match_rows (a.array_value (), na, s.array_value (), ns, nc, idx);
+      break;
+
+    case btyp_complex:
+      match_rows (a.complex_array_value (), na,
+                  s.complex_array_value (), ns, nc, idx);
+      break;
+
+    case btyp_float:
+      match_rows (a.float_array_value (), na,
+                  s.float_array_value (), ns, nc, idx);
+      break;
+
+    case btyp_float_complex:
+      match_rows (a.float_complex_array_value (), na,
+                  s.float_complex_array_value (), ns, nc, idx);
+      break;
+
+    case btyp_bool:
+      match_rows (a.bool_array_value (), na,
+                  s.bool_array_value (), ns, nc, idx);
+      break;
+
+    case btyp_char:
+      match_rows (a.char_array_value (), na,
+                  s.char_array_value (), ns, nc, idx);
+      break;
+
+#define MAKE_INT_BRANCH(X)                                              \
+    case btyp_ ## X:                                                    \
+      match_rows (a.X ## _array_value (), na,                           \
+                  s.X ## _array_value (), ns, nc, idx);                 \
+      break;
+
+    MAKE_INT_BRANCH (int8);
+    MAKE_INT_BRANCH (int16);
+    MAKE_INT_BRANCH (int32);
+    MAKE_INT_BRANCH (int64);
+    MAKE_INT_BRANCH (uint8);
+    MAKE_INT_BRANCH (uint16);
+    MAKE_INT_BRANCH (uint32);
+    MAKE_INT_BRANCH (uint64);
+
+#undef MAKE_INT_BRANCH
+
+    default:
+      if (a.is_cellstr () && s.is_cellstr ())
+        match_rows (a.cellstr_value (), na, s.cellstr_value (), ns, nc, idx);
+      else
+        err_wrong_type_arg ("ismember", a);
+    }
+}
+
+DEFUN (__unique__, args, nargout,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {[@var{y}, @var{i}, @var{j}] =} __unique__ (@var{x}, @var{byrows}, @var{first})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 3)
+    print_usage ();
+
+  octave_value x = args(0);
+  bool by_rows = args(1).bool_value ();
+  bool optfirst = args(2).bool_value ();
+
+  dim_vector dv = x.dims ();
+
+  if (by_rows && dv.ndims () > 2)
+    error ("unique: X must be a 2-D matrix to use \"rows\"");
+
+  octave_idx_type nr = (by_rows ? dv(0) : dv.numel ());
+  octave_idx_type nc = (by_rows ? dv(1) : 1);
+
+  Array<octave_idx_type> grp;
+  std::vector<octave_idx_type> first, last;
+
+  group_rows (x, nr, nc, grp, first, last);
+
+  octave_idx_type ngrp = first.size ();
+
+  // Pick one representative of each group and sort only those.  The
+  // representative is the last occurrence, which is the element a
+  // stable sort followed by removal of repeated values would keep.
+
+  Array<octave_idx_type> rep (dim_vector (ngrp, 1));
+  std::copy (last.begin (), last.end (), rep.fortran_vec ());
+
+  octave_value y;
+  Array<octave_idx_type> sidx;
+
+  if (by_rows)
+    {
+      octave_value_list idx (2);
+      idx(0) = idx_vector (rep, nr);
+      idx(1) = octave_value::magic_colon_t;
+
+      y = x.do_index_op (idx);
+
+      sidx = y.sort_rows_idx (ASCENDING);
+
+      idx(0) = idx_vector (sidx, ngrp);
+
+      y = y.do_index_op (idx);
+    }
+  else
+    {
+      y = x.do_index_op (ovl (idx_vector (rep, nr)));
+
+      y = y.sort (sidx, y.rows () == 1 ? 1 : 0, ASCENDING);
+    }
+
+  octave_value_list retval (nargout > 1 ? nargout : 1);
+
+  retval(0) = y;
+
+  if (nargout > 1)
+    {
+      // Index vectors follow the orientation of Y.
+      bool row_out = (! by_rows && dv.ndims () == 2 && dv(0) == 1);
+
+      const std::vector<octave_idx_type>& pick = (optfirst ? first : last);
+      const octave_idx_type *ps = sidx.data ();
+
+      Array<octave_idx_type> i (row_out ? dim_vector (1, ngrp)
+                                        : dim_vector (ngrp, 1));
+      octave_idx_type *pi = i.fortran_vec ();
+
+      for (octave_idx_type k = 0; k < ngrp; k++)
+        pi[k] = pick[ps[k]];
+
+      retval(1) = idx_vector (i, nr);
+
+      if (nargout > 2)
+        {
+          // Rank of each group in the sorted output.
+          Array<octave_idx_type> rank (dim_vector (ngrp, 1));
+          octave_idx_type *prank = rank.fortran_vec ();
+
+          for (octave_idx_type k = 0; k < ngrp; k++)
+            prank[ps[k]] = k;
+
+          Array<octave_idx_type> j (row_out ? dim_vector (1, nr)
+                                            : dim_vector (nr, 1));
+          octave_idx_type *pj = j.fortran_vec ();
+          const octave_idx_type *pgrp = grp.data ();
+
+#if defined (HAVE_OPENMP)
+#  pragma omp parallel for if (nr > parallel_threshold)
+#endif
+          for (octave_idx_type k = 0; k < nr; k++)
+            pj[k] = prank[pgrp[k]];
+
+          retval(2) = idx_vector (j, ngrp);
+        }
+    }
+
+  return retval;
+}
+
+/*
+%!test
+%! [y, i, j] = __unique__ ([3, 1, 3, NaN, 2, 1, NaN], false, false);
+%! assert (y, [1, 2, 3, NaN, NaN]);
+%! assert (i, [6, 5, 3, 4, 7]);
+%! assert (j, [3, 1, 3, 4, 2, 1, 5]);
+
+%!test
+%! [y, i, j] = __unique__ ([3; 1; 3; 2; 1], false, true);
+%! assert (y, [1; 2; 3]);
+%! assert (i, [2; 4; 1]);
+%! assert (j, [3; 1; 3; 2; 1]);
+
+%!test
+%! [y, i, j] = __unique__ ({"b", "a", "b"}, false, false);
+%! assert (y, {"a", "b"});
+%! assert (i, [2, 3]);
+%! assert (j, [2, 1, 2]);
+
+%!test
+%! x = int8 ([1 2; 0 1; 1 2]);
+%! [y, i, j] = __unique__ (x, true, true);
+%! assert (y, int8 ([0 1; 1 2]));
+%! assert (i, [2; 1]);
+%! assert (j, [2; 1; 2]);
+
+%!assert (__unique__ ([0, -0, 0], false, false), 0)
+%!error <X must be a 2-D matrix> __unique__ (ones (2, 2, 2), true, false)
+*/
+
+DEFUN (__ismember__, args, nargout,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {[@var{tf}, @var{s_idx}] =} __ismember__ (@var{a}, @var{s}, @var{byrows})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 3)
+    print_usage ();
+
+  octave_value a = args(0);
+  octave_value s = args(1);
+  bool by_rows = args(2).bool_value ();
+
+  dim_vector adv = a.dims ();
+  dim_vector sdv = s.dims ();
+
+  octave_idx_type na, ns, nc;
+
+  if (by_rows)
+    {
+      if (adv.ndims () > 2 || sdv.ndims () > 2)
+        error ("ismember: A and S must be 2-D matrices to use \"rows\"");
+      if (adv(1) != sdv(1))
+        error ("ismember: number of columns in A and S must match");
+
+      na = adv(0);
+      ns = sdv(0);
+      nc = adv(1);
+      adv = dim_vector (na, 1);
+    }
+  else
+    {
+      na = adv.numel ();
+      ns = sdv.numel ();
+      nc = 1;
+    }
+
+  Array<octave_idx_type> idx;
+
+  match_rows (a, na, s, ns, nc, idx);
+
+  const octave_idx_type *pidx = idx.data ();
+
+  boolNDArray tf (adv);
+  bool *ptf = tf.fortran_vec ();
+
+  for (octave_idx_type i = 0; i < na; i++)
+    ptf[i] = (pidx[i] >= 0);
+
+  octave_value_list retval (nargout > 1 ? 2 : 1);
+
+  retval(0) = tf;
+
+  if (nargout > 1)
+    {
+      NDArray s_idx (adv);
+      double *ps_idx = s_idx.fortran_vec ();
+
+      for (octave_idx_type i = 0; i < na; i++)
+        ps_idx[i] = pidx[i] + 1;
+
+      retval(1) = s_idx;
+    }
+
+  return retval;
+}
+
+/*
+%!test
+%! [tf, s_idx] = __ismember__ ([3, 10, 1, NaN], [0:9, 3], false);
+%! assert (tf, logical ([1, 0, 1, 0]));
+%! assert (s_idx, [11, 0, 2, 0]);
+
+%!test
+%! [tf, s_idx] = __ismember__ ({"abc"; "x"}, {"abc", "def"}, false);
+%! assert (tf, [true; false]);
+%! assert (s_idx, [1; 0]);
+
+%!test
+%! [tf, s_idx] = __ismember__ ([1:3; 5:7; 4:6], [0:2; 1:3; 2:4; 3:5; 4:6], true);
+%! assert (tf, logical ([1; 0; 1]));
+%! assert (s_idx, [2; 0; 5]);
+
+%!error <same class> __ismember__ (1, single (1), false)
+%!error <number of columns> __ismember__ ([1 2], [1 2 3], true)
+*/
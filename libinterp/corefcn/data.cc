@@ -32,7 +32,9 @@ along with Octave; see the file COPYING.  If not, see
 #include <cfloat>
 #include <ctime>
 
+#include <algorithm>
 #include <string>
+#include <vector>
 
 #include "lo-ieee.h"
 #include "lo-math.h"
@@ -57,6 +59,8 @@ along with Octave; see the file COPYING.  If not, see
 #include "ov-cx-mat.h"
 #include "ov-flt-cx-mat.h"
 #include "ov-cx-sparse.h"
+#include "ov-lazy-trans.h"
+#include "ov-re-mat.h"
 #include "parse.h"
 #include "pt-mat.h"
 #include "utils.h"
@@ -909,6 +913,46 @@ negative numbers or when the values are periodic.
 %!assert <42627> (mod (0.94, 0.01), 0.0)
 */
 
+// If ARGS(0) is a transpose that has not been formed yet, apply the
+// reduction FCN to the original matrix along the other dimension and
+// transpose the result.  NARGIN excludes trailing options, and DIM is
+// zero-based or -1.
+
+static bool
+reduce_lazy_transpose (octave_value& retval,
+                       octave_value_list (*fcn) (const octave_value_list&,
+                                                 int),
+                       const octave_value_list& args, int nargin, int dim)
+{
+  const octave_value& arg = args(0);
+
+  if (arg.type_id () != octave_lazy_transpose::static_type_id ())
+    return false;
+
+  const octave_lazy_transpose& v
+    = dynamic_cast<const octave_lazy_transpose&> (arg.get_rep ());
+
+  if (v.is_formed ())
+    return false;
+
+  if (dim < 0)
+    dim = arg.dims ().first_non_singleton ();
+
+  if (dim > 1)
+    return false;
+
+  octave_value_list new_args = ovl (v.untransposed_value (), 2 - dim);
+
+  for (int i = nargin; i < args.length (); i++)
+    new_args.append (args(i));
+
+  octave_value tmp = fcn (new_args, 1)(0);
+
+  retval = v.is_hermitian () ? op_hermitian (tmp) : op_transpose (tmp);
+
+  return true;
+}
+
 #define DATA_REDUCTION(FCN)                                             \
                                                                         \
   int nargin = args.length ();                                          \
@@ -1075,11 +1119,16 @@ See @code{sum} for an explanation of the optional parameters
   octave_value retval;
   octave_value arg = args(0);
 
+  if (reduce_lazy_transpose (retval, Fcumsum, args, nargin, dim))
+    return retval;
+
   switch (arg.builtin_type ())
     {
     case btyp_double:
       if (arg.is_sparse_type ())
         retval = arg.sparse_matrix_value ().cumsum (dim);
+      else if (arg.is_range () && (dim == -1 || dim == 1))
+        retval = arg.range_value ().cumsum ();
       else
         retval = arg.array_value ().cumsum (dim);
       break;
@@ -1361,6 +1410,9 @@ in double precision even for single precision inputs.
         error ("prod: invalid dimension DIM = %d", dim + 1);
     }
 
+  if (reduce_lazy_transpose (retval, Fprod, args, nargin, dim))
+    return retval;
+
   switch (arg.builtin_type ())
     {
     case btyp_double:
@@ -2422,6 +2474,29 @@ cat (4, ones (2, 2), zeros (2, 2))
 %!assert ([zeros(3,2,2); ones(1,2,2)], repmat ([0;0;0;1],[1,2,2]))
 %!assert ([zeros(3,2,2); ones(1,2,2)], vertcat (zeros (3,2,2), ones (1,2,2)))
 
+%!test
+%! a = reshape (1:24, [2, 3, 4]);
+%! b = reshape (25:40, [2, 2, 4]);
+%! c = reshape (41:60, [1, 5, 4]);
+%! x = [a, b; c];
+%! assert (size (x), [3, 5, 4]);
+%! assert (x(1:2,1:3,:), a);
+%! assert (x(1:2,4:5,:), b);
+%! assert (x(3,:,:), c);
+%! assert (cat (3, a, a)(:), [a(:); a(:)]);
+%! assert (cat (2, a, b), x(1:2,:,:));
+%! y = cat (1, a, a(1,:,:), zeros (0, 3, 4));
+%! assert (y(3,:,:), a(1,:,:));
+
+%!test
+%! a = rand (300, 400);
+%! b = rand (300, 100);
+%! x = [a, b; b, a];
+%! assert (x(1:300,401:500), b);
+%! assert (x(301:600,1:100), b);
+%! assert (x(301:600,101:500), a);
+%! assert (vertcat (a(:), b(:)), x(1:300,:)(:));
+
 %!test <49759>
 %! A = [];
 %! B = {1; 2};
@@ -2446,7 +2521,15 @@ do_permute (const octave_value_list& args, bool inv)
   for (int i = 0; i < n; i++)
     vec(i)--;
 
-  return octave_value (args(0).permute (vec, inv));
+  // Exchanging the dimensions of a full matrix is a transpose, which is
+  // only formed if it is needed.
+  octave_value arg = args(0);
+  if (n == 2 && vec(0) == 1 && vec(1) == 0
+      && (arg.type_id () == octave_matrix::static_type_id ()
+          || arg.type_id () == octave_complex_matrix::static_type_id ()))
+    return op_transpose (arg);
+
+  return octave_value (arg.permute (vec, inv));
 }
 
 DEFUN (permute, args, ,
@@ -2898,6 +2981,9 @@ inputs, @qcode{"extra"} is the same as @qcode{"double"}.  Otherwise,
   octave_value retval;
   octave_value arg = args(0);
 
+  if (reduce_lazy_transpose (retval, Fsum, args, nargin, dim))
+    return retval;
+
   switch (arg.builtin_type ())
     {
     case btyp_double:
@@ -2907,6 +2993,8 @@ inputs, @qcode{"extra"} is the same as @qcode{"double"}.  Otherwise,
             warning ("sum: 'extra' not yet implemented for sparse matrices");
           retval = arg.sparse_matrix_value ().sum (dim);
         }
+      else if (arg.is_range () && (dim == -1 || dim == 1) && ! isextra)
+        retval = arg.range_value ().sum ();
       else if (isextra)
         retval = arg.array_value ().xsum (dim);
       else
@@ -6820,6 +6908,8 @@ The result is equivalent to @code{sort(@var{x})(@var{n})}.
 
 @var{n} can also be a contiguous range, either ascending @code{l:u}
 or descending @code{u:-1:l}, in which case a range of elements is returned.
+Any other vector @var{n} selects all of the requested elements in a single
+pass over the data and returns them in the order given by @var{n}.
 
 If @var{x} is an array, @code{nth_element} operates along the dimension
 defined by @var{dim}, or the first non-singleton dimension if @var{dim} is
@@ -6904,6 +6994,20 @@ the ratio K/M is small; otherwise, it may be better to use @code{sort}.
   return retval;
 }
 
+/*
+%!assert (nth_element ([3, 1, NaN, 2], 2), 2)
+%!assert (nth_element ([3, 1, NaN, 2], 2:3), [2, 3])
+%!assert (nth_element ([3, 1, NaN, 2], 4:-1:3), [NaN, 3])
+%!assert (nth_element ([5, 3, 1, 4, 2], [5, 1, 3]), [5, 1, 3])
+%!assert (nth_element ([5, 3, 1, NaN, 2], [4, 5, 1]), [5, NaN, 1])
+%!assert (nth_element ([4; 1; 3; 2], [1; 1; 4]), [1; 1; 4])
+%!assert (nth_element (single ([4 8; 1 6; 3 7]), [3, 1], 1),
+%!        single ([4 8; 1 6]))
+%!assert (nth_element (int8 ([4 1 3 2]), [4, 2]), int8 ([4, 2]))
+
+%!error <invalid element index> nth_element ([1, 2, 3], [1, 4])
+*/
+
 template <typename NDT>
 static NDT
 do_accumarray_sum (const idx_vector& idx, const NDT& vals,
@@ -7119,6 +7223,255 @@ Undocumented internal function.
   return do_accumarray_minmax_fun (args, false);
 }
 
+// Count the elements of each group, and optionally only those for which
+// MASK is true.  For large inputs, every thread counts into its own
+// partial array and the partial counts are merged at the end.
+
+static void
+accumarray_count (const octave_idx_type *grp, octave_idx_type l,
+                  const bool *mask, octave_idx_type *cnt, octave_idx_type ng)
+{
+  std::fill_n (cnt, ng, 0);
+
+#if defined (HAVE_OPENMP)
+  if (l > 65536 && ng <= l / 8)
+    {
+#  pragma omp parallel
+      {
+        std::vector<octave_idx_type> part (ng, 0);
+
+#  pragma omp for nowait
+        for (octave_idx_type i = 0; i < l; i++)
+          if (! mask || mask[i])
+            part[grp[i]]++;
+
+#  pragma omp critical
+        for (octave_idx_type k = 0; k < ng; k++)
+          cnt[k] += part[k];
+      }
+
+      return;
+    }
+#endif
+
+  for (octave_idx_type i = 0; i < l; i++)
+    if (! mask || mask[i])
+      cnt[grp[i]]++;
+}
+
+// Grouped floating point reductions.  Sums and products are formed in
+// the order of the values so results agree with applying the reducer
+// to each group in turn.
+
+template <typename NDT>
+static NDT
+do_accumarray_reduce (const octave_idx_type *grp, const NDT& vals,
+                      const octave_idx_type *cnt, octave_idx_type ng,
+                      const std::string& op)
+{
+  typedef typename NDT::element_type T;
+
+  octave_idx_type l = vals.numel ();
+  const T *pv = vals.data ();
+
+  NDT retval (dim_vector (ng, 1), op == "prod" ? T (1) : T (0));
+  T *pr = retval.fortran_vec ();
+
+  if (op == "prod")
+    {
+      for (octave_idx_type i = 0; i < l; i++)
+        pr[grp[i]] *= pv[i];
+    }
+  else
+    {
+      for (octave_idx_type i = 0; i < l; i++)
+        pr[grp[i]] += pv[i];
+
+      for (octave_idx_type k = 0; k < ng; k++)
+        pr[k] /= cnt[k];
+
+      if (op == "var" || op == "std")
+        {
+          // Second pass over the centered values, as var does.
+          NDT ss (dim_vector (ng, 1), T (0));
+          T *pss = ss.fortran_vec ();
+
+          for (octave_idx_type i = 0; i < l; i++)
+            {
+              T d = pv[i] - pr[grp[i]];
+              pss[grp[i]] += d * d;
+            }
+
+          bool sq = (op == "std");
+
+          for (octave_idx_type k = 0; k < ng; k++)
+            {
+              pr[k] = (cnt[k] == 1 ? T (0) : pss[k] / (cnt[k] - 1));
+              if (sq)
+                pr[k] = std::sqrt (pr[k]);
+            }
+        }
+    }
+
+  return retval;
+}
+
+DEFUN (__accumarray_reduce__, args, nargout,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {[@var{vals}, @var{subs}] =} __accumarray_reduce__ (@var{idx}, @var{vals}, @var{op})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 3)
+    print_usage ();
+
+  if (! args(0).is_numeric_type ())
+    error ("__accumarray_reduce__: first argument must be numeric");
+
+  std::string op = args(2).xstring_value ("__accumarray_reduce__: OP must be a string");
+
+  octave_value_list retval (nargout > 1 ? 2 : 1);
+
+  try
+    {
+      idx_vector idx = args(0).index_vector ();
+      octave_value vals = args(1);
+
+      octave_idx_type n = idx.extent (0);
+      octave_idx_type l = idx.length (n);
+
+      if (vals.numel () != l)
+        error ("accumarray: dimensions mismatch");
+
+      // Number the nonempty groups in increasing order of subscript, so
+      // the reduced values come out in the same order as after sorting
+      // the subscripts.
+
+      Array<octave_idx_type> grp = idx.as_array ();
+      octave_idx_type *pgrp = grp.fortran_vec ();
+
+      Array<octave_idx_type> cnt (dim_vector (n, 1));
+      octave_idx_type *pcnt = cnt.fortran_vec ();
+
+      accumarray_count (pgrp, l, 0, pcnt, n);
+
+      Array<octave_idx_type> gnum (dim_vector (n, 1));
+      octave_idx_type *pgnum = gnum.fortran_vec ();
+
+      Array<octave_idx_type> subs (dim_vector (n, 1));
+      octave_idx_type *psubs = subs.fortran_vec ();
+
+      octave_idx_type ng = 0;
+
+      for (octave_idx_type k = 0; k < n; k++)
+        {
+          if (pcnt[k] > 0)
+            {
+              pcnt[ng] = pcnt[k];
+              psubs[ng] = k;
+              pgnum[k] = ng++;
+            }
+        }
+
+      subs.resize (dim_vector (ng, 1));
+
+      octave_value rvals;
+
+      if (op == "first" || op == "last")
+        {
+          Array<octave_idx_type> pos (dim_vector (ng, 1));
+          octave_idx_type *ppos = pos.fortran_vec ();
+
+          bool last = (op == "last");
+
+          if (last)
+            {
+              for (octave_idx_type i = 0; i < l; i++)
+                ppos[pgnum[pgrp[i]]] = i;
+            }
+          else
+            {
+              for (octave_idx_type i = l - 1; i >= 0; i--)
+                ppos[pgnum[pgrp[i]]] = i;
+            }
+
+          rvals = vals.do_index_op (ovl (idx_vector (pos, l)));
+        }
+      else
+        {
+          for (octave_idx_type i = 0; i < l; i++)
+            pgrp[i] = pgnum[pgrp[i]];
+
+          if (op == "numel")
+            {
+              NDArray r (dim_vector (ng, 1));
+              for (octave_idx_type k = 0; k < ng; k++)
+                r.xelem (k) = pcnt[k];
+              rvals = r;
+            }
+          else if (op == "any" || op == "all")
+            {
+              boolNDArray mask = vals.xbool_array_value ("accumarray: VALS must be logical for \"%s\"", op.c_str ());
+
+              Array<octave_idx_type> nnz (dim_vector (ng, 1));
+              octave_idx_type *pnnz = nnz.fortran_vec ();
+
+              accumarray_count (pgrp, l, mask.data (), pnnz, ng);
+
+              bool any = (op == "any");
+
+              boolNDArray r (dim_vector (ng, 1));
+              for (octave_idx_type k = 0; k < ng; k++)
+                r.xelem (k) = (any ? pnnz[k] > 0 : pnnz[k] == pcnt[k]);
+              rvals = r;
+            }
+          else if (op == "mean" || op == "prod" || op == "var" || op == "std")
+            {
+              if (vals.is_complex_type () || ! vals.is_float_type ())
+                err_wrong_type_arg ("accumarray", vals);
+
+              if (vals.is_single_type ())
+                rvals = do_accumarray_reduce (pgrp, vals.float_array_value (),
+                                              pcnt, ng, op);
+              else
+                rvals = do_accumarray_reduce (pgrp, vals.array_value (),
+                                              pcnt, ng, op);
+            }
+          else
+            error ("__accumarray_reduce__: unknown reduction '%s'", op.c_str ());
+        }
+
+      retval(0) = rvals;
+
+      if (nargout > 1)
+        retval(1) = idx_vector (subs, n);
+    }
+  catch (const octave::index_exception& e)
+    {
+      index_error ("__accumarray_reduce__: invalid IDX %s. %s",
+                   e.idx (), e.details ());
+    }
+
+  return retval;
+}
+
+/*
+%!test
+%! [v, s] = __accumarray_reduce__ ([3; 1; 3; 3], [1; 2; 3; 5], "mean");
+%! assert (v, [2; 3]);
+%! assert (s, [1; 3]);
+%!assert (__accumarray_reduce__ ([3; 1; 3; 3], [1; 2; 3; 5], "prod"), [2; 15])
+%!assert (__accumarray_reduce__ ([3; 1; 3], [1; 2; 3], "numel"), [1; 2])
+%!assert (__accumarray_reduce__ ([3; 1; 3], single ([1; 2; 4]), "var"),
+%!        single ([0; 4.5]))
+%!assert (__accumarray_reduce__ ([2; 2; 1], [1; 0; 0], "any"), [false; true])
+%!assert (__accumarray_reduce__ ([2; 2; 1], [1; 0; 1], "all"), [true; false])
+%!assert (__accumarray_reduce__ ([2; 1; 2; 1], int8 ([1; 2; 3; 4]), "first"),
+%!        int8 ([2; 1]))
+%!assert (__accumarray_reduce__ ([2; 1; 2; 1], "abcd", "last"), "dc")
+%!error <unknown reduction> __accumarray_reduce__ (1, 1, "median")
+*/
+
 template <typename NDT>
 static NDT
 do_accumdim_sum (const idx_vector& idx, const NDT& vals,
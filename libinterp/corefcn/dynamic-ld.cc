@@ -91,6 +91,31 @@ namespace octave
     return retval;
   }
 
+  dynamic_library
+  dynamic_loader::shlibs_list::take_file (const std::string& file_name)
+  {
+    dynamic_library retval;
+
+    for (iterator p = lib_list.begin (); p != lib_list.end (); p++)
+      {
+        if (p->file_name () == file_name)
+          {
+            retval = *p;
+            lib_list.erase (p);
+            break;
+          }
+      }
+
+    return retval;
+  }
+
+  void
+  dynamic_loader::shlibs_list::trim (size_t n)
+  {
+    while (lib_list.size () > n)
+      lib_list.pop_front ();
+  }
+
   void
   dynamic_loader::shlibs_list::display (void) const
   {
@@ -99,6 +124,16 @@ namespace octave
       std::cerr << "  " << lib.file_name () << std::endl;
   }
 
+  // Maximum number of unused .oct files that are kept open.  Windows
+  // does not allow replacing a DLL that is open, so keeping them would
+  // prevent rebuilding an .oct file after clearing its functions.
+
+#if defined (OCTAVE_USE_WINDOWS_API)
+  static const size_t max_idle_shlibs = 0;
+#else
+  static const size_t max_idle_shlibs = 32;
+#endif
+
   dynamic_loader *dynamic_loader::instance = 0;
 
   bool dynamic_loader::doing_load = false;
@@ -160,6 +195,14 @@ namespace octave
 
     dynamic_library oct_file = loaded_shlibs.find_file (file_name);
 
+    if (! oct_file)
+      {
+        oct_file = idle_shlibs.take_file (file_name);
+
+        if (oct_file)
+          loaded_shlibs.append (oct_file);
+      }
+
     if (oct_file && oct_file.is_out_of_date ())
       do_clear (oct_file);
 
@@ -272,7 +315,16 @@ namespace octave
         retval = shl.remove (fcn_name);
 
         if (shl.number_of_functions_loaded () == 0)
-          loaded_shlibs.remove (shl);
+          {
+            // Keep the library open in case its functions are needed
+            // again.  If the file changes in the meantime, do_load_oct
+            // closes it before opening the new version.
+
+            idle_shlibs.append (shl);
+            idle_shlibs.trim (max_idle_shlibs);
+
+            loaded_shlibs.remove (shl);
+          }
       }
 
     return retval;
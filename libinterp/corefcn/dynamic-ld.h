@@ -58,6 +58,13 @@ namespace octave
 
       octave::dynamic_library find_file (const std::string& file_name) const;
 
+      // Remove the library for FILE_NAME from the list without closing
+      // it and return it.
+      octave::dynamic_library take_file (const std::string& file_name);
+
+      // Close the oldest libraries until at most N remain.
+      void trim (size_t n);
+
       void display (void) const;
 
     private:
@@ -74,7 +81,7 @@ namespace octave
 
   protected:
 
-    dynamic_loader (void) : loaded_shlibs () { }
+    dynamic_loader (void) : loaded_shlibs (), idle_shlibs () { }
 
   public:
 
@@ -134,6 +141,11 @@ namespace octave
 
     shlibs_list loaded_shlibs;
 
+    // .oct files that are still open although none of their functions
+    // are currently defined, so that loading them again after a clear
+    // does not have to reopen them.
+    shlibs_list idle_shlibs;
+
     static std::string name_mangler (const std::string& name);
 
     static std::string name_uscore_mangler (const std::string& name);
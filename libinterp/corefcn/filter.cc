@@ -32,12 +32,277 @@ along with Octave; see the file COPYING.  If not, see
 #  include "config.h"
 #endif
 
+#include <algorithm>
+#include <vector>
+
+#include "lo-mappers.h"
 #include "quit.h"
 
 #include "defun.h"
 #include "error.h"
 #include "ovl.h"
 
+// Transposed direct form II recursion along one vector of X with a
+// state of length N, which is updated in place.  If IIR is false, the
+// denominator is 1 and A is not used.  The fixed-order version keeps
+// the state in registers.
+
+template <typename T, bool iir, int N>
+static void
+filter_fixed (const T *pa, const T *pb, const T *px, T *py, T *psi,
+              octave_idx_type x_len, octave_idx_type x_stride)
+{
+  T s[N];
+
+  std::copy (psi, psi + N, s);
+
+  for (octave_idx_type i = 0, idx = 0; i < x_len; i++, idx += x_stride)
+    {
+      const T xi = px[idx];
+      const T yi = s[0] + pb[0] * xi;
+
+      for (int j = 0; j < N - 1; j++)
+        s[j] = (iir ? s[j+1] - pa[j+1] * yi + pb[j+1] * xi
+                    : s[j+1] + pb[j+1] * xi);
+
+      s[N-1] = (iir ? pb[N] * xi - pa[N] * yi : pb[N] * xi);
+
+      py[idx] = yi;
+    }
+
+  std::copy (s, s + N, psi);
+}
+
+template <typename T, bool iir>
+static void
+filter_generic (const T *pa, const T *pb, const T *px, T *py, T *psi,
+                octave_idx_type x_len, octave_idx_type x_stride,
+                octave_idx_type n)
+{
+  for (octave_idx_type i = 0, idx = 0; i < x_len; i++, idx += x_stride)
+    {
+      const T xi = px[idx];
+      const T yi = psi[0] + pb[0] * xi;
+
+      for (octave_idx_type j = 0; j < n - 1; j++)
+        psi[j] = (iir ? psi[j+1] - pa[j+1] * yi + pb[j+1] * xi
+                      : psi[j+1] + pb[j+1] * xi);
+
+      psi[n-1] = (iir ? pb[n] * xi - pa[n] * yi : pb[n] * xi);
+
+      py[idx] = yi;
+    }
+}
+
+template <typename T, bool iir>
+static void
+filter_vector (const T *pa, const T *pb, const T *px, T *py, T *psi,
+               octave_idx_type x_len, octave_idx_type x_stride,
+               octave_idx_type si_len)
+{
+  switch (si_len)
+    {
+    case 1:
+      filter_fixed<T, iir, 1> (pa, pb, px, py, psi, x_len, x_stride);
+      break;
+    case 2:
+      filter_fixed<T, iir, 2> (pa, pb, px, py, psi, x_len, x_stride);
+      break;
+    case 3:
+      filter_fixed<T, iir, 3> (pa, pb, px, py, psi, x_len, x_stride);
+      break;
+    case 4:
+      filter_fixed<T, iir, 4> (pa, pb, px, py, psi, x_len, x_stride);
+      break;
+    case 5:
+      filter_fixed<T, iir, 5> (pa, pb, px, py, psi, x_len, x_stride);
+      break;
+    case 6:
+      filter_fixed<T, iir, 6> (pa, pb, px, py, psi, x_len, x_stride);
+      break;
+    case 7:
+      filter_fixed<T, iir, 7> (pa, pb, px, py, psi, x_len, x_stride);
+      break;
+    case 8:
+      filter_fixed<T, iir, 8> (pa, pb, px, py, psi, x_len, x_stride);
+      break;
+    default:
+      filter_generic<T, iir> (pa, pb, px, py, psi, x_len, x_stride, si_len);
+      break;
+    }
+}
+
+// FIR filters at least this long are applied by FFT convolution.
+
+static const octave_idx_type filter_fft_min_order = 256;
+
+template <typename T>
+struct filter_fft_traits;
+
+template <>
+struct filter_fft_traits<double>
+{
+  typedef ComplexNDArray array_type;
+  static double value (const Complex& z) { return z.real (); }
+};
+
+template <>
+struct filter_fft_traits<Complex>
+{
+  typedef ComplexNDArray array_type;
+  static Complex value (const Complex& z) { return z; }
+};
+
+template <>
+struct filter_fft_traits<float>
+{
+  typedef FloatComplexNDArray array_type;
+  static float value (const FloatComplex& z) { return z.real (); }
+};
+
+template <>
+struct filter_fft_traits<FloatComplex>
+{
+  typedef FloatComplexNDArray array_type;
+  static FloatComplex value (const FloatComplex& z) { return z; }
+};
+
+// FFT convolution is only used where it can't change the result much.
+// A single Inf or NaN would spread to the whole vector, and products of
+// integers would no longer be exact.
+
+static inline bool
+filter_integer_value (double v)
+{
+  return octave::math::isinteger (v);
+}
+
+static inline bool
+filter_integer_value (float v)
+{
+  return octave::math::isinteger (v);
+}
+
+template <typename T>
+static inline bool
+filter_integer_value (const std::complex<T>& v)
+{
+  return (filter_integer_value (v.real ())
+          && filter_integer_value (v.imag ()));
+}
+
+template <typename T>
+static bool
+filter_fft_coeffs_ok (const T *pb, octave_idx_type b_len)
+{
+  bool all_integer = true;
+
+  for (octave_idx_type i = 0; i < b_len; i++)
+    {
+      if (! octave::math::finite (pb[i]))
+        return false;
+
+      all_integer = all_integer && filter_integer_value (pb[i]);
+    }
+
+  return ! all_integer;
+}
+
+template <typename T>
+static bool
+filter_fft_data_ok (const T *px, octave_idx_type x_len,
+                    octave_idx_type x_stride)
+{
+  for (octave_idx_type i = 0; i < x_len; i++)
+    if (! octave::math::finite (px[i*x_stride]))
+      return false;
+
+  return true;
+}
+
+// Apply the FIR filter B to the vectors COLS of X at once by
+// convolution with FFTs.  The initial state SI is added to the start of
+// the result and the tail of the convolution becomes the final state.
+
+template <typename T>
+static void
+filter_fft (const MArray<T>& b, const MArray<T>& x, MArray<T>& y,
+            MArray<T>& si, octave_idx_type x_len, octave_idx_type x_stride,
+            const std::vector<octave_idx_type>& cols, octave_idx_type si_len)
+{
+  typedef typename filter_fft_traits<T>::array_type array_type;
+  typedef typename array_type::element_type complex_type;
+
+  octave_idx_type nfft = 1;
+  while (nfft < x_len + si_len)
+    nfft *= 2;
+
+  array_type bf (dim_vector (nfft, 1), complex_type (0));
+  std::copy (b.data (), b.data () + si_len + 1, bf.fortran_vec ());
+  bf = bf.fourier (0);
+
+  const octave_idx_type x_num = cols.size ();
+
+  array_type xf (dim_vector (nfft, x_num), complex_type (0));
+
+  const T *px = x.data ();
+  complex_type *pxf = xf.fortran_vec ();
+
+  for (octave_idx_type num = 0; num < x_num; num++)
+    {
+      octave_idx_type x_offset = ((cols[num] % x_stride)
+                                  + (cols[num] / x_stride) * x_stride * x_len);
+
+      for (octave_idx_type i = 0; i < x_len; i++)
+        pxf[num*nfft + i] = px[x_offset + i*x_stride];
+    }
+
+  octave_quit ();
+
+  xf = xf.fourier (0);
+
+  const complex_type *pbf = bf.data ();
+  pxf = xf.fortran_vec ();
+
+  for (octave_idx_type num = 0; num < x_num; num++)
+    for (octave_idx_type k = 0; k < nfft; k++)
+      pxf[num*nfft + k] *= pbf[k];
+
+  octave_quit ();
+
+  xf = xf.ifourier (0);
+
+  const complex_type *pc = xf.data ();
+  T *py = y.fortran_vec ();
+  T *psi = si.fortran_vec ();
+
+  for (octave_idx_type num = 0; num < x_num; num++)
+    {
+      octave_idx_type x_offset = ((cols[num] % x_stride)
+                                  + (cols[num] / x_stride) * x_stride * x_len);
+
+      const complex_type *pcn = pc + num*nfft;
+      T *psin = psi + cols[num]*si_len;
+
+      for (octave_idx_type i = 0; i < x_len; i++)
+        {
+          T yi = filter_fft_traits<T>::value (pcn[i]);
+          if (i < si_len)
+            yi += psin[i];
+          py[x_offset + i*x_stride] = yi;
+        }
+
+      // Only entries not yet overwritten are read, since x_len > 0.
+      for (octave_idx_type j = 0; j < si_len; j++)
+        {
+          T sj = filter_fft_traits<T>::value (pcn[x_len + j]);
+          if (x_len + j < si_len)
+            sj += psin[x_len + j];
+          psin[j] = sj;
+        }
+    }
+}
+
 template <typename T>
 MArray<T>
 filter (MArray<T>& b, MArray<T>& a, MArray<T>& x, MArray<T>& si,
@@ -108,97 +373,70 @@ filter (MArray<T>& b, MArray<T>& a, MArray<T>& x, MArray<T>& si,
     x_stride *= x_dims(i);
 
   octave_idx_type x_num = x_dims.numel () / x_len;
-  for (octave_idx_type num = 0; num < x_num; num++)
-    {
-      octave_idx_type x_offset;
-      if (x_stride == 1)
-        x_offset = num * x_len;
-      else
-        {
-          octave_idx_type x_offset2 = 0;
-          x_offset = num;
-          while (x_offset >= x_stride)
-            {
-              x_offset -= x_stride;
-              x_offset2++;
-            }
-          x_offset += x_offset2 * x_stride * x_len;
-        }
-      octave_idx_type si_offset = num * si_len;
 
-      if (a_len > 1)
-        {
-          T *py = y.fortran_vec ();
-          T *psi = si.fortran_vec ();
+  octave_quit ();
 
-          const T *pa = a.data ();
-          const T *pb = b.data ();
-          const T *px = x.data ();
+  const T *pa = a.data ();
+  const T *pb = b.data ();
+  const T *px = x.data ();
+  T *py = y.fortran_vec ();
+  T *psi = si.fortran_vec ();
 
-          psi += si_offset;
+  // Vectors that are filtered by FFT convolution.
 
-          for (octave_idx_type i = 0, idx = x_offset;
-               i < x_len;
-               i++, idx += x_stride)
-            {
-              py[idx] = psi[0] + pb[0] * px[idx];
+  std::vector<bool> use_fft;
 
-              if (si_len > 0)
-                {
-                  for (octave_idx_type j = 0; j < si_len - 1; j++)
-                    {
-                      octave_quit ();
+  if (a_len <= 1 && si_len >= filter_fft_min_order && x_len > si_len
+      && filter_fft_coeffs_ok (pb, si_len + 1))
+    {
+      use_fft.resize (x_num, false);
 
-                      psi[j] = psi[j+1] - pa[j+1] * py[idx] + pb[j+1] * px[idx];
-                    }
+      std::vector<octave_idx_type> cols;
 
-                  psi[si_len-1] = pb[si_len] * px[idx] - pa[si_len] * py[idx];
-                }
-              else
-                {
-                  octave_quit ();
+      for (octave_idx_type num = 0; num < x_num; num++)
+        {
+          octave_idx_type x_offset = ((num % x_stride)
+                                      + (num / x_stride) * x_stride * x_len);
 
-                  psi[0] = pb[si_len] * px[idx] - pa[si_len] * py[idx];
-                }
+          if (filter_fft_data_ok (px + x_offset, x_len, x_stride))
+            {
+              use_fft[num] = true;
+              cols.push_back (num);
             }
         }
-      else if (si_len > 0)
-        {
-          T *py = y.fortran_vec ();
-          T *psi = si.fortran_vec ();
 
-          const T *pb = b.data ();
-          const T *px = x.data ();
+      if (! cols.empty ())
+        filter_fft (b, x, y, si, x_len, x_stride, cols, si_len);
 
-          psi += si_offset;
-
-          for (octave_idx_type i = 0, idx = x_offset;
-               i < x_len;
-               i++, idx += x_stride)
-            {
-              py[idx] = psi[0] + pb[0] * px[idx];
+      if (static_cast<octave_idx_type> (cols.size ()) == x_num)
+        return y;
+    }
 
-              if (si_len > 1)
-                {
-                  for (octave_idx_type j = 0; j < si_len - 1; j++)
-                    {
-                      octave_quit ();
+  // octave_quit can't throw out of an OpenMP loop, so pending interrupts
+  // skip the remaining vectors and are handled after the loop.
 
-                      psi[j] = psi[j+1] + pb[j+1] * px[idx];
-                    }
+#if defined (HAVE_OPENMP)
+#  pragma omp parallel for if (x_num > 1 && x_len * x_num * si_len > 65536)
+#endif
+  for (octave_idx_type num = 0; num < x_num; num++)
+    {
+      if (octave_signal_caught || (! use_fft.empty () && use_fft[num]))
+        continue;
 
-                  psi[si_len-1] = pb[si_len] * px[idx];
-                }
-              else
-                {
-                  octave_quit ();
+      octave_idx_type x_offset = ((num % x_stride)
+                                  + (num / x_stride) * x_stride * x_len);
+      octave_idx_type si_offset = num * si_len;
 
-                  psi[0] = pb[1] * px[idx];
-                }
-            }
-        }
+      if (a_len > 1)
+        filter_vector<T, true> (pa, pb, px + x_offset, py + x_offset,
+                                psi + si_offset, x_len, x_stride, si_len);
+      else
+        filter_vector<T, false> (pa, pb, px + x_offset, py + x_offset,
+                                 psi + si_offset, x_len, x_stride, si_len);
     }
 
+  octave_quit ();
+
   return y;
 }
 
@@ -613,5 +851,41 @@ filter (MArray<FloatComplex>&, MArray<FloatComplex>&, MArray<FloatComplex>&,
 %! y0 = reshape (y0, size (x));
 %! y = filter ([1 1 1], 1, x, [], 3);
 %! assert (y, y0);
+
+%!test
+%! b = [1 2 1] / 4;
+%! a = [1 -0.5 0.25];
+%! x = rand (100, 40);
+%! y = filter (b, a, x);
+%! [y1, sf] = filter (b, a, x(1:50,:));
+%! y2 = filter (b, a, x(51:end,:), sf);
+%! assert ([y1; y2], y);
+%! assert (filter (b, a, x.', [], 2), y.');
+
+%!test
+%! ## Long FIR filters are applied with FFTs.
+%! b = rand (300, 1);
+%! x = rand (1000, 3);
+%! si = rand (299, 3);
+%! [y, sf] = filter (b, 1, x, si);
+%! c = conv2 (x, b);
+%! assert (y, c(1:1000,:) + [si; zeros(701,3)], 1e-10);
+%! assert (sf, c(1001:end,:), 1e-10);
+%! assert (filter (b, 1, single (x)), single (c(1:1000,:)), 1e-3);
+%! ## A NaN only affects the outputs within the filter length of it.
+%! x(500,2) = NaN;
+%! [y, sf] = filter (b, 1, x);
+%! c = conv2 (x, b);
+%! assert (isnan (y(500:799,2)));
+%! assert (y([1:499, 800:1000],2), c([1:499, 800:1000],2), 1e-10);
+%! assert (y(:,[1, 3]), c(1:1000,[1, 3]), 1e-10);
+%! assert (sf, c(1001:end,:), 1e-10);
+
+%!test
+%! ## Integer data is filtered exactly.
+%! b = ones (300, 1);
+%! x = randi (100, 1000, 2);
+%! c = conv2 (x, b);
+%! assert (filter (b, 1, x), c(1:1000,:));
 */
 
@@ -26,6 +26,9 @@ along with Octave; see the file COPYING.  If not, see
 #endif
 
 #include "base-text-renderer.h"
+#include "defun.h"
+#include "errwarn.h"
+#include "ov.h"
 
 #if defined (HAVE_FREETYPE)
 
@@ -45,15 +48,18 @@ along with Octave; see the file COPYING.  If not, see
 #pragma GCC diagnostic pop
 #endif
 
+#include <algorithm>
 #include <clocale>
 #include <cwchar>
 #include <iostream>
 #include <map>
 #include <utility>
+#include <vector>
 
 #include "singleton-cleanup.h"
 
 #include "error.h"
+#include "oct-map.h"
 #include "pr-output.h"
 #include "text-renderer.h"
 
@@ -89,13 +95,40 @@ static void ft_face_destroyed (void *object);
 
 namespace octave
 {
+  // Layout metrics and rasterized bitmap of a single glyph.
+
+  class
+  ft_glyph
+  {
+  public:
+
+    ft_glyph (void)
+      : advance (0), left (0), top (0), width (0), rows (0),
+        rendered (false), bitmap ()
+    { }
+
+    // Horizontal advance in pixels.
+    int advance;
+
+    // Position of the bitmap relative to the pen position, and its size.
+    int left, top, width, rows;
+
+    // Whether the bitmap below holds the rendered glyph.
+    bool rendered;
+
+    // Gray level of each pixel, row by row.
+    std::vector<unsigned char> bitmap;
+  };
+
   class
   ft_manager
   {
   private:
 
     ft_manager (void)
-      : library (), freetype_initialized (false), fontconfig_initialized (false)
+      : library (), freetype_initialized (false), fontconfig_initialized (false),
+        glyph_cache (), glyph_cache_bytes (0), glyph_cache_hits (0),
+        glyph_cache_misses (0), scratch_glyph ()
     {
       if (FT_Init_FreeType (&library))
         error ("unable to initialize FreeType library");
@@ -171,6 +204,31 @@ namespace octave
         instance->do_font_destroyed (face);
     }
 
+    // Return the glyph with index INDEX of FACE at the size currently
+    // set for FACE, or 0 if FreeType cannot load it.  If RENDER is true,
+    // also rasterize the glyph unless that has already been done.
+
+    static const ft_glyph * get_glyph (FT_Face face, FT_UInt index,
+                                       bool render)
+    {
+      return (instance_ok ()
+              ? instance->do_get_glyph (face, index, render)
+              : 0);
+    }
+
+    static octave_scalar_map glyph_cache_statistics (void)
+    {
+      return (instance_ok ()
+              ? instance->do_glyph_cache_statistics ()
+              : octave_scalar_map ());
+    }
+
+    static void clear_glyph_cache (void)
+    {
+      if (instance_ok ())
+        instance->do_clear_glyph_cache ();
+    }
+
   private:
 
     static ft_manager *instance;
@@ -308,12 +366,157 @@ namespace octave
           delete pkey;
           face->generic.data = 0;
         }
+
+      // Glyphs are cached by face pointer, which may be reused by the
+      // next face that gets loaded.
+
+      glyph_map::iterator first = glyph_cache.lower_bound (glyph_key (face, 0));
+      glyph_map::iterator last = first;
+
+      while (last != glyph_cache.end () && last->first.first == face)
+        {
+          glyph_cache_bytes -= glyph_size (last->second);
+          last++;
+        }
+
+      glyph_cache.erase (first, last);
+    }
+
+    static size_t glyph_size (const ft_glyph& glyph)
+    {
+      return sizeof (glyph_key) + sizeof (ft_glyph) + glyph.bitmap.size ();
+    }
+
+    // Load glyph INDEX of FACE into GLYPH, and rasterize it if RENDER
+    // is true.  Return false if the glyph cannot be loaded.  A glyph
+    // that cannot be rasterized is returned with RENDERED set to false.
+
+    static bool load_glyph (FT_Face face, FT_UInt index, bool render,
+                            ft_glyph& glyph)
+    {
+      if (FT_Load_Glyph (face, index, FT_LOAD_DEFAULT))
+        return false;
+
+      glyph.advance = (face->glyph->advance.x >> 6);
+      glyph.rendered = false;
+      glyph.bitmap.clear ();
+
+      if (render && ! FT_Render_Glyph (face->glyph, FT_RENDER_MODE_NORMAL))
+        {
+          const FT_Bitmap& bmp = face->glyph->bitmap;
+
+          glyph.left = face->glyph->bitmap_left;
+          glyph.top = face->glyph->bitmap_top;
+          glyph.width = bmp.width;
+          glyph.rows = bmp.rows;
+
+          int pitch = (bmp.pitch < 0 ? -bmp.pitch : bmp.pitch);
+
+          glyph.bitmap.resize (glyph.width * glyph.rows);
+
+          for (int r = 0; r < glyph.rows; r++)
+            std::copy (bmp.buffer + r*pitch,
+                       bmp.buffer + r*pitch + glyph.width,
+                       glyph.bitmap.begin () + r*glyph.width);
+
+          glyph.rendered = true;
+        }
+
+      return true;
+    }
+
+    const ft_glyph * do_get_glyph (FT_Face face, FT_UInt index, bool render)
+    {
+#if defined (HAVE_FT_REFERENCE_FACE)
+      glyph_key key (face, index);
+      glyph_map::iterator it = glyph_cache.find (key);
+
+      if (it == glyph_cache.end ())
+        {
+          glyph_cache_misses++;
+
+          ft_glyph glyph;
+
+          if (! load_glyph (face, index, render, glyph))
+            return 0;
+
+          size_t sz = glyph_size (glyph);
+
+          // Keep the cache bounded.  Text usually draws from a small
+          // set of glyphs, so simply start over when the limit is hit.
+
+          if (glyph_cache_bytes + sz > max_glyph_cache_bytes)
+            do_clear_glyph_cache ();
+
+          glyph_cache_bytes += sz;
+
+          it = glyph_cache.insert (glyph_map::value_type (key, glyph)).first;
+        }
+      else if (render && ! it->second.rendered)
+        {
+          glyph_cache_misses++;
+
+          glyph_cache_bytes -= glyph_size (it->second);
+          load_glyph (face, index, true, it->second);
+          glyph_cache_bytes += glyph_size (it->second);
+        }
+      else
+        glyph_cache_hits++;
+
+      return &(it->second);
+#else
+      // Without reference counted faces, we cannot tell when a face is
+      // destroyed, so glyphs are not cached.
+
+      glyph_cache_misses++;
+
+      if (! load_glyph (face, index, render, scratch_glyph))
+        return 0;
+
+      return &scratch_glyph;
+#endif
+    }
+
+    octave_scalar_map do_glyph_cache_statistics (void) const
+    {
+      octave_scalar_map retval;
+
+      retval.setfield ("hits", glyph_cache_hits);
+      retval.setfield ("misses", glyph_cache_misses);
+      retval.setfield ("glyphs", static_cast<double> (glyph_cache.size ()));
+      retval.setfield ("bytes", static_cast<double> (glyph_cache_bytes));
+      retval.setfield ("max_bytes", static_cast<double> (max_glyph_cache_bytes));
+
+      return retval;
+    }
+
+    void do_clear_glyph_cache (void)
+    {
+      glyph_cache.clear ();
+      glyph_cache_bytes = 0;
     }
 
   private:
     FT_Library library;
     bool freetype_initialized;
     bool fontconfig_initialized;
+
+    typedef std::pair<FT_Face, FT_UInt> glyph_key;
+    typedef std::map<glyph_key, ft_glyph> glyph_map;
+
+    // Glyphs loaded so far, by face and glyph index.  Each face is
+    // loaded at a single size, so the face identifies the size too.
+    glyph_map glyph_cache;
+
+    size_t glyph_cache_bytes;
+
+    // Number of lookups that were and were not served from the cache.
+    double glyph_cache_hits;
+    double glyph_cache_misses;
+
+    ft_glyph scratch_glyph;
+
+    static const size_t max_glyph_cache_bytes = 8 * 1024 * 1024;
   };
 
   ft_manager *ft_manager::instance = 0;
@@ -706,9 +909,12 @@ namespace octave
       {
         glyph_index = FT_Get_Char_Index (face, code);
 
+        const ft_glyph *glyph = 0;
+
         if (code != '\n'
             && (! glyph_index
-                || FT_Load_Glyph (face, glyph_index, FT_LOAD_DEFAULT)))
+                || ! (glyph = ft_manager::get_glyph (face, glyph_index,
+                                                     mode == MODE_RENDER))))
           {
             glyph_index = 0;
             warn_missing_glyph (code);
@@ -722,7 +928,7 @@ namespace octave
                   {
                     glyph_index = FT_Get_Char_Index (face, ' ');
                     if (! glyph_index
-                        || FT_Load_Glyph (face, glyph_index, FT_LOAD_DEFAULT))
+                        || ! ft_manager::get_glyph (face, glyph_index, false))
                       {
                         glyph_index = 0;
                         warn_missing_glyph (' ');
@@ -730,17 +936,16 @@ namespace octave
                     else
                       push_new_line ();
                   }
-                else if (FT_Render_Glyph (face->glyph, FT_RENDER_MODE_NORMAL))
+                else if (! glyph->rendered)
                   {
                     glyph_index = 0;
                     warn_glyph_render (code);
                   }
                 else
                   {
-                    FT_Bitmap& bitmap = face->glyph->bitmap;
                     int x0, y0;
 
-                    if (previous)
+                    if (previous && FT_HAS_KERNING (face))
                       {
                         FT_Vector delta;
 
@@ -749,8 +954,8 @@ namespace octave
                         xoffset += (delta.x >> 6);
                       }
 
-                    x0 = xoffset + face->glyph->bitmap_left;
-                    y0 = line_yoffset + yoffset + face->glyph->bitmap_top;
+                    x0 = xoffset + glyph->left;
+                    y0 = line_yoffset + yoffset + glyph->top;
 
                     // 'w' seems to have a negative -1
                     // face->glyph->bitmap_left, this is so we don't
@@ -759,10 +964,10 @@ namespace octave
                     if (x0 < 0)
                       x0 = 0;
 
-                    for (int r = 0; static_cast<unsigned int> (r) < bitmap.rows; r++)
-                      for (int c = 0; static_cast<unsigned int> (c) < bitmap.width; c++)
+                    for (int r = 0; r < glyph->rows; r++)
+                      for (int c = 0; c < glyph->width; c++)
                         {
-                          unsigned char pix = bitmap.buffer[r*bitmap.width+c];
+                          unsigned char pix = glyph->bitmap[r*glyph->width+c];
                           if (x0+c < 0 || x0+c >= pixels.dim2 ()
                               || y0-r < 0 || y0-r >= pixels.dim3 ())
                             {
@@ -778,7 +983,7 @@ namespace octave
                             }
                         }
 
-                    xoffset += (face->glyph->advance.x >> 6);
+                    xoffset += glyph->advance;
                   }
                 break;
 
@@ -787,7 +992,7 @@ namespace octave
                   {
                     glyph_index = FT_Get_Char_Index (face, ' ');
                     if (! glyph_index
-                        || FT_Load_Glyph (face, glyph_index, FT_LOAD_DEFAULT))
+                        || ! ft_manager::get_glyph (face, glyph_index, false))
                       {
                         glyph_index = 0;
                         warn_missing_glyph (' ');
@@ -802,7 +1007,7 @@ namespace octave
                     // If we have a previous glyph, use kerning information.
                     // This usually means moving a bit backward before adding
                     // the next glyph.  That is, "delta.x" is usually < 0.
-                    if (previous)
+                    if (previous && FT_HAS_KERNING (face))
                       {
                         FT_Vector delta;
 
@@ -815,7 +1020,7 @@ namespace octave
                     // Extend current X offset box by the width of the current
                     // glyph.  Then extend the line bounding box if necessary.
 
-                    xoffset += (face->glyph->advance.x >> 6);
+                    xoffset += glyph->advance;
                     bb(2) = octave::math::max (bb(2), xoffset);
                   }
                 break;
@@ -1389,3 +1594,45 @@ namespace octave
   }
 }
 
+DEFUN (__ft_glyph_cache__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{stats} =} __ft_glyph_cache__ ()
+@deftypefnx {} {} __ft_glyph_cache__ ("clear")
+Undocumented internal function.
+@end deftypefn */)
+{
+#if defined (HAVE_FREETYPE)
+  int nargin = args.length ();
+
+  if (nargin > 1)
+    print_usage ();
+
+  if (nargin == 1)
+    {
+      std::string opt = args(0).xstring_value ("__ft_glyph_cache__: argument must be a string");
+
+      if (opt != "clear")
+        error ("__ft_glyph_cache__: unrecognized option '%s'", opt.c_str ());
+
+      octave::ft_manager::clear_glyph_cache ();
+
+      return ovl ();
+    }
+
+  return ovl (octave::ft_manager::glyph_cache_statistics ());
+#else
+  octave_unused_parameter (args);
+
+  err_disabled_feature ("__ft_glyph_cache__", "FreeType");
+#endif
+}
+
+/*
+%!testif HAVE_FREETYPE
+%! __ft_glyph_cache__ ("clear");
+%! s = __ft_glyph_cache__ ();
+%! assert (s.glyphs, 0);
+%! assert (s.bytes, 0);
+%! assert (s.bytes <= s.max_bytes);
+%!error __ft_glyph_cache__ ("foo")
+*/
@@ -24,7 +24,9 @@ along with Octave; see the file COPYING.  If not, see
 #  include "config.h"
 #endif
 
+#include <algorithm>
 #include <iostream>
+#include <vector>
 
 #if defined (HAVE_WINDOWS_H)
 #  define WIN32_LEAN_AND_MEAN
@@ -2045,6 +2047,207 @@ namespace octave
 #endif
   }
 
+#if defined (HAVE_OPENGL)
+
+  // Maximum number of vertices submitted by a single glDrawArrays call
+  // when drawing line strips.
+
+  static const octave_idx_type max_strip_vertices = 65536;
+
+  // Minimum number of points before line data is decimated to the
+  // resolution of the screen.
+
+  static const octave_idx_type min_decimate_points = 8192;
+
+  // Draw the polyline through the points X, Y (and Z if HAS_Z) selected
+  // by IDX, or through the first N points if IDX is null.  The line is
+  // broken wherever a segment is clipped away or touches a non-finite
+  // point.  Vertices are submitted through a vertex array rather than
+  // one glVertex call per point.
+
+  static void
+  draw_line_strips (const Matrix& x, const Matrix& y, const Matrix& z,
+                    bool has_z, const std::vector<octave_uint8>& clip,
+                    octave_uint8 clip_ok, const octave_idx_type *idx,
+                    octave_idx_type n)
+  {
+    const int dim = (has_z ? 3 : 2);
+
+    std::vector<double> vtx;
+    vtx.reserve (dim * std::min (n, max_strip_vertices));
+
+    glEnableClientState (GL_VERTEX_ARRAY);
+
+    octave_idx_type nv = 0;
+
+    for (octave_idx_type k = 1; k < n; k++)
+      {
+        octave_idx_type a = (idx ? idx[k-1] : k-1);
+        octave_idx_type b = (idx ? idx[k] : k);
+
+        bool visible = ((clip[a] & clip[b]) == clip_ok);
+
+        if (visible)
+          {
+            if (nv == 0)
+              {
+                vtx.push_back (x(a));
+                vtx.push_back (y(a));
+                if (has_z)
+                  vtx.push_back (z(a));
+                nv++;
+              }
+
+            vtx.push_back (x(b));
+            vtx.push_back (y(b));
+            if (has_z)
+              vtx.push_back (z(b));
+            nv++;
+          }
+
+        if (nv > 1 && (! visible || k == n-1 || nv == max_strip_vertices))
+          {
+            glVertexPointer (dim, GL_DOUBLE, 0, vtx.data ());
+            glDrawArrays (GL_LINE_STRIP, 0, nv);
+
+            vtx.clear ();
+            nv = 0;
+
+            // Continue a strip that was only split because of its length.
+            if (visible && k < n-1)
+              {
+                vtx.push_back (x(b));
+                vtx.push_back (y(b));
+                if (has_z)
+                  vtx.push_back (z(b));
+                nv++;
+              }
+          }
+        else if (! visible)
+          {
+            vtx.clear ();
+            nv = 0;
+          }
+      }
+
+    glDisableClientState (GL_VERTEX_ARRAY);
+  }
+
+  static bool
+  is_nondecreasing (const Matrix& x, octave_idx_type n)
+  {
+    double last = -octave::numeric_limits<double>::Inf ();
+
+    for (octave_idx_type i = 0; i < n; i++)
+      {
+        double xi = x(i);
+
+        if (! octave::math::isnan (xi))
+          {
+            if (xi < last)
+              return false;
+
+            last = xi;
+          }
+      }
+
+    return true;
+  }
+
+  // Return true if a finite point of a 2-D line lies above or below the
+  // visible y range while within the visible x range.
+
+  static bool
+  is_y_clipped (const std::vector<octave_uint8>& clip, octave_idx_type n,
+                octave_uint8 clip_ok)
+  {
+    const octave_uint8 x_bits (0x03);
+    const octave_uint8 y_bits (0x0C);
+    const octave_uint8 none (0);
+
+    for (octave_idx_type i = 0; i < n; i++)
+      {
+        if ((clip[i] & clip_ok) == clip_ok && (clip[i] & x_bits) == none
+            && (clip[i] & y_bits) != none)
+          return true;
+      }
+
+    return false;
+  }
+
+  // Select the points of a 2-D line with nondecreasing X that are needed
+  // to draw it with NPIX pixel columns spanning [X0, X1].  Within each
+  // column only the first, last, lowest, and highest points are kept.
+  // For a solid line whose visible points are not clipped, the segments
+  // through these points cover the same vertical span of the column as
+  // the full data.  Points that are not finite are always kept so the
+  // line is broken at the same places, and all points left or right of
+  // the visible range collapse into a single column each.  Segments
+  // between points of those columns are clipped away in any case.
+
+  static std::vector<octave_idx_type>
+  decimate_line (const Matrix& x, const Matrix& y, octave_idx_type n,
+                 double x0, double x1, octave_idx_type npix,
+                 const std::vector<octave_uint8>& clip, octave_uint8 clip_ok)
+  {
+    std::vector<octave_idx_type> idx;
+    idx.reserve (4 * (npix + 2));
+
+    double scale = npix / (x1 - x0);
+
+    octave_idx_type col = 0;
+    octave_idx_type first = -1, last = -1, imin = -1, imax = -1;
+
+    for (octave_idx_type i = 0; i <= n; i++)
+      {
+        bool finite = (i < n && (clip[i] & clip_ok) == clip_ok);
+
+        octave_idx_type c = col;
+        if (finite)
+          {
+            double xc = (x(i) - x0) * scale;
+            c = (xc < 0 ? -1 : (xc >= npix ? npix
+                                : static_cast<octave_idx_type> (xc)));
+          }
+
+        if (first >= 0 && (! finite || c != col))
+          {
+            octave_idx_type sel[4] = { first, imin, imax, last };
+            std::sort (sel, sel + 4);
+
+            for (int k = 0; k < 4; k++)
+              if (k == 0 || sel[k] != sel[k-1])
+                idx.push_back (sel[k]);
+
+            first = -1;
+          }
+
+        if (i == n)
+          break;
+
+        if (! finite)
+          idx.push_back (i);
+        else
+          {
+            if (first < 0)
+              {
+                first = imin = imax = i;
+                col = c;
+              }
+            else if (y(i) < y(imin))
+              imin = i;
+            else if (y(i) > y(imax))
+              imax = i;
+
+            last = i;
+          }
+      }
+
+    return idx;
+  }
+
+#endif
+
   void
   opengl_renderer::draw_line (const line::properties& props)
   {
@@ -2081,59 +2284,45 @@ namespace octave
         set_linecap ("butt");
         set_linejoin (props.get_linejoin ());
 
-        if (has_z)
-          {
-            bool flag = false;
+        // For large 2-D plots with sorted X data, there is no point in
+        // sending more than a few vertices per pixel column to OpenGL.
+        // Only do this for solid lines when the X axis is horizontal on
+        // screen and the line is clipped to the axes.  Dashes would
+        // change their phase, and segments clipped in y could be lost.
 
-            for (int i = 1; i < n; i++)
-              {
-                if ((clip[i-1] & clip[i]) == clip_ok)
-                  {
-                    if (! flag)
-                      {
-                        flag = true;
-                        glBegin (GL_LINE_STRIP);
-                        glVertex3d (x(i-1), y(i-1), z(i-1));
-                      }
-                    glVertex3d (x(i), y(i), z(i));
-                  }
-                else if (flag)
-                  {
-                    flag = false;
-                    glEnd ();
-                  }
-              }
+        bool decimated = false;
 
-            if (flag)
-              glEnd ();
-          }
-        else
+        if (! has_z && props.is_clipping () && props.linestyle_is ("-")
+            && n > min_decimate_points)
           {
-            bool flag = false;
+            double z_mid = (zmin+zmax)/2;
 
-            for (int i = 1; i < n; i++)
+            ColumnVector p0 = xform.transform (xmin, ymin, z_mid, false);
+            ColumnVector px = xform.transform (xmax, ymin, z_mid, false);
+            ColumnVector py = xform.transform (xmin, ymax, z_mid, false);
+
+            octave_idx_type npix
+              = static_cast<octave_idx_type> (std::ceil (std::abs (px(0) - p0(0))));
+
+            if (std::abs (py(0) - p0(0)) < 0.5
+                && std::abs (px(1) - p0(1)) < 0.5
+                && npix > 0 && n > 4 * npix && xmax > xmin
+                && is_nondecreasing (x, n)
+                && ! is_y_clipped (clip, n, clip_ok))
               {
-                if ((clip[i-1] & clip[i]) == clip_ok)
-                  {
-                    if (! flag)
-                      {
-                        flag = true;
-                        glBegin (GL_LINE_STRIP);
-                        glVertex2d (x(i-1), y(i-1));
-                      }
-                    glVertex2d (x(i), y(i));
-                  }
-                else if (flag)
-                  {
-                    flag = false;
-                    glEnd ();
-                  }
-              }
+                std::vector<octave_idx_type> idx
+                  = decimate_line (x, y, n, xmin, xmax, npix, clip, clip_ok);
 
-            if (flag)
-              glEnd ();
+                draw_line_strips (x, y, z, has_z, clip, clip_ok, idx.data (),
+                                  idx.size ());
+
+                decimated = true;
+              }
           }
 
+        if (! decimated)
+          draw_line_strips (x, y, z, has_z, clip, clip_ok, nullptr, n);
+
         set_linewidth (0.5f);
         set_linestyle ("-");
       }
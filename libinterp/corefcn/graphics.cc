@@ -1150,7 +1150,8 @@ base_property::set (const octave_value& v, bool do_run, bool do_notify_toolkit)
   if (do_set (v))
     {
       // Notify graphics toolkit.
-      if (id >= 0 && do_notify_toolkit)
+      if (id >= 0 && do_notify_toolkit
+          && ! gh_manager::defer_update (parent, id))
         {
           graphics_object go = gh_manager::get_object (parent);
           if (go)
@@ -1158,7 +1159,8 @@ base_property::set (const octave_value& v, bool do_run, bool do_notify_toolkit)
         }
 
       // run listeners
-      if (do_run)
+      if (do_run && listeners[POSTSET].length () > 0
+          && ! gh_manager::defer_listeners (parent, name))
         run_listeners (POSTSET);
 
       return true;
@@ -2329,6 +2331,24 @@ graphics_object::set (const Array<std::string>& pnames,
 %! unwind_protect_cleanup
 %!   close (hf);
 %! end_unwind_protect
+
+## test that listeners run once, after all values are set
+%!test
+%! hf = figure ("visible", "off");
+%! unwind_protect
+%!   h = plot (1:10, 10:-1:1, 1:10, 1:10);
+%!   set (h, "userdata", {});
+%!   addlistener (h(1), "linewidth",
+%!                @(hl, ~) set (hl, "userdata",
+%!                              [get(hl, "userdata"), {get(hl, "marker")}]));
+%!   set (h, "linewidth", 2, "marker", "x");
+%!   assert (get (h, "userdata"), {{"x"}; {}});
+%!   set (h, {"linewidth", "marker"}, {3, "o"; 4, "+"});
+%!   assert (get (h, "userdata"), {{"x", "o"}; {}});
+%!   assert (get (h, "linewidth"), {3; 4});
+%! unwind_protect_cleanup
+%!   close (hf);
+%! end_unwind_protect
 */
 
 // Set properties given in a struct array
@@ -2547,7 +2567,11 @@ gh_manager::do_free (const graphics_handle& h)
       if (p == handle_map.end ())
         error ("graphics_handle::free: invalid object %g", h.value ());
 
-      base_properties& bp = p->second.get_properties ();
+      // Callbacks may create new objects, which invalidates iterators
+      // into the handle map.
+      graphics_object go = p->second;
+
+      base_properties& bp = go.get_properties ();
 
       bp.set_beingdeleted (true);
 
@@ -2558,7 +2582,7 @@ gh_manager::do_free (const graphics_handle& h)
       bp.execute_deletefcn ();
 
       // Notify graphics toolkit.
-      p->second.finalize ();
+      go.finalize ();
 
       // Note: this will be valid only for first explicitly deleted
       // object.  All its children will then have an
@@ -2569,7 +2593,7 @@ gh_manager::do_free (const graphics_handle& h)
       // running out of integers, we recycle the integer part
       // but tack on a new random part each time.
 
-      handle_map.erase (p);
+      handle_map.erase (h);
 
       if (h.value () < 0)
         handle_free_list.insert
@@ -9400,7 +9424,9 @@ gh_manager::gh_manager (void)
   : handle_map (), handle_free_list (),
     next_handle (-1.0 - (rand () + 1.0) / (RAND_MAX + 2.0)),
     figure_list (), graphics_lock (),  event_queue (),
-    callback_objects (), event_processing (0)
+    callback_objects (), event_processing (0), batch_update_depth (0),
+    pending_updates (), pending_update_set (), pending_listeners (),
+    pending_listener_set ()
 {
   handle_map[0] = graphics_object (new root_figure ());
 
@@ -9958,6 +9984,70 @@ gh_manager::do_enable_event_processing (bool enable)
     }
 }
 
+void
+gh_manager::do_end_batch_update (void)
+{
+  if (batch_update_depth == 0 || --batch_update_depth > 0)
+    return;
+
+  // Listeners may change properties again, so take the pending lists
+  // before sending them.
+
+  std::list<std::pair<graphics_handle, int>> updates;
+  std::list<std::pair<graphics_handle, std::string>> listeners;
+
+  updates.swap (pending_updates);
+  listeners.swap (pending_listeners);
+
+  pending_update_set.clear ();
+  pending_listener_set.clear ();
+
+  for (const auto& hid : updates)
+    {
+      graphics_object go = get_object (hid.first);
+
+      if (go)
+        go.update (hid.second);
+    }
+
+  for (const auto& hname : listeners)
+    {
+      graphics_object go = get_object (hname.first);
+
+      if (go)
+        go.get_properties ().get_property (hname.second).run_listeners ();
+    }
+}
+
+bool
+gh_manager::do_defer_update (const graphics_handle& h, int id)
+{
+  if (batch_update_depth == 0)
+    return false;
+
+  std::pair<graphics_handle, int> hid (h, id);
+
+  if (pending_update_set.insert (hid).second)
+    pending_updates.push_back (hid);
+
+  return true;
+}
+
+bool
+gh_manager::do_defer_listeners (const graphics_handle& h,
+                                const std::string& name)
+{
+  if (batch_update_depth == 0)
+    return false;
+
+  std::pair<graphics_handle, std::string> hname (h, name);
+
+  if (pending_listener_set.insert (hname).second)
+    pending_listeners.push_back (hname);
+
+  return true;
+}
+
 property_list::plist_map_type
 root_figure::init_factory_properties (void)
 {
@@ -10281,6 +10371,14 @@ being @qcode{"portrait"}.
 
   bool request_drawnow = false;
 
+  // Notify the graphics toolkit and run property listeners once for
+  // each changed property, after all values are set.
+
+  octave::unwind_protect_safe frame;
+
+  gh_manager::begin_batch_update ();
+  frame.add_fcn (gh_manager::end_batch_update);
+
   // loop over graphics objects
   for (octave_idx_type n = 0; n < hcv.numel (); n++)
     {
@@ -10347,6 +10445,8 @@ being @qcode{"portrait"}.
       request_drawnow = true;
     }
 
+  frame.run_first ();
+
   if (request_drawnow)
     Vdrawnow_requested = true;
 
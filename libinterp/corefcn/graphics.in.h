@@ -28,11 +28,14 @@ along with Octave; see the file COPYING.  If not, see
 #include <cctype>
 
 #include <algorithm>
+#include <functional>
 #include <list>
 #include <map>
 #include <set>
 #include <sstream>
 #include <string>
+#include <unordered_map>
+#include <utility>
 
 #include "caseless-str.h"
 
@@ -6362,6 +6365,35 @@ public:
       instance->do_close_all_figures ();
   }
 
+  // Between calls to begin_batch_update and end_batch_update, the
+  // graphics toolkit is not notified of changed properties and
+  // property listeners are not run.  Instead, when the outermost batch
+  // ends, each changed property is sent to the toolkit and has its
+  // listeners run once.
+
+  static void begin_batch_update (void)
+  {
+    if (instance_ok ())
+      instance->do_begin_batch_update ();
+  }
+
+  static void end_batch_update (void)
+  {
+    if (instance_ok ())
+      instance->do_end_batch_update ();
+  }
+
+  static bool defer_update (const graphics_handle& h, int id)
+  {
+    return instance_ok () && instance->do_defer_update (h, id);
+  }
+
+  static bool defer_listeners (const graphics_handle& h,
+                               const std::string& name)
+  {
+    return instance_ok () && instance->do_defer_listeners (h, name);
+  }
+
 public:
   class auto_lock : public octave_autolock
   {
@@ -6384,9 +6416,17 @@ private:
 
   static gh_manager *instance;
 
-  typedef std::map<graphics_handle, graphics_object>::iterator iterator;
-  typedef std::map<graphics_handle, graphics_object>::const_iterator
-    const_iterator;
+  struct handle_hash
+  {
+    size_t operator () (const graphics_handle& h) const
+    { return std::hash<double> () (h.value ()); }
+  };
+
+  typedef std::unordered_map<graphics_handle, graphics_object, handle_hash>
+    handle_map_type;
+
+  typedef handle_map_type::iterator iterator;
+  typedef handle_map_type::const_iterator const_iterator;
 
   typedef std::set<graphics_handle>::iterator free_list_iterator;
   typedef std::set<graphics_handle>::const_iterator const_free_list_iterator;
@@ -6395,7 +6435,7 @@ private:
   typedef std::list<graphics_handle>::const_iterator const_figure_list_iterator;
 
   // A map of handles to graphics objects.
-  std::map<graphics_handle, graphics_object> handle_map;
+  handle_map_type handle_map;
 
   // The available graphics handles.
   std::set<graphics_handle> handle_free_list;
@@ -6419,6 +6459,18 @@ private:
   // A flag telling whether event processing must be constantly on.
   int event_processing;
 
+  // The number of nested batch updates.
+  int batch_update_depth;
+
+  // The properties changed during a batch update, in the order in which
+  // they were first changed, by handle and id for the toolkit and by
+  // handle and name for listeners.
+  std::list<std::pair<graphics_handle, int>> pending_updates;
+  std::set<std::pair<graphics_handle, int>> pending_update_set;
+
+  std::list<std::pair<graphics_handle, std::string>> pending_listeners;
+  std::set<std::pair<graphics_handle, std::string>> pending_listener_set;
+
   graphics_handle do_get_handle (bool integer_figure_handle);
 
   void do_free (const graphics_handle& h);
@@ -6464,6 +6516,10 @@ private:
 
     retval.resize (1, i);
 
+    // List the handles in increasing order, as they are not stored in
+    // any particular order.
+    std::sort (retval.fortran_vec (), retval.fortran_vec () + i);
+
     return retval;
   }
 
@@ -6534,6 +6590,14 @@ private:
   void do_post_event (const graphics_event& e);
 
   void do_enable_event_processing (bool enable = true);
+
+  void do_begin_batch_update (void) { batch_update_depth++; }
+
+  void do_end_batch_update (void);
+
+  bool do_defer_update (const graphics_handle& h, int id);
+
+  bool do_defer_listeners (const graphics_handle& h, const std::string& name);
 };
 
 void get_children_limits (double& min_val, double& max_val,
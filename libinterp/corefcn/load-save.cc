@@ -35,6 +35,8 @@ along with Octave; see the file COPYING.  If not, see
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <limits>
+#include <map>
 #include <sstream>
 #include <string>
 
@@ -108,6 +110,9 @@ static std::string Vsave_default_options = "-text";
 // The output format for Octave core files.
 static std::string Voctave_core_file_options = "-binary";
 
+// The size in bytes of the cache for chunks of HDF5 datasets.
+double Vhdf5_chunk_cache_size = 16 * 1024 * 1024;
+
 static std::string
 default_save_header_format (void)
 {
@@ -340,11 +345,128 @@ get_file_format (const std::string& fname, const std::string& orig_fname,
   return retval;
 }
 
+// Indices of recently loaded data files, used to read selected variables
+// without reading all of the variables stored before them.
+
+struct
+data_file_index_entry
+{
+  octave::sys::time mtime;
+  off_t size;
+  unsigned long last_use;
+  data_file_index index;
+};
+
+static std::map<std::string, data_file_index_entry> data_file_indices;
+
+static unsigned long data_file_index_uses = 0;
+
+static const size_t max_data_file_indices = 16;
+
+// Return the index of the Octave binary or MAT v5 file FNAME, open as IS
+// and positioned after the file header.  The index is kept until the
+// file changes.  If it cannot be kept, it is stored in TMP.
+
+const data_file_index&
+get_data_file_index (const std::string& fname, std::istream& is,
+                     load_save_format format, bool swap,
+                     octave::mach_info::float_format flt_fmt,
+                     data_file_index& tmp)
+{
+  std::string key = octave::sys::env::make_absolute (fname);
+
+  octave::sys::file_stat fs (key);
+
+  auto p = data_file_indices.find (key);
+
+  if (p != data_file_indices.end ())
+    {
+      if (fs && p->second.mtime == fs.mtime () && p->second.size == fs.size ())
+        {
+          p->second.last_use = ++data_file_index_uses;
+          return p->second.index;
+        }
+
+      data_file_indices.erase (p);
+    }
+
+  octave::sys::time now;
+
+  std::streamoff start = is.tellg ();
+
+  tmp = scan_data_file (is, format, swap, flt_fmt, fname);
+
+  is.clear ();
+  is.seekg (start);
+
+  // Time stamps have a resolution of one second, so a file that was
+  // modified very recently could change again without a new time stamp.
+
+  if (! fs || fs.mtime ().unix_time () + 1 >= now.unix_time ())
+    return tmp;
+
+  if (data_file_indices.size () >= max_data_file_indices)
+    {
+      // Drop the index that was used least recently.
+
+      auto lru = data_file_indices.begin ();
+
+      for (auto q = data_file_indices.begin ();
+           q != data_file_indices.end (); q++)
+        {
+          if (q->second.last_use < lru->second.last_use)
+            lru = q;
+        }
+
+      data_file_indices.erase (lru);
+    }
+
+  data_file_index_entry& entry = data_file_indices[key];
+
+  entry.mtime = fs.mtime ();
+  entry.size = fs.size ();
+  entry.last_use = ++data_file_index_uses;
+  entry.index = tmp;
+
+  return entry.index;
+}
+
+void
+forget_data_file_index (const std::string& fname)
+{
+  data_file_indices.erase (octave::sys::env::make_absolute (fname));
+}
+
+// Keep the index of FNAME after its data was changed in place, which
+// leaves the variables at the same offsets.
+
+void
+touch_data_file_index (const std::string& fname)
+{
+  std::string key = octave::sys::env::make_absolute (fname);
+
+  auto p = data_file_indices.find (key);
+
+  if (p == data_file_indices.end ())
+    return;
+
+  octave::sys::file_stat fs (key);
+
+  if (fs)
+    {
+      p->second.mtime = fs.mtime ();
+      p->second.size = fs.size ();
+    }
+  else
+    data_file_indices.erase (p);
+}
+
 octave_value
 do_load (std::istream& stream, const std::string& orig_fname,
          load_save_format format, octave::mach_info::float_format flt_fmt,
          bool list_only, bool swap, bool verbose,
-         const string_vector& argv, int argv_idx, int argc, int nargout)
+         const string_vector& argv, int argv_idx, int argc, int nargout,
+         const data_file_index *index)
 {
   octave_value retval;
 
@@ -355,6 +477,43 @@ do_load (std::istream& stream, const std::string& orig_fname,
 
   octave_idx_type count = 0;
 
+  std::streamoff data_start = -1;
+  data_file_index::const_iterator next_var;
+
+  if (index)
+    {
+      // If a requested name is not in the index, the index may be
+      // incomplete.  Read the file sequentially instead.
+
+      for (int i = argv_idx; i < argc; i++)
+        {
+          glob_match pattern (argv[i]);
+
+          bool found = false;
+
+          for (const auto& var : *index)
+            {
+              if (pattern.match (var.first))
+                {
+                  found = true;
+                  break;
+                }
+            }
+
+          if (! found)
+            {
+              index = 0;
+              break;
+            }
+        }
+    }
+
+  if (index)
+    {
+      data_start = stream.tellg ();
+      next_var = index->begin ();
+    }
+
   for (;;)
     {
       bool global = false;
@@ -363,6 +522,21 @@ do_load (std::istream& stream, const std::string& orig_fname,
       std::string name;
       std::string doc;
 
+      if (index)
+        {
+          // Skip directly to the next variable that matches.
+
+          while (next_var != index->end ()
+                 && ! matches_patterns (argv, argv_idx, argc, next_var->first))
+            next_var++;
+
+          if (next_var == index->end ())
+            break;
+
+          stream.clear ();
+          stream.seekg (next_var->second);
+        }
+
       switch (format.type)
         {
         case LS_TEXT:
@@ -400,6 +574,25 @@ do_load (std::istream& stream, const std::string& orig_fname,
           break;
         }
 
+      if (index)
+        {
+          if (name != next_var->first)
+            {
+              // The file has changed since it was indexed.  Read it
+              // from the start instead.
+
+              index = 0;
+              count = 0;
+
+              stream.clear ();
+              stream.seekg (data_start);
+
+              continue;
+            }
+
+          next_var++;
+        }
+
       if (stream.eof () || name.empty ())
         break;
       else
@@ -547,6 +740,11 @@ can be full names or use a pattern syntax.  The format of the file is
 automatically detected but may be overridden by supplying the appropriate
 option.
 
+When variables are selected from an Octave binary or @sc{matlab} v5/v7
+file that is not compressed as a whole, Octave records where each variable
+is stored in the file.  Later loads of selected variables from the same
+file skip directly to them until the file changes.
+
 If load is invoked using the functional form
 
 @example
@@ -847,9 +1045,21 @@ Force Octave to assume the file is in Octave's text format.
                     }
                 }
 
+              // Loading selected variables from a file that is not
+              // compressed can skip the others.
+
+              const data_file_index *index = 0;
+              data_file_index tmp;
+
+              if (i < argc && ! list_only
+                  && (format == LS_BINARY || format == LS_MAT5_BINARY
+                      || format == LS_MAT7_BINARY))
+                index = &get_data_file_index (fname, file, format, swap,
+                                              flt_fmt, tmp);
+
               retval = do_load (file, orig_fname, format,
                                 flt_fmt, list_only, swap, verbose,
-                                argv, i, argc, nargout);
+                                argv, i, argc, nargout, index);
 
               file.close ();
             }
@@ -1018,7 +1228,7 @@ save_vars (std::ostream& os, const std::string& pattern,
 static string_vector
 parse_save_options (const string_vector &argv,
                     load_save_format &format, bool &append,
-                    bool &save_as_floats, bool &use_zlib)
+                    bool &save_as_floats, bool &use_zlib, bool &chunked)
 {
 #if ! defined (HAVE_ZLIB)
   octave_unused_parameter (use_zlib);
@@ -1029,6 +1239,7 @@ parse_save_options (const string_vector &argv,
 
   bool do_double = false;
   bool do_tabs = false;
+  bool do_chunked = false;
 
   for (int i = 0; i < argc; i++)
     {
@@ -1048,6 +1259,10 @@ parse_save_options (const string_vector &argv,
         {
           do_tabs = true;
         }
+      else if (argv[i] == "-chunked")
+        {
+          do_chunked = true;
+        }
       else if (argv[i] == "-text" || argv[i] == "-t")
         {
           format = LS_TEXT;
@@ -1130,12 +1345,23 @@ parse_save_options (const string_vector &argv,
         warning ("save: \"-tabs\" option only has an effect with \"-ascii\"");
     }
 
+  if (do_chunked)
+    {
+#if defined (HAVE_HDF5)
+      if (format == LS_HDF5)
+        chunked = true;
+      else
+#endif
+        warning ("save: \"-chunked\" option only has an effect with \"-hdf5\"");
+    }
+
   return retval;
 }
 
 static string_vector
 parse_save_options (const std::string &arg, load_save_format &format,
-                    bool &append, bool &save_as_floats, bool &use_zlib)
+                    bool &append, bool &save_as_floats, bool &use_zlib,
+                    bool &chunked)
 {
   std::istringstream is (arg);
   std::string str;
@@ -1147,9 +1373,28 @@ parse_save_options (const std::string &arg, load_save_format &format,
       argv.append (str);
     }
 
-  return parse_save_options (argv, format, append, save_as_floats, use_zlib);
+  return parse_save_options (argv, format, append, save_as_floats, use_zlib,
+                             chunked);
+}
+
+#if defined (HAVE_HDF5)
+
+// Set the layout of the datasets in HDF5 files until FRAME is run.
+// Compressed datasets are chunked and shuffled.
+
+static void
+set_hdf5_save_options (octave::unwind_protect& frame, bool chunked,
+                       bool use_zlib)
+{
+  frame.protect_var (Vhdf5_save_options);
+
+  Vhdf5_save_options.chunked = chunked || use_zlib;
+  Vhdf5_save_options.shuffle = use_zlib;
+  Vhdf5_save_options.deflate_level = (use_zlib ? 6 : 0);
 }
 
+#endif
+
 void
 write_header (std::ostream& os, load_save_format format)
 {
@@ -1364,8 +1609,10 @@ dump_octave_core (void)
 
       bool use_zlib = false;
 
+      bool chunked = false;
+
       parse_save_options (Voctave_core_file_options, format, append,
-                          save_as_floats, use_zlib);
+                          save_as_floats, use_zlib, chunked);
 
       std::ios::openmode mode = std::ios::out;
 
@@ -1387,6 +1634,10 @@ dump_octave_core (void)
 #if defined (HAVE_HDF5)
       if (format == LS_HDF5)
         {
+          octave::unwind_protect frame;
+
+          set_hdf5_save_options (frame, chunked, use_zlib);
+
           hdf5_ofstream file (fname, mode);
 
           if (file.file_id >= 0)
@@ -1499,6 +1750,12 @@ Save the data in @sc{hdf5} format but only using single precision.
 Only use this format if you know that all the
 values to be saved can be represented in single precision.
 
+@item -chunked
+With @sc{hdf5} format, store arrays in chunks.  Chunks of an array can be
+read separately, for example with @code{matfile}, and the array can grow
+later.  The size of the cache for chunks is set by
+@code{hdf5_chunk_cache_size}.
+
 @item  -V7
 @itemx -v7
 @itemx -7
@@ -1526,6 +1783,9 @@ Save the data in Octave's text data format.  (default).
 Use the gzip algorithm to compress the file.  This works equally on files
 that are compressed with gzip outside of octave, and gzip can equally be
 used to convert the files for backward compatibility.
+With @sc{hdf5} format, the file itself is not compressed.  Instead, arrays
+are stored in chunks as with @option{-chunked}, and the chunks are
+compressed with the deflate and shuffle filters of @sc{hdf5}.
 This option is only available if Octave was built with a link to the zlib
 libraries.
 @end table
@@ -1575,15 +1835,17 @@ the file @file{data} in Octave's binary format.
   bool save_as_floats = false;
   bool append = false;
   bool use_zlib = false;
+  bool chunked = false;
 
   // get default options
   parse_save_options (Vsave_default_options, format, append, save_as_floats,
-                      use_zlib);
+                      use_zlib, chunked);
 
   // override from command line
   string_vector argv = args.make_argv ();
 
-  argv = parse_save_options (argv, format, append, save_as_floats, use_zlib);
+  argv = parse_save_options (argv, format, append, save_as_floats, use_zlib,
+                             chunked);
 
   int argc = argv.numel ();
   int i = 0;
@@ -1630,6 +1892,8 @@ the file @file{data} in Octave's binary format.
     {
       std::string fname = octave::sys::file_ops::tilde_expand (argv[i]);
 
+      forget_data_file_index (fname);
+
       i++;
 
       // Matlab v7 files are always compressed
@@ -1658,6 +1922,10 @@ the file @file{data} in Octave's binary format.
           bool write_header_info
             = ! (append && H5Fis_hdf5 (fname.c_str ()) > 0);
 
+          octave::unwind_protect frame;
+
+          set_hdf5_save_options (frame, chunked, use_zlib);
+
           hdf5_ofstream hdf5_file (fname.c_str (), mode);
 
           if (hdf5_file.file_id == -1)
@@ -1839,3 +2107,27 @@ The original variable value is restored when exiting the function.
   return SET_INTERNAL_VARIABLE (save_header_format_string);
 }
 
+
+DEFUN (hdf5_chunk_cache_size, args, nargout,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{val} =} hdf5_chunk_cache_size ()
+@deftypefnx {} {@var{old_val} =} hdf5_chunk_cache_size (@var{new_val})
+@deftypefnx {} {} hdf5_chunk_cache_size (@var{new_val}, "local")
+Query or set the internal variable that specifies the size in bytes of
+the cache for chunks of each dataset in @sc{hdf5} files.
+
+Chunks of datasets written with @code{save -hdf5 -chunked} or
+@code{save -hdf5 -zip} are kept in this cache while they are read or
+written, so that reading or writing parts of an array, as @code{matfile}
+does, does not decompress the same chunk repeatedly.  The cache applies to
+files opened after the variable is changed.  The default value is 16 MB.
+
+When called from inside a function with the @qcode{"local"} option, the
+variable is changed locally for the function and any subroutines it calls.
+The original variable value is restored when exiting the function.
+@seealso{save, matfile}
+@end deftypefn */)
+{
+  return SET_INTERNAL_VARIABLE_WITH_LIMITS (hdf5_chunk_cache_size, 0,
+                                            std::numeric_limits<int>::max ());
+}
@@ -25,8 +25,10 @@ along with Octave; see the file COPYING.  If not, see
 
 #include "octave-config.h"
 
-#include <iosfwd>
+#include <ios>
+#include <list>
 #include <string>
+#include <utility>
 
 #include "mach-info.h"
 #include "symtab.h"
@@ -77,11 +79,31 @@ read_binary_file_header (std::istream& is, bool& swap,
                          octave::mach_info::float_format& flt_fmt,
                          bool quiet = false);
 
+// The names and offsets of the variables in a data file, in the order
+// in which they are stored.
+typedef std::list<std::pair<std::string, std::streamoff>> data_file_index;
+
+extern data_file_index
+scan_data_file (std::istream& is, load_save_format format, bool swap,
+                octave::mach_info::float_format flt_fmt,
+                const std::string& filename);
+
+extern const data_file_index&
+get_data_file_index (const std::string& fname, std::istream& is,
+                     load_save_format format, bool swap,
+                     octave::mach_info::float_format flt_fmt,
+                     data_file_index& tmp);
+
+extern void forget_data_file_index (const std::string& fname);
+
+extern void touch_data_file_index (const std::string& fname);
+
 extern octave_value
 do_load (std::istream& stream, const std::string& orig_fname,
          load_save_format format, octave::mach_info::float_format flt_fmt,
          bool list_only, bool swap, bool verbose,
-         const string_vector& argv, int argv_idx, int argc, int nargout);
+         const string_vector& argv, int argv_idx, int argc, int nargout,
+         const data_file_index *index = 0);
 
 extern OCTINTERP_API bool is_octave_data_file (const std::string& file);
 
@@ -29,9 +29,11 @@ along with Octave; see the file COPYING.  If not, see
 #if defined (HAVE_HDF5)
 
 #include <cfloat>
+#include <cmath>
 #include <cstring>
 #include <cctype>
 
+#include <algorithm>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
@@ -68,7 +70,9 @@ along with Octave; see the file COPYING.  If not, see
 #include "variables.h"
 #include "version.h"
 #include "dMatrix.h"
+#include "ov-lazy-cellstr.h"
 #include "ov-lazy-idx.h"
+#include "ov-lazy-trans.h"
 
 #include "ls-utils.h"
 #include "ls-hdf5.h"
@@ -91,16 +95,20 @@ hdf5_fstreambase::hdf5_fstreambase (const char *name, int mode, int /* prot */)
 {
 #if defined (HAVE_HDF5)
 
+  hid_t access_plist = hdf5_file_access_plist ();
+
   if (mode & std::ios::in)
-    file_id = H5Fopen (name, H5F_ACC_RDONLY, octave_H5P_DEFAULT);
+    file_id = H5Fopen (name, H5F_ACC_RDONLY, access_plist);
   else if (mode & std::ios::out)
     {
       if (mode & std::ios::app && H5Fis_hdf5 (name) > 0)
-        file_id = H5Fopen (name, H5F_ACC_RDWR, octave_H5P_DEFAULT);
+        file_id = H5Fopen (name, H5F_ACC_RDWR, access_plist);
       else
         file_id = H5Fcreate (name, H5F_ACC_TRUNC, octave_H5P_DEFAULT,
-                             octave_H5P_DEFAULT);
+                             access_plist);
     }
+
+  H5Pclose (access_plist);
   if (file_id < 0)
     std::ios::setstate (std::ios::badbit);
 
@@ -138,16 +146,20 @@ hdf5_fstreambase::open (const char *name, int mode, int)
 
   clear ();
 
+  hid_t access_plist = hdf5_file_access_plist ();
+
   if (mode & std::ios::in)
-    file_id = H5Fopen (name, H5F_ACC_RDONLY, octave_H5P_DEFAULT);
+    file_id = H5Fopen (name, H5F_ACC_RDONLY, access_plist);
   else if (mode & std::ios::out)
     {
       if (mode & std::ios::app && H5Fis_hdf5 (name) > 0)
-        file_id = H5Fopen (name, H5F_ACC_RDWR, octave_H5P_DEFAULT);
+        file_id = H5Fopen (name, H5F_ACC_RDWR, access_plist);
       else
         file_id = H5Fcreate (name, H5F_ACC_TRUNC, octave_H5P_DEFAULT,
-                             octave_H5P_DEFAULT);
+                             access_plist);
     }
+
+  H5Pclose (access_plist);
   if (file_id < 0)
     std::ios::setstate (std::ios::badbit);
 
@@ -889,6 +901,151 @@ hdf5_add_scalar_attr (octave_hdf5_id loc_id, octave_hdf5_id type_id,
 #endif
 }
 
+hdf5_save_options Vhdf5_save_options;
+
+#if defined (HAVE_HDF5)
+
+// Choose the dimensions CHUNK of the chunks of an RANK-dimensional
+// dataset with dimensions HDIMS and elements of SIZE bytes.  Chunks
+// grow with the dataset from 16 kB up to 1 MB, and are split by halving
+// each dimension in turn, starting with the slowest varying one.
+
+static void
+hdf5_chunk_dims (int rank, const hsize_t *hdims, size_t size, hsize_t *chunk)
+{
+  static const double chunk_base = 16 * 1024;
+  static const double chunk_min = 8 * 1024;
+  static const double chunk_max = 1024 * 1024;
+
+  double nel = 1;
+  for (int i = 0; i < rank; i++)
+    {
+      chunk[i] = std::max (hdims[i], static_cast<hsize_t> (1));
+      nel *= chunk[i];
+    }
+
+  double total = nel * size;
+
+  double target = chunk_base * std::pow (2.0, std::log10 (total / (1024 * 1024)));
+  target = std::min (std::max (target, chunk_min), chunk_max);
+
+  for (int k = 0; nel > 1; k = (k + 1) % rank)
+    {
+      double bytes = nel * size;
+
+      if ((bytes < target || std::abs (bytes - target) / target < 0.5)
+          && bytes < chunk_max)
+        break;
+
+      if (chunk[k] > 1)
+        {
+          nel /= chunk[k];
+          chunk[k] = (chunk[k] + 1) / 2;
+          nel *= chunk[k];
+        }
+    }
+}
+
+#endif
+
+octave_hdf5_id
+hdf5_array_space (const dim_vector& dv)
+{
+#if defined (HAVE_HDF5)
+
+  int rank = dv.ndims ();
+
+  OCTAVE_LOCAL_BUFFER (hsize_t, hdims, rank);
+  OCTAVE_LOCAL_BUFFER (hsize_t, maxdims, rank);
+
+  // Octave uses column-major, while HDF5 uses row-major ordering
+  for (int i = 0; i < rank; i++)
+    {
+      hdims[i] = dv(rank-i-1);
+      maxdims[i] = (Vhdf5_save_options.chunked ? H5S_UNLIMITED : hdims[i]);
+    }
+
+  return H5Screate_simple (rank, hdims, maxdims);
+
+#else
+  octave_unused_parameter (dv);
+
+  err_disabled_feature ("hdf5_array_space", "HDF5");
+#endif
+}
+
+octave_hdf5_id
+hdf5_array_create_plist (const dim_vector& dv, octave_hdf5_id type_id)
+{
+#if defined (HAVE_HDF5)
+
+  hid_t plist_id = H5Pcreate (H5P_DATASET_CREATE);
+
+  if (plist_id < 0 || ! Vhdf5_save_options.chunked)
+    return plist_id;
+
+  int rank = dv.ndims ();
+
+  OCTAVE_LOCAL_BUFFER (hsize_t, hdims, rank);
+  OCTAVE_LOCAL_BUFFER (hsize_t, chunk, rank);
+
+  for (int i = 0; i < rank; i++)
+    hdims[i] = dv(rank-i-1);
+
+  hdf5_chunk_dims (rank, hdims, H5Tget_size (type_id), chunk);
+
+  H5Pset_chunk (plist_id, rank, chunk);
+
+  // The shuffle filter must come before compression.
+  if (Vhdf5_save_options.shuffle)
+    H5Pset_shuffle (plist_id);
+
+  if (Vhdf5_save_options.deflate_level > 0
+      && H5Zfilter_avail (H5Z_FILTER_DEFLATE) > 0)
+    H5Pset_deflate (plist_id, Vhdf5_save_options.deflate_level);
+
+  return plist_id;
+
+#else
+  octave_unused_parameter (dv);
+  octave_unused_parameter (type_id);
+
+  err_disabled_feature ("hdf5_array_create_plist", "HDF5");
+#endif
+}
+
+octave_hdf5_id
+hdf5_file_access_plist (void)
+{
+#if defined (HAVE_HDF5)
+
+  hid_t plist_id = H5Pcreate (H5P_FILE_ACCESS);
+
+  if (plist_id >= 0)
+    {
+      int mdc_nelmts;
+      size_t rdcc_nslots, rdcc_nbytes;
+      double rdcc_w0;
+
+      H5Pget_cache (plist_id, &mdc_nelmts, &rdcc_nslots, &rdcc_nbytes,
+                    &rdcc_w0);
+
+      // HDF5 recommends about 100 hash slots for each chunk that fits
+      // in the cache, assuming chunks of at least 64 kB.
+      rdcc_nbytes = Vhdf5_chunk_cache_size;
+      rdcc_nslots = std::max (rdcc_nslots,
+                              100 * (rdcc_nbytes / (64 * 1024)) + 1);
+
+      H5Pset_cache (plist_id, mdc_nelmts, rdcc_nslots, rdcc_nbytes, rdcc_w0);
+    }
+
+  return plist_id;
+
+#else
+  err_disabled_feature ("hdf5_file_access_plist", "HDF5");
+#endif
+}
+
 // Save an empty matrix, if needed.  Returns
 //    > 0  Saved empty matrix
 //    = 0  Not an empty matrix; did nothing
@@ -1066,7 +1223,9 @@ add_hdf5_data (octave_hdf5_id loc_id, const octave_value& tc,
   // themselves, so we convert them first to normal matrices using A = A(:,:).
   // This is a temporary hack.
   if (val.is_diag_matrix () || val.is_perm_matrix ()
-      || val.type_id () == octave_lazy_index::static_type_id ())
+      || val.type_id () == octave_lazy_index::static_type_id ()
+      || val.type_id () == octave_lazy_cellstr::static_type_id ()
+      || val.type_id () == octave_lazy_transpose::static_type_id ())
     val = val.full_value ();
 
   std::string t = val.type_name ();
@@ -131,6 +131,44 @@ add_hdf5_data (octave_hdf5_id loc_id, const octave_value& tc,
                const std::string& name, const std::string& doc,
                bool mark_as_global, bool save_as_floats);
 
+// Layout of the datasets written by the save_hdf5 methods of arrays.
+
+struct
+hdf5_save_options
+{
+  hdf5_save_options (void)
+    : chunked (false), shuffle (false), deflate_level (0) { }
+
+  // Store arrays in chunks that can be compressed and read separately,
+  // with unlimited maximum dimensions so that they can grow.
+  bool chunked;
+
+  // Apply the shuffle filter, which usually improves compression.
+  bool shuffle;
+
+  // Compression level from 1 to 9, or 0 for no compression.
+  int deflate_level;
+};
+
+extern OCTINTERP_API hdf5_save_options Vhdf5_save_options;
+
+// Size in bytes of the cache for chunks of datasets in open files.
+extern OCTINTERP_API double Vhdf5_chunk_cache_size;
+
+// Return a dataspace for an array with dimensions DV.
+extern OCTINTERP_API octave_hdf5_id
+hdf5_array_space (const dim_vector& dv);
+
+// Return the creation property list for the dataset of an array with
+// dimensions DV and elements of type TYPE_ID.  The caller must close it.
+extern OCTINTERP_API octave_hdf5_id
+hdf5_array_create_plist (const dim_vector& dv, octave_hdf5_id type_id);
+
+// Return the access property list for opening files, which sets the
+// size of the chunk cache.  The caller must close it.
+extern OCTINTERP_API octave_hdf5_id
+hdf5_file_access_plist (void);
+
 extern OCTINTERP_API int
 save_hdf5_empty (octave_hdf5_id loc_id, const char *name, const dim_vector d);
 
@@ -422,7 +422,7 @@ read_mat5_integer_data (std::istream& is, int *m,
 // place the type code in TYPE, the byte count in BYTES and true (false) to
 // IS_SMALL_DATA_ELEMENT if the tag is 4 (8) bytes long.
 // return nonzero on error
-static int
+int
 read_mat5_tag (std::istream& is, bool swap, int32_t& type, int32_t& bytes,
                bool& is_small_data_element)
 {
@@ -47,6 +47,10 @@ enum mat5_data_type
   miUTF32                     // Unicode UTF-32 Encoded Character Data
 };
 
+extern int
+read_mat5_tag (std::istream& is, bool swap, int32_t& type, int32_t& bytes,
+               bool& is_small_data_element);
+
 extern int
 read_mat5_binary_file_header (std::istream& is, bool& swap,
                               bool quiet = false,
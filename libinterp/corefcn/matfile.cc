@@ -0,0 +1,3017 @@
+/*
+
+Copyright (C) 2016 The Octave Project Developers
+
+This file is part of Octave.
+
+Octave is free software; you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+Octave is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Octave; see the file COPYING.  If not, see
+<http://www.gnu.org/licenses/>.
+
+*/
+
+// Reading and writing parts of variables in data files, for the
+// matfile class.  Numeric and logical arrays stored without
+// compression are accessed in place: HDF5 datasets through hyperslab
+// selections, and Octave binary and MATLAB v6 files through byte
+// ranges.  MATLAB v6 files are those written by save -v6, in the
+// level 5 MAT-file format that ls-mat5.cc reads.  Everything else is
+// read and written as a whole.
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <cmath>
+#include <cstring>
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <list>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined (HAVE_ZLIB)
+#  include <zlib.h>
+#endif
+
+#include "byte-swap.h"
+#include "data-conv.h"
+#include "file-stat.h"
+#include "lo-array-errwarn.h"
+#include "mach-info.h"
+#include "oct-locbuf.h"
+
+#include "defun.h"
+#include "error.h"
+#include "errwarn.h"
+#include "load-save.h"
+#include "ls-hdf5.h"
+#include "ls-mat5.h"
+#include "ls-oct-binary.h"
+#include "oct-hdf5.h"
+#include "oct-map.h"
+#include "ov.h"
+#include "ovl.h"
+#include "unwind-prot.h"
+#include "utils.h"
+
+#define READ_PAD(is_small_data_element, l) ((is_small_data_element) ? 4 : (((l)+7)/8)*8)
+
+// Types of the elements stored in a file.
+
+enum matfile_type
+{
+  mf_unknown,
+  mf_int8,
+  mf_uint8,
+  mf_int16,
+  mf_uint16,
+  mf_int32,
+  mf_uint32,
+  mf_int64,
+  mf_uint64,
+  mf_single,
+  mf_double
+};
+
+static int
+matfile_type_size (matfile_type type)
+{
+  switch (type)
+    {
+    case mf_int8:
+    case mf_uint8:
+      return 1;
+
+    case mf_int16:
+    case mf_uint16:
+      return 2;
+
+    case mf_int32:
+    case mf_uint32:
+    case mf_single:
+      return 4;
+
+    case mf_int64:
+    case mf_uint64:
+    case mf_double:
+      return 8;
+
+    default:
+      return 0;
+    }
+}
+
+static const char *
+matfile_type_name (matfile_type type)
+{
+  switch (type)
+    {
+    case mf_int8:
+      return "int8";
+    case mf_uint8:
+      return "uint8";
+    case mf_int16:
+      return "int16";
+    case mf_uint16:
+      return "uint16";
+    case mf_int32:
+      return "int32";
+    case mf_uint32:
+      return "uint32";
+    case mf_int64:
+      return "int64";
+    case mf_uint64:
+      return "uint64";
+    case mf_single:
+      return "single";
+    case mf_double:
+      return "double";
+    default:
+      return "unknown";
+    }
+}
+
+static matfile_type
+mat5_to_matfile_type (int32_t type)
+{
+  switch (type)
+    {
+    case miINT8:
+      return mf_int8;
+    case miUINT8:
+      return mf_uint8;
+    case miINT16:
+      return mf_int16;
+    case miUINT16:
+      return mf_uint16;
+    case miINT32:
+      return mf_int32;
+    case miUINT32:
+      return mf_uint32;
+    case miINT64:
+      return mf_int64;
+    case miUINT64:
+      return mf_uint64;
+    case miSINGLE:
+      return mf_single;
+    case miDOUBLE:
+      return mf_double;
+    default:
+      return mf_unknown;
+    }
+}
+
+static matfile_type
+save_type_to_matfile_type (char st)
+{
+  switch (st)
+    {
+    case LS_U_CHAR:
+      return mf_uint8;
+    case LS_U_SHORT:
+      return mf_uint16;
+    case LS_U_INT:
+      return mf_uint32;
+    case LS_CHAR:
+      return mf_int8;
+    case LS_SHORT:
+      return mf_int16;
+    case LS_INT:
+      return mf_int32;
+    case LS_FLOAT:
+      return mf_single;
+    case LS_DOUBLE:
+      return mf_double;
+    default:
+      return mf_unknown;
+    }
+}
+
+// The type that stores elements of class CLS without conversion.
+
+static matfile_type
+class_to_matfile_type (const std::string& cls)
+{
+  if (cls == "double")
+    return mf_double;
+  else if (cls == "single")
+    return mf_single;
+  else if (cls == "logical" || cls == "uint8")
+    return mf_uint8;
+  else if (cls == "int8")
+    return mf_int8;
+  else if (cls == "int16")
+    return mf_int16;
+  else if (cls == "uint16")
+    return mf_uint16;
+  else if (cls == "int32")
+    return mf_int32;
+  else if (cls == "uint32")
+    return mf_uint32;
+  else if (cls == "int64")
+    return mf_int64;
+  else if (cls == "uint64")
+    return mf_uint64;
+  else
+    return mf_unknown;
+}
+
+// Convert VAL to an array of class CLS.
+
+static octave_value
+convert_value (const octave_value& val, const std::string& cls, bool cplx)
+{
+  if (cls == "double")
+    return (cplx ? octave_value (val.complex_array_value ())
+                 : octave_value (val.array_value ()));
+  else if (cls == "single")
+    return (cplx ? octave_value (val.float_complex_array_value ())
+                 : octave_value (val.float_array_value ()));
+  else if (cls == "logical")
+    return val.bool_array_value ();
+  else if (cls == "int8")
+    return val.int8_array_value ();
+  else if (cls == "int16")
+    return val.int16_array_value ();
+  else if (cls == "int32")
+    return val.int32_array_value ();
+  else if (cls == "int64")
+    return val.int64_array_value ();
+  else if (cls == "uint8")
+    return val.uint8_array_value ();
+  else if (cls == "uint16")
+    return val.uint16_array_value ();
+  else if (cls == "uint32")
+    return val.uint32_array_value ();
+  else if (cls == "uint64")
+    return val.uint64_array_value ();
+  else
+    return val;
+}
+
+// Description of a variable in a file.
+
+struct
+matfile_var
+{
+  matfile_var (void)
+    : name (), class_name (), dims (), dims_known (false),
+      is_complex (false), pos (-1), partial (false), type (mf_unknown),
+      imag_type (mf_unknown), swap (false), real_pos (-1), imag_pos (-1),
+      dataset ()
+  { }
+
+  std::string name;
+
+  std::string class_name;
+
+  dim_vector dims;
+
+  // False if the dimensions can only be found by reading the value.
+  bool dims_known;
+
+  bool is_complex;
+
+  // Offset of the element or record holding the variable.
+  std::streamoff pos;
+
+  // The remaining fields describe where the data is stored, if it can
+  // be read and written in parts.
+
+  bool partial;
+
+  // Types of the real and imaginary parts.
+  matfile_type type;
+  matfile_type imag_type;
+
+  bool swap;
+
+  // Offsets of the real and imaginary parts.  If IMAG_POS is negative,
+  // the real and imaginary parts of complex values are interleaved.
+  std::streamoff real_pos;
+  std::streamoff imag_pos;
+
+  // Path of the HDF5 dataset.
+  std::string dataset;
+};
+
+// The selection A(IDX{:}) from an array with dimensions DIMS, described
+// by the smallest box containing it and the offsets of the selected
+// elements in that box.
+
+struct
+matfile_selection
+{
+  matfile_selection (void)
+    : result_dims (), lo (), box (), offsets (), contiguous (false)
+  { }
+
+  dim_vector result_dims;
+
+  // Lower corner and dimensions of the box.
+  Array<octave_idx_type> lo;
+  dim_vector box;
+
+  // Zero-based offsets of the selected elements in the box, in the
+  // order in which indexing returns them.
+  Array<octave_idx_type> offsets;
+
+  // True if the box holds exactly the selected elements, in order.
+  bool contiguous;
+};
+
+// Compute the selection IDX from an array with dimensions DV.  If an
+// index is out of range, return false if RESIZE_OK is true and throw
+// an index error otherwise.
+
+static bool
+make_selection (const dim_vector& dv, const octave_value_list& idx,
+                bool resize_ok, matfile_selection& sel)
+{
+  int nd = dv.ndims ();
+  int n = idx.length ();
+
+  std::vector<idx_vector> iv (std::max (n, 1));
+
+  if (n == 0)
+    {
+      iv[0] = idx_vector::colon;
+      n = 1;
+    }
+  else
+    {
+      int k = 0;
+
+      try
+        {
+          for (k = 0; k < n; k++)
+            iv[k] = idx(k).index_vector ();
+        }
+      catch (octave::index_exception& e)
+        {
+          // Rethrow to allow more info to be reported later.
+          e.set_pos_if_unset (n, k+1);
+          throw;
+        }
+    }
+
+  // Trailing dimensions are folded into the last index.
+  dim_vector fd = dv.redim (n);
+
+  std::vector<octave_idx_type> len (n);
+
+  for (int k = 0; k < n; k++)
+    {
+      octave_idx_type ext = iv[k].extent (fd(k));
+
+      if (ext > fd(k))
+        {
+          if (resize_ok)
+            return false;
+
+          octave::err_index_out_of_range (n, k+1, ext, fd(k), dv);
+        }
+
+      len[k] = iv[k].length (fd(k));
+    }
+
+  if (n == 1)
+    {
+      // Same rules as for Array<T>::index (const idx_vector&).
+      octave_idx_type il = len[0];
+
+      if (iv[0].is_colon ())
+        sel.result_dims = dim_vector (il, 1);
+      else
+        {
+          sel.result_dims = iv[0].orig_dimensions ();
+
+          if (nd == 2 && fd(0) != 1 && sel.result_dims.is_vector ())
+            {
+              if (dv(1) == 1)
+                sel.result_dims = dim_vector (il, 1);
+              else if (dv(0) == 1)
+                sel.result_dims = dim_vector (1, il);
+            }
+        }
+    }
+  else
+    {
+      sel.result_dims = dim_vector::alloc (n);
+      for (int k = 0; k < n; k++)
+        sel.result_dims(k) = len[k];
+      sel.result_dims.chop_trailing_singletons ();
+    }
+
+  octave_idx_type nsel = sel.result_dims.numel ();
+
+  sel.lo = Array<octave_idx_type> (dim_vector (nd, 1), 0);
+  sel.box = dv;
+
+  if (nsel == 0)
+    {
+      for (int d = 0; d < nd; d++)
+        sel.box(d) = 0;
+
+      sel.offsets = Array<octave_idx_type> (dim_vector (0, 1));
+      sel.contiguous = true;
+
+      return true;
+    }
+
+  // The bounding box.  Dimensions beyond the last index are spanned
+  // by the last index, so narrow them down from the outermost.
+
+  std::vector<octave_idx_type> hi (nd);
+  for (int d = 0; d < nd; d++)
+    hi[d] = dv(d) - 1;
+
+  for (int k = 0; k < std::min (n, nd); k++)
+    {
+      octave_idx_type a = iv[k].xelem (0);
+      octave_idx_type b = a;
+
+      for (octave_idx_type j = 1; j < len[k]; j++)
+        {
+          octave_idx_type v = iv[k].xelem (j);
+          a = std::min (a, v);
+          b = std::max (b, v);
+        }
+
+      if (k < n-1 || n >= nd)
+        {
+          sel.lo.xelem (k) = a;
+          hi[k] = b;
+        }
+      else
+        {
+          for (int d = nd-1; d >= k; d--)
+            {
+              octave_idx_type p = 1;
+              for (int d2 = k; d2 < d; d2++)
+                p *= dv(d2);
+
+              sel.lo.xelem (d) = a / p;
+              hi[d] = b / p;
+
+              if (a / p != b / p)
+                break;
+
+              a %= p;
+              b %= p;
+            }
+        }
+    }
+
+  std::vector<octave_idx_type> bstride (nd);
+  octave_idx_type bnel = 1;
+  for (int d = 0; d < nd; d++)
+    {
+      sel.box(d) = hi[d] - sel.lo.xelem (d) + 1;
+      bstride[d] = bnel;
+      bnel *= sel.box(d);
+    }
+
+  // Offsets of the selected elements in the box.
+
+  sel.offsets = Array<octave_idx_type> (dim_vector (nsel, 1));
+  octave_idx_type *off = sel.offsets.fortran_vec ();
+
+  off[0] = 0;
+  octave_idx_type nprev = 1;
+
+  for (int k = 0; k < n; k++)
+    {
+      std::vector<octave_idx_type> koff (len[k], 0);
+
+      if (k < nd)
+        {
+          for (octave_idx_type j = 0; j < len[k]; j++)
+            {
+              octave_idx_type v = iv[k].xelem (j);
+
+              if (k < n-1 || n >= nd)
+                koff[j] = (v - sel.lo.xelem (k)) * bstride[k];
+              else
+                {
+                  for (int d = k; d < nd; d++)
+                    {
+                      koff[j] += (v % dv(d) - sel.lo.xelem (d)) * bstride[d];
+                      v /= dv(d);
+                    }
+                }
+            }
+        }
+
+      for (octave_idx_type j = len[k] - 1; j >= 0; j--)
+        for (octave_idx_type i = 0; i < nprev; i++)
+          off[j*nprev + i] = off[i] + koff[j];
+
+      nprev *= len[k];
+    }
+
+  sel.contiguous = (nsel == bnel);
+  for (octave_idx_type i = 0; i < nsel && sel.contiguous; i++)
+    sel.contiguous = (off[i] == i);
+
+  return true;
+}
+
+// Compute the dimensions NEW_DIMS of an array with dimensions DV after
+// assigning to the elements IDX, some of which are out of range.
+// Return false for assignments other than growing a vector or
+// extending dimensions that are all indexed.
+
+static bool
+grown_dims (const dim_vector& dv, const octave_value_list& idx,
+            dim_vector& new_dims)
+{
+  int nd = dv.ndims ();
+  int n = idx.length ();
+
+  if (n < nd && n != 1)
+    return false;
+
+  dim_vector fd = dv.redim (n);
+
+  if (n == 1)
+    {
+      octave_idx_type ext = idx(0).index_vector ().extent (fd(0));
+
+      if (nd != 2)
+        return false;
+      else if (dv(0) == 1 || dv.zero_by_zero ())
+        new_dims = dim_vector (1, ext);
+      else if (dv(1) == 1)
+        new_dims = dim_vector (ext, 1);
+      else
+        return false;
+
+      return true;
+    }
+
+  new_dims = dim_vector::alloc (n);
+
+  for (int k = 0; k < n; k++)
+    new_dims(k) = idx(k).index_vector ().extent (fd(k));
+
+  new_dims.chop_trailing_singletons ();
+
+  return true;
+}
+
+// Access to the data of one variable.
+
+class
+matfile_data
+{
+public:
+
+  matfile_data (const matfile_var& v) : var (v) { }
+
+  virtual ~matfile_data (void) = default;
+
+  // Return the box of elements with lower corner LO and dimensions
+  // CNT, as an array of the class of the variable.
+  virtual octave_value read (const Array<octave_idx_type>& lo,
+                             const dim_vector& cnt) = 0;
+
+  // Write VAL, which has the class of the variable, to the box with
+  // lower corner LO.
+  virtual void write (const Array<octave_idx_type>& lo,
+                      const octave_value& val) = 0;
+
+  // Change the dimensions to DV, filling new elements with zeros.
+  // Return false if that is not possible without rewriting the
+  // variable.
+  virtual bool resize (const dim_vector&) { return false; }
+
+  const dim_vector& dims (void) const { return var.dims; }
+
+protected:
+
+  matfile_var var;
+};
+
+// Data stored contiguously in column-major order in an Octave binary
+// or MATLAB v6 file.
+
+// Call FCN (FILE_IDX, BOX_IDX, LEN) for each run of LEN elements of the
+// box with lower corner LO and dimensions CNT in an array with
+// dimensions DV that are contiguous in the array.
+
+template <typename F>
+static void
+for_each_run (const dim_vector& dv, const Array<octave_idx_type>& lo,
+              const dim_vector& cnt, F fcn)
+{
+  if (cnt.numel () == 0)
+    return;
+
+  int nd = dv.ndims ();
+
+  int k = 0;
+  octave_idx_type len = 1;
+
+  while (k < nd && cnt(k) == dv(k))
+    len *= dv(k++);
+
+  if (k < nd)
+    len *= cnt(k++);
+
+  std::vector<octave_idx_type> stride (nd);
+  octave_idx_type base = 0;
+  octave_idx_type s = 1;
+  for (int d = 0; d < nd; d++)
+    {
+      stride[d] = s;
+      base += lo.xelem (d) * s;
+      s *= dv(d);
+    }
+
+  octave_idx_type nruns = cnt.numel () / len;
+
+  std::vector<octave_idx_type> sub (nd, 0);
+
+  for (octave_idx_type r = 0; r < nruns; r++)
+    {
+      octave_idx_type fi = base;
+      for (int d = k; d < nd; d++)
+        fi += sub[d] * stride[d];
+
+      fcn (fi, r * len, len);
+
+      for (int d = k; d < nd; d++)
+        {
+          if (++sub[d] < cnt(d))
+            break;
+
+          sub[d] = 0;
+        }
+    }
+}
+
+template <typename S, typename T>
+static void
+convert_elements (const char *buf, bool swap, octave_idx_type n,
+                  int step, T *dest)
+{
+  for (octave_idx_type j = 0; j < n; j++)
+    {
+      S s;
+      std::memcpy (&s, buf + j * step * sizeof (S), sizeof (S));
+
+      if (swap)
+        swap_bytes<sizeof (S)> (&s);
+
+      dest[j] = static_cast<T> (s);
+    }
+}
+
+// Convert N elements of type TYPE, STEP elements apart in BUF, to DEST.
+
+template <typename T>
+static void
+read_converted (const char *buf, matfile_type type, bool swap,
+                octave_idx_type n, int step, T *dest)
+{
+  switch (type)
+    {
+    case mf_int8:
+      convert_elements<int8_t> (buf, swap, n, step, dest);
+      break;
+
+    case mf_uint8:
+      convert_elements<uint8_t> (buf, swap, n, step, dest);
+      break;
+
+    case mf_int16:
+      convert_elements<int16_t> (buf, swap, n, step, dest);
+      break;
+
+    case mf_uint16:
+      convert_elements<uint16_t> (buf, swap, n, step, dest);
+      break;
+
+    case mf_int32:
+      convert_elements<int32_t> (buf, swap, n, step, dest);
+      break;
+
+    case mf_uint32:
+      convert_elements<uint32_t> (buf, swap, n, step, dest);
+      break;
+
+    case mf_int64:
+      convert_elements<int64_t> (buf, swap, n, step, dest);
+      break;
+
+    case mf_uint64:
+      convert_elements<uint64_t> (buf, swap, n, step, dest);
+      break;
+
+    case mf_single:
+      convert_elements<float> (buf, swap, n, step, dest);
+      break;
+
+    case mf_double:
+      convert_elements<double> (buf, swap, n, step, dest);
+      break;
+
+    default:
+      panic_impossible ();
+    }
+}
+
+template <typename T>
+static T
+element_value (const T& x)
+{
+  return x;
+}
+
+template <typename T>
+static T
+element_value (const octave_int<T>& x)
+{
+  return x.value ();
+}
+
+template <typename T>
+static bool
+same_value (const T& x, const T& y)
+{
+  return x == y || (octave::math::isnan (x) && octave::math::isnan (y));
+}
+
+// TRUE if the value V can be converted to the integer type S.  Integer
+// values saturate when converted, which store_elements detects.
+
+template <typename V>
+struct store_range
+{
+  template <typename S>
+  static bool contains (const V&) { return true; }
+};
+
+// The largest value of S may round up when converted to floating
+// point, so compare with the exact power of 2 above it.  NaN fails.
+
+template <typename V>
+struct float_store_range
+{
+  template <typename S>
+  static bool contains (const V& v)
+  {
+    return (v >= std::numeric_limits<S>::min ()
+            && v < std::ldexp (V (1), std::numeric_limits<S>::digits));
+  }
+};
+
+template <>
+struct store_range<double> : public float_store_range<double> { };
+
+template <>
+struct store_range<float> : public float_store_range<float> { };
+
+// Convert V to the stored type S, or return false if V is NaN or out
+// of the range of S.  A plain cast would be undefined in those cases.
+
+template <typename S>
+struct store_cast
+{
+  template <typename V>
+  static bool convert (const V& v, S& s)
+  {
+    if (! store_range<V>::template contains<S> (v))
+      return false;
+
+    s = octave_int<S> (v).value ();
+    return true;
+  }
+};
+
+template <>
+struct store_cast<float>
+{
+  template <typename V>
+  static bool convert (const V& v, float& s)
+  {
+    double d = v;
+
+    if (! octave::math::isinf (d)
+        && std::abs (d) > std::numeric_limits<float>::max ())
+      return false;
+
+    s = d;
+    return true;
+  }
+};
+
+template <>
+struct store_cast<double>
+{
+  template <typename V>
+  static bool convert (const V& v, double& s)
+  {
+    s = v;
+    return true;
+  }
+};
+
+template <typename S, typename T>
+static bool
+store_elements (char *buf, bool swap, octave_idx_type n, const T *src)
+{
+  for (octave_idx_type j = 0; j < n; j++)
+    {
+      S s;
+
+      if (! store_cast<S>::convert (element_value (src[j]), s)
+          || ! same_value (static_cast<T> (s), src[j]))
+        return false;
+
+      if (swap)
+        swap_bytes<sizeof (S)> (&s);
+
+      std::memcpy (buf + j * sizeof (S), &s, sizeof (S));
+    }
+
+  return true;
+}
+
+// Convert N elements of SRC to type TYPE in BUF.  Return false if a
+// value cannot be represented exactly.
+
+template <typename T>
+static bool
+store_converted (char *buf, matfile_type type, bool swap,
+                 octave_idx_type n, const T *src)
+{
+  switch (type)
+    {
+    case mf_int8:
+      return store_elements<int8_t> (buf, swap, n, src);
+
+    case mf_uint8:
+      return store_elements<uint8_t> (buf, swap, n, src);
+
+    case mf_int16:
+      return store_elements<int16_t> (buf, swap, n, src);
+
+    case mf_uint16:
+      return store_elements<uint16_t> (buf, swap, n, src);
+
+    case mf_int32:
+      return store_elements<int32_t> (buf, swap, n, src);
+
+    case mf_uint32:
+      return store_elements<uint32_t> (buf, swap, n, src);
+
+    case mf_int64:
+      return store_elements<int64_t> (buf, swap, n, src);
+
+    case mf_uint64:
+      return store_elements<uint64_t> (buf, swap, n, src);
+
+    case mf_single:
+      return store_elements<float> (buf, swap, n, src);
+
+    case mf_double:
+      return store_elements<double> (buf, swap, n, src);
+
+    default:
+      panic_impossible ();
+    }
+
+  return false;
+}
+
+class
+matfile_flat_data : public matfile_data
+{
+public:
+
+  matfile_flat_data (std::fstream& s, const matfile_var& v)
+    : matfile_data (v), fs (s) { }
+
+  octave_value read (const Array<octave_idx_type>& lo, const dim_vector& cnt);
+
+  void write (const Array<octave_idx_type>& lo, const octave_value& val);
+
+private:
+
+  // Number of elements read or written at once.
+  static const octave_idx_type chunk_size = 1 << 20;
+
+  template <typename T>
+  void read_values (const Array<octave_idx_type>& lo, const dim_vector& cnt,
+                    std::streamoff pos, matfile_type type, T *re, T *im);
+
+  template <typename T>
+  void write_values (const Array<octave_idx_type>& lo, const dim_vector& cnt,
+                     std::streamoff pos, matfile_type type, const T *src,
+                     int step);
+
+  template <typename RA>
+  octave_value read_real (const Array<octave_idx_type>& lo,
+                          const dim_vector& cnt);
+
+  template <typename RA, typename CA>
+  octave_value read_complex (const Array<octave_idx_type>& lo,
+                             const dim_vector& cnt);
+
+  template <typename T>
+  void write_real (const Array<octave_idx_type>& lo, const dim_vector& cnt,
+                   const T *src);
+
+  template <typename RA, typename CA>
+  void write_complex (const Array<octave_idx_type>& lo, const CA& z);
+
+  std::fstream& fs;
+};
+
+// Read the elements of the box into RE.  If IM is not null, the real
+// and imaginary parts are interleaved in the file.
+
+template <typename T>
+void
+matfile_flat_data::read_values (const Array<octave_idx_type>& lo,
+                                const dim_vector& cnt, std::streamoff pos,
+                                matfile_type type, T *re, T *im)
+{
+  int step = (im ? 2 : 1);
+  int size = matfile_type_size (type);
+
+  std::vector<char> buf;
+
+  for_each_run (var.dims, lo, cnt,
+                [&] (octave_idx_type fi, octave_idx_type bi,
+                     octave_idx_type len)
+                {
+                  for (octave_idx_type j = 0; j < len; j += chunk_size)
+                    {
+                      octave_idx_type m = std::min (chunk_size, len - j);
+
+                      buf.resize (step * m * size);
+
+                      fs.seekg (pos + static_cast<std::streamoff> (step)
+                                      * (fi + j) * size);
+
+                      if (! fs.read (buf.data (), buf.size ()))
+                        error ("matfile: error reading '%s'",
+                               var.name.c_str ());
+
+                      read_converted (buf.data (), type, var.swap, m,
+                                      step, re + bi + j);
+
+                      if (im)
+                        read_converted (buf.data () + size, type,
+                                        var.swap, m, step, im + bi + j);
+                    }
+                });
+}
+
+// Write the elements of the box from SRC, which holds STEP values of
+// type T for each element.
+
+template <typename T>
+void
+matfile_flat_data::write_values (const Array<octave_idx_type>& lo,
+                                 const dim_vector& cnt, std::streamoff pos,
+                                 matfile_type type, const T *src, int step)
+{
+  int size = matfile_type_size (type);
+
+  std::vector<char> buf;
+
+  for_each_run (var.dims, lo, cnt,
+                [&] (octave_idx_type fi, octave_idx_type bi,
+                     octave_idx_type len)
+                {
+                  for (octave_idx_type j = 0; j < len; j += chunk_size)
+                    {
+                      octave_idx_type m = std::min (chunk_size, len - j);
+
+                      buf.resize (step * m * size);
+
+                      if (! store_converted (buf.data (), type, var.swap,
+                                             step * m, src + step * (bi + j)))
+                        {
+                          // Octave and MATLAB store floating point
+                          // arrays of integer values in smaller integer
+                          // types to save space.
+                          if ((var.class_name == "double"
+                               || var.class_name == "single")
+                              && type != mf_double && type != mf_single)
+                            error ("matfile: values assigned to '%s' cannot be stored in its data type: the file stores its %s values as %s integers, which cannot be changed in place; use an HDF5 file instead",
+                                   var.name.c_str (), var.class_name.c_str (),
+                                   matfile_type_name (type));
+                          else
+                            error ("matfile: values assigned to '%s' cannot be stored in its data type",
+                                   var.name.c_str ());
+                        }
+
+                      fs.seekp (pos + static_cast<std::streamoff> (step)
+                                      * (fi + j) * size);
+
+                      if (! fs.write (buf.data (), buf.size ()))
+                        error ("matfile: error writing '%s'",
+                               var.name.c_str ());
+                    }
+                });
+}
+
+template <typename RA>
+octave_value
+matfile_flat_data::read_real (const Array<octave_idx_type>& lo,
+                              const dim_vector& cnt)
+{
+  typedef typename RA::element_type T;
+
+  RA retval (cnt);
+
+  read_values<T> (lo, cnt, var.real_pos, var.type, retval.fortran_vec (), 0);
+
+  return retval;
+}
+
+template <typename RA, typename CA>
+octave_value
+matfile_flat_data::read_complex (const Array<octave_idx_type>& lo,
+                                 const dim_vector& cnt)
+{
+  typedef typename RA::element_type T;
+
+  RA re (cnt);
+  RA im (cnt);
+
+  if (var.imag_pos < 0)
+    read_values<T> (lo, cnt, var.real_pos, var.type, re.fortran_vec (),
+                    im.fortran_vec ());
+  else
+    {
+      read_values<T> (lo, cnt, var.real_pos, var.type, re.fortran_vec (), 0);
+      read_values<T> (lo, cnt, var.imag_pos, var.imag_type, im.fortran_vec (),
+                      0);
+    }
+
+  CA retval (cnt);
+
+  octave_idx_type n = retval.numel ();
+  for (octave_idx_type i = 0; i < n; i++)
+    retval.xelem (i) = typename CA::element_type (re.xelem (i), im.xelem (i));
+
+  return retval;
+}
+
+template <typename T>
+void
+matfile_flat_data::write_real (const Array<octave_idx_type>& lo,
+                               const dim_vector& cnt, const T *src)
+{
+  write_values (lo, cnt, var.real_pos, var.type, src, 1);
+}
+
+template <typename RA, typename CA>
+void
+matfile_flat_data::write_complex (const Array<octave_idx_type>& lo,
+                                  const CA& z)
+{
+  typedef typename RA::element_type T;
+
+  if (var.imag_pos < 0)
+    write_values (lo, z.dims (), var.real_pos, var.type,
+                  reinterpret_cast<const T *> (z.data ()), 2);
+  else
+    {
+      RA re = real (z);
+      RA im = imag (z);
+
+      write_values (lo, z.dims (), var.real_pos, var.type, re.data (), 1);
+      write_values (lo, z.dims (), var.imag_pos, var.imag_type, im.data (),
+                    1);
+    }
+}
+
+octave_value
+matfile_flat_data::read (const Array<octave_idx_type>& lo,
+                         const dim_vector& cnt)
+{
+  const std::string& cls = var.class_name;
+
+  if (cls == "double")
+    return (var.is_complex ? read_complex<NDArray, ComplexNDArray> (lo, cnt)
+                           : read_real<NDArray> (lo, cnt));
+  else if (cls == "single")
+    return (var.is_complex
+            ? read_complex<FloatNDArray, FloatComplexNDArray> (lo, cnt)
+            : read_real<FloatNDArray> (lo, cnt));
+  else if (cls == "logical")
+    return read_real<boolNDArray> (lo, cnt);
+  else if (cls == "int8")
+    return read_real<int8NDArray> (lo, cnt);
+  else if (cls == "int16")
+    return read_real<int16NDArray> (lo, cnt);
+  else if (cls == "int32")
+    return read_real<int32NDArray> (lo, cnt);
+  else if (cls == "int64")
+    return read_real<int64NDArray> (lo, cnt);
+  else if (cls == "uint8")
+    return read_real<uint8NDArray> (lo, cnt);
+  else if (cls == "uint16")
+    return read_real<uint16NDArray> (lo, cnt);
+  else if (cls == "uint32")
+    return read_real<uint32NDArray> (lo, cnt);
+  else if (cls == "uint64")
+    return read_real<uint64NDArray> (lo, cnt);
+  else
+    panic_impossible ();
+}
+
+void
+matfile_flat_data::write (const Array<octave_idx_type>& lo,
+                          const octave_value& val)
+{
+  const std::string& cls = var.class_name;
+
+  dim_vector cnt = val.dims ();
+
+  if (cls == "double")
+    {
+      if (var.is_complex)
+        write_complex<NDArray> (lo, val.complex_array_value ());
+      else
+        write_real (lo, cnt, val.array_value ().data ());
+    }
+  else if (cls == "single")
+    {
+      if (var.is_complex)
+        write_complex<FloatNDArray> (lo, val.float_complex_array_value ());
+      else
+        write_real (lo, cnt, val.float_array_value ().data ());
+    }
+  else if (cls == "logical")
+    write_real (lo, cnt, val.bool_array_value ().data ());
+  else if (cls == "int8")
+    write_real (lo, cnt, val.int8_array_value ().data ());
+  else if (cls == "int16")
+    write_real (lo, cnt, val.int16_array_value ().data ());
+  else if (cls == "int32")
+    write_real (lo, cnt, val.int32_array_value ().data ());
+  else if (cls == "int64")
+    write_real (lo, cnt, val.int64_array_value ().data ());
+  else if (cls == "uint8")
+    write_real (lo, cnt, val.uint8_array_value ().data ());
+  else if (cls == "uint16")
+    write_real (lo, cnt, val.uint16_array_value ().data ());
+  else if (cls == "uint32")
+    write_real (lo, cnt, val.uint32_array_value ().data ());
+  else if (cls == "uint64")
+    write_real (lo, cnt, val.uint64_array_value ().data ());
+  else
+    panic_impossible ();
+
+  fs.flush ();
+}
+
+#if defined (HAVE_HDF5)
+
+// Data stored in an HDF5 dataset.  HDF5 stores arrays in row-major
+// order, so the dimensions of the dataset are those of the variable in
+// reverse order.
+
+class
+matfile_hdf5_data : public matfile_data
+{
+public:
+
+  matfile_hdf5_data (hid_t file_id, const matfile_var& v)
+    : matfile_data (v), data_id (-1)
+  {
+#if defined (HAVE_HDF5_18)
+    data_id = H5Dopen (file_id, var.dataset.c_str (), octave_H5P_DEFAULT);
+#else
+    data_id = H5Dopen (file_id, var.dataset.c_str ());
+#endif
+
+    if (data_id < 0)
+      error ("matfile: unable to open '%s'", var.name.c_str ());
+  }
+
+  // No copying!
+
+  matfile_hdf5_data (const matfile_hdf5_data&) = delete;
+
+  matfile_hdf5_data& operator = (const matfile_hdf5_data&) = delete;
+
+  ~matfile_hdf5_data (void) { H5Dclose (data_id); }
+
+  octave_value read (const Array<octave_idx_type>& lo, const dim_vector& cnt);
+
+  void write (const Array<octave_idx_type>& lo, const octave_value& val);
+
+  bool resize (const dim_vector& dv);
+
+private:
+
+  hid_t mem_type (void) const;
+
+  // Select the box in the dataset and return the file and memory
+  // dataspaces, or return false if the box is empty.
+  bool select (const Array<octave_idx_type>& lo, const dim_vector& cnt,
+               hid_t& file_space, hid_t& mem_space);
+
+  void transfer (const Array<octave_idx_type>& lo, const dim_vector& cnt,
+                 void *buf, bool reading);
+
+  hid_t data_id;
+};
+
+hid_t
+matfile_hdf5_data::mem_type (void) const
+{
+  const std::string& cls = var.class_name;
+
+  hid_t retval = -1;
+
+  if (cls == "double")
+    retval = H5T_NATIVE_DOUBLE;
+  else if (cls == "single")
+    retval = H5T_NATIVE_FLOAT;
+  else if (cls == "logical")
+    retval = H5T_NATIVE_HBOOL;
+  else if (cls == "int8")
+    retval = H5T_NATIVE_INT8;
+  else if (cls == "int16")
+    retval = H5T_NATIVE_INT16;
+  else if (cls == "int32")
+    retval = H5T_NATIVE_INT32;
+  else if (cls == "int64")
+    retval = H5T_NATIVE_INT64;
+  else if (cls == "uint8")
+    retval = H5T_NATIVE_UINT8;
+  else if (cls == "uint16")
+    retval = H5T_NATIVE_UINT16;
+  else if (cls == "uint32")
+    retval = H5T_NATIVE_UINT32;
+  else if (cls == "uint64")
+    retval = H5T_NATIVE_UINT64;
+  else
+    panic_impossible ();
+
+  return (var.is_complex ? hdf5_make_complex_type (retval) : retval);
+}
+
+bool
+matfile_hdf5_data::select (const Array<octave_idx_type>& lo,
+                           const dim_vector& cnt,
+                           hid_t& file_space, hid_t& mem_space)
+{
+  if (cnt.numel () == 0)
+    return false;
+
+  file_space = H5Dget_space (data_id);
+
+  int rank = H5Sget_simple_extent_ndims (file_space);
+  int nd = var.dims.ndims ();
+
+  OCTAVE_LOCAL_BUFFER (hsize_t, start, rank);
+  OCTAVE_LOCAL_BUFFER (hsize_t, count, rank);
+
+  if (rank == 1)
+    {
+      // Loaded as a row vector.
+      start[0] = lo.xelem (1);
+      count[0] = cnt(1);
+    }
+  else
+    {
+      for (int i = 0; i < rank; i++)
+        {
+          start[i] = lo.xelem (nd-i-1);
+          count[i] = cnt(nd-i-1);
+        }
+    }
+
+  H5Sselect_hyperslab (file_space, H5S_SELECT_SET, start, 0, count, 0);
+
+  mem_space = H5Screate_simple (rank, count, 0);
+
+  return true;
+}
+
+void
+matfile_hdf5_data::transfer (const Array<octave_idx_type>& lo,
+                             const dim_vector& cnt, void *buf, bool reading)
+{
+  hid_t file_space, mem_space;
+
+  if (! select (lo, cnt, file_space, mem_space))
+    return;
+
+  hid_t type = mem_type ();
+
+  herr_t status
+    = (reading
+       ? H5Dread (data_id, type, mem_space, file_space, octave_H5P_DEFAULT,
+                  buf)
+       : H5Dwrite (data_id, type, mem_space, file_space, octave_H5P_DEFAULT,
+                   buf));
+
+  if (var.is_complex)
+    H5Tclose (type);
+
+  H5Sclose (mem_space);
+  H5Sclose (file_space);
+
+  if (status < 0)
+    error ("matfile: error %s '%s'", reading ? "reading" : "writing",
+           var.name.c_str ());
+}
+
+octave_value
+matfile_hdf5_data::read (const Array<octave_idx_type>& lo,
+                         const dim_vector& cnt)
+{
+  const std::string& cls = var.class_name;
+
+  octave_value retval;
+
+#define READ_HDF5_ARRAY(ARRAY_T)                        \
+  do                                                    \
+    {                                                   \
+      ARRAY_T tmp (cnt);                                \
+      transfer (lo, cnt, tmp.fortran_vec (), true);     \
+      retval = tmp;                                     \
+    }                                                   \
+  while (0)
+
+  if (cls == "double")
+    {
+      if (var.is_complex)
+        READ_HDF5_ARRAY (ComplexNDArray);
+      else
+        READ_HDF5_ARRAY (NDArray);
+    }
+  else if (cls == "single")
+    {
+      if (var.is_complex)
+        READ_HDF5_ARRAY (FloatComplexNDArray);
+      else
+        READ_HDF5_ARRAY (FloatNDArray);
+    }
+  else if (cls == "logical")
+    {
+      boolNDArray b (cnt);
+      octave_idx_type n = b.numel ();
+
+      OCTAVE_LOCAL_BUFFER (hbool_t, tmp, n);
+      transfer (lo, cnt, tmp, true);
+
+      for (octave_idx_type i = 0; i < n; i++)
+        b.xelem (i) = tmp[i];
+
+      retval = b;
+    }
+  else if (cls == "int8")
+    READ_HDF5_ARRAY (int8NDArray);
+  else if (cls == "int16")
+    READ_HDF5_ARRAY (int16NDArray);
+  else if (cls == "int32")
+    READ_HDF5_ARRAY (int32NDArray);
+  else if (cls == "int64")
+    READ_HDF5_ARRAY (int64NDArray);
+  else if (cls == "uint8")
+    READ_HDF5_ARRAY (uint8NDArray);
+  else if (cls == "uint16")
+    READ_HDF5_ARRAY (uint16NDArray);
+  else if (cls == "uint32")
+    READ_HDF5_ARRAY (uint32NDArray);
+  else if (cls == "uint64")
+    READ_HDF5_ARRAY (uint64NDArray);
+  else
+    panic_impossible ();
+
+#undef READ_HDF5_ARRAY
+
+  return retval;
+}
+
+void
+matfile_hdf5_data::write (const Array<octave_idx_type>& lo,
+                          const octave_value& val)
+{
+  dim_vector cnt = val.dims ();
+
+  if (var.class_name == "logical")
+    {
+      boolNDArray b = val.bool_array_value ();
+
+      octave_idx_type n = b.numel ();
+
+      OCTAVE_LOCAL_BUFFER (hbool_t, tmp, n);
+      for (octave_idx_type i = 0; i < n; i++)
+        tmp[i] = b.xelem (i);
+
+      transfer (lo, cnt, tmp, false);
+    }
+  else
+    {
+      // Indexing may have narrowed complex values to real ones.
+      octave_value tmp = convert_value (val, var.class_name, var.is_complex);
+
+      transfer (lo, cnt, tmp.mex_get_data (), false);
+    }
+}
+
+bool
+matfile_hdf5_data::resize (const dim_vector& dv)
+{
+  // Only chunked datasets can change their size.
+
+  hid_t plist = H5Dget_create_plist (data_id);
+  bool chunked = (H5Pget_layout (plist) == H5D_CHUNKED);
+  H5Pclose (plist);
+
+  if (! chunked)
+    return false;
+
+  hid_t space_id = H5Dget_space (data_id);
+
+  int rank = H5Sget_simple_extent_ndims (space_id);
+
+  OCTAVE_LOCAL_BUFFER (hsize_t, hdims, rank);
+  OCTAVE_LOCAL_BUFFER (hsize_t, olddims, rank);
+  OCTAVE_LOCAL_BUFFER (hsize_t, maxdims, rank);
+
+  H5Sget_simple_extent_dims (space_id, olddims, maxdims);
+  H5Sclose (space_id);
+
+  if (rank == 1)
+    {
+      if (dv.ndims () != 2 || dv(0) != 1)
+        return false;
+
+      hdims[0] = dv(1);
+    }
+  else
+    {
+      if (dv.ndims () != rank)
+        return false;
+
+      for (int i = 0; i < rank; i++)
+        hdims[i] = dv(rank-i-1);
+    }
+
+  for (int i = 0; i < rank; i++)
+    if (maxdims[i] != H5S_UNLIMITED && hdims[i] > maxdims[i])
+      return false;
+
+#if defined (HAVE_HDF5_18)
+  if (H5Dset_extent (data_id, hdims) < 0)
+    return false;
+#else
+  // Datasets can only grow with older versions of HDF5.
+  for (int i = 0; i < rank; i++)
+    if (hdims[i] < olddims[i])
+      return false;
+
+  if (H5Dextend (data_id, hdims) < 0)
+    return false;
+#endif
+
+  var.dims = dv;
+
+  return true;
+}
+
+#endif
+
+// Octave type names of arrays that can be accessed in parts, with the
+// class of their elements.
+
+static bool
+partial_octave_type (const std::string& typ, std::string& cls, bool& cplx)
+{
+  static const char *types[][2] =
+  {
+    { "matrix", "double" },
+    { "complex matrix", "double" },
+    { "float matrix", "single" },
+    { "float complex matrix", "single" },
+    { "bool matrix", "logical" },
+    { "int8 matrix", "int8" },
+    { "int16 matrix", "int16" },
+    { "int32 matrix", "int32" },
+    { "int64 matrix", "int64" },
+    { "uint8 matrix", "uint8" },
+    { "uint16 matrix", "uint16" },
+    { "uint32 matrix", "uint32" },
+    { "uint64 matrix", "uint64" }
+  };
+
+  for (const auto& t : types)
+    {
+      if (typ == t[0])
+        {
+          cls = t[1];
+          cplx = (typ.find ("complex") != std::string::npos);
+          return true;
+        }
+    }
+
+  return false;
+}
+
+static std::string
+mat5_class_name (int cls, bool logical)
+{
+  static const char *names[] =
+  {
+    "", "cell", "struct", "object", "char", "double", "double", "single",
+    "int8", "uint8", "int16", "uint16", "int32", "uint32", "int64",
+    "uint64", "function_handle"
+  };
+
+  if (logical && cls >= 5 && cls <= 15)
+    return "logical";
+  else if (cls >= 1 && cls <= 16)
+    return names[cls];
+  else
+    return "";
+}
+
+// Read the array flags, dimensions, and name of the miMATRIX element
+// whose tag has just been read from IS.  If LOCATE_DATA is true, also
+// find the data of numeric arrays.
+
+static bool
+read_mat5_header (std::istream& is, bool swap, matfile_var& var,
+                  bool locate_data)
+{
+  int32_t type, len, flags, nzmax;
+  bool small;
+
+  if (read_mat5_tag (is, swap, type, len, small) || type != miUINT32
+      || len != 8)
+    return false;
+
+  is.read (reinterpret_cast<char *> (&flags), 4);
+  is.read (reinterpret_cast<char *> (&nzmax), 4);
+
+  if (swap)
+    swap_bytes<4> (&flags);
+
+  int cls = flags & 0xff;
+  bool logical = (flags & 0x0200) != 0;
+
+  var.is_complex = (flags & 0x0800) != 0;
+  var.class_name = mat5_class_name (cls, logical);
+
+  // Workspace elements have no dimensions.
+  if (cls == 17)
+    return false;
+
+  if (read_mat5_tag (is, swap, type, len, small) || type != miINT32)
+    return false;
+
+  int ndims = len / 4;
+
+  var.dims = dim_vector::alloc (std::max (ndims, 2));
+  var.dims(1) = 1;
+
+  for (int i = 0; i < ndims; i++)
+    {
+      int32_t n;
+      is.read (reinterpret_cast<char *> (&n), 4);
+
+      if (swap)
+        swap_bytes<4> (&n);
+
+      var.dims(i) = n;
+    }
+
+  var.dims_known = true;
+
+  is.seekg (READ_PAD (small, len) - len, std::ios::cur);
+
+  if (read_mat5_tag (is, swap, type, len, small)
+      || (type != miINT8 && type != miUINT8 && type != miUTF8))
+    return false;
+
+  std::string name (len, '\0');
+  is.read (&name[0], len);
+  var.name = name;
+
+  is.seekg (READ_PAD (small, len) - len, std::ios::cur);
+
+  if (cls == 3)
+    {
+      // Objects store their class name after the variable name.
+
+      if (read_mat5_tag (is, swap, type, len, small) || type != miINT8)
+        return false;
+
+      std::string class_name (len, '\0');
+      is.read (&class_name[0], len);
+      var.class_name = class_name;
+
+      return true;
+    }
+
+  // Only full numeric and logical arrays can be accessed in parts.
+  if (! is || ! locate_data || cls < 6 || cls > 15)
+    return true;
+
+  // Real part.
+
+  if (read_mat5_tag (is, swap, type, len, small) || small)
+    return true;
+
+  var.type = mat5_to_matfile_type (type);
+  var.real_pos = is.tellg ();
+
+  int size = matfile_type_size (var.type);
+
+  if (size == 0 || len != var.dims.numel () * size)
+    return true;
+
+  if (var.is_complex)
+    {
+      is.seekg (var.real_pos + READ_PAD (small, len));
+
+      if (read_mat5_tag (is, swap, type, len, small) || small)
+        return true;
+
+      // The imaginary part may be stored in a different type.
+      var.imag_type = mat5_to_matfile_type (type);
+
+      int imag_size = matfile_type_size (var.imag_type);
+
+      if (imag_size == 0 || len != var.dims.numel () * imag_size)
+        return true;
+
+      var.imag_pos = is.tellg ();
+    }
+
+  var.swap = swap;
+  var.partial = true;
+
+  return true;
+}
+
+#if defined (HAVE_ZLIB)
+
+// Uncompress at most N bytes from the start of the compressed data
+// element of length LEN at the current position of IS.
+
+static std::string
+inflate_prefix (std::istream& is, int32_t len, size_t n)
+{
+  std::string retval (n, '\0');
+
+  z_stream zs;
+  std::memset (&zs, 0, sizeof (zs));
+
+  if (inflateInit (&zs) != Z_OK)
+    return "";
+
+  zs.next_out = reinterpret_cast<Bytef *> (&retval[0]);
+  zs.avail_out = n;
+
+  char buf[4096];
+
+  while (zs.avail_out > 0 && len > 0)
+    {
+      int32_t m = std::min (len, static_cast<int32_t> (sizeof (buf)));
+
+      if (! is.read (buf, m))
+        break;
+
+      len -= m;
+
+      zs.next_in = reinterpret_cast<Bytef *> (buf);
+      zs.avail_in = m;
+
+      int err = inflate (&zs, Z_NO_FLUSH);
+
+      if (err != Z_OK)
+        break;
+    }
+
+  retval.resize (n - zs.avail_out);
+
+  inflateEnd (&zs);
+
+  return retval;
+}
+
+#endif
+
+// Describe the variable stored in the element at the current position
+// of the MATLAB v6 or v7 file IS, and move to the next element.  VAR
+// has no name if the element does not hold a variable.  Return false
+// at the end of the file.
+
+static bool
+read_mat5_var (std::istream& is, bool swap, matfile_var& var)
+{
+  std::streamoff pos = is.tellg ();
+
+  int32_t type, elt_len;
+  bool small;
+
+  // Elements without data would leave us at the same position.
+  if (read_mat5_tag (is, swap, type, elt_len, small) || elt_len <= 0)
+    return false;
+
+  var = matfile_var ();
+  var.pos = pos;
+
+  if (type == miMATRIX)
+    read_mat5_header (is, swap, var, true);
+  else if (type == miCOMPRESSED)
+    {
+#if defined (HAVE_ZLIB)
+      std::istringstream hs (inflate_prefix (is, elt_len, 1024));
+
+      int32_t len;
+
+      if (! read_mat5_tag (hs, swap, type, len, small) && type == miMATRIX)
+        read_mat5_header (hs, swap, var, false);
+#endif
+    }
+
+  is.clear ();
+  is.seekg (pos + 8 + elt_len);
+
+  return true;
+}
+
+// Find the variables in the MATLAB v6 or v7 file IS, positioned after
+// the file header.
+
+static std::list<matfile_var>
+scan_mat5_file (std::istream& is, bool swap)
+{
+  std::list<matfile_var> retval;
+
+  matfile_var var;
+
+  while (read_mat5_var (is, swap, var))
+    {
+      if (! var.name.empty ())
+        retval.push_back (var);
+    }
+
+  return retval;
+}
+
+// Read a 32-bit integer from the Octave binary file IS.
+
+static bool
+read_binary_int32 (std::istream& is, bool swap, int32_t& val)
+{
+  if (! is.read (reinterpret_cast<char *> (&val), 4))
+    return false;
+
+  if (swap)
+    swap_bytes<4> (&val);
+
+  return true;
+}
+
+// Read the dimensions of an array with MDIMS dimensions from the Octave
+// binary file IS.
+
+static bool
+read_binary_dims (std::istream& is, bool swap, int32_t mdims,
+                  dim_vector& dv)
+{
+  dv = dim_vector::alloc (std::max (mdims, 2));
+  dv(1) = 1;
+
+  for (int i = 0; i < mdims; i++)
+    {
+      int32_t n;
+
+      if (! read_binary_int32 (is, swap, n))
+        return false;
+
+      dv(i) = n;
+    }
+
+  // Octave reads arrays with a single dimension as row vectors.
+  if (mdims == 1)
+    dv = dim_vector (1, dv(0));
+
+  return true;
+}
+
+static bool
+skip_binary_record (std::istream& is, bool swap);
+
+// Skip the value of type TYP at the current position of the Octave
+// binary file IS, and describe it in VAR.  The layouts are those written
+// by the save_binary methods of the value types.  Return false for
+// types whose values must be read to find their end.
+
+static bool
+skip_binary_value (std::istream& is, bool swap, const std::string& typ,
+                   matfile_var& var)
+{
+  int32_t n;
+
+  var.dims = dim_vector (1, 1);
+
+  if (partial_octave_type (typ, var.class_name, var.is_complex))
+    {
+      if (! read_binary_int32 (is, swap, n) || n >= 0
+          || ! read_binary_dims (is, swap, -n, var.dims))
+        return false;
+
+      octave_idx_type nel = var.dims.numel ();
+
+      if (var.class_name == "double" || var.class_name == "single")
+        {
+          // No type is written for empty arrays.
+          char st = LS_DOUBLE;
+          if (nel > 0 && ! is.read (&st, 1))
+            return false;
+
+          var.type = save_type_to_matfile_type (st);
+        }
+      else
+        var.type = class_to_matfile_type (var.class_name);
+
+      int size = matfile_type_size (var.type);
+
+      if (size == 0)
+        return false;
+
+      var.real_pos = is.tellg ();
+
+      is.seekg (var.real_pos + static_cast<std::streamoff> (nel)
+                * (var.is_complex ? 2 : 1) * size);
+    }
+  else if (typ == "cell")
+    {
+      var.class_name = "cell";
+
+      if (! read_binary_int32 (is, swap, n) || n >= 0
+          || ! read_binary_dims (is, swap, -n, var.dims))
+        return false;
+
+      octave_idx_type nel = var.dims.numel ();
+
+      for (octave_idx_type i = 0; i < nel; i++)
+        if (! skip_binary_record (is, swap))
+          return false;
+    }
+  else if (typ == "struct" || typ == "scalar struct")
+    {
+      var.class_name = "struct";
+
+      if (! read_binary_int32 (is, swap, n))
+        return false;
+
+      // Struct arrays may store their dimensions before the number of
+      // fields.
+      if (n < 0 && typ == "struct")
+        {
+          if (! read_binary_dims (is, swap, -n, var.dims)
+              || ! read_binary_int32 (is, swap, n))
+            return false;
+        }
+
+      if (n < 0)
+        return false;
+
+      for (int32_t i = 0; i < n; i++)
+        if (! skip_binary_record (is, swap))
+          return false;
+    }
+  else if (typ == "string" || typ == "sq_string")
+    {
+      var.class_name = "char";
+
+      if (! read_binary_int32 (is, swap, n))
+        return false;
+
+      if (n < 0)
+        {
+          if (! read_binary_dims (is, swap, -n, var.dims))
+            return false;
+
+          is.seekg (var.dims.numel (), std::ios::cur);
+        }
+      else
+        {
+          // Rows of different lengths, padded to the longest one.
+
+          int32_t max_len = 0;
+
+          for (int32_t i = 0; i < n; i++)
+            {
+              int32_t len;
+
+              if (! read_binary_int32 (is, swap, len) || len < 0)
+                return false;
+
+              max_len = std::max (max_len, len);
+
+              is.seekg (len, std::ios::cur);
+            }
+
+          var.dims = dim_vector (n, max_len);
+        }
+    }
+  else if (typ == "sparse matrix" || typ == "sparse complex matrix"
+           || typ == "sparse bool matrix")
+    {
+      int32_t nr, nc, nz;
+
+      if (! read_binary_int32 (is, swap, n) || n != -2
+          || ! read_binary_int32 (is, swap, nr)
+          || ! read_binary_int32 (is, swap, nc)
+          || ! read_binary_int32 (is, swap, nz)
+          || nr < 0 || nc < 0 || nz < 0)
+        return false;
+
+      bool logical = (typ == "sparse bool matrix");
+
+      var.class_name = (logical ? "logical" : "double");
+      var.is_complex = (typ == "sparse complex matrix");
+      var.dims = dim_vector (nr, nc);
+
+      // Column pointers and row indices.
+      is.seekg (4 * (static_cast<std::streamoff> (nc) + 1 + nz),
+                std::ios::cur);
+
+      int size = 1;
+
+      if (! logical)
+        {
+          char st;
+          if (! is.read (&st, 1))
+            return false;
+
+          size = matfile_type_size (save_type_to_matfile_type (st));
+
+          if (size == 0)
+            return false;
+        }
+
+      is.seekg (static_cast<std::streamoff> (nz)
+                * (var.is_complex ? 2 : 1) * size, std::ios::cur);
+    }
+  else if (typ == "scalar" || typ == "complex scalar"
+           || typ == "float scalar" || typ == "float complex scalar")
+    {
+      var.class_name = (typ[0] == 'f' ? "single" : "double");
+      var.is_complex = (typ.find ("complex") != std::string::npos);
+
+      char st;
+      if (! is.read (&st, 1))
+        return false;
+
+      int size = matfile_type_size (save_type_to_matfile_type (st));
+
+      if (size == 0)
+        return false;
+
+      is.seekg ((var.is_complex ? 2 : 1) * size, std::ios::cur);
+    }
+  else if (typ == "bool")
+    {
+      var.class_name = "logical";
+
+      is.seekg (1, std::ios::cur);
+    }
+  else if (typ.size () > 7 && typ.compare (typ.size () - 7, 7, " scalar") == 0
+           && class_to_matfile_type (typ.substr (0, typ.size () - 7))
+              != mf_unknown)
+    {
+      // Integer scalars.
+
+      var.class_name = typ.substr (0, typ.size () - 7);
+
+      if (var.class_name == "double" || var.class_name == "single"
+          || var.class_name == "logical")
+        return false;
+
+      is.seekg (matfile_type_size (class_to_matfile_type (var.class_name)),
+                std::ios::cur);
+    }
+  else
+    return false;
+
+  var.dims_known = true;
+
+  return static_cast<bool> (is);
+}
+
+// Skip a whole record of the Octave binary file IS, as written by
+// save_binary_data for the elements of cells and structs.
+
+static bool
+skip_binary_record (std::istream& is, bool swap)
+{
+  int32_t len;
+
+  // Name and doc string.
+
+  for (int i = 0; i < 2; i++)
+    {
+      if (! read_binary_int32 (is, swap, len) || len < 0)
+        return false;
+
+      is.seekg (len, std::ios::cur);
+    }
+
+  // Global flag and type code.
+
+  unsigned char flags[2];
+
+  if (! is.read (reinterpret_cast<char *> (flags), 2) || flags[1] != 255)
+    return false;
+
+  if (! read_binary_int32 (is, swap, len) || len < 0)
+    return false;
+
+  std::string typ (len, '\0');
+  if (! is.read (&typ[0], len))
+    return false;
+
+  matfile_var var;
+
+  return skip_binary_value (is, swap, typ, var);
+}
+
+// Describe the variable stored in the record at the current position
+// of the Octave binary file IS, and move to the next record.  Values are
+// skipped without being read where their layout is known.  Return false
+// at the end of the file.  WHO is the name of the calling function, for
+// error messages.
+
+static bool
+read_binary_var (std::istream& is, bool swap,
+                 octave::mach_info::float_format flt_fmt,
+                 const std::string& filename, const char *who,
+                 matfile_var& var)
+{
+  var = matfile_var ();
+  var.pos = is.tellg ();
+
+  int32_t len;
+
+  if (! read_binary_int32 (is, swap, len))
+    return false;
+
+  var.name.resize (len);
+  is.read (&var.name[0], len);
+
+  is.read (reinterpret_cast<char *> (&len), 4);
+  if (swap)
+    swap_bytes<4> (&len);
+  is.seekg (len + 1, std::ios::cur);
+
+  unsigned char tmp = 0;
+  is.read (reinterpret_cast<char *> (&tmp), 1);
+
+  std::string typ;
+
+  if (tmp == 255)
+    {
+      is.read (reinterpret_cast<char *> (&len), 4);
+      if (swap)
+        swap_bytes<4> (&len);
+
+      typ.resize (len);
+      is.read (&typ[0], len);
+    }
+
+  if (is && ! typ.empty () && skip_binary_value (is, swap, typ, var))
+    {
+      bool ieee = (flt_fmt == octave::mach_info::flt_fmt_ieee_little_endian
+                   || flt_fmt == octave::mach_info::flt_fmt_ieee_big_endian);
+
+      bool floating = (var.class_name == "double"
+                       || var.class_name == "single");
+
+      var.swap = swap;
+      var.partial = (var.real_pos >= 0 && var.dims.numel () > 0
+                     && (ieee || ! floating));
+    }
+  else
+    {
+      // Read the value to find its class and dimensions, and the start
+      // of the next record.
+
+      matfile_var rvar;
+      rvar.name = var.name;
+      rvar.pos = var.pos;
+
+      var = rvar;
+
+      is.clear ();
+      is.seekg (var.pos);
+
+      bool global;
+      octave_value tc;
+      std::string doc;
+
+      read_binary_data (is, swap, flt_fmt, filename, global, tc, doc);
+
+      var.class_name = tc.class_name ();
+      var.dims = tc.dims ();
+      var.dims_known = true;
+      var.is_complex = tc.is_complex_type ();
+    }
+
+  if (! is)
+    error ("%s: trouble reading binary file '%s'", who, filename.c_str ());
+
+  return true;
+}
+
+// Find the variables in the Octave binary file IS, positioned after
+// the file header.
+
+static std::list<matfile_var>
+scan_binary_file (std::istream& is, bool swap,
+                  octave::mach_info::float_format flt_fmt,
+                  const std::string& filename, const char *who = "matfile")
+{
+  std::list<matfile_var> retval;
+
+  matfile_var var;
+
+  while (read_binary_var (is, swap, flt_fmt, filename, who, var))
+    retval.push_back (var);
+
+  return retval;
+}
+
+data_file_index
+scan_data_file (std::istream& is, load_save_format format, bool swap,
+                octave::mach_info::float_format flt_fmt,
+                const std::string& filename)
+{
+  std::list<matfile_var> vars;
+
+  if (format == LS_BINARY)
+    vars = scan_binary_file (is, swap, flt_fmt, filename, "load");
+  else if (format == LS_MAT5_BINARY || format == LS_MAT7_BINARY)
+    vars = scan_mat5_file (is, swap);
+
+  data_file_index retval;
+
+  for (const auto& var : vars)
+    retval.push_back (std::make_pair (var.name, var.pos));
+
+  return retval;
+}
+
+// A data file opened for partial I/O.
+
+class
+matfile_io
+{
+public:
+
+  matfile_io (const std::string& fname, bool writable);
+
+  // No copying!
+
+  matfile_io (const matfile_io&) = delete;
+
+  matfile_io& operator = (const matfile_io&) = delete;
+
+  ~matfile_io (void);
+
+  std::list<matfile_var> variables (void);
+
+  octave_value read (const std::string& name, const octave_value_list& idx);
+
+  void write (const std::string& name, const octave_value& rhs,
+              const octave_value_list& idx);
+
+private:
+
+  bool find (const std::string& name, matfile_var& var);
+
+  void finish_write (void);
+
+  octave_value read_value (const matfile_var& var);
+
+  void rewrite (const matfile_var& var,
+                const std::list<octave_value_list>& idx,
+                const octave_value& rhs);
+
+  void write_value (const std::string& name, const octave_value& val,
+                    bool exists);
+
+  matfile_data * make_data (const matfile_var& var);
+
+#if defined (HAVE_HDF5)
+  bool hdf5_var (const std::string& name, matfile_var& var);
+#endif
+
+  std::string file_name;
+
+  load_save_format format;
+
+  bool swap;
+
+  octave::mach_info::float_format flt_fmt;
+
+  std::fstream fs;
+
+  octave_hdf5_id file_id;
+};
+
+matfile_io::matfile_io (const std::string& fname, bool writable)
+  : file_name (fname), format (LS_UNKNOWN), swap (false),
+    flt_fmt (octave::mach_info::flt_fmt_unknown), fs (), file_id (-1)
+{
+  octave::sys::file_stat fst (file_name);
+
+  if (! fst)
+    {
+      if (! writable)
+        error ("matfile: unable to find file %s", file_name.c_str ());
+
+      // New files use the HDF5 format if possible, which allows
+      // variables to grow.
+
+#if defined (HAVE_HDF5)
+      hid_t access_plist = hdf5_file_access_plist ();
+
+      file_id = H5Fcreate (file_name.c_str (), H5F_ACC_TRUNC,
+                           octave_H5P_DEFAULT, access_plist);
+
+      H5Pclose (access_plist);
+
+      if (file_id < 0)
+        error ("matfile: unable to create file %s", file_name.c_str ());
+
+      format = LS_HDF5;
+#else
+      {
+        std::ofstream os (file_name.c_str (),
+                          std::ios::out | std::ios::binary);
+
+        if (! os)
+          error ("matfile: unable to create file %s", file_name.c_str ());
+
+        write_header (os, LS_BINARY);
+      }
+#endif
+    }
+
+#if defined (HAVE_HDF5)
+  if (format != LS_HDF5 && H5Fis_hdf5 (file_name.c_str ()) > 0)
+    {
+      hid_t access_plist = hdf5_file_access_plist ();
+
+      file_id = H5Fopen (file_name.c_str (),
+                         writable ? H5F_ACC_RDWR : H5F_ACC_RDONLY,
+                         access_plist);
+
+      H5Pclose (access_plist);
+
+      if (file_id < 0)
+        error ("matfile: unable to open file %s", file_name.c_str ());
+
+      format = LS_HDF5;
+    }
+#endif
+
+  if (format == LS_HDF5)
+    return;
+
+  std::ios::openmode mode = std::ios::in | std::ios::binary;
+  if (writable)
+    mode |= std::ios::out;
+
+  fs.open (file_name.c_str (), mode);
+
+  if (! fs)
+    error ("matfile: unable to open file %s", file_name.c_str ());
+
+  if (read_binary_file_header (fs, swap, flt_fmt, true) == 0)
+    format = LS_BINARY;
+  else
+    {
+      fs.clear ();
+      fs.seekg (0);
+
+      if (read_mat5_binary_file_header (fs, swap, true, file_name) == 0)
+        {
+          format = LS_MAT5_BINARY;
+          fs.clear ();
+          fs.seekg (128);
+        }
+      else
+        error ("matfile: %s is not an Octave binary, MATLAB, or HDF5 file",
+               file_name.c_str ());
+    }
+}
+
+matfile_io::~matfile_io (void)
+{
+#if defined (HAVE_HDF5)
+  if (file_id >= 0)
+    H5Fclose (file_id);
+#endif
+}
+
+#if defined (HAVE_HDF5)
+
+// Describe the variable NAME in an HDF5 file.  Octave stores variables
+// as groups holding the type name and the value; other programs may
+// store arrays as datasets.
+
+bool
+matfile_io::hdf5_var (const std::string& name, matfile_var& var)
+{
+  H5G_stat_t info;
+
+  if (H5Gget_objinfo (file_id, name.c_str (), 1, &info) < 0)
+    return false;
+
+  var.name = name;
+
+  std::string typ;
+
+  if (info.type == H5G_GROUP)
+    {
+#if defined (HAVE_HDF5_18)
+      hid_t group_id = H5Gopen (file_id, name.c_str (), octave_H5P_DEFAULT);
+#else
+      hid_t group_id = H5Gopen (file_id, name.c_str ());
+#endif
+
+      bool new_format = hdf5_check_attr (group_id, "OCTAVE_NEW_FORMAT");
+
+      // Empty arrays store their dimensions instead of their value.
+      bool empty = hdf5_check_attr (group_id, "OCTAVE_EMPTY_MATRIX");
+
+      if (new_format)
+        {
+#if defined (HAVE_HDF5_18)
+          hid_t data_id = H5Dopen (group_id, "type", octave_H5P_DEFAULT);
+#else
+          hid_t data_id = H5Dopen (group_id, "type");
+#endif
+          hid_t type_id = H5Dget_type (data_id);
+          size_t slen = H5Tget_size (type_id);
+
+          OCTAVE_LOCAL_BUFFER (char, tbuf, slen + 1);
+          std::fill (tbuf, tbuf + slen + 1, '\0');
+
+          hid_t st_id = H5Tcopy (H5T_C_S1);
+          H5Tset_size (st_id, slen);
+
+          if (H5Dread (data_id, st_id, octave_H5S_ALL, octave_H5S_ALL,
+                       octave_H5P_DEFAULT, tbuf) >= 0)
+            typ = tbuf;
+
+          H5Tclose (st_id);
+          H5Tclose (type_id);
+          H5Dclose (data_id);
+        }
+
+      H5Gclose (group_id);
+
+      if (! new_format)
+        {
+          var.class_name = "struct";
+          return true;
+        }
+
+      if (! partial_octave_type (typ, var.class_name, var.is_complex))
+        {
+          octave_value tmp = octave_value_typeinfo::lookup_type (typ);
+
+          var.class_name = tmp.class_name ();
+          return true;
+        }
+
+      if (empty)
+        return true;
+
+      var.dataset = name + "/value";
+    }
+  else if (info.type == H5G_DATASET)
+    var.dataset = name;
+  else
+    return false;
+
+#if defined (HAVE_HDF5_18)
+  hid_t data_id = H5Dopen (file_id, var.dataset.c_str (), octave_H5P_DEFAULT);
+#else
+  hid_t data_id = H5Dopen (file_id, var.dataset.c_str ());
+#endif
+
+  if (data_id < 0)
+    return false;
+
+  if (var.class_name.empty ())
+    {
+      // A dataset written by another program.
+
+      hid_t type_id = H5Dget_type (data_id);
+
+      H5T_class_t type_class = H5Tget_class (type_id);
+      size_t size = H5Tget_size (type_id);
+
+      if (type_class == H5T_INTEGER)
+        {
+          bool is_signed = (H5Tget_sign (type_id) != H5T_SGN_NONE);
+
+          var.class_name = (std::string (is_signed ? "int" : "uint")
+                            + std::to_string (8 * size));
+        }
+      else if (type_class == H5T_FLOAT)
+        var.class_name = (size == 4 ? "single" : "double");
+      else if (type_class == H5T_COMPOUND)
+        {
+          hid_t complex_type = hdf5_make_complex_type (H5T_NATIVE_DOUBLE);
+
+          if (hdf5_types_compatible (type_id, complex_type))
+            {
+              var.class_name = "double";
+              var.is_complex = true;
+            }
+
+          H5Tclose (complex_type);
+        }
+
+      H5Tclose (type_id);
+    }
+
+  hid_t space_id = H5Dget_space (data_id);
+
+  int rank = H5Sget_simple_extent_ndims (space_id);
+
+  if (rank > 0 && ! hdf5_check_attr (data_id, "OCTAVE_EMPTY_MATRIX")
+      && class_to_matfile_type (var.class_name) != mf_unknown)
+    {
+      OCTAVE_LOCAL_BUFFER (hsize_t, hdims, rank);
+
+      H5Sget_simple_extent_dims (space_id, hdims, 0);
+
+      if (rank == 1)
+        var.dims = dim_vector (1, hdims[0]);
+      else
+        {
+          var.dims = dim_vector::alloc (rank);
+          for (int i = 0; i < rank; i++)
+            var.dims(rank-i-1) = hdims[i];
+        }
+
+      var.dims_known = true;
+      var.partial = true;
+    }
+
+  H5Sclose (space_id);
+  H5Dclose (data_id);
+
+  return true;
+}
+
+#endif
+
+std::list<matfile_var>
+matfile_io::variables (void)
+{
+  std::list<matfile_var> retval;
+
+  switch (format)
+    {
+#if defined (HAVE_HDF5)
+    case LS_HDF5:
+      {
+        hsize_t num_obj = 0;
+
+#if defined (HAVE_HDF5_18)
+        hid_t group_id = H5Gopen (file_id, "/", octave_H5P_DEFAULT);
+#else
+        hid_t group_id = H5Gopen (file_id, "/");
+#endif
+        H5Gget_num_objs (group_id, &num_obj);
+        H5Gclose (group_id);
+
+        for (hsize_t i = 0; i < num_obj; i++)
+          {
+            size_t len = H5Gget_objname_by_idx (file_id, i, 0, 0);
+
+            std::string name (len, '\0');
+            H5Gget_objname_by_idx (file_id, i, &name[0], len+1);
+
+            matfile_var var;
+            if (hdf5_var (name, var))
+              retval.push_back (var);
+          }
+      }
+      break;
+#endif
+
+    case LS_BINARY:
+      fs.clear ();
+      fs.seekg (11);
+      retval = scan_binary_file (fs, swap, flt_fmt, file_name);
+      break;
+
+    case LS_MAT5_BINARY:
+      fs.clear ();
+      fs.seekg (128);
+      retval = scan_mat5_file (fs, swap);
+      break;
+
+    default:
+      panic_impossible ();
+    }
+
+  fs.clear ();
+
+  return retval;
+}
+
+bool
+matfile_io::find (const std::string& name, matfile_var& var)
+{
+#if defined (HAVE_HDF5)
+  if (format == LS_HDF5)
+    return hdf5_var (name, var);
+#endif
+
+  // Look up the offset of the variable in the cached index of the file,
+  // and only describe that variable.
+
+  fs.clear ();
+  fs.seekg (format == LS_BINARY ? 11 : 128);
+
+  data_file_index tmp;
+  const data_file_index& index
+    = get_data_file_index (file_name, fs, format, swap, flt_fmt, tmp);
+
+  for (const auto& entry : index)
+    {
+      if (entry.first == name)
+        {
+          fs.clear ();
+          fs.seekg (entry.second);
+
+          if (format == LS_BINARY)
+            read_binary_var (fs, swap, flt_fmt, file_name, "matfile", var);
+          else
+            read_mat5_var (fs, swap, var);
+
+          fs.clear ();
+
+          if (var.name == name)
+            return true;
+
+          // The file has changed since it was indexed.
+
+          forget_data_file_index (file_name);
+
+          break;
+        }
+    }
+
+  for (const auto& v : variables ())
+    {
+      if (v.name == name)
+        {
+          var = v;
+          return true;
+        }
+    }
+
+  return false;
+}
+
+// Keep the index of the file after writing data in place, which leaves
+// the variables at the same offsets.
+
+void
+matfile_io::finish_write (void)
+{
+  if (format == LS_HDF5)
+    return;
+
+  fs.flush ();
+
+  touch_data_file_index (file_name);
+}
+
+matfile_data *
+matfile_io::make_data (const matfile_var& var)
+{
+#if defined (HAVE_HDF5)
+  if (format == LS_HDF5)
+    return new matfile_hdf5_data (file_id, var);
+#endif
+
+  return new matfile_flat_data (fs, var);
+}
+
+// Read the whole value of VAR.
+
+octave_value
+matfile_io::read_value (const matfile_var& var)
+{
+  octave_value retval;
+
+  bool global;
+  std::string doc;
+
+  switch (format)
+    {
+#if defined (HAVE_HDF5)
+    case LS_HDF5:
+      {
+        hdf5_callback_data d;
+
+        if (hdf5_read_next_data (file_id, var.name.c_str (), &d) <= 0)
+          error ("matfile: error reading '%s'", var.name.c_str ());
+
+        retval = d.tc;
+      }
+      break;
+#endif
+
+    case LS_BINARY:
+      fs.seekg (var.pos);
+      read_binary_data (fs, swap, flt_fmt, file_name, global, retval, doc);
+      break;
+
+    case LS_MAT5_BINARY:
+      fs.seekg (var.pos);
+      read_mat5_binary_element (fs, file_name, swap, global, retval);
+      break;
+
+    default:
+      panic_impossible ();
+    }
+
+  return retval;
+}
+
+// Store VAL as the variable NAME, replacing the variable if EXISTS is
+// true.
+
+void
+matfile_io::write_value (const std::string& name, const octave_value& val,
+                         bool exists)
+{
+#if defined (HAVE_HDF5)
+  if (format == LS_HDF5)
+    {
+      if (exists)
+        {
+#if defined (HAVE_HDF5_18)
+          H5Ldelete (file_id, name.c_str (), octave_H5P_DEFAULT);
+#else
+          H5Gunlink (file_id, name.c_str ());
+#endif
+        }
+
+      // Chunked datasets can grow later without being rewritten.
+
+      octave::unwind_protect frame;
+
+      frame.protect_var (Vhdf5_save_options);
+
+      Vhdf5_save_options.chunked = true;
+
+      add_hdf5_data (file_id, val, name, "", false, false);
+
+      return;
+    }
+#endif
+
+  if (exists)
+    error ("matfile: cannot change the size or type of '%s' in %s; use an HDF5 file instead",
+           name.c_str (), file_name.c_str ());
+
+  forget_data_file_index (file_name);
+
+  // New variables are appended.  Data is written in native byte order.
+
+  if (swap)
+    error ("matfile: cannot add variables to %s, which was written on a machine with different byte order",
+           file_name.c_str ());
+
+  fs.clear ();
+  fs.seekp (0, std::ios::end);
+
+  if (format == LS_BINARY)
+    save_binary_data (fs, val, name, "", false, false);
+  else
+    save_mat5_binary_element (fs, val, name, false, false, false);
+
+  fs.flush ();
+
+  if (! fs)
+    error ("matfile: error writing '%s' to %s", name.c_str (),
+           file_name.c_str ());
+}
+
+// Assign RHS to the elements IDX of the variable VAR by reading and
+// storing the whole variable.
+
+void
+matfile_io::rewrite (const matfile_var& var,
+                     const std::list<octave_value_list>& idx,
+                     const octave_value& rhs)
+{
+  if (format != LS_HDF5)
+    error ("matfile: cannot resize or change the type of '%s' in %s; use an HDF5 file instead",
+           var.name.c_str (), file_name.c_str ());
+
+  octave_value val = read_value (var);
+
+  write_value (var.name, val.subsasgn ("(", idx, rhs), true);
+}
+
+octave_value
+matfile_io::read (const std::string& name, const octave_value_list& idx)
+{
+  matfile_var var;
+
+  if (! find (name, var))
+    error ("matfile: variable '%s' not found in %s", name.c_str (),
+           file_name.c_str ());
+
+  if (! var.partial)
+    {
+      octave_value val = read_value (var);
+
+      return (idx.empty () ? val : val.do_index_op (idx));
+    }
+
+  matfile_selection sel;
+  make_selection (var.dims, idx, false, sel);
+
+  std::unique_ptr<matfile_data> data (make_data (var));
+
+  octave_value box = data->read (sel.lo, sel.box);
+
+  if (! sel.contiguous)
+    box = box.do_index_op (octave_value (idx_vector (sel.offsets)));
+
+  return box.reshape (sel.result_dims);
+}
+
+void
+matfile_io::write (const std::string& name, const octave_value& rhs,
+                   const octave_value_list& idx)
+{
+  matfile_var var;
+
+  bool exists = find (name, var);
+
+  if (idx.empty ())
+    {
+      // Replace the whole variable, in place if possible.
+
+      if (exists && var.partial && format != LS_HDF5
+          && rhs.class_name () == var.class_name
+          && rhs.is_complex_type () == var.is_complex
+          && rhs.dims () == var.dims && ! rhs.is_sparse_type ())
+        {
+          std::unique_ptr<matfile_data> data (make_data (var));
+
+          Array<octave_idx_type> lo (dim_vector (var.dims.ndims (), 1), 0);
+
+          data->write (lo, convert_value (rhs, var.class_name,
+                                          var.is_complex));
+
+          finish_write ();
+        }
+      else
+        write_value (name, rhs, exists);
+
+      return;
+    }
+
+  if (! exists)
+    error ("matfile: variable '%s' not found in %s", name.c_str (),
+           file_name.c_str ());
+
+  std::list<octave_value_list> lidx (1, idx);
+
+  // Deleting elements changes the dimensions, and assigning complex
+  // values to a real variable changes its type.
+  bool deleting = (rhs.is_zero_by_zero () && rhs.is_double_type ());
+  bool to_complex = (rhs.is_complex_type () && ! var.is_complex);
+
+  if (! var.partial || deleting || to_complex)
+    {
+      rewrite (var, lidx, rhs);
+      return;
+    }
+
+  // Assignments keep the class of the variable.
+  octave_value val = convert_value (rhs, var.class_name, var.is_complex);
+
+  std::unique_ptr<matfile_data> data (make_data (var));
+
+  matfile_selection sel;
+
+  if (! make_selection (var.dims, idx, true, sel))
+    {
+      // The variable must grow.  Chunked HDF5 datasets are extended in
+      // place; otherwise the variable is rewritten.
+
+      dim_vector new_dims;
+
+      if (! grown_dims (var.dims, idx, new_dims) || ! data->resize (new_dims))
+        {
+          data.reset ();
+
+          rewrite (var, lidx, val);
+          return;
+        }
+
+      var.dims = new_dims;
+
+      make_selection (var.dims, idx, false, sel);
+    }
+
+  octave_idx_type n = sel.result_dims.numel ();
+
+  if (val.numel () != 1)
+    {
+      // Same rules as Array<T>::assign: with a single index, only the
+      // number of elements must agree.  Otherwise the dimensions must
+      // agree, apart from singleton dimensions.
+
+      bool match = (val.numel () == n);
+
+      if (match && idx.length () > 1)
+        {
+          dim_vector rhdv = val.dims ();
+          rhdv.chop_all_singletons ();
+
+          int rhdvl = rhdv.ndims ();
+          int j = 0;
+
+          for (int k = 0; k < sel.result_dims.ndims (); k++)
+            {
+              octave_idx_type l = sel.result_dims(k);
+
+              if (l == 1)
+                continue;
+
+              match = match && j < rhdvl && l == rhdv(j++);
+            }
+
+          match = match && (j == rhdvl || rhdv(j) == 1);
+        }
+
+      if (! match)
+        octave::err_nonconformant ("=", sel.result_dims, val.dims ());
+    }
+
+  if (sel.contiguous)
+    {
+      if (val.numel () != n)
+        {
+          Array<octave_idx_type> zeros (dim_vector (n, 1), 0);
+
+          val = val.do_index_op (octave_value (idx_vector (zeros)));
+        }
+
+      data->write (sel.lo, val.reshape (sel.box));
+    }
+  else
+    {
+      octave_value box = data->read (sel.lo, sel.box);
+
+      if (val.numel () != 1)
+        val = val.reshape (dim_vector (n, 1));
+
+      std::list<octave_value_list>
+        bidx (1, octave_value_list (octave_value (idx_vector (sel.offsets))));
+
+      data->write (sel.lo, box.subsasgn ("(", bidx, val));
+    }
+
+  finish_write ();
+}
+
+DEFUN (__matfile_info__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {@var{s} =} __matfile_info__ (@var{file})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 1)
+    print_usage ();
+
+  std::string file = args(0).xstring_value ("__matfile_info__: FILE must be a string");
+
+  matfile_io io (file, false);
+
+  std::list<matfile_var> vars = io.variables ();
+
+  octave_map retval (dim_vector (vars.size (), 1));
+
+  Cell names (retval.dims ());
+  Cell sizes (retval.dims ());
+  Cell classes (retval.dims ());
+
+  octave_idx_type i = 0;
+
+  for (const auto& var : vars)
+    {
+      names(i) = var.name;
+
+      if (var.dims_known)
+        {
+          int nd = var.dims.ndims ();
+
+          RowVector sz (nd);
+          for (int j = 0; j < nd; j++)
+            sz(j) = var.dims(j);
+
+          sizes(i) = sz;
+        }
+      else
+        sizes(i) = Matrix ();
+
+      classes(i) = var.class_name;
+
+      i++;
+    }
+
+  retval.setfield ("name", names);
+  retval.setfield ("size", sizes);
+  retval.setfield ("class", classes);
+
+  return ovl (retval);
+}
+
+DEFUN (__matfile_read__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {@var{val} =} __matfile_read__ (@var{file}, @var{name}, @var{idx1}, @dots{})
+Undocumented internal function.
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin < 2)
+    print_usage ();
+
+  std::string file = args(0).xstring_value ("__matfile_read__: FILE must be a string");
+  std::string name = args(1).xstring_value ("__matfile_read__: NAME must be a string");
+
+  matfile_io io (file, false);
+
+  return ovl (io.read (name, args.slice (2, nargin - 2)));
+}
+
+DEFUN (__matfile_write__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {} __matfile_write__ (@var{file}, @var{name}, @var{rhs}, @var{idx1}, @dots{})
+Undocumented internal function.
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin < 3)
+    print_usage ();
+
+  std::string file = args(0).xstring_value ("__matfile_write__: FILE must be a string");
+  std::string name = args(1).xstring_value ("__matfile_write__: NAME must be a string");
+
+  if (! valid_identifier (name))
+    error ("__matfile_write__: invalid variable name '%s'", name.c_str ());
+
+  matfile_io io (file, true);
+
+  io.write (name, args(2), args.slice (3, nargin - 3));
+
+  return ovl ();
+}
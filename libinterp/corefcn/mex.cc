@@ -31,6 +31,8 @@ along with Octave; see the file COPYING.  If not, see
 #include <cstring>
 #include <cctype>
 
+#include <algorithm>
+#include <map>
 #include <set>
 
 #include "f77-fcn.h"
@@ -149,7 +151,12 @@ calc_single_subscript_internal (mwSize ndims, const mwSize *dims,
 // happens, we delete this representation, so the conversion can only
 // happen once per call to a MEX file.
 
-static inline void *maybe_mark_foreign (void *ptr);
+class mex;
+
+// Current context.
+extern mex *mex_context;
+
+static inline void *maybe_mark_foreign (void *ptr, size_t n);
 
 class mxArray_octave_value : public mxArray_base
 {
@@ -405,10 +412,19 @@ public:
 
   void *get_data (void) const
   {
-    void *retval = val.mex_get_data ();
+    // The data of full complex values is interleaved, so it can only be
+    // returned by get_complex_data.
+    void *retval = 0;
+
+    if (! (val.is_complex_type () && ! val.is_sparse_type ()))
+      retval = val.mex_get_data ();
 
     if (retval)
-      maybe_mark_foreign (retval);
+      {
+        size_t n = (val.is_sparse_type () ? val.nzmax () : val.numel ());
+
+        maybe_mark_foreign (retval, n * get_element_size ());
+      }
     else
       request_mutation ();
 
@@ -433,14 +449,42 @@ public:
   // Not allowed.
   void set_imag_data (void * /*pi*/) { request_mutation (); }
 
+  void *get_complex_data (void) const
+  {
+    void *retval = 0;
+
+    if (is_numeric () && is_real_type ())
+      retval = 0;
+    else if (val.is_float_type () && ! val.is_sparse_type ())
+      {
+        retval = val.mex_get_data ();
+
+        if (retval)
+          maybe_mark_foreign (retval, 2 * val.numel () * get_element_size ());
+        else
+          request_mutation ();
+      }
+    else
+      request_mutation ();
+
+    return retval;
+  }
+
+  // Not allowed.
+  void set_complex_data (void * /*pc*/) { request_mutation (); }
+
   mwIndex *get_ir (void) const
   {
-    return static_cast<mwIndex *> (maybe_mark_foreign (val.mex_get_ir ()));
+    return static_cast<mwIndex *> (maybe_mark_foreign (val.mex_get_ir (),
+                                                       val.nzmax ()
+                                                       * sizeof (mwIndex)));
   }
 
   mwIndex *get_jc (void) const
   {
-    return static_cast<mwIndex *> (maybe_mark_foreign (val.mex_get_jc ()));
+    return static_cast<mwIndex *> (maybe_mark_foreign (val.mex_get_jc (),
+                                                       (val.columns () + 1)
+                                                       * sizeof (mwIndex)));
   }
 
   mwSize get_nzmax (void) const { return val.nzmax (); }
@@ -1039,55 +1083,51 @@ public:
 
   mxArray_number (mxClassID id_arg, mwSize ndims_arg, const mwSize *dims_arg,
                   mxComplexity flag = mxREAL, bool init = true)
-    : mxArray_matlab (id_arg, ndims_arg, dims_arg),
-      pr (init ? mxArray::calloc (get_number_of_elements (),
-                                  get_element_size ())
-               : mxArray::malloc (get_number_of_elements ()
-                                  * get_element_size ())),
+    : mxArray_matlab (id_arg, ndims_arg, dims_arg), pr_owner (),
+      pr (alloc_data (init)),
       pi (flag == mxCOMPLEX
             ? (init ? mxArray::calloc (get_number_of_elements (),
                                        get_element_size ())
                     : mxArray::malloc (get_number_of_elements ()
                                        * get_element_size ()))
-            : 0) { }
+            : 0),
+      interleaved (false)
+  { }
 
   mxArray_number (mxClassID id_arg, const dim_vector& dv,
                   mxComplexity flag = mxREAL)
-    : mxArray_matlab (id_arg, dv),
-      pr (mxArray::calloc (get_number_of_elements (), get_element_size ())),
+    : mxArray_matlab (id_arg, dv), pr_owner (), pr (alloc_data (true)),
       pi (flag == mxCOMPLEX ? mxArray::calloc (get_number_of_elements (),
                                                get_element_size ())
-                            : 0)
+                            : 0),
+      interleaved (false)
   { }
 
   mxArray_number (mxClassID id_arg, mwSize m, mwSize n,
                   mxComplexity flag = mxREAL, bool init = true)
-    : mxArray_matlab (id_arg, m, n),
-      pr (init ? mxArray::calloc (get_number_of_elements (),
-                                  get_element_size ())
-               : mxArray::malloc (get_number_of_elements ()
-                                  * get_element_size ())),
+    : mxArray_matlab (id_arg, m, n), pr_owner (), pr (alloc_data (init)),
       pi (flag == mxCOMPLEX
             ? (init ? mxArray::calloc (get_number_of_elements (),
                                        get_element_size ())
                     : mxArray::malloc (get_number_of_elements ()
                                        * get_element_size ()))
-            : 0)
+            : 0),
+      interleaved (false)
   { }
 
   mxArray_number (mxClassID id_arg, double val)
-    : mxArray_matlab (id_arg, 1, 1),
+    : mxArray_matlab (id_arg, 1, 1), pr_owner (),
       pr (mxArray::calloc (get_number_of_elements (), get_element_size ())),
-      pi (0)
+      pi (0), interleaved (false)
   {
     double *dpr = static_cast<double *> (pr);
     dpr[0] = val;
   }
 
   mxArray_number (mxClassID id_arg, mxLogical val)
-    : mxArray_matlab (id_arg, 1, 1),
+    : mxArray_matlab (id_arg, 1, 1), pr_owner (),
       pr (mxArray::calloc (get_number_of_elements (), get_element_size ())),
-      pi (0)
+      pi (0), interleaved (false)
   {
     mxLogical *lpr = static_cast<mxLogical *> (pr);
     lpr[0] = val;
@@ -1097,8 +1137,9 @@ public:
     : mxArray_matlab (mxCHAR_CLASS,
                       str ? (strlen (str) ? 1 : 0) : 0,
                       str ? strlen (str) : 0),
+    pr_owner (),
     pr (mxArray::calloc (get_number_of_elements (), get_element_size ())),
-    pi (0)
+    pi (0), interleaved (false)
   {
     mxChar *cpr = static_cast<mxChar *> (pr);
     mwSize nel = get_number_of_elements ();
@@ -1108,9 +1149,9 @@ public:
 
   // FIXME: ???
   mxArray_number (mwSize m, const char **str)
-    : mxArray_matlab (mxCHAR_CLASS, m, max_str_len (m, str)),
+    : mxArray_matlab (mxCHAR_CLASS, m, max_str_len (m, str)), pr_owner (),
       pr (mxArray::calloc (get_number_of_elements (), get_element_size ())),
-      pi (0)
+      pi (0), interleaved (false)
   {
     mxChar *cpr = static_cast<mxChar *> (pr);
 
@@ -1135,16 +1176,18 @@ public:
 protected:
 
   mxArray_number (const mxArray_number& val)
-    : mxArray_matlab (val),
-      pr (mxArray::malloc (get_number_of_elements () * get_element_size ())),
+    : mxArray_matlab (val), pr_owner (),
+      pr (mxArray::malloc (get_number_of_elements () * get_element_size ()
+                           * (val.interleaved ? 2 : 1))),
       pi (val.pi ? mxArray::malloc (get_number_of_elements ()
                                     * get_element_size ())
-                 : 0)
+                 : 0),
+      interleaved (val.interleaved)
   {
     size_t nbytes = get_number_of_elements () * get_element_size ();
 
     if (pr)
-      memcpy (pr, val.pr, nbytes);
+      memcpy (pr, val.pr, interleaved ? 2 * nbytes : nbytes);
 
     if (pi)
       memcpy (pi, val.pi, nbytes);
@@ -1161,11 +1204,13 @@ public:
 
   ~mxArray_number (void)
   {
-    mxFree (pr);
+    if (! pr_is_owned ())
+      mxFree (pr);
+
     mxFree (pi);
   }
 
-  int is_complex (void) const { return pi != 0; }
+  int is_complex (void) const { return pi != 0 || interleaved; }
 
   double get_scalar (void) const
   {
@@ -1228,13 +1273,68 @@ public:
     return retval;
   }
 
-  void *get_data (void) const { return pr; }
+  void *get_data (void) const
+  {
+    if (interleaved)
+      split_complex ();
 
-  void *get_imag_data (void) const { return pi; }
+    return pr;
+  }
 
-  void set_data (void *pr_arg) { pr = pr_arg; }
+  void *get_imag_data (void) const
+  {
+    if (interleaved)
+      split_complex ();
 
-  void set_imag_data (void *pi_arg) { pi = pi_arg; }
+    return pi;
+  }
+
+  void set_data (void *pr_arg)
+  {
+    if (interleaved)
+      split_complex (false, true);
+
+    pr = pr_arg;
+
+    if (! pr_is_owned ())
+      pr_owner = octave_value ();
+  }
+
+  void set_imag_data (void *pi_arg)
+  {
+    if (interleaved)
+      split_complex (true, false);
+
+    pi = pi_arg;
+  }
+
+  void *get_complex_data (void) const
+  {
+    if (pi)
+      interleave_complex ();
+
+    return interleaved ? pr : 0;
+  }
+
+  void set_complex_data (void *pc)
+  {
+    // Storage that was only ever visible to the caller as separate
+    // real and imaginary parts is replaced, not leaked.
+    if (pi)
+      {
+        if (! pr_is_owned ())
+          mxFree (pr);
+
+        mxFree (pi);
+        pi = 0;
+      }
+
+    pr = pc;
+    interleaved = true;
+
+    if (! pr_is_owned ())
+      pr_owner = octave_value ();
+  }
 
   int get_string (char *buf, mwSize buflen) const
   {
@@ -1297,7 +1397,17 @@ public:
 
           double *ppr = static_cast<double *> (pr);
 
-          if (pi)
+          if (interleaved)
+            {
+              ComplexNDArray val (dv);
+
+              const Complex *ppc = static_cast<const Complex *> (pr);
+
+              std::copy (ppc, ppc + nel, val.fortran_vec ());
+
+              retval = val;
+            }
+          else if (pi)
             {
               ComplexNDArray val (dv);
 
@@ -1330,7 +1440,17 @@ public:
 
           float *ppr = static_cast<float *> (pr);
 
-          if (pi)
+          if (interleaved)
+            {
+              FloatComplexNDArray val (dv);
+
+              const FloatComplex *ppc = static_cast<const FloatComplex *> (pr);
+
+              std::copy (ppc, ppc + nel, val.fortran_vec ());
+
+              retval = val;
+            }
+          else if (pi)
             {
               FloatComplexNDArray val (dv);
 
@@ -1417,13 +1537,28 @@ public:
     return retval;
   }
 
+  octave_value as_shared_octave_value (void) const
+  {
+    if (pi || ! pr_is_owned ())
+      return as_octave_value ();
+
+    dim_vector dv = dims_to_dim_vector ();
+
+    if (dv == pr_owner.dims ())
+      return pr_owner;
+    else if (dv.numel () == pr_owner.numel ())
+      return pr_owner.reshape (dv);
+    else
+      return as_octave_value ();
+  }
+
 protected:
 
   template <typename ELT_T, typename ARRAY_T, typename ARRAY_ELT_T>
   octave_value
   int_to_ov (const dim_vector& dv) const
   {
-    if (pi)
+    if (pi || interleaved)
       error ("complex integer types are not supported");
 
     mwSize nel = get_number_of_elements ();
@@ -1442,8 +1577,183 @@ protected:
 
 private:
 
-  void *pr;
-  void *pi;
+  // Allocate the real data of a new array.  Where the element type
+  // matches, use the storage of an Octave array so that the array can
+  // be returned to Octave without copying.
+
+  void *alloc_data (bool init) const
+  {
+    mwSize nel = get_number_of_elements ();
+
+    // Without a MEX context, mxRealloc can't tell such storage from
+    // memory obtained with malloc.
+    if (nel > 0 && mex_context)
+      {
+        switch (get_class_id ())
+          {
+          case mxDOUBLE_CLASS:
+            return alloc_owned<NDArray> (init);
+
+          case mxSINGLE_CLASS:
+            return alloc_owned<FloatNDArray> (init);
+
+          case mxCHAR_CLASS:
+            return alloc_owned<charNDArray> (init);
+
+          case mxINT8_CLASS:
+            return alloc_owned<int8NDArray> (init);
+
+          case mxUINT8_CLASS:
+            return alloc_owned<uint8NDArray> (init);
+
+          case mxINT16_CLASS:
+            return alloc_owned<int16NDArray> (init);
+
+          case mxUINT16_CLASS:
+            return alloc_owned<uint16NDArray> (init);
+
+          case mxINT32_CLASS:
+            return alloc_owned<int32NDArray> (init);
+
+          case mxUINT32_CLASS:
+            return alloc_owned<uint32NDArray> (init);
+
+          case mxINT64_CLASS:
+            return alloc_owned<int64NDArray> (init);
+
+          case mxUINT64_CLASS:
+            return alloc_owned<uint64NDArray> (init);
+
+          default:
+            // Logical values must be normalized to 0 and 1, so they
+            // are always copied.
+            break;
+          }
+      }
+
+    return (init ? mxArray::calloc (nel, get_element_size ())
+                 : mxArray::malloc (nel * get_element_size ()));
+  }
+
+  template <typename ARRAY_T>
+  void *alloc_owned (bool init) const
+  {
+    ARRAY_T a (dims_to_dim_vector ());
+
+    if (init)
+      a.fill (typename ARRAY_T::element_type ());
+
+    pr_owner = octave_value (a);
+
+    // Memory that mxFree must not release.
+    return maybe_mark_foreign (pr_owner.mex_get_data (),
+                               a.numel () * sizeof (*a.data ()));
+  }
+
+  bool pr_is_owned (void) const
+  {
+    return pr_owner.is_defined () && pr == pr_owner.mex_get_data ();
+  }
+
+  // Convert separate real and imaginary parts to interleaved storage.
+
+  void interleave_complex (void) const
+  {
+    mwSize nel = get_number_of_elements ();
+
+    bool old_pr_owned = pr_is_owned ();
+
+    void *pc = 0;
+
+    switch (get_class_id ())
+      {
+      case mxDOUBLE_CLASS:
+        {
+          pc = (nel > 0 ? alloc_owned<ComplexNDArray> (false)
+                        : mxArray::malloc (0));
+
+          Complex *ppc = static_cast<Complex *> (pc);
+          const double *ppr = static_cast<const double *> (pr);
+          const double *ppi = static_cast<const double *> (pi);
+
+          for (mwIndex i = 0; i < nel; i++)
+            ppc[i] = Complex (ppr[i], ppi[i]);
+        }
+        break;
+
+      case mxSINGLE_CLASS:
+        {
+          pc = (nel > 0 ? alloc_owned<FloatComplexNDArray> (false)
+                        : mxArray::malloc (0));
+
+          FloatComplex *ppc = static_cast<FloatComplex *> (pc);
+          const float *ppr = static_cast<const float *> (pr);
+          const float *ppi = static_cast<const float *> (pi);
+
+          for (mwIndex i = 0; i < nel; i++)
+            ppc[i] = FloatComplex (ppr[i], ppi[i]);
+        }
+        break;
+
+      default:
+        error ("complex integer types are not supported");
+      }
+
+    if (! old_pr_owned)
+      mxFree (pr);
+
+    mxFree (pi);
+
+    pr = pc;
+    pi = 0;
+    interleaved = true;
+  }
+
+  // Convert interleaved storage to separate real and imaginary parts.
+  // A part that the caller is about to replace is not extracted.
+
+  void split_complex (bool real_part = true, bool imag_part = true) const
+  {
+    mwSize nel = get_number_of_elements ();
+    size_t nbytes = get_element_size ();
+
+    char *re = (real_part
+                ? static_cast<char *> (mxArray::malloc (nel * nbytes)) : 0);
+    char *im = (imag_part
+                ? static_cast<char *> (mxArray::malloc (nel * nbytes)) : 0);
+
+    const char *pc = static_cast<const char *> (pr);
+
+    for (mwIndex i = 0; i < nel; i++)
+      {
+        if (re)
+          memcpy (re + i*nbytes, pc + 2*i*nbytes, nbytes);
+        if (im)
+          memcpy (im + i*nbytes, pc + (2*i+1)*nbytes, nbytes);
+      }
+
+    if (pr_is_owned ())
+      pr_owner = octave_value ();
+    else
+      mxFree (pr);
+
+    pr = re;
+    pi = im;
+    interleaved = false;
+  }
+
+  // The representation may change between separate and interleaved
+  // complex storage when the data is accessed, so these are mutable.
+
+  // Octave array that owns the memory pointed to by PR, if any.
+  mutable octave_value pr_owner;
+
+  mutable void *pr;
+  mutable void *pi;
+
+  // TRUE if PR holds complex data with interleaved real and imaginary
+  // parts.  PI is NULL in that case.
+  mutable bool interleaved;
 };
 
 // Matlab-style sparse arrays.
@@ -2037,15 +2347,21 @@ mxArray::set_name (const char *name_arg)
 }
 
 octave_value
-mxArray::as_octave_value (const mxArray *ptr)
+mxArray_base::as_shared_octave_value (void) const
 {
-  return ptr ? ptr->as_octave_value () : octave_value (Matrix ());
+  return as_octave_value ();
 }
 
 octave_value
-mxArray::as_octave_value (void) const
+mxArray::as_octave_value (const mxArray *ptr, bool share_data)
 {
-  return rep->as_octave_value ();
+  return ptr ? ptr->as_octave_value (share_data) : octave_value (Matrix ());
+}
+
+octave_value
+mxArray::as_octave_value (bool share_data) const
+{
+  return share_data ? rep->as_shared_octave_value () : rep->as_octave_value ();
 }
 
 void
@@ -2183,7 +2499,20 @@ public:
   {
     void *v;
 
-    if (ptr)
+    std::map<void *, size_t>::iterator pf = foreign_memlist.find (ptr);
+
+    if (ptr && pf != foreign_memlist.end ())
+      {
+        // Memory that belongs to an Octave value was not allocated
+        // with malloc, so copy it instead.  The old block remains
+        // valid for as long as the value that owns it.
+        v = malloc (n);
+
+        memcpy (v, ptr, std::min (n, pf->second));
+
+        foreign_memlist.erase (pf);
+      }
+    else if (ptr)
       {
         v = std::realloc (ptr, n);
 
@@ -2226,10 +2555,10 @@ public:
           }
         else
           {
-            p = foreign_memlist.find (ptr);
+            std::map<void *, size_t>::iterator pf = foreign_memlist.find (ptr);
 
-            if (p != foreign_memlist.end ())
-              foreign_memlist.erase (p);
+            if (pf != foreign_memlist.end ())
+              foreign_memlist.erase (pf);
 #if defined (DEBUG)
             else
               warning ("mxFree: skipping memory not allocated by mxMalloc, mxCalloc, or mxRealloc");
@@ -2277,21 +2606,28 @@ public:
       arraylist.erase (p);
   }
 
-  // Mark a pointer as one we allocated.
-  void mark_foreign (void *ptr)
+  // TRUE if PTR will be freed on exit.
+  bool is_marked_array (mxArray *ptr) const
+  {
+    return arraylist.find (ptr) != arraylist.end ();
+  }
+
+  // Mark a pointer to N bytes as one we know about but did not
+  // allocate.
+  void mark_foreign (void *ptr, size_t n)
   {
 #if defined (DEBUG)
     if (foreign_memlist.find (ptr) != foreign_memlist.end ())
       warning ("%s: double registration ignored", function_name ());
 #endif
 
-    foreign_memlist.insert (ptr);
+    foreign_memlist[ptr] = n;
   }
 
   // Unmark a pointer as one we allocated.
   void unmark_foreign (void *ptr)
   {
-    std::set<void *>::iterator p = foreign_memlist.find (ptr);
+    std::map<void *, size_t>::iterator p = foreign_memlist.find (ptr);
 
     if (p != foreign_memlist.end ())
       foreign_memlist.erase (p);
@@ -2350,8 +2686,8 @@ private:
   std::set<mxArray *> arraylist;
 
   // List of memory resources we know about, but that were allocated
-  // elsewhere.
-  std::set<void *> foreign_memlist;
+  // elsewhere, with their sizes in bytes.
+  std::map<void *, size_t> foreign_memlist;
 
   // The name of the currently executing function.
   mutable char *fname;
@@ -2404,10 +2740,10 @@ mxArray::calloc (size_t n, size_t t)
 }
 
 static inline void *
-maybe_mark_foreign (void *ptr)
+maybe_mark_foreign (void *ptr, size_t n)
 {
   if (mex_context)
-    mex_context->mark_foreign (ptr);
+    mex_context->mark_foreign (ptr, n);
 
   return ptr;
 }
@@ -2900,6 +3236,43 @@ mxGetImagData (const mxArray *ptr)
   return ptr->get_imag_data ();
 }
 
+// Typed data extractors.  Complex data is interleaved.
+mxDouble *
+mxGetDoubles (const mxArray *ptr)
+{
+  if (mxIsDouble (ptr) && ! mxIsComplex (ptr))
+    return static_cast<mxDouble *> (ptr->get_data ());
+  else
+    return NULL;
+}
+
+mxSingle *
+mxGetSingles (const mxArray *ptr)
+{
+  if (mxIsSingle (ptr) && ! mxIsComplex (ptr))
+    return static_cast<mxSingle *> (ptr->get_data ());
+  else
+    return NULL;
+}
+
+mxComplexDouble *
+mxGetComplexDoubles (const mxArray *ptr)
+{
+  if (mxIsDouble (ptr))
+    return static_cast<mxComplexDouble *> (ptr->get_complex_data ());
+  else
+    return NULL;
+}
+
+mxComplexSingle *
+mxGetComplexSingles (const mxArray *ptr)
+{
+  if (mxIsSingle (ptr))
+    return static_cast<mxComplexSingle *> (ptr->get_complex_data ());
+  else
+    return NULL;
+}
+
 // Data setters.
 void
 mxSetPr (mxArray *ptr, double *pr)
@@ -2925,6 +3298,48 @@ mxSetImagData (mxArray *ptr, void *pi)
   ptr->set_imag_data (maybe_unmark (pi));
 }
 
+// Typed data setters.  These return 1 on success and 0 if the class or
+// complexity of the array does not match.
+int
+mxSetDoubles (mxArray *ptr, mxDouble *data)
+{
+  if (! mxIsDouble (ptr) || mxIsComplex (ptr))
+    return 0;
+
+  ptr->set_data (maybe_unmark (data));
+  return 1;
+}
+
+int
+mxSetSingles (mxArray *ptr, mxSingle *data)
+{
+  if (! mxIsSingle (ptr) || mxIsComplex (ptr))
+    return 0;
+
+  ptr->set_data (maybe_unmark (data));
+  return 1;
+}
+
+int
+mxSetComplexDoubles (mxArray *ptr, mxComplexDouble *data)
+{
+  if (! mxIsDouble (ptr) || ! mxIsComplex (ptr))
+    return 0;
+
+  ptr->set_complex_data (maybe_unmark (data));
+  return 1;
+}
+
+int
+mxSetComplexSingles (mxArray *ptr, mxComplexSingle *data)
+{
+  if (! mxIsSingle (ptr) || ! mxIsComplex (ptr))
+    return 0;
+
+  ptr->set_complex_data (maybe_unmark (data));
+  return 1;
+}
+
 // Classes.
 mxClassID
 mxGetClassID (const mxArray *ptr)
@@ -3142,8 +3557,12 @@ call_mex (bool have_fmex, void *f, const octave_value_list& args,
 
   retval.resize (nargout);
 
+  // Arrays that are freed on exit can no longer be modified, so their
+  // data is handed over without copying.
+
   for (int i = 0; i < nargout; i++)
-    retval(i) = mxArray::as_octave_value (argout[i]);
+    retval(i) = mxArray::as_octave_value (argout[i],
+                                          context.is_marked_array (argout[i]));
 
   return retval;
 }
@@ -245,12 +245,26 @@ extern OCTINTERP_API mxLogical *mxGetLogicals (const mxArray *ptr);
 extern OCTINTERP_API void *mxGetData (const mxArray *ptr);
 extern OCTINTERP_API void *mxGetImagData (const mxArray *ptr);
 
+/* Typed data extractors, with interleaved complex data.  */
+extern OCTINTERP_API mxDouble *mxGetDoubles (const mxArray *ptr);
+extern OCTINTERP_API mxSingle *mxGetSingles (const mxArray *ptr);
+extern OCTINTERP_API mxComplexDouble *mxGetComplexDoubles (const mxArray *ptr);
+extern OCTINTERP_API mxComplexSingle *mxGetComplexSingles (const mxArray *ptr);
+
 /* Data setters.  */
 extern OCTINTERP_API void mxSetPr (mxArray *ptr, double *pr);
 extern OCTINTERP_API void mxSetPi (mxArray *ptr, double *pi);
 extern OCTINTERP_API void mxSetData (mxArray *ptr, void *data);
 extern OCTINTERP_API void mxSetImagData (mxArray *ptr, void *pi);
 
+/* Typed data setters, with interleaved complex data.  */
+extern OCTINTERP_API int mxSetDoubles (mxArray *ptr, mxDouble *data);
+extern OCTINTERP_API int mxSetSingles (mxArray *ptr, mxSingle *data);
+extern OCTINTERP_API int mxSetComplexDoubles (mxArray *ptr,
+                                              mxComplexDouble *data);
+extern OCTINTERP_API int mxSetComplexSingles (mxArray *ptr,
+                                              mxComplexSingle *data);
+
 /* Classes.  */
 extern OCTINTERP_API mxClassID mxGetClassID (const mxArray *ptr);
 extern OCTINTERP_API const char *mxGetClassName (const mxArray *ptr);
@@ -124,6 +124,7 @@ COREFCN_SRC = \
   libinterp/corefcn/__magick_read__.cc \
   libinterp/corefcn/__pchip_deriv__.cc \
   libinterp/corefcn/__qp__.cc \
+  libinterp/corefcn/__unique__.cc \
   libinterp/corefcn/balance.cc \
   libinterp/corefcn/besselj.cc \
   libinterp/corefcn/betainc.cc \
@@ -196,6 +197,7 @@ COREFCN_SRC = \
   libinterp/corefcn/lsode.cc \
   libinterp/corefcn/lu.cc \
   libinterp/corefcn/mappers.cc \
+  libinterp/corefcn/matfile.cc \
   libinterp/corefcn/matrix_type.cc \
   libinterp/corefcn/max.cc \
   libinterp/corefcn/mex.cc \
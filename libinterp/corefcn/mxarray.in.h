@@ -84,6 +84,14 @@ typedef char mxChar;
 
 typedef unsigned char mxLogical;
 
+typedef double mxDouble;
+typedef float mxSingle;
+
+/* Element types of complex arrays stored with interleaved real and
+   imaginary parts. */
+typedef struct { mxDouble real; mxDouble imag; } mxComplexDouble;
+typedef struct { mxSingle real; mxSingle imag; } mxComplexSingle;
+
 /*
  * FIXME: Mathworks says mwSize, mwIndex should be int generally.
  * But on 64-bit systems, or when mex -largeArrayDims is used, it is size_t.
@@ -242,6 +250,11 @@ public:
 
   virtual void set_imag_data (void *pi) = 0;
 
+  // Interleaved complex data, or NULL if the array is not complex.
+  virtual void *get_complex_data (void) const { return 0; }
+
+  virtual void set_complex_data (void * /*pc*/) { err_invalid_type (); }
+
   virtual mwIndex *get_ir (void) const = 0;
 
   virtual mwIndex *get_jc (void) const = 0;
@@ -283,6 +296,11 @@ public:
 
   virtual octave_value as_octave_value (void) const = 0;
 
+  // Like as_octave_value, but the result may share the data buffer of
+  // this array instead of copying it.  Only valid if the data of this
+  // array is not modified afterward.
+  virtual octave_value as_shared_octave_value (void) const;
+
 protected:
 
   mxArray_base (const mxArray_base&) { }
@@ -461,6 +479,12 @@ public:
 
   void set_imag_data (void *pi) { DO_VOID_MUTABLE_METHOD (set_imag_data (pi)); }
 
+  void *get_complex_data (void) const
+  { DO_MUTABLE_METHOD (void *, get_complex_data ()); }
+
+  void set_complex_data (void *pc)
+  { DO_VOID_MUTABLE_METHOD (set_complex_data (pc)); }
+
   mwIndex *get_ir (void) const { DO_MUTABLE_METHOD (mwIndex *, get_ir ()); }
 
   mwIndex *get_jc (void) const { DO_MUTABLE_METHOD (mwIndex *, get_jc ()); }
@@ -524,11 +548,12 @@ public:
     return retval;
   }
 
-  static octave_value as_octave_value (const mxArray *ptr);
+  static octave_value as_octave_value (const mxArray *ptr,
+                                       bool share_data = false);
 
 protected:
 
-  octave_value as_octave_value (void) const;
+  octave_value as_octave_value (bool share_data = false) const;
 
 private:
 
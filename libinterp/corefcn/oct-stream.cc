@@ -5525,6 +5525,18 @@ do_printf_string (std::ostream& os, const printf_format_elt *elt,
 static bool
 is_nan_or_inf (const octave_value& val)
 {
+  // Values are passed one element at a time, so avoid creating new
+  // octave_value objects for the common case of real scalars.
+  if (val.is_real_scalar ())
+    {
+      if (! val.is_float_type ())
+        return false;
+
+      double dval = val.double_value ();
+
+      return lo_ieee_isnan (dval) || lo_ieee_isinf (dval);
+    }
+
   octave_value ov_isnan = val.isnan ();
   octave_value ov_isinf = val.isinf ();
 
@@ -51,7 +51,9 @@ octave_link *octave_link::instance = 0;
 
 octave_link::octave_link (void)
   : event_queue_mutex (new octave_mutex ()), gui_event_queue (),
-    debugging (false), link_enabled (true)
+    debugging (false), link_enabled (true), shown_workspace (),
+    shown_workspace_valid (false), shown_top_level (false),
+    shown_debugging (false)
 {
   octave::command_editor::add_event_hook (octave_readline_hook);
 }
@@ -65,10 +67,64 @@ void
 octave_link::set_workspace (void)
 {
   if (enabled ())
-    instance->do_set_workspace ((symbol_table::current_scope ()
-                                 == symbol_table::top_scope ()),
-                                instance->debugging,
-                                symbol_table::workspace_info ());
+    instance->send_workspace ((symbol_table::current_scope ()
+                               == symbol_table::top_scope ()),
+                              symbol_table::workspace_info (), false);
+}
+
+static bool
+same_workspace_element (const workspace_element& a,
+                        const workspace_element& b)
+{
+  return (a.scope () == b.scope () && a.class_name () == b.class_name ()
+          && a.dimension () == b.dimension () && a.value () == b.value ()
+          && a.complex_flag () == b.complex_flag ());
+}
+
+// Send the workspace WS, or only its differences from the workspace
+// last sent unless FULL is true.
+
+void
+octave_link::send_workspace (bool top_level,
+                             const std::list<workspace_element>& ws,
+                             bool full)
+{
+  std::map<std::string, workspace_element> new_workspace;
+
+  for (const auto& elt : ws)
+    new_workspace.insert (std::make_pair (elt.symbol (), elt));
+
+  if (full || ! shown_workspace_valid || top_level != shown_top_level
+      || debugging != shown_debugging)
+    do_set_workspace (top_level, debugging, ws);
+  else
+    {
+      std::list<workspace_element> changed;
+      std::list<std::string> removed;
+
+      for (const auto& elt : ws)
+        {
+          auto p = shown_workspace.find (elt.symbol ());
+
+          if (p == shown_workspace.end ()
+              || ! same_workspace_element (p->second, elt))
+            changed.push_back (elt);
+        }
+
+      for (const auto& nm_elt : shown_workspace)
+        {
+          if (new_workspace.find (nm_elt.first) == new_workspace.end ())
+            removed.push_back (nm_elt.first);
+        }
+
+      if (! (changed.empty () && removed.empty ()))
+        do_update_workspace (top_level, debugging, changed, removed);
+    }
+
+  shown_workspace.swap (new_workspace);
+  shown_workspace_valid = true;
+  shown_top_level = top_level;
+  shown_debugging = debugging;
 }
 
 // OBJ should be an object of a class that is derived from the base
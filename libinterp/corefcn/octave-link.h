@@ -27,13 +27,15 @@ along with Octave; see the file COPYING.  If not, see
 
 #include "octave-config.h"
 
+#include <list>
+#include <map>
 #include <string>
 
 #include "event-queue.h"
+#include "workspace-element.h"
 
 class octave_mutex;
 class string_vector;
-class workspace_element;
 
 // \class OctaveLink
 // \brief Provides threadsafe access to octave.
@@ -238,19 +240,26 @@ public:
       instance->do_execute_command_in_terminal (command);
   }
 
+  // Send only the variables that changed since the workspace was last
+  // sent.
+
   static void set_workspace (void);
 
   static void set_workspace (bool top_level,
                              const std::list<workspace_element>& ws)
   {
     if (enabled ())
-      instance->do_set_workspace (top_level, instance->debugging, ws);
+      instance->send_workspace (top_level, ws, true);
   }
 
   static void clear_workspace (void)
   {
     if (enabled ())
-      instance->do_clear_workspace ();
+      {
+        instance->shown_workspace_valid = false;
+
+        instance->do_clear_workspace ();
+      }
   }
 
   static void set_history (const string_vector& hist)
@@ -373,6 +382,16 @@ protected:
   bool debugging;
   bool link_enabled;
 
+  // The workspace last sent, by variable name, and the state of the
+  // interpreter at that time.
+  std::map<std::string, workspace_element> shown_workspace;
+  bool shown_workspace_valid;
+  bool shown_top_level;
+  bool shown_debugging;
+
+  void send_workspace (bool top_level, const std::list<workspace_element>& ws,
+                       bool full);
+
   void do_generate_events (void);
   void do_process_events (void);
   void do_discard_events (void);
@@ -450,6 +469,13 @@ protected:
   do_set_workspace (bool top_level, bool debug,
                     const std::list<workspace_element>& ws) = 0;
 
+  // Replace or add the variables CHANGED and remove the variables named
+  // REMOVED from the workspace last set.
+  virtual void
+  do_update_workspace (bool top_level, bool debug,
+                       const std::list<workspace_element>& changed,
+                       const std::list<std::string>& removed) = 0;
+
   virtual void do_clear_workspace (void) = 0;
 
   virtual void do_set_history (const string_vector& hist) = 0;
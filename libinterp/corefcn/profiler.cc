@@ -28,6 +28,7 @@ along with Octave; see the file COPYING.  If not, see
 #include <iostream>
 
 #include "defun.h"
+#include "oct-mem-hook.h"
 #include "oct-time.h"
 #include "ov-struct.h"
 #include "pager.h"
@@ -54,7 +55,8 @@ profile_data_accumulator::stats::function_set_value (const function_set& list)
 }
 
 profile_data_accumulator::tree_node::tree_node (tree_node* p, octave_idx_type f)
-  : parent (p), fcn_id (f), children (), time (0.0), calls (0)
+  : active_line (0), parent (p), fcn_id (f), children (), time (0.0),
+    calls (0)
 { }
 
 profile_data_accumulator::tree_node::~tree_node ()
@@ -92,6 +94,16 @@ profile_data_accumulator::tree_node::exit (octave_idx_type /* fcn */)
   return parent;
 }
 
+profile_data_accumulator::line_stats *
+profile_data_accumulator::tree_node::current_line (void) const
+{
+  for (const tree_node* i = this; i; i = i->parent)
+    if (i->active_line)
+      return i->active_line;
+
+  return 0;
+}
+
 void
 profile_data_accumulator::tree_node::build_flat (flat_profile& data) const
 {
@@ -173,7 +185,8 @@ profile_data_accumulator::tree_node::get_hierarchical (double* total) const
 profile_data_accumulator::profile_data_accumulator ()
   : known_functions (), fcn_index (),
     enabled (false), call_tree (new tree_node (0, 0)),
-    active_fcn (0), last_time (-1.0)
+    active_fcn (0), last_time (-1.0), line_data (), line_start_time (-1.0),
+    track_memory (false), live_bytes (0.0), memory_thread ()
 { }
 
 profile_data_accumulator::~profile_data_accumulator ()
@@ -185,6 +198,66 @@ void
 profile_data_accumulator::set_active (bool value)
 {
   enabled = value;
+
+  update_memory_hook ();
+}
+
+void
+profile_data_accumulator::set_memory_tracking (bool value)
+{
+  track_memory = value;
+
+  update_memory_hook ();
+}
+
+void
+profile_data_accumulator::update_memory_hook (void)
+{
+  // The profiler is switched on and off by the interpreter thread, which
+  // is the only thread whose allocations are recorded.
+
+  memory_thread = std::this_thread::get_id ();
+
+  octave::memory_event_hook
+    = (enabled && track_memory ? memory_event : nullptr);
+}
+
+void
+profile_data_accumulator::memory_event (std::ptrdiff_t bytes)
+{
+  profile_data_accumulator& acc = profiler;
+
+  // Arrays allocated on other threads, such as the GUI thread or the
+  // worker threads of parallel loops, are not attributed to any line,
+  // and the statistics are not synchronized.
+
+  if (std::this_thread::get_id () != acc.memory_thread)
+    return;
+
+  // Arrays allocated before tracking started can be released while it
+  // runs.  Their memory was never counted, so the count stops at zero
+  // instead of going negative and hiding later allocations from the
+  // peak.
+
+  acc.live_bytes += bytes;
+
+  if (acc.live_bytes < 0)
+    acc.live_bytes = 0;
+
+  line_stats *line = (acc.active_fcn ? acc.active_fcn->current_line () : 0);
+
+  if (line)
+    {
+      line_stats& entry = *line;
+
+      if (bytes > 0)
+        entry.alloc_bytes += bytes;
+      else
+        entry.freed_bytes -= bytes;
+
+      if (acc.live_bytes > entry.peak_bytes)
+        entry.peak_bytes = acc.live_bytes;
+    }
 }
 
 void
@@ -214,7 +287,10 @@ profile_data_accumulator::enter_function (const std::string& fcn)
   if (! active_fcn)
     active_fcn = call_tree;
 
+  add_line_time (query_time ());
+
   active_fcn = active_fcn->enter (fcn_idx);
+  active_fcn->active_line = 0;
 
   last_time = query_time ();
 
@@ -234,7 +310,10 @@ profile_data_accumulator::exit_function (const std::string& fcn)
       // call disabling the profiler is an exception.  So also check here
       // and only record the time if enabled.
       if (is_active ())
-        add_current_time ();
+        {
+          add_current_time ();
+          add_line_time (query_time ());
+        }
 
       fcn_index_map::iterator pos = fcn_index.find (fcn);
       // FIXME: This assert statements doesn't make sense if profile() is called
@@ -245,6 +324,7 @@ profile_data_accumulator::exit_function (const std::string& fcn)
       // If this was an "inner call", we resume executing the parent function
       // up the stack.  So note the start-time for this!
       last_time = query_time ();
+      line_start_time = last_time;
     }
 }
 
@@ -256,6 +336,7 @@ profile_data_accumulator::reset (void)
 
   known_functions.clear ();
   fcn_index.clear ();
+  line_data.clear ();
 
   if (call_tree)
     {
@@ -265,6 +346,8 @@ profile_data_accumulator::reset (void)
     }
 
   last_time = -1.0;
+  line_start_time = -1.0;
+  live_bytes = 0.0;
 }
 
 octave_value
@@ -355,6 +438,47 @@ profile_data_accumulator::get_hierarchical (void) const
   return retval;
 }
 
+octave_value
+profile_data_accumulator::get_lines (void) const
+{
+  const octave_idx_type n = line_data.size ();
+
+  Cell rv_indices (n, 1);
+  Cell rv_lines (n, 1);
+  Cell rv_times (n, 1);
+  Cell rv_calls (n, 1);
+  Cell rv_alloc (n, 1);
+  Cell rv_freed (n, 1);
+  Cell rv_peak (n, 1);
+
+  octave_idx_type i = 0;
+  for (const auto& key_stats : line_data)
+    {
+      rv_indices(i) = octave_value (key_stats.first.first);
+      rv_lines(i) = octave_value (key_stats.first.second);
+      rv_times(i) = octave_value (key_stats.second.time);
+      rv_calls(i) = octave_value (key_stats.second.calls);
+      rv_alloc(i) = octave_value (key_stats.second.alloc_bytes);
+      rv_freed(i) = octave_value (key_stats.second.freed_bytes);
+      rv_peak(i) = octave_value (key_stats.second.peak_bytes);
+
+      ++i;
+    }
+  assert (i == n);
+
+  octave_map retval (dim_vector (n, 1));
+
+  retval.assign ("Index", rv_indices);
+  retval.assign ("Line", rv_lines);
+  retval.assign ("TotalTime", rv_times);
+  retval.assign ("NumCalls", rv_calls);
+  retval.assign ("AllocatedBytes", rv_alloc);
+  retval.assign ("FreedBytes", rv_freed);
+  retval.assign ("PeakBytes", rv_peak);
+
+  return retval;
+}
+
 double
 profile_data_accumulator::query_time (void) const
 {
@@ -378,6 +502,34 @@ profile_data_accumulator::add_current_time (void)
     }
 }
 
+void
+profile_data_accumulator::do_enter_statement (int line)
+{
+  // Statements at the top level are not attributed to any function.
+  if (! active_fcn || active_fcn == call_tree)
+    return;
+
+  add_line_time (query_time ());
+
+  line_stats& entry
+    = line_data[line_key (active_fcn->function_index (), line)];
+
+  ++entry.calls;
+
+  active_fcn->active_line = &entry;
+}
+
+void
+profile_data_accumulator::add_line_time (double t)
+{
+  line_stats *line = (active_fcn ? active_fcn->current_line () : 0);
+
+  if (line)
+    line->time += t - line_start_time;
+
+  line_start_time = t;
+}
+
 profile_data_accumulator profiler;
 
 // Enable or disable the profiler data collection.
@@ -389,13 +541,16 @@ Undocumented internal function.
 {
   int nargin = args.length ();
 
-  if (nargin > 1)
+  if (nargin > 2)
     print_usage ();
 
+  if (nargin > 1)
+    profiler.set_memory_tracking (args(1).bool_value ());
+
   if (nargin > 0)
     profiler.set_active (args(0).bool_value ());
 
-  return ovl (profiler.is_active ());
+  return ovl (profiler.is_active (), profiler.is_tracking_memory ());
 }
 
 // Clear all collected profiling data.
@@ -423,7 +578,10 @@ Undocumented internal function.
   if (args.length () > 0)
     warning ("profiler_data: ignoring extra arguments");
 
-  if (nargout > 1)
+  if (nargout > 2)
+    return ovl (profiler.get_flat (), profiler.get_hierarchical (),
+                profiler.get_lines ());
+  else if (nargout > 1)
     return ovl (profiler.get_flat (), profiler.get_hierarchical ());
   else
     return ovl (profiler.get_flat ());
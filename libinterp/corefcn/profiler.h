@@ -30,6 +30,8 @@ along with Octave; see the file COPYING.  If not, see
 #include <map>
 #include <set>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 class octave_value;
@@ -98,13 +100,50 @@ public:
   bool is_active (void) const { return enabled; }
   void set_active (bool);
 
+  // Whether allocations of array data are attributed to lines while the
+  // profiler is active.
+  bool is_tracking_memory (void) const { return track_memory; }
+  void set_memory_tracking (bool);
+
   void reset (void);
 
+  // Note that execution of the statement on line LINE of the active
+  // function is starting.  This is called for every statement, so the
+  // check for an inactive profiler is kept inline.
+  void enter_statement (int line)
+  {
+    if (enabled)
+      do_enter_statement (line);
+  }
+
   octave_value get_flat (void) const;
   octave_value get_hierarchical (void) const;
+  octave_value get_lines (void) const;
 
 private:
 
+  // Time spent and number of executions of one line of a function.
+  struct line_stats
+  {
+    line_stats ()
+      : time (0.0), calls (0), alloc_bytes (0.0), freed_bytes (0.0),
+        peak_bytes (0.0)
+    { }
+
+    double time;
+    unsigned calls;
+
+    // Array memory allocated and released while executing the line,
+    // and the largest amount of live array memory seen meanwhile.
+    double alloc_bytes;
+    double freed_bytes;
+    double peak_bytes;
+  };
+
+  // Line statistics are keyed by function index and line number.
+  typedef std::pair<octave_idx_type, int> line_key;
+  typedef std::map<line_key, line_stats> line_map;
+
   // One entry in the flat profile (i.e., a collection of data for a single
   // function).  This is filled in when building the flat profile from the
   // hierarchical call tree.
@@ -155,6 +194,17 @@ private:
 
     void build_flat (flat_profile&) const;
 
+    octave_idx_type function_index (void) const { return fcn_id; }
+
+    // The line currently executing in the most recent activation of this
+    // node, or 0 if no statement has started yet.
+    line_stats *active_line;
+
+    // The active line of the innermost user function or script on the
+    // path to this node.  Built-in functions and operators have no lines
+    // of their own, so their time is charged to the line calling them.
+    line_stats *current_line (void) const;
+
     // Get the hierarchical profile for this node and its children.  If total
     // is set, accumulate total time of the subtree in that variable as
     // additional return value.
@@ -192,6 +242,21 @@ private:
   // Store last timestamp we had, when the currently active function was called.
   double last_time;
 
+  line_map line_data;
+
+  // Timestamp at which the active line of the active function started or
+  // resumed executing.
+  double line_start_time;
+
+  bool track_memory;
+
+  // Array memory allocated and not yet released since memory tracking
+  // started.  This is never negative.
+  double live_bytes;
+
+  // The thread whose array allocations are recorded.
+  std::thread::id memory_thread;
+
   // These are private as only the unwind-protecting inner class enter
   // should be allowed to call them.
   void enter_function (const std::string&);
@@ -207,6 +272,17 @@ private:
   // This is called from two different positions, thus it is useful to have
   // it as a seperate function.
   void add_current_time (void);
+
+  void do_enter_statement (int line);
+
+  // Install or remove the liboctave memory hook as needed.
+  void update_memory_hook (void);
+
+  static void memory_event (std::ptrdiff_t bytes);
+
+  // Add the time elapsed since line_start_time to the current line of the
+  // active function, and restart the line timer at T.
+  void add_line_time (double t);
 };
 
 // The instance used.
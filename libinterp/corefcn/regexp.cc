@@ -1280,20 +1280,22 @@ for details on the syntax of the search pattern.
 %!assert (regexpi ("\n", "\n"), 1)
 */
 
-static octave_value
-octregexprep (const octave_value_list &args, const std::string &who)
+// Extract the pattern, the replacement, and the options from the
+// arguments of regexprep.
+
+static void
+parse_regexprep_args (const octave_value_list& args, const std::string& who,
+                      std::string& pattern, std::string& replacement,
+                      octave::regexp::opts& options)
 {
   int nargin = args.length ();
 
-  // Make sure we have string, pattern, replacement
-  const std::string buffer = args(0).string_value ();
-
-  std::string pattern = args(1).string_value ();
+  pattern = args(1).string_value ();
 
   // Rewrite pattern for PCRE
   pattern = do_regexp_ptn_string_escapes (pattern, args(1).is_sq_string ());
 
-  std::string replacement = args(2).string_value ();
+  replacement = args(2).string_value ();
 
   // Matlab compatibility.
   if (args(2).is_sq_string ())
@@ -1316,9 +1318,21 @@ octregexprep (const octave_value_list &args, const std::string &who)
     }
   regexpargs.resize (len);
 
-  octave::regexp::opts options;
   bool extra_args = false;
   parse_options (options, regexpargs, who, 0, extra_args);
+}
+
+static octave_value
+octregexprep (const octave_value_list &args, const std::string &who)
+{
+  // Make sure we have string, pattern, replacement
+  const std::string buffer = args(0).string_value ();
+
+  std::string pattern;
+  std::string replacement;
+  octave::regexp::opts options;
+
+  parse_regexprep_args (args, who, pattern, replacement, options);
 
   return octave::regexp::replace (pattern, buffer, replacement, options, who);
 }
@@ -1368,7 +1382,35 @@ function.
 
   octave_value_list retval;
 
-  if (args(0).is_cell () || args(1).is_cell () || args(2).is_cell ())
+  if (args(0).is_cellstr () && args(1).is_string () && args(2).is_string ())
+    {
+      // Compile the pattern only once, and return the results in a
+      // compact cellstr.
+
+      std::string pattern;
+      std::string replacement;
+      octave::regexp::opts options;
+
+      parse_regexprep_args (args, "regexprep", pattern, replacement, options);
+
+      octave::regexp rx (pattern, options, "regexprep");
+
+      const octave::string_array str = args(0).string_array_value ();
+      octave_idx_type n = str.numel ();
+
+      std::string chars;
+      Array<octave_idx_type> offsets (dim_vector (n + 1, 1));
+      offsets.xelem (0) = 0;
+
+      for (octave_idx_type i = 0; i < n; i++)
+        {
+          chars += rx.replace (str(i), replacement);
+          offsets.xelem (i+1) = chars.length ();
+        }
+
+      retval = ovl (octave::string_array (str.dims (), chars, offsets));
+    }
+  else if (args(0).is_cell () || args(1).is_cell () || args(2).is_cell ())
     {
       Cell str, pat, rep;
       dim_vector dv0;
@@ -1485,6 +1527,8 @@ function.
 %!assert (regexprep ("abc", {"b","a"}, "?"), "??c")
 %!assert (regexprep ({"abc","cba"}, "b", "?"), {"a?c","c?a"})
 %!assert (regexprep ({"abc","cba"}, {"b","a"}, {"?","!"}), {"!?c","c?!"})
+%!assert (regexprep ({"aaa"; "ba"; ""}, "a", "X", "once"), {"Xaa"; "bX"; ""})
+%!assert (regexprep (cellstr (["a1 "; "b22"]), '(\d+)', '<$1>'), {"a<1>"; "b<22>"})
 
 # Nasty lookbehind expression
 %!test
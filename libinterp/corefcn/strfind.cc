@@ -34,6 +34,7 @@ along with Octave; see the file COPYING.  If not, see
 
 #include "Cell.h"
 #include "ov.h"
+#include "ov-lazy-cellstr.h"
 #include "defun.h"
 #include "unwind-prot.h"
 #include "errwarn.h"
@@ -59,27 +60,22 @@ qs_preprocess (const Array<char>& needle,
     table[ORD(x[i])] = m - i;
 }
 
-static Array<octave_idx_type>
-qs_search (const Array<char>& needle,
-           const Array<char>& haystack,
-           const octave_idx_type *table,
-           bool overlaps = true)
-{
-  const char *x = needle.data ();
-  octave_idx_type m = needle.numel ();
-  const char *y = haystack.data ();
-  octave_idx_type n = haystack.numel ();
+// Call FOUND with the position of each occurrence of the M characters
+// at X in the N characters at Y, in increasing order.
 
-  // We'll use deque because it typically has the most favorable properties for
-  // the operation we need.
-  std::deque<octave_idx_type> accum;
+template <typename F>
+static void
+qs_search_each (const char *x, octave_idx_type m,
+                const char *y, octave_idx_type n,
+                const octave_idx_type *table, bool overlaps, F found)
+{
   if (m == 1)
     {
       // Looking for a single character.
       for (octave_idx_type i = 0; i < n; i++)
         {
           if (y[i] == x[0])
-            accum.push_back (i);
+            found (i);
         }
     }
   else if (m == 2)
@@ -90,7 +86,7 @@ qs_search (const Array<char>& needle,
           for (octave_idx_type i = 0; i < n-1; i++)
             {
               if (y[i] == x[0] && y[i+1] == x[1])
-                accum.push_back (i);
+                found (i);
             }
         }
       else
@@ -98,7 +94,7 @@ qs_search (const Array<char>& needle,
           for (octave_idx_type i = 0; i < n-1; i++)
             {
               if (y[i] == x[0] && y[i+1] == x[1])
-                accum.push_back (i++);
+                found (i++);
             }
         }
     }
@@ -112,7 +108,7 @@ qs_search (const Array<char>& needle,
           while (j < n - m)
             {
               if (std::equal (x, x + m, y + j))
-                accum.push_back (j);
+                found (j);
               j += table[ORD(y[j + m])];
             }
         }
@@ -122,7 +118,7 @@ qs_search (const Array<char>& needle,
             {
               if (std::equal (x, x + m, y + j))
                 {
-                  accum.push_back (j);
+                  found (j);
                   j += m;
                 }
               else
@@ -131,8 +127,22 @@ qs_search (const Array<char>& needle,
         }
 
       if (j == n - m && std::equal (x, x + m, y + j))
-        accum.push_back (j);
+        found (j);
     }
+}
+
+static Array<octave_idx_type>
+qs_search (const Array<char>& needle,
+           const char *y, octave_idx_type n,
+           const octave_idx_type *table,
+           bool overlaps = true)
+{
+  // We'll use deque because it typically has the most favorable properties for
+  // the operation we need.
+  std::deque<octave_idx_type> accum;
+
+  qs_search_each (needle.data (), needle.numel (), y, n, table, overlaps,
+                  [&accum] (octave_idx_type i) { accum.push_back (i); });
 
   octave_idx_type nmatch = accum.size ();
   octave_idx_type one = 1;
@@ -144,6 +154,16 @@ qs_search (const Array<char>& needle,
   return result;
 }
 
+static Array<octave_idx_type>
+qs_search (const Array<char>& needle,
+           const Array<char>& haystack,
+           const octave_idx_type *table,
+           bool overlaps = true)
+{
+  return qs_search (needle, haystack.data (), haystack.numel (), table,
+                    overlaps);
+}
+
 DEFUN (strfind, args, ,
        doc: /* -*- texinfo -*-
 @deftypefn  {} {@var{idx} =} strfind (@var{str}, @var{pattern})
@@ -227,6 +247,28 @@ strfind (@{"abababa", "bebebe", "ab"@}, "aba")
                                             argstr.char_array_value (),
                                             table, overlaps),
                                  true, true);
+      else if (argstr.type_id () == octave_lazy_cellstr::static_type_id ())
+        {
+          // Search the packed strings.  Each element of a compact cellstr
+          // is a single row.  Ordinary cells are searched below, so that
+          // char matrix elements are searched in column-major order.
+          const octave::string_array strs = argstr.string_array_value ();
+          Cell retc (strs.dims ());
+          octave_idx_type ns = strs.numel ();
+
+          for (octave_idx_type i = 0; i < ns; i++)
+            {
+              if (argpat.is_empty ())
+                retc(i) = Matrix ();
+              else
+                retc(i) = octave_value (qs_search (needle, strs.data (i),
+                                                   strs.length (i),
+                                                   table, overlaps),
+                                        true, true);
+            }
+
+          retval = retc;
+        }
       else if (argstr.is_cell ())
         {
           const Cell argsc = argstr.cell_value ();
@@ -269,6 +311,9 @@ strfind (@{"abababa", "bebebe", "ab"@}, "aba")
 %!assert (strfind ("abc", ""), [])
 %!assert (strfind ("abc", {"", "b", ""}), {[], 2, []})
 %!assert (strfind ({"abc", "def"}, ""), {[], []})
+%!assert (strfind (cellstr (["abcb"; "bbbb"]), "bb"), {[]; [1, 2, 3]})
+%!assert (strfind ({["abc"; "bcd"], "xbc"}, "bc"), {3, 2})
+%!assert (strfind ({["abc"; "bcd"]; "bc"}, "b"), {[2, 3]; 1})
 
 %!error strfind ()
 %!error strfind ("foo", "bar", 1)
@@ -347,6 +392,33 @@ qs_replace (const Array<char>& str, const Array<char>& pat,
   return ret;
 }
 
+// Append the N characters at SRC to DEST, with all occurrences of PAT
+// replaced by REP.  The result is the same as that of qs_replace.
+
+static void
+qs_replace_append (std::string& dest, const char *src, octave_idx_type n,
+                   const Array<char>& pat, const Array<char>& rep,
+                   const octave_idx_type *table, bool overlaps)
+{
+  octave_idx_type psiz = pat.numel ();
+  octave_idx_type rsiz = rep.numel ();
+  const char *reps = rep.data ();
+
+  octave_idx_type k = 0;
+
+  if (psiz != 0)
+    qs_search_each (pat.data (), psiz, src, n, table, overlaps,
+                    [&] (octave_idx_type j)
+                    {
+                      if (j >= k)
+                        dest.append (src + k, j - k);
+                      dest.append (reps, rsiz);
+                      k = j + psiz;
+                    });
+
+  dest.append (src + k, n - k);
+}
+
 DEFUN (strrep, args, ,
        doc: /* -*- texinfo -*-
 @deftypefn  {} {@var{newstr} =} strrep (@var{str}, @var{ptn}, @var{rep})
@@ -410,6 +482,27 @@ strrep ("This is a test string", "is", "&%$")
       if (argstr.is_string ())
         retval = qs_replace (argstr.char_array_value (), pat, rep,
                              table, overlaps);
+      else if (argstr.type_id () == octave_lazy_cellstr::static_type_id ())
+        {
+          // Keep the result packed like the argument.
+          const octave::string_array strs = argstr.string_array_value ();
+          octave_idx_type ns = strs.numel ();
+
+          std::string chars;
+          chars.reserve (strs.chars ().numel ());
+
+          Array<octave_idx_type> offsets (dim_vector (ns + 1, 1));
+          offsets.xelem (0) = 0;
+
+          for (octave_idx_type i = 0; i < ns; i++)
+            {
+              qs_replace_append (chars, strs.data (i), strs.length (i),
+                                 pat, rep, table, overlaps);
+              offsets.xelem (i+1) = chars.length ();
+            }
+
+          retval = octave::string_array (strs.dims (), chars, offsets);
+        }
       else if (argstr.is_cell ())
         {
           const Cell argsc = argstr.cell_value ();
@@ -447,6 +540,14 @@ strrep ("This is a test string", "is", "&%$")
 
 %!assert (size (strrep ("a", "a", "")), [0 0])
 
+%!test
+%! c = strrep (cellstr (["abab"; "cd  "; "ab  "]), "ab", "x");
+%! assert (c, {"xx"; "cd"; "x"});
+%! c = strrep (c, "x", "");
+%! assert (c, {""; "cd"; ""});
+%! assert (size (c{1}), [0, 0]);
+%! assert (strrep (cellstr ("aaa"), "aa", "b"), {"bb"});
+
 %!error strrep ()
 %!error strrep ("foo", "bar", 3, 4)
 */
@@ -24,6 +24,7 @@ along with Octave; see the file COPYING.  If not, see
 #  include "config.h"
 #endif
 
+#include <algorithm>
 #include <cctype>
 
 #include <queue>
@@ -310,13 +311,68 @@ Return true if @var{x} is a character array.
 %!error ischar ("test", 1)
 */
 
+// Compare the LEN1 characters at S1 with the LEN2 characters at S2, in
+// the same way as the std::string specializations of the functions in
+// octave::string.  N is ignored by strcmp and strcmpi.
+
+typedef bool (*str_cmp_fcn) (const char *, octave_idx_type,
+                             const char *, octave_idx_type, octave_idx_type);
+
+static bool
+strcmp_str (const char *s1, octave_idx_type len1,
+            const char *s2, octave_idx_type len2, octave_idx_type)
+{
+  return len1 == len2 && std::equal (s1, s1 + len1, s2);
+}
+
+static bool
+strcmpi_str (const char *s1, octave_idx_type len1,
+             const char *s2, octave_idx_type len2, octave_idx_type)
+{
+  if (len1 != len2)
+    return false;
+
+  for (octave_idx_type i = 0; i < len1; i++)
+    if (std::tolower (s1[i]) != std::tolower (s2[i]))
+      return false;
+
+  return true;
+}
+
+static bool
+strncmp_str (const char *s1, octave_idx_type len1,
+             const char *s2, octave_idx_type len2, octave_idx_type n)
+{
+  return len1 >= n && len2 >= n && std::equal (s1, s1 + n, s2);
+}
+
+static bool
+strncmpi_str (const char *s1, octave_idx_type len1,
+              const char *s2, octave_idx_type len2, octave_idx_type n)
+{
+  return len1 >= n && len2 >= n && strcmpi_str (s1, n, s2, n, n);
+}
+
+// Compare each element of the cellstr STRS with the LEN characters at S.
+
+static void
+strcmp_cellstr (boolNDArray& output, const octave::string_array& strs,
+                const char *s, octave_idx_type len, octave_idx_type n,
+                str_cmp_fcn str_op)
+{
+  bool *out = output.fortran_vec ();
+  octave_idx_type nel = strs.numel ();
+
+  for (octave_idx_type i = 0; i < nel; i++)
+    out[i] = str_op (strs.data (i), strs.length (i), s, len, n);
+}
+
 static octave_value
 do_strcmp_fun (const octave_value& arg0, const octave_value& arg1,
                octave_idx_type n, const char *fcn_name,
                bool (*array_op) (const Array<char>&, const Array<char>&,
                                  octave_idx_type),
-               bool (*str_op) (const std::string&, const std::string&,
-                               std::string::size_type))
+               str_cmp_fcn str_op)
 
 {
   octave_value retval;
@@ -326,6 +382,9 @@ do_strcmp_fun (const octave_value& arg0, const octave_value& arg1,
   bool s2_string = arg1.is_string ();
   bool s2_cell = arg1.is_cell ();
 
+  // Cell arrays of strings are compared in their packed form, without
+  // extracting each element.
+
   if (s1_string && s2_string)
     retval = array_op (arg0.char_array_value (), arg1.char_array_value (), n);
   else if ((s1_string && s2_cell) || (s1_cell && s2_string))
@@ -343,7 +402,6 @@ do_strcmp_fun (const octave_value& arg0, const octave_value& arg1,
           cell_val = arg0;
         }
 
-      const Cell cell = cell_val.cell_value ();
       const string_vector str = str_val.string_vector_value ();
       octave_idx_type r = str.numel ();
 
@@ -356,18 +414,20 @@ do_strcmp_fun (const octave_value& arg0, const octave_value& arg1,
           std::string s = r == 0 ? "" : str[0];
 
           if (cell_val.is_cellstr ())
-            {
-              const Array<std::string> cellstr = cell_val.cellstr_value ();
-              for (octave_idx_type i = 0; i < cellstr.numel (); i++)
-                output(i) = str_op (cellstr(i), s, n);
-            }
+            strcmp_cellstr (output, cell_val.string_array_value (),
+                            s.data (), s.length (), n, str_op);
           else
             {
               // FIXME: should we warn here?
+              const Cell cell = cell_val.cell_value ();
               for (octave_idx_type i = 0; i < cell.numel (); i++)
                 {
                   if (cell(i).is_string ())
-                    output(i) = str_op (cell(i).string_value (), s, n);
+                    {
+                      const std::string str1 = cell(i).string_value ();
+                      output(i) = str_op (str1.data (), str1.length (),
+                                          s.data (), s.length (), n);
+                    }
                 }
             }
 
@@ -375,19 +435,22 @@ do_strcmp_fun (const octave_value& arg0, const octave_value& arg1,
         }
       else if (r > 1)
         {
-          if (cell.numel () == 1)
+          if (cell_val.numel () == 1)
             {
               // Broadcast the cell.
 
               const dim_vector dv (r, 1);
               boolNDArray output (dv, false);
 
+              const Cell cell = cell_val.cell_value ();
+
               if (cell(0).is_string ())
                 {
                   const std::string str2 = cell(0).string_value ();
 
                   for (octave_idx_type i = 0; i < r; i++)
-                    output(i) = str_op (str[i], str2, n);
+                    output(i) = str_op (str[i].data (), str[i].length (),
+                                        str2.data (), str2.length (), n);
                 }
 
               retval = output;
@@ -396,25 +459,33 @@ do_strcmp_fun (const octave_value& arg0, const octave_value& arg1,
             {
               // Must match in all dimensions.
 
-              boolNDArray output (cell.dims (), false);
+              boolNDArray output (cell_val.dims (), false);
 
-              if (cell.numel () == r)
+              if (cell_val.numel () == r)
                 {
                   if (cell_val.is_cellstr ())
                     {
-                      const Array<std::string> cellstr
-                        = cell_val.cellstr_value ();
-                      for (octave_idx_type i = 0; i < cellstr.numel (); i++)
-                        output(i) = str_op (str[i], cellstr(i), n);
+                      const octave::string_array strs
+                        = cell_val.string_array_value ();
+                      for (octave_idx_type i = 0; i < r; i++)
+                        output(i) = str_op (str[i].data (), str[i].length (),
+                                            strs.data (i), strs.length (i),
+                                            n);
                     }
                   else
                     {
                       // FIXME: should we warn here?
+                      const Cell cell = cell_val.cell_value ();
                       for (octave_idx_type i = 0; i < r; i++)
                         {
                           if (cell(i).is_string ())
-                            output(i) = str_op (str[i],
-                                                cell(i).string_value (), n);
+                            {
+                              const std::string str2 = cell(i).string_value ();
+                              output(i) = str_op (str[i].data (),
+                                                  str[i].length (),
+                                                  str2.data (),
+                                                  str2.length (), n);
+                            }
                         }
                     }
 
@@ -443,13 +514,11 @@ do_strcmp_fun (const octave_value& arg0, const octave_value& arg1,
           cell2_val = arg1;
         }
 
-      const Cell cell1 = cell1_val.cell_value ();
-      const Cell cell2 = cell2_val.cell_value ();
-      r1 = cell1.numel ();
-      r2 = cell2.numel ();
+      r1 = cell1_val.numel ();
+      r2 = cell2_val.numel ();
 
-      const dim_vector size1 = cell1.dims ();
-      const dim_vector size2 = cell2.dims ();
+      const dim_vector size1 = cell1_val.dims ();
+      const dim_vector size2 = cell2_val.dims ();
 
       boolNDArray output (size1, false);
 
@@ -457,25 +526,26 @@ do_strcmp_fun (const octave_value& arg0, const octave_value& arg1,
         {
           // Broadcast cell2.
 
+          const Cell cell2 = cell2_val.cell_value ();
+
           if (cell2(0).is_string ())
             {
               const std::string str2 = cell2(0).string_value ();
 
               if (cell1_val.is_cellstr ())
-                {
-                  const Array<std::string> cellstr = cell1_val.cellstr_value ();
-                  for (octave_idx_type i = 0; i < cellstr.numel (); i++)
-                    output(i) = str_op (cellstr(i), str2, n);
-                }
+                strcmp_cellstr (output, cell1_val.string_array_value (),
+                                str2.data (), str2.length (), n, str_op);
               else
                 {
                   // FIXME: should we warn here?
+                  const Cell cell1 = cell1_val.cell_value ();
                   for (octave_idx_type i = 0; i < r1; i++)
                     {
                       if (cell1(i).is_string ())
                         {
                           const std::string str1 = cell1(i).string_value ();
-                          output(i) = str_op (str1, str2, n);
+                          output(i) = str_op (str1.data (), str1.length (),
+                                              str2.data (), str2.length (), n);
                         }
                     }
                 }
@@ -486,23 +556,29 @@ do_strcmp_fun (const octave_value& arg0, const octave_value& arg1,
           if (size1 != size2)
             error ("%s: nonconformant cell arrays", fcn_name);
 
-          if (cell1.is_cellstr () && cell2.is_cellstr ())
+          if (cell1_val.is_cellstr () && cell2_val.is_cellstr ())
             {
-              const Array<std::string> cellstr1 = cell1_val.cellstr_value ();
-              const Array<std::string> cellstr2 = cell2_val.cellstr_value ();
+              const octave::string_array strs1
+                = cell1_val.string_array_value ();
+              const octave::string_array strs2
+                = cell2_val.string_array_value ();
               for (octave_idx_type i = 0; i < r1; i++)
-                output (i) = str_op (cellstr1(i), cellstr2(i), n);
+                output (i) = str_op (strs1.data (i), strs1.length (i),
+                                     strs2.data (i), strs2.length (i), n);
             }
           else
             {
               // FIXME: should we warn here?
+              const Cell cell1 = cell1_val.cell_value ();
+              const Cell cell2 = cell2_val.cell_value ();
               for (octave_idx_type i = 0; i < r1; i++)
                 {
                   if (cell1(i).is_string () && cell2(i).is_string ())
                     {
                       const std::string str1 = cell1(i).string_value ();
                       const std::string str2 = cell2(i).string_value ();
-                      output(i) = str_op (str1, str2, n);
+                      output(i) = str_op (str1.data (), str1.length (),
+                                          str2.data (), str2.length (), n);
                     }
                 }
             }
@@ -553,7 +629,7 @@ This is just the opposite of the corresponding C library function.
     print_usage ();
 
   return ovl (do_strcmp_fun (args(0), args(1), 0, "strcmp",
-                             strcmp_ignore_n, strcmp_ignore_n));
+                             strcmp_ignore_n, strcmp_str));
 }
 
 /*
@@ -600,6 +676,15 @@ This is just the opposite of the corresponding C library function.
 %!assert (strcmp ("foobar", "foobar"), true)
 %!assert (strcmp ("fooba", "foobar"), false)
 
+%!test
+%! c = cellstr (["abc"; "ABC"; "ab "]);
+%! assert (strcmp (c, "abc"), [true; false; false]);
+%! assert (strcmp ({"ab"}, c), [false; false; true]);
+%! assert (strcmp (c, c), [true; true; true]);
+%! assert (strcmpi (c, "abc"), [true; true; false]);
+%! assert (strncmp (c, "abx", 2), [true; false; true]);
+%! assert (strncmpi (c, {"abx"; "abx"; "xyz"}, 2), [true; true; false]);
+
 %!error strcmp ()
 %!error strcmp ("foo", "bar", 3)
 */
@@ -643,8 +728,7 @@ This is just the opposite of the corresponding C library function.
 
   if (n > 0)
     return ovl (do_strcmp_fun (args(0), args(1), n, "strncmp",
-                               octave::string::strncmp,
-                               octave::string::strncmp));
+                               octave::string::strncmp, strncmp_str));
   else
     error ("strncmp: N must be greater than 0");
 }
@@ -657,6 +741,8 @@ This is just the opposite of the corresponding C library function.
 %!assert (strncmp ({"abcd", "bca", "abc"},"abce", 3), logical ([1, 0, 1]))
 %!assert (strncmp ({"abcd", "bca", "abc"},{"abcd", "bca", "abe"}, 3), logical ([1, 1, 0]))
 %!assert (strncmp ("abc", {"abcd", 10}, 2), logical ([1, 0]))
+%!assert (strncmp ("abc", "ABC", 3), false)
+%!assert (strncmp ({"abc", "ABC"}, "abd", 2), logical ([1, 0]))
 
 %!error strncmp ()
 %!error strncmp ("abc", "def")
@@ -686,7 +772,7 @@ This is just the opposite of the corresponding C library function.
     print_usage ();
 
   return ovl (do_strcmp_fun (args(0), args(1), 0, "strcmpi",
-                             strcmpi_ignore_n, strcmpi_ignore_n));
+                             strcmpi_ignore_n, strcmpi_str));
 }
 
 /*
@@ -720,8 +806,7 @@ This is just the opposite of the corresponding C library function.
 
   if (n > 0)
     return ovl (do_strcmp_fun (args(0), args(1), n, "strncmpi",
-                               octave::string::strncmpi,
-                               octave::string::strncmpi));
+                               octave::string::strncmpi, strncmpi_str));
   else
     error ("strncmpi: N must be greater than 0");
 }
@@ -51,6 +51,8 @@ along with Octave; see the file COPYING.  If not, see
 
 octave_value symbol_table::dummy_octave_value;
 
+size_t symbol_table::symbol_record::symbol_record_rep::last_stamp = 0;
+
 symbol_table *symbol_table::instance = 0;
 
 symbol_table::scope_id_cache *symbol_table::scope_id_cache::instance = 0;
@@ -1502,6 +1504,20 @@ symbol_table::do_workspace_info (void) const
 {
   std::list<workspace_element> retval;
 
+  // The values shown depend on the output format, so forget them if
+  // the format has changed.
+
+  std::ostringstream fmt_buf;
+  octave_value (Complex (M_PI, -1e5 * M_PI)).short_disp (fmt_buf);
+
+  if (fmt_buf.str () != workspace_cache_format)
+    {
+      workspace_cache.clear ();
+      workspace_cache_format = fmt_buf.str ();
+    }
+
+  std::map<std::string, workspace_cache_entry> new_cache;
+
   for (const auto& nm_sr : table)
     {
       std::string nm = nm_sr.first;
@@ -1509,6 +1525,36 @@ symbol_table::do_workspace_info (void) const
 
       if (! sr.is_hidden ())
         {
+          char storage = ' ';
+          if (sr.is_global ())
+            storage = 'g';
+          else if (sr.is_persistent ())
+            storage = 'p';
+          else if (sr.is_automatic ())
+            storage = 'a';
+          else if (sr.is_formal ())
+            storage = 'f';
+          else if (sr.is_hidden ())
+            storage = 'h';
+          else if (sr.is_inherited ())
+            storage = 'i';
+
+          size_t stamp = sr.change_stamp ();
+          context_id context = sr.active_context ();
+
+          // Reuse the element made for an unchanged variable.
+
+          auto p = workspace_cache.find (nm);
+
+          if (p != workspace_cache.end () && p->second.stamp == stamp
+              && p->second.context == context
+              && p->second.elt.scope () == storage)
+            {
+              retval.push_back (p->second.elt);
+              new_cache[nm] = p->second;
+              continue;
+            }
+
           octave_value val = sr.varval ();
 
           if (val.is_defined ())
@@ -1521,20 +1567,6 @@ symbol_table::do_workspace_info (void) const
               for (octave_idx_type i = 0; i < dv.ndims (); i++)
                 dv(i) = sz(i);
 
-              char storage = ' ';
-              if (sr.is_global ())
-                storage = 'g';
-              else if (sr.is_persistent ())
-                storage = 'p';
-              else if (sr.is_automatic ())
-                storage = 'a';
-              else if (sr.is_formal ())
-                storage = 'f';
-              else if (sr.is_hidden ())
-                storage = 'h';
-              else if (sr.is_inherited ())
-                storage = 'i';
-
               std::ostringstream buf;
               val.short_disp (buf);
               std::string short_disp_str = buf.str ();
@@ -1544,10 +1576,21 @@ symbol_table::do_workspace_info (void) const
                                      val.is_complex_type ());
 
               retval.push_back (elt);
+
+              // The values of global, persistent, and inherited
+              // variables, and the contents of handle objects, can
+              // change without changing the record.
+
+              if (! (sr.is_global () || sr.is_persistent ()
+                     || sr.is_inherited () || val.is_classdef_object ()
+                     || val.is_java ()))
+                new_cache[nm] = { stamp, context, elt };
             }
         }
     }
 
+  workspace_cache.swap (new_cache);
+
   return retval;
 }
 
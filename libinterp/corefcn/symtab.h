@@ -209,7 +209,8 @@ public:
       symbol_record_rep (scope_id s, const std::string& nm,
                          const octave_value& v, unsigned int sc)
         : decl_scope (s), curr_fcn (0), name (nm), value_stack (),
-          storage_class (sc), finfo (), valid (true), count (1)
+          storage_class (sc), finfo (), valid (true), stamp (++last_stamp),
+          count (1)
       {
         value_stack.push_back (v);
       }
@@ -257,6 +258,9 @@ public:
 
       octave_value& varref (context_id context = xdefault_context)
       {
+        // The value may be changed through the returned reference.
+        stamp = ++last_stamp;
+
         // We duplicate global_varref and persistent_varref here to
         // avoid calling deprecated functions.
 
@@ -310,7 +314,10 @@ public:
       {
         if (! (is_persistent () || is_global ())
             && s == scope ())
-          value_stack.push_back (octave_value ());
+          {
+            value_stack.push_back (octave_value ());
+            stamp = ++last_stamp;
+          }
       }
 
       // If pop_context returns 0, we are out of values and this element
@@ -336,6 +343,7 @@ public:
           {
             value_stack.pop_back ();
             retval = value_stack.size ();
+            stamp = ++last_stamp;
           }
 
         return retval;
@@ -477,6 +485,14 @@ public:
 
       bool valid;
 
+      // Changes whenever the value may have changed.  Stamps are never
+      // reused, so records with the same stamp have the same value.
+      // Values of global and persistent variables can change without
+      // changing the stamp.
+      size_t stamp;
+
+      static size_t last_stamp;
+
       octave::refcount<size_t> count;
     };
 
@@ -633,6 +649,8 @@ public:
 
     context_id active_context (void) const { return rep->active_context (); }
 
+    size_t change_stamp (void) const { return rep->stamp; }
+
     scope_id scope (void) const { return rep->scope (); }
 
     unsigned int xstorage_class (void) const { return rep->storage_class; }
@@ -2266,6 +2284,21 @@ private:
   // Map from names of persistent variables to values.
   std::map<std::string, octave_value> persistent_table;
 
+  // The workspace elements last made for the variables in this table,
+  // with the change stamps and contexts of their records at that time.
+  // Elements are only made again for variables that have changed.
+  struct workspace_cache_entry
+  {
+    size_t stamp;
+    context_id context;
+    workspace_element elt;
+  };
+
+  mutable std::map<std::string, workspace_cache_entry> workspace_cache;
+
+  // A sample of the output format used for the cached elements.
+  mutable std::string workspace_cache_format;
+
   // Pointer to symbol table for current scope (variables only).
   static symbol_table *instance;
 
@@ -2305,7 +2338,7 @@ private:
   symbol_table (scope_id scope)
     : my_scope (scope), table_name (), table (), nest_children (),
       nest_parent (0), curr_fcn (0), static_workspace (false),
-      persistent_table () { }
+      persistent_table (), workspace_cache (), workspace_cache_format () { }
 
   // No copying!
 
@@ -26,8 +26,14 @@ along with Octave; see the file COPYING.  If not, see
 #  include "config.h"
 #endif
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 #include "lo-ieee.h"
+#include "lo-mappers.h"
 #include "lo-math.h"
+#include "quit.h"
 
 #include "defun.h"
 #include "error.h"
@@ -51,14 +57,6 @@ inline double min (double a, double b, double c)
 
 #define REF(x,k,i) x(static_cast<octave_idx_type>(elem((k), (i))) - 1)
 
-// for large data set the algorithm is very slow
-// one should presort (how?) either the elements of the points of evaluation
-// to cut down the time needed to decide which triangle contains the
-// given point
-
-// e.g., build up a neighbouring triangle structure and use a simplex-like
-// method to traverse it
-
 DEFUN (tsearch, args, ,
        doc: /* -*- texinfo -*-
 @deftypefn {} {@var{idx} =} tsearch (@var{x}, @var{y}, @var{t}, @var{xi}, @var{yi})
@@ -66,7 +64,8 @@ Search for the enclosing Delaunay convex hull.
 
 For @code{@var{t} = delaunay (@var{x}, @var{y})}, finds the index in @var{t}
 containing the points @code{(@var{xi}, @var{yi})}.  For points outside the
-convex hull, @var{idx} is NaN.
+convex hull, @var{idx} is NaN.  If a point lies in more than one triangle,
+for example on a shared edge, the lowest index is returned.
 @seealso{delaunay, delaunayn}
 @end deftypefn */)
 {
@@ -96,48 +95,129 @@ convex hull, @var{idx} is NaN.
     }
 
   const octave_idx_type np = xi.numel ();
-  ColumnVector values (np);
+  ColumnVector values (np, lo_ieee_nan_value ());
+
+  if (nelem == 0)
+    return ovl (values);
+
+  // Bucket the triangles by the cells of a uniform grid, about one cell
+  // per triangle, that their bounding boxes overlap.  A point then only
+  // needs to be tested against the triangles of the cell it falls in.
+
+  const double gx0 = minx.min ();
+  const double gx1 = maxx.max ();
+  const double gy0 = miny.min ();
+  const double gy1 = maxy.max ();
+
+  const double wx = gx1 - gx0;
+  const double wy = gy1 - gy0;
+
+  // The extent is zero along an axis if the points are collinear with
+  // coordinates so large that EPS is lost in rounding.  Such an axis
+  // gets a single cell.
+
+  const bool x_ok = (wx > 0 && octave::math::finite (wx));
+  const bool y_ok = (wy > 0 && octave::math::finite (wy));
+
+  octave_idx_type nx = 1;
+  if (x_ok && y_ok)
+    {
+      const double nxd = std::sqrt (nelem * (wx / wy));
+      nx = (nxd < nelem ? std::max (octave_idx_type (1),
+                                    static_cast<octave_idx_type> (nxd))
+                        : nelem);
+    }
+  else if (x_ok)
+    nx = nelem;
+
+  octave_idx_type ny = (y_ok ? std::max (octave_idx_type (1), nelem / nx) : 1);
+
+  const double sx = (x_ok ? nx / wx : 0.0);
+  const double sy = (y_ok ? ny / wy : 0.0);
 
-  double x0, y0, a11, a12, a21, a22, det;
-  x0 = y0 = 0.0;
-  a11 = a12 = a21 = a22 = 0.0;
-  det = 0.0;
+  // Cell coordinate of V along an axis with origin V0, scale S and N cells.
+  auto cell = [] (double v, double v0, double s, octave_idx_type n)
+  {
+    const double c = (v - v0) * s;
+    if (! (c >= 0))
+      return octave_idx_type (0);
+    else if (c >= n - 1)
+      return n - 1;
+    else
+      return static_cast<octave_idx_type> (c);
+  };
 
-  octave_idx_type k = nelem; // k is a counter of elements
+  // Compressed lists of triangles per cell, in increasing order.
+
+  std::vector<octave_idx_type> cell_ptr (nx * ny + 1, 0);
+  std::vector<octave_idx_type> cell_tri;
+
+  for (int pass = 0; pass < 2; pass++)
+    {
+      std::vector<octave_idx_type> fill (cell_ptr.begin (), cell_ptr.end () - 1);
+
+      for (octave_idx_type k = 0; k < nelem; k++)
+        {
+          octave_quit ();
+
+          octave_idx_type i0 = cell (minx(k), gx0, sx, nx);
+          octave_idx_type i1 = cell (maxx(k), gx0, sx, nx);
+          octave_idx_type j0 = cell (miny(k), gy0, sy, ny);
+          octave_idx_type j1 = cell (maxy(k), gy0, sy, ny);
+
+          for (octave_idx_type j = j0; j <= j1; j++)
+            for (octave_idx_type i = i0; i <= i1; i++)
+              {
+                if (pass == 0)
+                  cell_ptr[j*nx + i + 1]++;
+                else
+                  cell_tri[fill[j*nx + i]++] = k;
+              }
+        }
+
+      if (pass == 0)
+        {
+          for (octave_idx_type c = 0; c < nx * ny; c++)
+            cell_ptr[c+1] += cell_ptr[c];
+
+          cell_tri.resize (cell_ptr[nx * ny]);
+        }
+    }
+
+  // octave_quit can't throw out of an OpenMP loop, so pending interrupts
+  // skip the remaining points and are handled after the loop.
+
+#if defined (HAVE_OPENMP)
+#  pragma omp parallel for if (np > 1000)
+#endif
   for (octave_idx_type kp = 0; kp < np; kp++)
     {
+      if (octave_signal_caught)
+        continue;
+
       const double xt = xi(kp);
       const double yt = yi(kp);
 
-      // check if last triangle contains the next point
-      if (k < nelem)
-        {
-          const double dx1 = xt - x0;
-          const double dx2 = yt - y0;
-          const double c1 = (a22 * dx1 - a21 * dx2) / det;
-          const double c2 = (-a12 * dx1 + a11 * dx2) / det;
-          if (c1 >= -eps && c2 >= -eps && (c1 + c2) <= (1 + eps))
-            {
-              values(kp) = double(k+1);
-              continue;
-            }
-        }
+      if (! (xt >= gx0 && xt <= gx1 && yt >= gy0 && yt <= gy1))
+        continue;
+
+      octave_idx_type c = (cell (yt, gy0, sy, ny) * nx
+                           + cell (xt, gx0, sx, nx));
 
-      // it doesn't, so go through all elements
-      for (k = 0; k < nelem; k++)
+      for (octave_idx_type t = cell_ptr[c]; t < cell_ptr[c+1]; t++)
         {
-          octave_quit ();
+          octave_idx_type k = cell_tri[t];
 
           if (xt >= minx(k) && xt <= maxx(k) && yt >= miny(k) && yt <= maxy(k))
             {
               // element inside the minimum rectangle: examine it closely
-              x0  = REF (x, k, 0);
-              y0  = REF (y, k, 0);
-              a11 = REF (x, k, 1) - x0;
-              a12 = REF (y, k, 1) - y0;
-              a21 = REF (x, k, 2) - x0;
-              a22 = REF (y, k, 2) - y0;
-              det = a11 * a22 - a21 * a12;
+              const double x0  = REF (x, k, 0);
+              const double y0  = REF (y, k, 0);
+              const double a11 = REF (x, k, 1) - x0;
+              const double a12 = REF (y, k, 1) - y0;
+              const double a21 = REF (x, k, 2) - x0;
+              const double a22 = REF (y, k, 2) - y0;
+              const double det = a11 * a22 - a21 * a12;
 
               // solve the system
               const double dx1 = xt - x0;
@@ -149,13 +229,11 @@ convex hull, @var{idx} is NaN.
                   values(kp) = double(k+1);
                   break;
                 }
-            } //endif # examine this element closely
-        } //endfor # each element
-
-      if (k == nelem)
-        values(kp) = lo_ieee_nan_value ();
+            }
+        }
+    }
 
-    } //endfor # kp
+  octave_quit ();
 
   return ovl (values);
 }
@@ -171,6 +249,35 @@ convex hull, @var{idx} is NaN.
 %!assert (tsearch (x,y,tri,-1/3, -1/3), 1)
 %!assert (tsearch (x,y,tri, 1, 1), NaN)
 
+%!test
+%! [x, y] = meshgrid (0:10);
+%! x = x(:);
+%! y = y(:);
+%! tri = delaunay (x, y);
+%! xi = 10 * rand (200, 1);
+%! yi = 10 * rand (200, 1);
+%! idx = tsearch (x, y, tri, [xi; 11; NaN], [yi; 5; 5]);
+%! assert (isnan (idx(end-1:end)));
+%! idx = idx(1:end-2);
+%! assert (! any (isnan (idx)));
+%! ## Check barycentric coordinates of the points in the found triangles.
+%! x1 = x(tri(idx,1));  y1 = y(tri(idx,1));
+%! a11 = x(tri(idx,2)) - x1;  a12 = y(tri(idx,2)) - y1;
+%! a21 = x(tri(idx,3)) - x1;  a22 = y(tri(idx,3)) - y1;
+%! det = a11 .* a22 - a21 .* a12;
+%! c1 = (a22 .* (xi - x1) - a21 .* (yi - y1)) ./ det;
+%! c2 = (-a12 .* (xi - x1) + a11 .* (yi - y1)) ./ det;
+%! assert (all (c1 >= -1e-12 & c2 >= -1e-12 & c1 + c2 <= 1 + 1e-12));
+
+## Collinear points with a zero extent along one axis
+%!test
+%! x = [0; 1; 2];
+%! y = [1e6; 1e6; 1e6];
+%! tri = [1, 2, 3];
+%! assert (tsearch (x, y, tri, [1; 5], [1e6; 1e6]), [NaN; NaN]);
+%! assert (tsearch (y, x, tri, [1e6; 1e6], [1; 5]), [NaN; NaN]);
+%! assert (tsearch (y, y, tri, 1e6, 1e6), NaN);
+
 %!error tsearch ()
 */
 
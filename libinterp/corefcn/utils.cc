@@ -1266,11 +1266,22 @@ octave_format (std::ostream& os, const char *fmt, ...)
 size_t
 octave_vformat (std::ostream& os, const char *fmt, va_list args)
 {
-  std::string s = octave_vasprintf (fmt, args);
+  // Most conversions fit in the local buffer and need no allocation.
 
-  os << s;
+  char buf[256];
+  size_t len = sizeof (buf);
 
-  return s.length ();
+  char *result = octave_vasnprintf_wrapper (buf, &len, fmt, args);
+
+  if (! result)
+    return 0;
+
+  os.write (result, len);
+
+  if (result != buf)
+    ::free (result);
+
+  return len;
 }
 
 std::string
@@ -1667,12 +1667,37 @@ do_who (int argc, const string_vector& argv, bool return_list,
 
           frame.add_fcn (symbol_table::clear_variables);
 
-          feval ("load", octave_value (nm), 0);
+          // Names following the file name select the variables to list.
+          // Unless there are other options, only those variables need
+          // to be loaded.
+
+          string_vector new_argv (argc - 2);
+          octave_value_list load_args (1, octave_value (nm));
+
+          bool select = ! have_regexp;
+
+          for (int j = 0; j < i; j++)
+            new_argv[j] = argv[j];
+
+          for (int j = i + 2; j < argc; j++)
+            {
+              new_argv[j-2] = argv[j];
+
+              if (argv[j][0] == '-' || argv[j] == "global")
+                select = false;
+              else
+                load_args.append (octave_value (argv[j]));
+            }
+
+          if (! select)
+            load_args.resize (1);
+
+          feval ("load", load_args, 0);
 
           std::string newmsg = std::string ("Variables in the file ")
                                + nm + ":\n\n";
 
-          retval = do_who (i, argv, return_list, verbose, newmsg);
+          retval = do_who (argc - 2, new_argv, return_list, verbose, newmsg);
 
           return retval;
         }
@@ -254,5 +254,37 @@ instead.
 %!     unlink (fn);
 %!   end_unwind_protect
 %! endif
+
+## Large 2-D lines are decimated to the pixel columns of the axes.  Lines
+## with Z data are not, so they give the reference image.
+%!testif HAVE_OPENGL, HAVE_OSMESA, HAVE_GL2PS_H
+%! if (isunix ())
+%!   hf = figure ("visible", "off");
+%!   unwind_protect
+%!     x = linspace (0, 10, 2e5);
+%!     y = sin (x) + 0.3 * sin (97 * x);
+%!     hl = plot (x, y);
+%!     axis ([2 8 -2 2]);
+%!     img = __osmesa_print__ (hf);
+%!     set (hl, "zdata", zeros (size (x)));
+%!     ref = __osmesa_print__ (hf);
+%!     line_px = nnz (any (ref != 255, 3));
+%!     assert (line_px > 0);
+%!     assert (nnz (any (img != ref, 3)) <= 0.02 * line_px);
+%!     ## Lines clipped in y and dashed lines are drawn in full.
+%!     set (hl, "zdata", []);
+%!     ylim ([-0.5 0.5]);
+%!     img = __osmesa_print__ (hf);
+%!     set (hl, "zdata", zeros (size (x)));
+%!     assert (__osmesa_print__ (hf), img);
+%!     set (hl, "zdata", [], "linestyle", "--");
+%!     ylim ([-2 2]);
+%!     img = __osmesa_print__ (hf);
+%!     set (hl, "zdata", zeros (size (x)));
+%!     assert (__osmesa_print__ (hf), img);
+%!   unwind_protect_cleanup
+%!     close (hf);
+%!   end_unwind_protect
+%! endif
 */
 
@@ -45,7 +45,9 @@ OCTAVE_VALUE_INC = \
   libinterp/octave-value/ov-flt-re-diag.h \
   libinterp/octave-value/ov-flt-re-mat.h \
   libinterp/octave-value/ov-java.h \
+  libinterp/octave-value/ov-lazy-cellstr.h \
   libinterp/octave-value/ov-lazy-idx.h \
+  libinterp/octave-value/ov-lazy-trans.h \
   libinterp/octave-value/ov-mex-fcn.h \
   libinterp/octave-value/ov-null-mat.h \
   libinterp/octave-value/ov-oncleanup.h \
@@ -103,7 +105,9 @@ OCTAVE_VALUE_SRC = \
   libinterp/octave-value/ov-flt-re-diag.cc \
   libinterp/octave-value/ov-flt-re-mat.cc \
   libinterp/octave-value/ov-java.cc \
+  libinterp/octave-value/ov-lazy-cellstr.cc \
   libinterp/octave-value/ov-lazy-idx.cc \
+  libinterp/octave-value/ov-lazy-trans.cc \
   libinterp/octave-value/ov-mex-fcn.cc \
   libinterp/octave-value/ov-null-mat.cc \
   libinterp/octave-value/ov-oncleanup.cc \
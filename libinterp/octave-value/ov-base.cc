@@ -860,6 +860,12 @@ octave_base_value::cellstr_value (void) const
   err_wrong_type_arg ("octave_base_value::cellstr_value()", type_name ());
 }
 
+octave::string_array
+octave_base_value::string_array_value (void) const
+{
+  err_wrong_type_arg ("octave_base_value::string_array_value()", type_name ());
+}
+
 Range
 octave_base_value::range_value (void) const
 {
@@ -35,6 +35,7 @@ along with Octave; see the file COPYING.  If not, see
 #include "Range.h"
 #include "data-conv.h"
 #include "mx-base.h"
+#include "str-array.h"
 #include "str-vec.h"
 
 #include "error.h"
@@ -177,6 +178,122 @@ DEF_CLASS_TO_BTYP (char, btyp_char);
     t_id = octave_value_typeinfo::register_type (t::t_name, t::c_name, v); \
   }
 
+#if defined (OCTAVE_HAVE_THREAD_LOCAL)
+
+// Free list of memory blocks of N bytes, used to allocate the objects
+// of small value types such as scalars.  Each thread has its own list,
+// so no locking is needed, and at most MAX_FREE blocks are kept.  The
+// blocks on the list are returned to the heap when the thread exits.
+
+template <size_t N>
+class
+octave_fixed_size_allocator
+{
+public:
+
+  static void * allocate (size_t size)
+  {
+    if (size == N && free_list)
+      {
+        block *p = free_list;
+        free_list = p->next;
+        n_free--;
+        return p;
+      }
+
+    return ::operator new (size);
+  }
+
+  static void deallocate (void *p, size_t size)
+  {
+    if (size == N && ! released && n_free < max_free)
+      {
+        // Make sure the list is released when this thread exits.
+        if (n_free == 0)
+          (void) &thread_releaser;
+
+        block *b = static_cast<block *> (p);
+        b->next = free_list;
+        free_list = b;
+        n_free++;
+      }
+    else
+      ::operator delete (p);
+  }
+
+private:
+
+  struct block { block *next; };
+
+  // Return the free blocks to the heap.  Objects that are deleted later
+  // on this thread, for example by the destructors of other thread
+  // local or static objects, go directly to the heap.
+
+  static void release (void)
+  {
+    while (free_list)
+      {
+        block *p = free_list;
+        free_list = p->next;
+        ::operator delete (p);
+      }
+
+    n_free = 0;
+    released = true;
+  }
+
+  struct releaser
+  {
+    ~releaser (void) { release (); }
+  };
+
+  static const size_t max_free = 1024;
+
+  // These are trivially destructible, so they remain usable while the
+  // other thread local objects are destroyed.
+
+  static thread_local block *free_list;
+
+  static thread_local size_t n_free;
+
+  static thread_local bool released;
+
+  static thread_local releaser thread_releaser;
+};
+
+template <size_t N>
+thread_local typename octave_fixed_size_allocator<N>::block *
+octave_fixed_size_allocator<N>::free_list = 0;
+
+template <size_t N>
+thread_local size_t octave_fixed_size_allocator<N>::n_free = 0;
+
+template <size_t N>
+thread_local bool octave_fixed_size_allocator<N>::released = false;
+
+template <size_t N>
+thread_local typename octave_fixed_size_allocator<N>::releaser
+octave_fixed_size_allocator<N>::thread_releaser;
+
+// Allocate objects of type T with octave_fixed_size_allocator.  Objects
+// of derived types of a different size use the default allocator.
+
+#define DECLARE_OV_FIXED_SIZE_ALLOCATOR(t)                              \
+  public:                                                               \
+    static void * operator new (size_t size)                            \
+    { return octave_fixed_size_allocator<sizeof (t)>::allocate (size); } \
+    static void operator delete (void *p, size_t size)                  \
+    { octave_fixed_size_allocator<sizeof (t)>::deallocate (p, size); }
+
+#else
+
+// Without thread local storage, the free lists would need a lock, which
+// costs about as much as the heap allocation they save.
+
+#define DECLARE_OV_FIXED_SIZE_ALLOCATOR(t)
+
+#endif
+
 // A base value type, so that derived types only have to redefine what
 // they need (if they are derived from octave_base_value instead of
 // octave_value).
@@ -585,6 +702,8 @@ public:
 
   virtual Array<std::string> cellstr_value (void) const;
 
+  virtual octave::string_array string_array_value (void) const;
+
   virtual Range range_value (void) const;
 
   virtual octave_map map_value (void) const;
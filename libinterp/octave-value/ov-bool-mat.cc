@@ -438,26 +438,20 @@ octave_bool_matrix::save_hdf5 (octave_hdf5_id loc_id, const char *name,
   if (empty)
     return (empty > 0);
 
-  int rank = dv.ndims ();
   hid_t space_hid, data_hid;
   space_hid = data_hid = -1;
   boolNDArray m = bool_array_value ();
 
-  OCTAVE_LOCAL_BUFFER (hsize_t, hdims, rank);
-
-  // Octave uses column-major, while HDF5 uses row-major ordering
-  for (int i = 0; i < rank; i++)
-    hdims[i] = dv(rank-i-1);
-
-  space_hid = H5Screate_simple (rank, hdims, 0);
+  space_hid = hdf5_array_space (dv);
   if (space_hid < 0) return false;
+  hid_t plist_hid = hdf5_array_create_plist (dv, H5T_NATIVE_HBOOL);
 #if defined (HAVE_HDF5_18)
   data_hid = H5Dcreate (loc_id, name, H5T_NATIVE_HBOOL, space_hid,
-                        octave_H5P_DEFAULT, octave_H5P_DEFAULT, octave_H5P_DEFAULT);
+                        octave_H5P_DEFAULT, plist_hid, octave_H5P_DEFAULT);
 #else
-  data_hid = H5Dcreate (loc_id, name, H5T_NATIVE_HBOOL, space_hid,
-                        octave_H5P_DEFAULT);
+  data_hid = H5Dcreate (loc_id, name, H5T_NATIVE_HBOOL, space_hid, plist_hid);
 #endif
+  H5Pclose (plist_hid);
   if (data_hid < 0)
     {
       H5Sclose (space_hid);
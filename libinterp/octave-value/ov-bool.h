@@ -254,6 +254,8 @@ public:
     return m.map (umap);
   }
 
+  DECLARE_OV_FIXED_SIZE_ALLOCATOR (octave_bool)
+
 private:
 
   DECLARE_OV_TYPEID_FUNCTIONS_AND_DATA
@@ -619,6 +619,57 @@ octave_cell::cellstr_value (void) const
   return retval;
 }
 
+// Pack the strings without creating a std::string for each element.
+// As with string_value, only the first row of a character matrix is
+// used.
+
+octave::string_array
+octave_cell::string_array_value (void) const
+{
+  if (! is_cellstr ())
+    error ("invalid conversion from cell array to array of strings");
+
+  if (! strarray_cache)
+    {
+      octave_idx_type n = matrix.numel ();
+
+      Array<octave_idx_type> offsets (dim_vector (n + 1, 1));
+
+      octave_idx_type nchars = 0;
+      offsets.xelem (0) = 0;
+      for (octave_idx_type i = 0; i < n; i++)
+        {
+          const dim_vector dv = matrix(i).dims ();
+
+          if (dv.ndims () != 2)
+            error ("invalid conversion of charNDArray to string");
+
+          nchars += (dv(0) == 0 ? 0 : dv(1));
+          offsets.xelem (i+1) = nchars;
+        }
+
+      Array<char> chars (dim_vector (nchars, 1));
+
+      char *dest = chars.fortran_vec ();
+      for (octave_idx_type i = 0; i < n; i++)
+        {
+          const charNDArray chm = matrix(i).char_array_value ();
+
+          octave_idx_type nr = chm.rows ();
+          octave_idx_type len = offsets.xelem (i+1) - offsets.xelem (i);
+
+          const char *src = chm.data ();
+          for (octave_idx_type j = 0; j < len; j++)
+            *dest++ = src[j*nr];
+        }
+
+      strarray_cache.reset (new octave::string_array (matrix.dims (),
+                                                      chars, offsets));
+    }
+
+  return *strarray_cache;
+}
+
 bool
 octave_cell::print_as_scalar (void) const
 {
@@ -1275,6 +1326,42 @@ To convert back from a cellstr to a character array use @code{char}.
 
   if (tmp(0).is_true ())
     return ovl (args(0));
+  else if (args(0).is_string () && args(0).ndims () == 2
+           && args(0).rows () > 0)
+    {
+      // Copy the rows straight into a compact cellstr.
+
+      const charMatrix chm = args(0).char_matrix_value ();
+
+      octave_idx_type nr = chm.rows ();
+      octave_idx_type nc = chm.cols ();
+
+      Array<octave_idx_type> offsets (dim_vector (nr + 1, 1));
+
+      octave_idx_type nchars = 0;
+      offsets.xelem (0) = 0;
+      for (octave_idx_type i = 0; i < nr; i++)
+        {
+          octave_idx_type len = nc;
+          while (len > 0 && chm(i, len-1) == ' ')
+            len--;
+
+          nchars += len;
+          offsets.xelem (i+1) = nchars;
+        }
+
+      Array<char> chars (dim_vector (nchars, 1));
+
+      char *dest = chars.fortran_vec ();
+      for (octave_idx_type i = 0; i < nr; i++)
+        {
+          octave_idx_type len = offsets.xelem (i+1) - offsets.xelem (i);
+          for (octave_idx_type j = 0; j < len; j++)
+            *dest++ = chm(i, j);
+        }
+
+      return ovl (octave::string_array (dim_vector (nr, 1), chars, offsets));
+    }
   else
     {
       string_vector s = args(0).xstring_vector_value ("cellstr: argument STRING must be a 2-D character array");
@@ -1284,6 +1371,29 @@ To convert back from a cellstr to a character array use @code{char}.
     }
 }
 
+/*
+%!assert (cellstr (["abc "; "d   "; "    "]), {"abc"; "d"; ""})
+%!assert (cellstr (char ("a", "bcd")), {"a"; "bcd"})
+%!assert (size (cellstr ("   "){1}), [0, 0])
+
+%!test
+%! c = cellstr (["foo"; "bar"; "baz"]);
+%! assert (iscellstr (c));
+%! assert (class (c), "cell");
+%! assert (size (c), [3, 1]);
+%! assert (c{2}, "bar");
+%! assert (c(2:3), {"bar"; "baz"});
+%! assert (c([3, 1]).', {"baz", "foo"});
+%! assert ([c{:}], "foobarbaz");
+%! assert (upper (c), {"FOO"; "BAR"; "BAZ"});
+%! assert (sort (c), {"bar"; "baz"; "foo"});
+%! c{2} = 1;
+%! assert (iscellstr (c), false);
+%! assert (c, {"foo"; 1; "baz"});
+
+%!error <index \(4,_\): out of bound> cellstr (["a"; "b"; "c"])(4,1)
+*/
+
 DEFUN (struct2cell, args, ,
        doc: /* -*- texinfo -*-
 @deftypefn {} {@var{c} =} struct2cell (@var{s})
@@ -52,17 +52,17 @@ octave_cell : public octave_base_matrix<Cell>
 public:
 
   octave_cell (void)
-    : octave_base_matrix<Cell> (), cellstr_cache () { }
+    : octave_base_matrix<Cell> (), cellstr_cache (), strarray_cache () { }
 
   octave_cell (const Cell& c)
-    : octave_base_matrix<Cell> (c), cellstr_cache () { }
+    : octave_base_matrix<Cell> (c), cellstr_cache (), strarray_cache () { }
 
   octave_cell (const Array<std::string>& str)
     : octave_base_matrix<Cell> (Cell (str)),
-      cellstr_cache (new Array<std::string> (str)) { }
+      cellstr_cache (new Array<std::string> (str)), strarray_cache () { }
 
   octave_cell (const octave_cell& c)
-    : octave_base_matrix<Cell> (c), cellstr_cache () { }
+    : octave_base_matrix<Cell> (c), cellstr_cache (), strarray_cache () { }
 
   ~octave_cell (void) = default;
 
@@ -148,6 +148,8 @@ public:
 
   Array<std::string> cellstr_value (const char *fmt, ...) const;
 
+  octave::string_array string_array_value (void) const;
+
   bool print_as_scalar (void) const;
 
   void print (std::ostream& os, bool pr_as_read_syntax = false);
@@ -180,10 +182,15 @@ public:
 private:
 
   void clear_cellstr_cache (void) const
-  { cellstr_cache.reset (); }
+  {
+    cellstr_cache.reset ();
+    strarray_cache.reset ();
+  }
 
   mutable std::unique_ptr<Array<std::string> > cellstr_cache;
 
+  mutable std::unique_ptr<octave::string_array> strarray_cache;
+
   DECLARE_OV_TYPEID_FUNCTIONS_AND_DATA
 };
 
@@ -193,6 +193,8 @@ public:
 
   octave_value map (unary_mapper_t umap) const;
 
+  DECLARE_OV_FIXED_SIZE_ALLOCATOR (octave_complex)
+
 private:
 
   DECLARE_OV_TYPEID_FUNCTIONS_AND_DATA
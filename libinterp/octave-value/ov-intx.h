@@ -672,6 +672,8 @@ public:
       }
   }
 
+  DECLARE_OV_FIXED_SIZE_ALLOCATOR (OCTAVE_VALUE_INT_SCALAR_T)
+
 private:
 
   DECLARE_OV_TYPEID_FUNCTIONS_AND_DATA
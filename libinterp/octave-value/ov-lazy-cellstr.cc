@@ -0,0 +1,515 @@
+/*
+
+Copyright (C) 2016 The Octave Project Developers
+
+This file is part of Octave.
+
+Octave is free software; you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+Octave is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Octave; see the file COPYING.  If not, see
+<http://www.gnu.org/licenses/>.
+
+*/
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <vector>
+
+#include "Array-util.h"
+#include "chNDArray.h"
+#include "lo-array-errwarn.h"
+
+#include "ov-lazy-cellstr.h"
+#include "ovl.h"
+#include "ls-oct-text.h"
+#include "ls-oct-binary.h"
+
+DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA (octave_lazy_cellstr, "lazy_cellstr",
+                                     "cell");
+
+static octave_value
+string_element (const octave::string_array& strs, octave_idx_type i)
+{
+  octave_idx_type len = strs.length (i);
+
+  charNDArray chm (len == 0 ? dim_vector (0, 0) : dim_vector (1, len));
+  std::copy (strs.data (i), strs.data (i) + len, chm.fortran_vec ());
+
+  return octave_value (chm, '\'');
+}
+
+// Store in DEST the linear indices BASE + sum (IA(j)(k) * STRIDE(j))
+// for all subscripts selected by IA(0:K) along dimensions of length
+// LEN, with the first subscript varying fastest.
+
+static void
+gather_positions (const Array<idx_vector>& ia, const dim_vector& len,
+                  const Array<octave_idx_type>& stride, int k,
+                  octave_idx_type base, octave_idx_type *& dest)
+{
+  octave_idx_type s = stride(k);
+
+  if (k == 0)
+    ia(0).loop (len(0), [base, s, &dest] (octave_idx_type i)
+                { *dest++ = base + i * s; });
+  else
+    ia(k).loop (len(k), [&ia, &len, &stride, k, base, s, &dest]
+                        (octave_idx_type i)
+                { gather_positions (ia, len, stride, k-1, base + i * s,
+                                    dest); });
+}
+
+// Linear indices of the elements of an array with dimensions DV that
+// are selected by IA, with the dimensions that Array<T>::index gives
+// the result.  Only the selected elements are visited, so the cost is
+// proportional to the size of the result.
+
+static Array<octave_idx_type>
+element_positions (const dim_vector& dv, const Array<idx_vector>& ia)
+{
+  int ial = ia.numel ();
+
+  // Allow Fortran indexing in the last dimension.
+  dim_vector rdv = dv.redim (ial);
+
+  Array<octave_idx_type> stride (dim_vector (ial, 1));
+  dim_vector len = rdv;
+
+  octave_idx_type s = 1;
+  for (int k = 0; k < ial; k++)
+    {
+      octave_idx_type ext = ia(k).extent (rdv(k));
+      if (ext != rdv(k))
+        octave::err_index_out_of_range (ial, k+1, ext, rdv(k), dv);
+
+      stride(k) = s;
+      s *= rdv(k);
+
+      rdv(k) = ia(k).length (rdv(k));
+    }
+
+  if (ial == 1 && ia(0).is_colon ())
+    rdv = dim_vector (len(0), 1);
+  else if (ial == 1)
+    {
+      // Same rules for the orientation as Array<T>::index.
+      octave_idx_type n = len(0);
+      octave_idx_type il = rdv(0);
+
+      rdv = ia(0).orig_dimensions ();
+
+      if (dv.ndims () == 2 && n != 1 && rdv.is_vector ())
+        {
+          if (dv(1) == 1)
+            rdv = dim_vector (il, 1);
+          else if (dv(0) == 1)
+            rdv = dim_vector (1, il);
+        }
+    }
+  else
+    rdv.chop_trailing_singletons ();
+
+  Array<octave_idx_type> retval (rdv);
+
+  if (retval.numel () > 0)
+    {
+      octave_idx_type *dest = retval.fortran_vec ();
+      gather_positions (ia, len, stride, ial - 1, 0, dest);
+    }
+
+  return retval;
+}
+
+static octave_base_value *
+default_numeric_conversion_function (const octave_base_value& a)
+{
+  const octave_lazy_cellstr& v = dynamic_cast<const octave_lazy_cellstr&> (a);
+
+  return v.full_value ().clone ();
+}
+
+octave_base_value::type_conv_info
+octave_lazy_cellstr::numeric_conversion_function (void) const
+{
+  return octave_base_value::type_conv_info (default_numeric_conversion_function,
+                                            octave_cell::static_type_id ());
+}
+
+Cell
+octave_lazy_cellstr::make_cell (void) const
+{
+  Cell retval (dims ());
+
+  octave_idx_type n = numel ();
+  for (octave_idx_type i = 0; i < n; i++)
+    retval.xelem (i) = string_element (strings, i);
+
+  return retval;
+}
+
+octave_value
+octave_lazy_cellstr::fast_elem_extract (octave_idx_type n) const
+{
+  if (n < numel ())
+    return strings.index (Array<octave_idx_type> (dim_vector (1, 1), n));
+  else
+    return octave_value ();
+}
+
+octave_value_list
+octave_lazy_cellstr::subsref (const std::string& type,
+                              const std::list<octave_value_list>& idx,
+                              int nargout,
+                              const std::list<octave_lvalue> *lvalue_list)
+{
+  octave_value_list retval;
+
+  switch (type[0])
+    {
+    case '(':
+      retval(0) = do_index_op (idx.front ());
+      break;
+
+    case '{':
+      {
+        octave_value tmp = do_index_op (idx.front ());
+
+        const octave::string_array tstr = tmp.string_array_value ();
+
+        octave_idx_type n = tstr.numel ();
+
+        if (n == 1)
+          retval(0) = string_element (tstr, 0);
+        else
+          {
+            octave_value_list lst (n, octave_value ());
+
+            for (octave_idx_type i = 0; i < n; i++)
+              lst(i) = string_element (tstr, i);
+
+            retval = octave_value (lst, true);
+          }
+      }
+      break;
+
+    case '.':
+      {
+        octave_value tmp = make_value ();
+        return tmp.subsref (type, idx, nargout, lvalue_list);
+      }
+
+    default:
+      panic_impossible ();
+    }
+
+  if (idx.size () > 1)
+    retval = (lvalue_list
+              ? retval(0).next_subsref (nargout, type, idx, lvalue_list)
+              : retval(0).next_subsref (nargout, type, idx));
+
+  return retval;
+}
+
+octave_value
+octave_lazy_cellstr::do_index_op (const octave_value_list& idx,
+                                  bool resize_ok)
+{
+  // Out of range elements would be filled with [], which is not a
+  // string.
+  if (resize_ok)
+    return make_value ().do_index_op (idx, resize_ok);
+
+  Array<octave_idx_type> elems;
+
+  octave_idx_type n_idx = idx.length ();
+
+  const dim_vector dv = dims ();
+
+  // If we catch an indexing error in index_vector, we flag an error in
+  // index k.  Ensure it is the right value befor each idx_vector call.
+  // Same variable as used in the for loop in the default case.
+
+  octave_idx_type k = 0;
+
+  try
+    {
+      switch (n_idx)
+        {
+        case 0:
+          return strings;
+
+        case 1:
+          {
+            idx_vector i = idx (0).index_vector ();
+
+            if (i.is_colon ())
+              return strings.reshape (dim_vector (numel (), 1));
+            else if (i.is_scalar ())
+              elems = Array<octave_idx_type> (dim_vector (1, 1),
+                                              compute_index (i(0), dv));
+            else
+              elems = element_positions (dv, Array<idx_vector> (dim_vector (1, 1), i));
+          }
+          break;
+
+        case 2:
+          {
+            idx_vector i = idx (0).index_vector ();
+
+            k=1;
+            idx_vector j = idx (1).index_vector ();
+
+            if (i.is_scalar () && j.is_scalar ())
+              elems = Array<octave_idx_type> (dim_vector (1, 1),
+                                              compute_index (i(0), j(0), dv));
+            else
+              {
+                Array<idx_vector> ia (dim_vector (2, 1));
+                ia(0) = i;
+                ia(1) = j;
+
+                elems = element_positions (dv, ia);
+              }
+          }
+          break;
+
+        default:
+          {
+            Array<idx_vector> idx_vec (dim_vector (n_idx, 1));
+            bool scalar_opt = n_idx == dv.ndims ();
+
+            for (k = 0; k < n_idx; k++)
+              {
+                idx_vec(k) = idx(k).index_vector ();
+
+                scalar_opt = (scalar_opt && idx_vec(k).is_scalar ());
+              }
+
+            if (scalar_opt)
+              elems = Array<octave_idx_type>
+                        (dim_vector (1, 1),
+                         compute_index (conv_to_int_array (idx_vec), dv));
+            else
+              elems = element_positions (dv, idx_vec);
+          }
+          break;
+        }
+    }
+  catch (octave::index_exception& e)
+    {
+      // Rethrow to allow more info to be reported later.
+      e.set_pos_if_unset (n_idx, k+1);
+      throw;
+    }
+
+  return strings.index (elems);
+}
+
+octave_value
+octave_lazy_cellstr::subsasgn (const std::string& type,
+                               const std::list<octave_value_list>& idx,
+                               const octave_value& rhs)
+{
+  // The result of an assignment is an ordinary cell array.  Release
+  // the cached Cell so that it can usually be modified in place.
+
+  octave_value tmp = make_value ();
+
+  value = octave_value ();
+
+  tmp.make_unique ();
+
+  return tmp.subsasgn (type, idx, rhs);
+}
+
+octave_value
+octave_lazy_cellstr::squeeze (void) const
+{
+  return strings.reshape (dims ().squeeze ());
+}
+
+octave_value
+octave_lazy_cellstr::permute (const Array<int>& vec, bool inv) const
+{
+  const char *who = (inv ? "ipermute" : "permute");
+
+  dim_vector dv = dims ();
+
+  int n = vec.numel ();
+
+  if (n < dv.ndims ())
+    error ("%s: invalid permutation vector", who);
+
+  dv.resize (n, 1);
+
+  // Element K of the result is element VEC(K) of the original, or the
+  // other way around for the inverse.
+
+  Array<int> src (dim_vector (n, 1));
+  std::vector<bool> checked (n, false);
+
+  for (int k = 0; k < n; k++)
+    {
+      int p = vec(k);
+
+      if (p < 0 || p >= n)
+        error ("%s: permutation vector contains an invalid element", who);
+
+      if (checked[p])
+        error ("%s: permutation vector cannot contain identical elements",
+               who);
+
+      checked[p] = true;
+
+      if (inv)
+        src(p) = k;
+      else
+        src(k) = p;
+    }
+
+  Array<octave_idx_type> stride (dim_vector (n, 1));
+  octave_idx_type s = 1;
+  for (int k = 0; k < n; k++)
+    {
+      stride(k) = s;
+      s *= dv(k);
+    }
+
+  dim_vector rdv = dim_vector::alloc (n);
+  Array<octave_idx_type> rstride (dim_vector (n, 1));
+  for (int k = 0; k < n; k++)
+    {
+      rdv(k) = dv(src(k));
+      rstride(k) = stride(src(k));
+    }
+
+  Array<octave_idx_type> elems (rdv);
+
+  if (elems.numel () > 0)
+    {
+      Array<idx_vector> ia (dim_vector (n, 1), idx_vector::colon);
+      octave_idx_type *dest = elems.fortran_vec ();
+      gather_positions (ia, rdv, rstride, n - 1, 0, dest);
+    }
+
+  rdv.chop_trailing_singletons ();
+
+  return strings.index (elems.reshape (rdv));
+}
+
+octave_value
+octave_lazy_cellstr::sort (octave_idx_type dim, sortmode mode) const
+{
+  Array<std::string> tmp = strings.cellstr_value ();
+
+  return octave::string_array (tmp.sort (dim, mode));
+}
+
+octave_value
+octave_lazy_cellstr::sort (Array<octave_idx_type> &sidx, octave_idx_type dim,
+                           sortmode mode) const
+{
+  Array<std::string> tmp = strings.cellstr_value ();
+
+  return octave::string_array (tmp.sort (sidx, dim, mode));
+}
+
+octave_value
+octave_lazy_cellstr::map (unary_mapper_t umap) const
+{
+  switch (umap)
+    {
+    // Changing case does not change the lengths of the strings, so the
+    // character offsets can be shared.
+    case umap_xtolower:
+      return octave::string_array
+               (dims (), strings.chars ().map<char, int (&) (int)> (std::tolower),
+                strings.offsets ());
+
+    case umap_xtoupper:
+      return octave::string_array
+               (dims (), strings.chars ().map<char, int (&) (int)> (std::toupper),
+                strings.offsets ());
+
+    default:
+      return make_value ().map (umap);
+    }
+}
+
+static const std::string value_save_tag ("cellstr_value");
+
+bool octave_lazy_cellstr::save_ascii (std::ostream& os)
+{
+  return save_text_data (os, make_value (), value_save_tag, false, 0);
+}
+
+bool octave_lazy_cellstr::load_ascii (std::istream& is)
+{
+  bool dummy;
+
+  std::string nm = read_text_data (is, "", dummy, value, 0);
+  if (nm != value_save_tag)
+    error ("lazy_cellstr: corrupted data on load");
+
+  strings = value.string_array_value ();
+
+  return true;
+}
+
+bool octave_lazy_cellstr::save_binary (std::ostream& os, bool& save_as_floats)
+{
+  return save_binary_data (os, make_value (), value_save_tag,
+                           "", false, save_as_floats);
+}
+
+bool octave_lazy_cellstr::load_binary (std::istream& is, bool swap,
+                                       octave::mach_info::float_format fmt)
+{
+  bool dummy;
+  std::string doc;
+
+  std::string nm = read_binary_data (is, swap, fmt, "", dummy, value, doc);
+  if (nm != value_save_tag)
+    error ("lazy_cellstr: corrupted data on load");
+
+  strings = value.string_array_value ();
+
+  return true;
+}
+
+/*
+## Indexing a packed cellstr gives the same result as an ordinary cell.
+%!test
+%! c = cellstr (char ("a", "bb", "ccc", "dddd", "e", "ff"));
+%! d = {"a"; "bb"; "ccc"; "dddd"; "e"; "ff"};
+%! assert (c(2:4), d(2:4));
+%! assert (c([6 1 1]), d([6 1 1]));
+%! assert (c(logical ([1 0 1 0 0 1])), d(logical ([1 0 1 0 0 1])));
+%! assert (c([2 3; 4 5]), d([2 3; 4 5]));
+%! assert (c(:,1), d(:,1));
+%! assert (c(end:-1:1,1), d(end:-1:1,1));
+%! c = reshape (c, 1, 2, 3);
+%! d = reshape (d, 1, 2, 3);
+%! assert (c(1,:,2:3), d(1,:,2:3));
+%! assert (c(1,[2 1],:), d(1,[2 1],:));
+%! assert (c(:,5), d(:,5));
+%! assert (permute (c, [3 1 2]), permute (d, [3 1 2]));
+%! assert (ipermute (c, [3 1 2]), ipermute (d, [3 1 2]));
+
+%!error <out of bound> c = cellstr (char ("a", "b")); c(3)
+%!error <out of bound> c = cellstr (char ("a", "b")); c(1,2)
+%!error <identical elements> permute (cellstr (char ("a", "b")), [1 1])
+*/
@@ -0,0 +1,210 @@
+/*
+
+Copyright (C) 2016 The Octave Project Developers
+
+This file is part of Octave.
+
+Octave is free software; you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+Octave is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Octave; see the file COPYING.  If not, see
+<http://www.gnu.org/licenses/>.
+
+*/
+
+#if ! defined (octave_ov_lazy_cellstr_h)
+#define octave_ov_lazy_cellstr_h 1
+
+#include "octave-config.h"
+
+#include "str-array.h"
+
+#include "ov-cell.h"
+
+// Cell arrays of strings that stay in string_array form until a Cell
+// of individual character matrices is actually needed.  Each element
+// is a character row vector, or a 0x0 character matrix if empty.
+
+class
+OCTINTERP_API
+octave_lazy_cellstr : public octave_base_value
+{
+public:
+
+  octave_lazy_cellstr (void)
+    : octave_base_value (), strings (), value () { }
+
+  octave_lazy_cellstr (const octave::string_array& strs)
+    : octave_base_value (), strings (strs), value () { }
+
+  octave_lazy_cellstr (const octave_lazy_cellstr& s)
+    : octave_base_value (), strings (s.strings), value (s.value) { }
+
+  ~octave_lazy_cellstr (void) = default;
+
+  octave_base_value *clone (void) const
+  { return new octave_lazy_cellstr (*this); }
+  octave_base_value *empty_clone (void) const { return new octave_cell (); }
+
+  type_conv_info numeric_conversion_function (void) const;
+
+  octave_value fast_elem_extract (octave_idx_type n) const;
+
+  size_t byte_size (void) const { return strings.byte_size (); }
+
+  octave_value squeeze (void) const;
+
+  octave_value full_value (void) const { return make_value (); }
+
+  octave_value subsref (const std::string& type,
+                        const std::list<octave_value_list>& idx)
+  {
+    octave_value_list tmp = subsref (type, idx, 1);
+    return tmp.length () > 0 ? tmp(0) : octave_value ();
+  }
+
+  octave_value_list subsref (const std::string& type,
+                             const std::list<octave_value_list>& idx,
+                             int nargout)
+  {
+    return subsref (type, idx, nargout, 0);
+  }
+
+  octave_value_list subsref (const std::string& type,
+                             const std::list<octave_value_list>& idx,
+                             int nargout,
+                             const std::list<octave_lvalue> *lvalue_list);
+
+  octave_value subsref (const std::string& type,
+                        const std::list<octave_value_list>& idx,
+                        bool auto_add)
+  { return make_value ().subsref (type, idx, auto_add); }
+
+  octave_value do_index_op (const octave_value_list& idx,
+                            bool resize_ok = false);
+
+  octave_value subsasgn (const std::string& type,
+                         const std::list<octave_value_list>& idx,
+                         const octave_value& rhs);
+
+  dim_vector dims (void) const { return strings.dims (); }
+
+  octave_idx_type numel (void) const { return strings.numel (); }
+
+  octave_value reshape (const dim_vector& new_dims) const
+  { return strings.reshape (new_dims); }
+
+  octave_value permute (const Array<int>& vec, bool inv = false) const;
+
+  octave_value resize (const dim_vector& dv, bool fill = false) const
+  { return make_value ().resize (dv, fill); }
+
+  octave_value sort (octave_idx_type dim = 0, sortmode mode = ASCENDING) const;
+
+  octave_value sort (Array<octave_idx_type> &sidx, octave_idx_type dim = 0,
+                     sortmode mode = ASCENDING) const;
+
+  sortmode is_sorted (sortmode mode = UNSORTED) const
+  { return strings.cellstr_value ().is_sorted (mode); }
+
+  Array<octave_idx_type> sort_rows_idx (sortmode mode = ASCENDING) const
+  { return strings.cellstr_value ().sort_rows_idx (mode); }
+
+  sortmode is_sorted_rows (sortmode mode = UNSORTED) const
+  { return strings.cellstr_value ().is_sorted_rows (mode); }
+
+  bool is_defined (void) const { return true; }
+
+  bool is_constant (void) const { return true; }
+
+  bool is_cell (void) const { return true; }
+
+  bool is_cellstr (void) const { return true; }
+
+  builtin_type_t builtin_type (void) const { return btyp_cell; }
+
+  bool is_true (void) const { return make_value ().is_true (); }
+
+  Cell cell_value (void) const { return make_value ().cell_value (); }
+
+  octave_value_list list_value (void) const
+  { return make_value ().list_value (); }
+
+  octave_value convert_to_str_internal (bool pad, bool force, char type) const
+  { return make_value ().convert_to_str_internal (pad, force, type); }
+
+  string_vector string_vector_value (bool pad = false) const
+  { return make_value ().string_vector_value (pad); }
+
+  Array<std::string> cellstr_value (void) const
+  { return strings.cellstr_value (); }
+
+  octave::string_array string_array_value (void) const { return strings; }
+
+  bool print_as_scalar (void) const { return true; }
+
+  void print (std::ostream& os, bool pr_as_read_syntax = false)
+  { make_value ().print (os, pr_as_read_syntax); }
+
+  void print_raw (std::ostream& os, bool pr_as_read_syntax = false) const
+  { make_value ().print_raw (os, pr_as_read_syntax); }
+
+  bool print_name_tag (std::ostream& os, const std::string& name) const
+  { return make_value ().print_name_tag (os, name); }
+
+  void print_info (std::ostream& os, const std::string& prefix) const
+  { make_value ().print_info (os, prefix); }
+
+  void short_disp (std::ostream& os) const { make_value ().short_disp (os); }
+
+  bool save_ascii (std::ostream& os);
+
+  bool load_ascii (std::istream& is);
+
+  bool save_binary (std::ostream& os, bool& save_as_floats);
+
+  bool load_binary (std::istream& is, bool swap,
+                    octave::mach_info::float_format fmt);
+
+  octave_value map (unary_mapper_t umap) const;
+
+  mxArray *as_mxArray (void) const { return make_value ().as_mxArray (); }
+
+private:
+
+  const octave_value& make_value (void) const
+  {
+    if (value.is_undefined ())
+      value = octave_value (make_cell ());
+
+    return value;
+  }
+
+  octave_value& make_value (void)
+  {
+    if (value.is_undefined ())
+      value = octave_value (make_cell ());
+
+    return value;
+  }
+
+  Cell make_cell (void) const;
+
+  octave::string_array strings;
+  mutable octave_value value;
+
+  static octave_base_value *
+  numeric_conversion_function (const octave_base_value&);
+
+  DECLARE_OV_TYPEID_FUNCTIONS_AND_DATA
+};
+
+#endif
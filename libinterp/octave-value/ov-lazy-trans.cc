@@ -0,0 +1,307 @@
+/*
+
+Copyright (C) 2016 The Octave Project Developers
+
+This file is part of Octave.
+
+Octave is free software; you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+Octave is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Octave; see the file COPYING.  If not, see
+<http://www.gnu.org/licenses/>.
+
+*/
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include "CMatrix.h"
+#include "dMatrix.h"
+#include "lo-array-errwarn.h"
+
+#include "ov-lazy-trans.h"
+#include "ov-cx-mat.h"
+#include "ovl.h"
+#include "ls-oct-text.h"
+#include "ls-oct-binary.h"
+
+DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA (octave_lazy_transpose, "lazy_transpose",
+                                     "double");
+
+static octave_base_value *
+default_numeric_conversion_function (const octave_base_value& a)
+{
+  const octave_lazy_transpose& v
+    = dynamic_cast<const octave_lazy_transpose&> (a);
+
+  return v.full_value ().clone ();
+}
+
+octave_base_value::type_conv_info
+octave_lazy_transpose::numeric_conversion_function (void) const
+{
+  return octave_base_value::type_conv_info
+           (default_numeric_conversion_function,
+            (is_complex_type ()
+             ? octave_complex_matrix::static_type_id ()
+             : octave_matrix::static_type_id ()));
+}
+
+octave_value
+octave_lazy_transpose::make_transpose (void) const
+{
+  if (matrix.is_complex_type ())
+    {
+      ComplexMatrix m = matrix.complex_matrix_value ();
+
+      return hermitian ? m.hermitian () : m.transpose ();
+    }
+  else
+    return matrix.matrix_value ().transpose ();
+}
+
+octave_value
+octave_lazy_transpose::transpose_result (const octave_value& val) const
+{
+  return hermitian ? op_hermitian (val) : op_transpose (val);
+}
+
+octave_value
+octave_lazy_transpose::fast_elem_extract (octave_idx_type n) const
+{
+  if (is_formed ())
+    return value.fast_elem_extract (n);
+
+  dim_vector dv = matrix.dims ();
+
+  if (n >= dv.numel ())
+    return octave_value ();
+
+  // Element N of the transpose is element (N / NC, N % NC) of the
+  // NR-by-NC original matrix.
+
+  octave_idx_type nr = dv(0);
+  octave_idx_type nc = dv(1);
+
+  octave_value retval = matrix.fast_elem_extract (n / nc + (n % nc) * nr);
+
+  if (hermitian && retval.is_defined ())
+    retval = std::conj (retval.complex_value ());
+
+  return retval;
+}
+
+octave_value
+octave_lazy_transpose::subsref (const std::string& type,
+                                const std::list<octave_value_list>& idx)
+{
+  if (type[0] != '(')
+    return make_value ().subsref (type, idx);
+
+  octave_value retval = do_index_op (idx.front ());
+
+  return retval.next_subsref (type, idx);
+}
+
+octave_value
+octave_lazy_transpose::do_index_op (const octave_value_list& idx,
+                                    bool resize_ok)
+{
+  if (! resize_ok && ! is_formed ())
+    {
+      try
+        {
+          if (idx.length () == 2)
+            {
+              // A.'(I,J) is A(J,I).', which is usually much smaller
+              // than A.'.
+
+              return transpose_result (matrix.do_index_op (ovl (idx(1),
+                                                                idx(0))));
+            }
+          else if (idx.length () == 1)
+            {
+              idx_vector i = idx(0).index_vector ();
+
+              if (i.is_scalar () && i(0) < numel ())
+                return fast_elem_extract (i(0));
+            }
+        }
+      catch (const octave::index_exception&)
+        {
+          // Report the error for the indices as they were given.
+        }
+    }
+
+  return make_value ().do_index_op (idx, resize_ok);
+}
+
+octave_value
+octave_lazy_transpose::permute (const Array<int>& vec, bool inv) const
+{
+  // Exchanging the dimensions again gives the original matrix, which
+  // is not conjugated.
+
+  if (! is_formed () && vec.numel () == 2 && vec(0) == 1 && vec(1) == 0)
+    return hermitian ? matrix.map (umap_conj) : matrix;
+  else
+    return make_value ().permute (vec, inv);
+}
+
+void
+octave_lazy_transpose::set_value (const octave_value& val)
+{
+  value = val;
+  matrix = octave_value ();
+  hermitian = false;
+}
+
+static const std::string value_save_tag ("transpose_value");
+
+bool octave_lazy_transpose::save_ascii (std::ostream& os)
+{
+  return save_text_data (os, make_value (), value_save_tag, false, 0);
+}
+
+bool octave_lazy_transpose::load_ascii (std::istream& is)
+{
+  bool dummy;
+  octave_value val;
+
+  std::string nm = read_text_data (is, "", dummy, val, 0);
+  if (nm != value_save_tag)
+    error ("lazy_transpose: corrupted data on load");
+
+  set_value (val);
+
+  return true;
+}
+
+bool octave_lazy_transpose::save_binary (std::ostream& os,
+                                         bool& save_as_floats)
+{
+  return save_binary_data (os, make_value (), value_save_tag,
+                           "", false, save_as_floats);
+}
+
+bool octave_lazy_transpose::load_binary (std::istream& is, bool swap,
+                                         octave::mach_info::float_format fmt)
+{
+  bool dummy;
+  std::string doc;
+  octave_value val;
+
+  std::string nm = read_binary_data (is, swap, fmt, "", dummy, val, doc);
+  if (nm != value_save_tag)
+    error ("lazy_transpose: corrupted data on load");
+
+  set_value (val);
+
+  return true;
+}
+
+/*
+%!shared a, c
+%! a = magic (4)(:, 1:3);
+%! c = a + 1i * fliplr (a);
+
+%!test
+%! at = a';
+%! b = full (at);
+%! assert (typeinfo (at), "lazy_transpose");
+%! assert (class (at), "double");
+%! assert (size (at), [3, 4]);
+%! assert (typeinfo (b), "matrix");
+%! assert (b, [a(:,1)'; a(:,2)'; a(:,3)']);
+%! assert (at', a);
+%! assert (typeinfo (at'), "matrix");
+%! assert (permute (a, [2, 1]), b);
+%! assert (permute (at, [2, 1]), a);
+%! assert (at * a, b * a);
+%! assert (a * at, a * b);
+%! assert (at * at', b * a);
+%! assert (at * c, b * c);
+%! assert (at(2, 3), a(3, 2));
+%! assert (at(2:3, [1, 4]), b(2:3, [1, 4]));
+%! assert (at(:, end), b(:, end));
+%! assert (at(5), b(5));
+%! assert (at(:), b(:));
+%! assert (sum (at), sum (b));
+%! assert (sum (at, 2), sum (b, 2));
+%! assert (cumsum (at), cumsum (b));
+%! assert (prod (at, 2), prod (b, 2));
+%! assert (-at, -b);
+%! assert (at + 1, b + 1);
+
+%!test
+%! ct = c';
+%! b = full (ct);
+%! assert (b, conj (full (c.')));
+%! assert (ct', c);
+%! assert (ct.', conj (c));
+%! assert (permute (ct, [2, 1]), conj (c));
+%! assert (ct * c, b * c);
+%! assert (c * ct, c * b);
+%! assert (ct(2, 3), conj (c(3, 2)));
+%! assert (ct(7), b(7));
+%! assert (sum (ct), sum (b));
+%! assert (cumsum (ct, 2), cumsum (b, 2));
+
+%!test
+%! at = magic (3)';
+%! assert (at \ [1; 2; 3], full (at) \ [1; 2; 3], -1e-12);
+%! ct = (magic (3) + 2i * eye (3))';
+%! assert (ct \ [1; 2; 3], full (ct) \ [1; 2; 3], -1e-12);
+
+%!test
+%! at = a';
+%! f = tempname ();
+%! unwind_protect
+%!   save ("-text", f, "at");
+%!   s = load (f);
+%!   assert (s.at, full (at));
+%!   save ("-binary", f, "at");
+%!   s = load (f);
+%!   assert (s.at, full (at));
+%! unwind_protect_cleanup
+%!   unlink (f);
+%! end_unwind_protect
+
+## Operations on a transpose that has been formed
+%!test
+%! at = a';
+%! b = full (at);
+%! assert (at(:), b(:));
+%! assert (typeinfo (at), "lazy_transpose");
+%! assert (size (at), [3, 4]);
+%! assert (at', a);
+%! assert (permute (at, [2, 1]), a);
+%! assert (at * a, b * a);
+%! assert (a * at, a * b);
+%! assert (at \ b, b \ b, -1e-12);
+%! assert (at(2, 3), a(3, 2));
+%! assert (at(2:3, [1, 4]), b(2:3, [1, 4]));
+%! assert (sum (at), sum (b));
+%! assert (sum (at, 2), sum (b, 2));
+%! ct = c';
+%! b = full (ct);
+%! assert (ct(7), b(7));
+%! assert (ct(:), b(:));
+%! assert (ct', c);
+%! assert (ct.', conj (c));
+%! assert (ct * c, b * c);
+%! assert (sum (ct, 2), sum (b, 2));
+
+%!error <out of bound; value 5 out of bound 3>
+%! at = magic (4)(:, 1:3)';
+%! at(5, 1);
+*/
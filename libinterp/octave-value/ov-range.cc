@@ -24,6 +24,8 @@ along with Octave; see the file COPYING.  If not, see
 #  include "config.h"
 #endif
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 #include "dNDArray.h"
@@ -128,6 +130,38 @@ octave_range::subsref (const std::string& type,
   return retval.next_subsref (type, idx);
 }
 
+// Index R with a single subscript.  The elements of a range of
+// integers selected by a range of indices form another range with
+// exactly the same values, so that result is not stored.
+
+static octave_value
+index_range (const Range& r, const idx_vector& i)
+{
+  octave_idx_type n = r.numel ();
+
+  if (i.is_scalar () && i(0) < n)
+    return r.elem (i(0));
+
+  octave_idx_type len = i.length (n);
+
+  if (i.is_range () && len > 1 && i.extent (n) == n
+      && r.all_elements_are_ints ()
+      && std::max (std::abs (r.base ()), std::abs (r.limit ()))
+         < 9007199254740992.0)
+    {
+      Range retval (r.elem (i(0)), r.inc () * i.increment (), len);
+
+      // The last element may be -0, which the new range would not have.
+      double last = r.elem (i(len-1));
+
+      if (retval.limit () == last
+          && std::signbit (retval.limit ()) == std::signbit (last))
+        return retval;
+    }
+
+  return r.index (i);
+}
+
 octave_value
 octave_range::do_index_op (const octave_value_list& idx, bool resize_ok)
 {
@@ -141,10 +175,7 @@ octave_range::do_index_op (const octave_value_list& idx, bool resize_ok)
         {
           idx_vector i = idx(0).index_vector ();
 
-          if (i.is_scalar () && i(0) < range.numel ())
-            retval = range.elem (i(0));
-          else
-            retval = range.index (i);
+          retval = index_range (range, i);
         }
       catch (octave::index_exception& e)
         {
@@ -156,6 +187,50 @@ octave_range::do_index_op (const octave_value_list& idx, bool resize_ok)
 
       return retval;
     }
+  else if (idx.length () == 2 && ! resize_ok)
+    {
+      // A range is a row vector, so R(1,J) and R(:,J) are the same as
+      // R(J) with the shape of a row.
+
+      octave_idx_type n = range.numel ();
+
+      int k = 0;
+
+      try
+        {
+          idx_vector i = idx(0).index_vector ();
+
+          if (i.is_colon_equiv (1))
+            {
+              k = 1;
+              idx_vector j = idx(1).index_vector ();
+
+              if (j.extent (n) != n)
+                octave::err_index_out_of_range (2, 2, j.extent (n), n,
+                                                dims ());
+
+              octave_value retval = index_range (range, j);
+
+              dim_vector dv (1, j.length (n));
+
+              if (retval.dims () != dv)
+                retval = retval.reshape (dv);
+
+              return retval;
+            }
+        }
+      catch (octave::index_exception& e)
+        {
+          // More info may be added later before displaying error.
+
+          e.set_pos_if_unset (2, k+1);
+          throw;
+        }
+
+      octave_value tmp (new octave_matrix (range.matrix_value ()));
+
+      return tmp.do_index_op (idx, resize_ok);
+    }
   else
     {
       octave_value tmp (new octave_matrix (range.matrix_value ()));
@@ -269,6 +269,8 @@ public:
 
   bool fast_elem_insert_self (void *where, builtin_type_t btyp) const;
 
+  DECLARE_OV_FIXED_SIZE_ALLOCATOR (octave_scalar)
+
 private:
 
   DECLARE_OV_TYPEID_FUNCTIONS_AND_DATA
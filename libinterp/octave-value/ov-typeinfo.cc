@@ -317,6 +317,8 @@ octave_value_typeinfo::do_register_binary_op (octave_value::binary_op op,
   binary_ops.checkelem (static_cast<int> (op), t1, t2)
     = reinterpret_cast<void *> (f);
 
+  binary_op_changes++;
+
   return false;
 }
 
@@ -136,6 +136,15 @@ public:
     return instance->do_lookup_binary_op (op, t1, t2);
   }
 
+  // The number of binary operator functions that have been registered.
+  // Lookups made before a change of this number may be out of date.
+
+  static int
+  binary_op_generation (void)
+  {
+    return instance->binary_op_changes;
+  }
+
   static binary_class_op_fcn
   lookup_binary_class_op (octave_value::compound_binary_op op)
   {
@@ -204,7 +213,8 @@ protected:
       assign_ops (dim_vector (octave_value::num_assign_ops, init_tab_sz, init_tab_sz), 0),
       assignany_ops (dim_vector (octave_value::num_assign_ops, init_tab_sz), 0),
       pref_assign_conv (dim_vector (init_tab_sz, init_tab_sz), -1),
-      widening_ops (dim_vector (init_tab_sz, init_tab_sz), 0)  { }
+      widening_ops (dim_vector (init_tab_sz, init_tab_sz), 0),
+      binary_op_changes (0) { }
 
   // No copying!
 
@@ -252,6 +262,8 @@ private:
 
   Array<void *> widening_ops;
 
+  int binary_op_changes;
+
   int do_register_type (const std::string&, const std::string&,
                         const octave_value&);
 
@@ -76,7 +76,9 @@ along with Octave; see the file COPYING.  If not, see
 #include "ov-fcn-inline.h"
 #include "ov-typeinfo.h"
 #include "ov-null-mat.h"
+#include "ov-lazy-cellstr.h"
 #include "ov-lazy-idx.h"
+#include "ov-lazy-trans.h"
 #include "ov-java.h"
 
 #include "defun.h"
@@ -1088,6 +1090,12 @@ octave_value::octave_value (const Array<std::string>& cellstr)
   maybe_mutate ();
 }
 
+octave_value::octave_value (const octave::string_array& strs)
+  : rep (new octave_lazy_cellstr (strs))
+{
+  maybe_mutate ();
+}
+
 octave_value::octave_value (double base, double limit, double inc)
   : rep (new octave_range (base, limit, inc))
 {
@@ -2210,6 +2218,60 @@ err_binary_op_conv (const std::string& on)
   error ("type conversion failed for binary operator '%s'", on.c_str ());
 }
 
+// Evaluate the most common operators for two real scalars directly,
+// without looking up the operator function.  Return false if OP is not
+// handled here.
+
+static inline bool
+do_scalar_binary_op (octave_value::binary_op op, double a, double b,
+                     octave_value& retval)
+{
+  switch (op)
+    {
+    case octave_value::op_add:
+      retval = octave_value (a + b);
+      break;
+
+    case octave_value::op_sub:
+      retval = octave_value (a - b);
+      break;
+
+    case octave_value::op_mul:
+    case octave_value::op_el_mul:
+      retval = octave_value (a * b);
+      break;
+
+    case octave_value::op_lt:
+      retval = octave_value (a < b);
+      break;
+
+    case octave_value::op_le:
+      retval = octave_value (a <= b);
+      break;
+
+    case octave_value::op_eq:
+      retval = octave_value (a == b);
+      break;
+
+    case octave_value::op_ge:
+      retval = octave_value (a >= b);
+      break;
+
+    case octave_value::op_gt:
+      retval = octave_value (a > b);
+      break;
+
+    case octave_value::op_ne:
+      retval = octave_value (a != b);
+      break;
+
+    default:
+      return false;
+    }
+
+  return true;
+}
+
 octave_value
 do_binary_op (octave_value::binary_op op,
               const octave_value& v1, const octave_value& v2)
@@ -2219,6 +2281,12 @@ do_binary_op (octave_value::binary_op op,
   int t1 = v1.type_id ();
   int t2 = v2.type_id ();
 
+  if (t1 == octave_scalar::static_type_id ()
+      && t2 == octave_scalar::static_type_id ()
+      && do_scalar_binary_op (op, v1.rep->scalar_value (),
+                              v2.rep->scalar_value (), retval))
+    return retval;
+
   if (t1 == octave_class::static_type_id ()
       || t2 == octave_class::static_type_id ()
       || t1 == octave_classdef::static_type_id ()
@@ -2352,6 +2420,49 @@ do_binary_op (octave_value::binary_op op,
   return retval;
 }
 
+octave_value
+do_binary_op (octave_value::binary_op op,
+              const octave_value& v1, const octave_value& v2,
+              octave_value::binary_op_cache& cache)
+{
+  int t1 = v1.type_id ();
+  int t2 = v2.type_id ();
+
+  int generation = octave_value_typeinfo::binary_op_generation ();
+
+  if (t1 != cache.t1 || t2 != cache.t2 || generation != cache.generation)
+    {
+      // Only operators that are applied to the operands as they are,
+      // without conversions, are cached.
+
+      octave_value_typeinfo::binary_op_fcn f = 0;
+
+      if (t1 != octave_class::static_type_id ()
+          && t2 != octave_class::static_type_id ()
+          && t1 != octave_classdef::static_type_id ()
+          && t2 != octave_classdef::static_type_id ())
+        f = octave_value_typeinfo::lookup_binary_op (op, t1, t2);
+
+      if (! f)
+        return do_binary_op (op, v1, v2);
+
+      cache.t1 = t1;
+      cache.t2 = t2;
+      cache.generation = generation;
+      cache.fcn = f;
+    }
+
+  octave_value retval;
+
+  if (t1 == octave_scalar::static_type_id ()
+      && t2 == octave_scalar::static_type_id ()
+      && do_scalar_binary_op (op, v1.rep->scalar_value (),
+                              v2.rep->scalar_value (), retval))
+    return retval;
+
+  return cache.fcn (*v1.rep, *v2.rep);
+}
+
 static octave_value
 decompose_binary_op (octave_value::compound_binary_op op,
                      const octave_value& v1, const octave_value& v2)
@@ -2961,6 +3072,8 @@ install_types (void)
   octave_null_str::register_type ();
   octave_null_sq_str::register_type ();
   octave_lazy_index::register_type ();
+  octave_lazy_cellstr::register_type ();
+  octave_lazy_transpose::register_type ();
   octave_oncleanup::register_type ();
   octave_java::register_type ();
 }
@@ -147,6 +147,23 @@ public:
     unknown_assign_op
   };
 
+  // The operator function found for the operand types of the last
+  // evaluation of a binary expression.  Expressions that are evaluated
+  // repeatedly, for example in loops, keep one of these so that they
+  // need not look up the function again while the types are the same.
+
+  class binary_op_cache
+  {
+  public:
+
+    binary_op_cache (void) : t1 (-1), t2 (-1), generation (-1), fcn (0) { }
+
+    int t1;
+    int t2;
+    int generation;
+    octave_value (*fcn) (const octave_base_value&, const octave_base_value&);
+  };
+
   static binary_op assign_op_to_binary_op (assign_op);
 
   static assign_op binary_op_to_assign_op (binary_op);
@@ -284,6 +301,7 @@ public:
   octave_value (const Array<octave_idx_type>& inda,
                 bool zero_based = false, bool cache_index = false);
   octave_value (const Array<std::string>& cellstr);
+  octave_value (const octave::string_array& strs);
   octave_value (const idx_vector& idx, bool lazy = true);
   octave_value (double base, double limit, double inc);
   octave_value (const Range& r, bool force_range = false);
@@ -920,6 +938,9 @@ public:
   Array<std::string> cellstr_value (void) const
   { return rep->cellstr_value (); }
 
+  octave::string_array string_array_value (void) const
+  { return rep->string_array_value (); }
+
   Range range_value (void) const
   { return rep->range_value (); }
 
@@ -1251,6 +1272,11 @@ public:
                                                   const octave_value& a,
                                                   const octave_value& b);
 
+  friend OCTINTERP_API octave_value do_binary_op (binary_op op,
+                                                  const octave_value& a,
+                                                  const octave_value& b,
+                                                  binary_op_cache& cache);
+
   friend OCTINTERP_API octave_value do_cat_op (const octave_value& a,
                                                const octave_value& b,
                                                const Array<octave_idx_type>& ra_idx);
@@ -1463,6 +1489,11 @@ extern OCTINTERP_API octave_value
 do_binary_op (octave_value::compound_binary_op op,
               const octave_value& a, const octave_value& b);
 
+extern OCTINTERP_API octave_value
+do_binary_op (octave_value::binary_op op,
+              const octave_value& a, const octave_value& b,
+              octave_value::binary_op_cache& cache);
+
 #define OV_UNOP_FN(name)                        \
   inline octave_value                           \
   name (const octave_value& a)                  \
@@ -77,6 +77,7 @@ LIBINTERP_OPERATORS_SRC = \
   libinterp/operators/op-i64-i64.cc \
   libinterp/operators/op-i8-i8.cc \
   libinterp/operators/op-int-concat.cc \
+  libinterp/operators/op-lazy-trans.cc \
   libinterp/operators/op-m-cdm.cc \
   libinterp/operators/op-m-cm.cc \
   libinterp/operators/op-m-cs.cc \
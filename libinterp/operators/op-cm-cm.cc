@@ -29,6 +29,7 @@ along with Octave; see the file COPYING.  If not, see
 #include "ov.h"
 #include "ov-cx-mat.h"
 #include "ov-flt-cx-mat.h"
+#include "ov-lazy-trans.h"
 #include "ov-typeinfo.h"
 #include "ov-null-mat.h"
 #include "ops.h"
@@ -49,6 +50,10 @@ DEFUNOP (transpose, complex_matrix)
   if (v.ndims () > 2)
     error ("transpose not defined for N-D objects");
 
+  if (v.rows () > 1 && v.columns () > 1)
+    return octave_value (new octave_lazy_transpose (octave_value (a.clone ()),
+                                                   false));
+
   return octave_value (v.complex_matrix_value ().transpose ());
 }
 
@@ -60,6 +65,10 @@ DEFUNOP (hermitian, complex_matrix)
   if (v.ndims () > 2)
     error ("complex-conjugate transpose not defined for N-D objects");
 
+  if (v.rows () > 1 && v.columns () > 1)
+    return octave_value (new octave_lazy_transpose (octave_value (a.clone ()),
+                                                   true));
+
   return octave_value (v.complex_matrix_value ().hermitian ());
 }
 
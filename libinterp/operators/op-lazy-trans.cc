@@ -0,0 +1,159 @@
+/*
+
+Copyright (C) 2016 The Octave Project Developers
+
+This file is part of Octave.
+
+Octave is free software; you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+Octave is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Octave; see the file COPYING.  If not, see
+<http://www.gnu.org/licenses/>.
+
+*/
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include "ovl.h"
+#include "ov.h"
+#include "ov-re-mat.h"
+#include "ov-cx-mat.h"
+#include "ov-lazy-trans.h"
+#include "ov-typeinfo.h"
+#include "ops.h"
+#include "xdiv.h"
+
+// The matrix to pass to BLAS or LAPACK for the operand A, and how to
+// transpose it.  A transpose that has already been formed is passed as
+// it is.
+
+static octave_value
+blas_operand (const octave_base_value& a, blas_trans_type& trans)
+{
+  if (a.type_id () == octave_lazy_transpose::static_type_id ())
+    {
+      const octave_lazy_transpose& v
+        = dynamic_cast<const octave_lazy_transpose&> (a);
+
+      if (! v.is_formed ())
+        {
+          trans = v.is_hermitian () ? blas_conj_trans : blas_trans;
+
+          return v.untransposed_value ();
+        }
+    }
+
+  trans = blas_no_trans;
+
+  return a.full_value ();
+}
+
+// lazy transpose unary ops.
+
+DEFUNOP (transpose, lazy_transpose)
+{
+  const octave_lazy_transpose& v
+    = dynamic_cast<const octave_lazy_transpose&> (a);
+
+  if (v.is_formed ())
+    return op_transpose (v.full_value ());
+
+  octave_value m = v.untransposed_value ();
+
+  return v.is_hermitian () ? m.map (octave_base_value::umap_conj) : m;
+}
+
+DEFUNOP (hermitian, lazy_transpose)
+{
+  const octave_lazy_transpose& v
+    = dynamic_cast<const octave_lazy_transpose&> (a);
+
+  if (v.is_formed ())
+    return op_hermitian (v.full_value ());
+
+  octave_value m = v.untransposed_value ();
+
+  return (v.is_hermitian () || ! m.is_complex_type ()
+          ? m : m.map (octave_base_value::umap_conj));
+}
+
+// Products with a lazy transpose, computed by xgemm with the transpose
+// flags.
+
+DEFBINOP (mul, lazy_transpose, any)
+{
+  blas_trans_type t1, t2;
+
+  octave_value m1 = blas_operand (a1, t1);
+  octave_value m2 = blas_operand (a2, t2);
+
+  if (m1.is_real_type () && m2.is_real_type ())
+    return xgemm (m1.matrix_value (), m2.matrix_value (), t1, t2);
+  else if (m1.is_complex_type () && m2.is_complex_type ())
+    return xgemm (m1.complex_matrix_value (), m2.complex_matrix_value (),
+                  t1, t2);
+  else
+    return do_binary_op (octave_value::op_mul, a1.full_value (),
+                         a2.full_value ());
+}
+
+// Left division by a lazy transpose, solved with the original matrix.
+
+DEFBINOP (ldiv, lazy_transpose, any)
+{
+  blas_trans_type t1;
+
+  octave_value m1 = blas_operand (a1, t1);
+
+  MatrixType typ = m1.matrix_type ();
+
+  octave_value retval;
+
+  if (m1.is_complex_type ())
+    {
+      if (a2.is_complex_type ())
+        retval = xleftdiv (m1.complex_matrix_value (),
+                           a2.complex_matrix_value (), typ, t1);
+      else
+        retval = xleftdiv (m1.complex_matrix_value (), a2.matrix_value (),
+                           typ, t1);
+    }
+  else
+    {
+      if (a2.is_complex_type ())
+        retval = xleftdiv (m1.matrix_value (), a2.complex_matrix_value (),
+                           typ, t1);
+      else
+        retval = xleftdiv (m1.matrix_value (), a2.matrix_value (), typ, t1);
+    }
+
+  m1.matrix_type (typ);
+
+  return retval;
+}
+
+void
+install_lazy_trans_ops (void)
+{
+  INSTALL_UNOP (op_transpose, octave_lazy_transpose, transpose);
+  INSTALL_UNOP (op_hermitian, octave_lazy_transpose, hermitian);
+
+  INSTALL_BINOP (op_mul, octave_lazy_transpose, octave_matrix, mul);
+  INSTALL_BINOP (op_mul, octave_lazy_transpose, octave_complex_matrix, mul);
+  INSTALL_BINOP (op_mul, octave_lazy_transpose, octave_lazy_transpose, mul);
+  INSTALL_BINOP (op_mul, octave_matrix, octave_lazy_transpose, mul);
+  INSTALL_BINOP (op_mul, octave_complex_matrix, octave_lazy_transpose, mul);
+
+  INSTALL_BINOP (op_ldiv, octave_lazy_transpose, octave_matrix, ldiv);
+  INSTALL_BINOP (op_ldiv, octave_lazy_transpose, octave_complex_matrix, ldiv);
+}
@@ -29,6 +29,7 @@ along with Octave; see the file COPYING.  If not, see
 #include "ov.h"
 #include "ov-re-mat.h"
 #include "ov-flt-re-mat.h"
+#include "ov-lazy-trans.h"
 #include "ov-typeinfo.h"
 #include "ov-null-mat.h"
 #include "ops.h"
@@ -48,6 +49,12 @@ DEFUNOP (transpose, matrix)
   if (v.ndims () > 2)
     error ("transpose not defined for N-D objects");
 
+  // Transposing a vector only changes its dimensions.  The transpose of
+  // any other matrix is only formed if it is needed.
+  if (v.rows () > 1 && v.columns () > 1)
+    return octave_value (new octave_lazy_transpose (octave_value (a.clone ()),
+                                                   false));
+
   return octave_value (v.matrix_value ().transpose ());
 }
 
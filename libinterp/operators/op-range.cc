@@ -24,6 +24,12 @@ along with Octave; see the file COPYING.  If not, see
 #  include "config.h"
 #endif
 
+#include <algorithm>
+#include <cmath>
+
+#include "lo-array-errwarn.h"
+#include "lo-mappers.h"
+
 #include "errwarn.h"
 #include "ovl.h"
 #include "ov.h"
@@ -66,6 +72,156 @@ DEFBINOP_OP (subrs, range, scalar, -)
 DEFBINOP_OP (subsr, scalar, range, -)
 DEFBINOP_OP (mulrs, range, scalar, *)
 DEFBINOP_OP (mulsr, scalar, range, *)
+// The following operations return a range only if every element of
+// the result is exactly the value that the operation gives for the
+// corresponding element of the full matrix.  That holds for integer
+// ranges and scalars when all values involved are exactly representable
+// integers.  Otherwise, the range is converted to a matrix first.  A
+// negative scalar could change the sign of zero elements, so it also
+// gives a matrix.
+
+// Integers of at most this magnitude are exactly representable.
+static const double range_max_exact_int = 9007199254740992.0;
+
+// Largest magnitude of the elements of R.
+
+static double
+range_bound (const Range& r)
+{
+  octave_idx_type n = r.numel ();
+
+  return (n > 0 ? std::max (std::abs (r.base ()), std::abs (r.elem (n-1)))
+                : 0.0);
+}
+
+static bool
+range_is_exact_int (const Range& r)
+{
+  return r.all_elements_are_ints () && range_bound (r) <= range_max_exact_int;
+}
+
+static bool
+scalar_is_positive_int (double x)
+{
+  return x > 0 && x <= range_max_exact_int && octave::math::isinteger (x);
+}
+
+static octave_value
+range_el_mul (const Range& r, double x)
+{
+  if (range_is_exact_int (r) && scalar_is_positive_int (x)
+      && range_bound (r) * x <= range_max_exact_int)
+    return octave_value (Range (r.base () * x, r.inc () * x, r.numel ()));
+  else
+    return octave_value (r.matrix_value () * x);
+}
+
+DEFBINOP (el_mulrs, range, scalar)
+{
+  const octave_range& v1 = dynamic_cast<const octave_range&> (a1);
+  const octave_scalar& v2 = dynamic_cast<const octave_scalar&> (a2);
+
+  return range_el_mul (v1.range_value (), v2.scalar_value ());
+}
+
+DEFBINOP (el_mulsr, scalar, range)
+{
+  const octave_scalar& v1 = dynamic_cast<const octave_scalar&> (a1);
+  const octave_range& v2 = dynamic_cast<const octave_range&> (a2);
+
+  return range_el_mul (v2.range_value (), v1.scalar_value ());
+}
+
+DEFBINOP (divrs, range, scalar)
+{
+  const octave_range& v1 = dynamic_cast<const octave_range&> (a1);
+  const octave_scalar& v2 = dynamic_cast<const octave_scalar&> (a2);
+
+  Range r = v1.range_value ();
+  double x = v2.scalar_value ();
+
+  // The base and increment must be multiples of X.
+  if (range_is_exact_int (r) && scalar_is_positive_int (x)
+      && std::fmod (r.base (), x) == 0
+      && (r.numel () <= 1 || std::fmod (r.inc (), x) == 0))
+    return octave_value (Range (r.base () / x, r.inc () / x, r.numel ()));
+  else
+    return octave_value (r.matrix_value () / x);
+}
+
+// The ranges must have the same number of elements.
+
+#define DEFRANGEADDOP(name, op, opname)                                 \
+  DEFBINOP (name, range, range)                                         \
+  {                                                                     \
+    const octave_range& v1 = dynamic_cast<const octave_range&> (a1);    \
+    const octave_range& v2 = dynamic_cast<const octave_range&> (a2);    \
+                                                                        \
+    Range r1 = v1.range_value ();                                       \
+    Range r2 = v2.range_value ();                                       \
+                                                                        \
+    octave_idx_type n = r1.numel ();                                    \
+                                                                        \
+    if (n != r2.numel ())                                               \
+      octave::err_nonconformant (opname, 1, n, 1, r2.numel ());         \
+                                                                        \
+    if (range_is_exact_int (r1) && range_is_exact_int (r2)             \
+        && range_bound (r1) + range_bound (r2) <= range_max_exact_int)  \
+      return octave_value (Range (r1.base () op r2.base (),             \
+                                  r1.inc () op r2.inc (), n));          \
+    else                                                                \
+      return octave_value (r1.matrix_value () op r2.matrix_value ());   \
+  }
+
+DEFRANGEADDOP (addrr, +, "operator +")
+DEFRANGEADDOP (subrr, -, "operator -")
+
+#undef DEFRANGEADDOP
+
+// Compare the elements of a range with a scalar without creating the
+// matrix of the range.
+
+#define DEFRANGECMPOP(name, op)                                         \
+  DEFBINOP (CONCAT2 (name, rs), range, scalar)                          \
+  {                                                                     \
+    const octave_range& v1 = dynamic_cast<const octave_range&> (a1);    \
+    const octave_scalar& v2 = dynamic_cast<const octave_scalar&> (a2);  \
+                                                                        \
+    Range r = v1.range_value ();                                        \
+    double s = v2.scalar_value ();                                      \
+                                                                        \
+    octave_idx_type n = r.numel ();                                     \
+    boolMatrix retval (1, n);                                           \
+    for (octave_idx_type i = 0; i < n; i++)                             \
+      retval.xelem (i) = r.elem (i) op s;                               \
+                                                                        \
+    return retval;                                                      \
+  }                                                                     \
+                                                                        \
+  DEFBINOP (CONCAT2 (name, sr), scalar, range)                          \
+  {                                                                     \
+    const octave_scalar& v1 = dynamic_cast<const octave_scalar&> (a1);  \
+    const octave_range& v2 = dynamic_cast<const octave_range&> (a2);    \
+                                                                        \
+    double s = v1.scalar_value ();                                      \
+    Range r = v2.range_value ();                                        \
+                                                                        \
+    octave_idx_type n = r.numel ();                                     \
+    boolMatrix retval (1, n);                                           \
+    for (octave_idx_type i = 0; i < n; i++)                             \
+      retval.xelem (i) = s op r.elem (i);                               \
+                                                                        \
+    return retval;                                                      \
+  }
+
+DEFRANGECMPOP (lt_, <)
+DEFRANGECMPOP (le_, <=)
+DEFRANGECMPOP (eq_, ==)
+DEFRANGECMPOP (ge_, >=)
+DEFRANGECMPOP (gt_, >)
+DEFRANGECMPOP (ne_, !=)
+
+#undef DEFRANGECMPOP
 
 DEFBINOP_FN (el_powsr, scalar, range, elem_xpow)
 DEFBINOP_FN (el_powcsr, complex, range, elem_xpow)
@@ -108,6 +264,26 @@ install_range_ops (void)
   INSTALL_BINOP (op_sub, octave_scalar, octave_range, subsr);
   INSTALL_BINOP (op_mul, octave_range, octave_scalar, mulrs);
   INSTALL_BINOP (op_mul, octave_scalar, octave_range, mulsr);
+  INSTALL_BINOP (op_el_mul, octave_range, octave_scalar, el_mulrs);
+  INSTALL_BINOP (op_el_mul, octave_scalar, octave_range, el_mulsr);
+  INSTALL_BINOP (op_div, octave_range, octave_scalar, divrs);
+  INSTALL_BINOP (op_el_div, octave_range, octave_scalar, divrs);
+
+  INSTALL_BINOP (op_add, octave_range, octave_range, addrr);
+  INSTALL_BINOP (op_sub, octave_range, octave_range, subrr);
+
+  INSTALL_BINOP (op_lt, octave_range, octave_scalar, lt_rs);
+  INSTALL_BINOP (op_le, octave_range, octave_scalar, le_rs);
+  INSTALL_BINOP (op_eq, octave_range, octave_scalar, eq_rs);
+  INSTALL_BINOP (op_ge, octave_range, octave_scalar, ge_rs);
+  INSTALL_BINOP (op_gt, octave_range, octave_scalar, gt_rs);
+  INSTALL_BINOP (op_ne, octave_range, octave_scalar, ne_rs);
+  INSTALL_BINOP (op_lt, octave_scalar, octave_range, lt_sr);
+  INSTALL_BINOP (op_le, octave_scalar, octave_range, le_sr);
+  INSTALL_BINOP (op_eq, octave_scalar, octave_range, eq_sr);
+  INSTALL_BINOP (op_ge, octave_scalar, octave_range, ge_sr);
+  INSTALL_BINOP (op_gt, octave_scalar, octave_range, gt_sr);
+  INSTALL_BINOP (op_ne, octave_scalar, octave_range, ne_sr);
 
   INSTALL_BINOP (op_el_pow, octave_scalar, octave_range, el_powsr);
   INSTALL_BINOP (op_el_pow, octave_complex, octave_range, el_powcsr);
@@ -125,7 +125,7 @@ tree_binary_expression::rvalue1 (int)
               // is entangled and it's not clear where to start/stop
               // timing the operator to make it reasonable.
 
-              retval = ::do_binary_op (etype, a, b);
+              retval = ::do_binary_op (etype, a, b, op_cache);
 
               END_PROFILER_BLOCK
             }
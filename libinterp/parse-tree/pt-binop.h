@@ -129,6 +129,9 @@ private:
   // for this operator.
   bool braindead_shortcircuit_warning_issued;
 
+  // The operator function for the operand types of the last evaluation.
+  octave_value::binary_op_cache op_cache;
+
   void matlab_style_short_circuit_warning (const char *op);
 };
 
@@ -40,6 +40,7 @@ along with Octave; see the file COPYING.  If not, see
 #include "interpreter.h"
 #include "ov-fcn-handle.h"
 #include "ov-usr-fcn.h"
+#include "profiler.h"
 #include "variables.h"
 #include "pt-all.h"
 #include "pt-eval.h"
@@ -351,11 +352,30 @@ namespace octave
                 iidx = 1;
               }
 
+            // For row vectors of the usual numeric, logical and cell
+            // types, extracting an element directly gives the same
+            // value as indexing and avoids building an index list on
+            // every iteration.
+            bool fast_extract = (nrows == 1
+                                 && (rhs.is_matrix_type () || rhs.is_cell ())
+                                 && ! rhs.is_string ()
+                                 && ! rhs.is_sparse_type ()
+                                 && ! rhs.is_diag_matrix ()
+                                 && ! rhs.is_perm_matrix ());
+
             for (octave_idx_type i = 1; i <= steps; i++)
               {
-                // do_index_op expects one-based indices.
-                idx(iidx) = i;
-                octave_value val = arg.do_index_op (idx);
+                octave_value val;
+
+                if (fast_extract)
+                  val = arg.fast_elem_extract (i-1);
+
+                if (val.is_undefined ())
+                  {
+                    // do_index_op expects one-based indices.
+                    idx(iidx) = i;
+                    val = arg.do_index_op (idx);
+                  }
 
                 ult.assign (octave_value::op_asn_eq, val);
 
@@ -644,6 +664,8 @@ namespace octave
             if (Vtrack_line_num)
               octave_call_stack::set_location (stmt.line (), stmt.column ());
 
+            profiler.enter_statement (stmt.line ());
+
             if ((statement_context == script
                  && ((Vecho_executing_commands & ECHO_SCRIPTS
                       && octave_call_stack::all_scripts ())
@@ -40,6 +40,7 @@ along with Octave; see the file COPYING.  If not, see
 #include "idx-vector.h"
 #include "lo-error.h"
 #include "lo-mappers.h"
+#include "lo-traits.h"
 #include "oct-locbuf.h"
 
 // One dimensional array class.  Handles the reference counting for
@@ -306,6 +307,43 @@ Array<T>::linear_slice (octave_idx_type lo, octave_idx_type up) const
   return Array<T> (*this, dim_vector (up - lo, 1), lo, up);
 }
 
+// Copy N blocks of LEN contiguous elements, the K-th from SRC + K*SSTEP
+// to DEST + K*DSTEP.  This is how concatenations fill their result.
+// Large copies are split into chunks for several threads.
+
+template <typename T>
+static void
+copy_blocks (const T *src, octave_idx_type sstep, T *dest,
+             octave_idx_type dstep, octave_idx_type len, octave_idx_type n)
+{
+  static const octave_idx_type chunk = 32768;
+
+  if (is_plain_data<T>::value && len > chunk)
+    {
+      octave_idx_type nchunk = (len + chunk - 1) / chunk;
+
+#if defined (HAVE_OPENMP)
+#  pragma omp parallel for if (n * len > 65536)
+#endif
+      for (octave_idx_type q = 0; q < n * nchunk; q++)
+        {
+          octave_idx_type k = q / nchunk;
+          octave_idx_type lo = (q % nchunk) * chunk;
+          octave_idx_type hi = std::min (lo + chunk, len);
+          std::copy (src + k*sstep + lo, src + k*sstep + hi,
+                     dest + k*dstep + lo);
+        }
+    }
+  else
+    {
+#if defined (HAVE_OPENMP)
+#  pragma omp parallel for if (is_plain_data<T>::value && n * len > 65536)
+#endif
+      for (octave_idx_type k = 0; k < n; k++)
+        std::copy (src + k*sstep, src + k*sstep + len, dest + k*dstep);
+    }
+}
+
 // Helper class for multi-d dimension permuting (generalized transpose).
 class rec_permute_helper
 {
@@ -365,45 +403,67 @@ public:
 
   ~rec_permute_helper (void) { delete [] dim; }
 
-  // Helper method for fast blocked transpose.
-  template <typename T>
+  // Helper method for fast blocked transpose, applying FCN to each
+  // element.  The tiles are just large enough for each of their columns
+  // to fill a cache line.  Each row of tiles fills a contiguous part of
+  // DEST, so large matrices are transposed by several threads.
+  template <typename T, typename F>
   static T *
-  blk_trans (const T *src, T *dest, octave_idx_type nr, octave_idx_type nc)
+  blk_trans (const T *src, T *dest, octave_idx_type nr, octave_idx_type nc,
+             F fcn)
   {
-    static const octave_idx_type m = 8;
-    OCTAVE_LOCAL_BUFFER (T, blk, m*m);
-    for (octave_idx_type kr = 0; kr < nr; kr += m)
-      for (octave_idx_type kc = 0; kc < nc; kc += m)
-        {
-          octave_idx_type lr = std::min (m, nr - kr);
-          octave_idx_type lc = std::min (m, nc - kc);
-          if (lr == m && lc == m)
-            {
-              const T *ss = src + kc * nr + kr;
-              for (octave_idx_type j = 0; j < m; j++)
-                for (octave_idx_type i = 0; i < m; i++)
-                  blk[j*m+i] = ss[j*nr + i];
-              T *dd = dest + kr * nc + kc;
-              for (octave_idx_type j = 0; j < m; j++)
-                for (octave_idx_type i = 0; i < m; i++)
-                  dd[j*nc+i] = blk[i*m+j];
-            }
-          else
-            {
-              const T *ss = src + kc * nr + kr;
-              for (octave_idx_type j = 0; j < lc; j++)
-                for (octave_idx_type i = 0; i < lr; i++)
-                  blk[j*m+i] = ss[j*nr + i];
-              T *dd = dest + kr * nc + kc;
-              for (octave_idx_type j = 0; j < lr; j++)
-                for (octave_idx_type i = 0; i < lc; i++)
-                  dd[j*nc+i] = blk[i*m+j];
-            }
-        }
+    static const octave_idx_type m = (sizeof (T) <= 4
+                                      ? 16 : (sizeof (T) <= 8 ? 8 : 4));
+
+    octave_idx_type nbr = (nr + m - 1) / m;
+
+#if defined (HAVE_OPENMP)
+#  pragma omp parallel for if (is_plain_data<T>::value && nbr > 1 \
+                               && nr * nc > 65536)
+#endif
+    for (octave_idx_type b = 0; b < nbr; b++)
+      {
+        // Not OCTAVE_LOCAL_BUFFER, which is shared between threads.
+        T blk[m*m];
+
+        octave_idx_type kr = b * m;
+        octave_idx_type lr = std::min (m, nr - kr);
+        for (octave_idx_type kc = 0; kc < nc; kc += m)
+          {
+            octave_idx_type lc = std::min (m, nc - kc);
+            const T *ss = src + kc * nr + kr;
+            T *dd = dest + kr * nc + kc;
+            if (lr == m && lc == m)
+              {
+                for (octave_idx_type j = 0; j < m; j++)
+                  for (octave_idx_type i = 0; i < m; i++)
+                    blk[j*m+i] = ss[j*nr + i];
+                for (octave_idx_type j = 0; j < m; j++)
+                  for (octave_idx_type i = 0; i < m; i++)
+                    dd[j*nc+i] = fcn (blk[i*m+j]);
+              }
+            else
+              {
+                for (octave_idx_type j = 0; j < lc; j++)
+                  for (octave_idx_type i = 0; i < lr; i++)
+                    blk[j*m+i] = ss[j*nr + i];
+                for (octave_idx_type j = 0; j < lr; j++)
+                  for (octave_idx_type i = 0; i < lc; i++)
+                    dd[j*nc+i] = fcn (blk[i*m+j]);
+              }
+          }
+      }
 
     return dest + nr*nc;
   }
 
+  template <typename T>
+  static T *
+  blk_trans (const T *src, T *dest, octave_idx_type nr, octave_idx_type nc)
+  {
+    return blk_trans (src, dest, nr, nc, [] (const T& x) { return x; });
+  }
+
 private:
 
   // Recursive N-D generalized transpose
@@ -443,7 +503,29 @@ private:
 public:
 
   template <typename T>
-  void permute (const T *src, T *dest) const { do_permute (src, dest, top); }
+  void permute (const T *src, T *dest) const
+  {
+    if (top > 1 || (top == 1 && ! use_blk))
+      {
+        // The slices along the outermost dimension fill consecutive
+        // parts of DEST, so large arrays are permuted by several threads.
+
+        octave_idx_type len = dim[top];
+        octave_idx_type step = stride[top];
+        octave_idx_type slice = 1;
+        for (int k = 0; k < top; k++)
+          slice *= dim[k];
+
+#if defined (HAVE_OPENMP)
+#  pragma omp parallel for if (is_plain_data<T>::value && len > 1 \
+                               && len * slice > 65536)
+#endif
+        for (octave_idx_type i = 0; i < len; i++)
+          do_permute (src + i * step, dest + i * slice, top-1);
+      }
+    else
+      do_permute (src, dest, top);
+  }
 };
 
 template <typename T>
@@ -713,6 +795,32 @@ public:
   { do_resize_fill (src, dest, rfv, n-1); }
 };
 
+// Index SRC by I into DEST, as I.index does.  Large gathers through an
+// index vector are split over several threads.
+
+template <typename T>
+static void
+index_gather (const idx_vector& i, const T *src, octave_idx_type n, T *dest)
+{
+#if defined (HAVE_OPENMP)
+  if (is_plain_data<T>::value && i.idx_class () == idx_vector::class_vector
+      && i.length (n) > 65536)
+    {
+      idx_vector ii (i);
+      const octave_idx_type *idx = ii.raw ();
+      octave_idx_type len = ii.length (n);
+
+#  pragma omp parallel for
+      for (octave_idx_type k = 0; k < len; k++)
+        dest[k] = src[idx[k]];
+
+      return;
+    }
+#endif
+
+  i.index (src, n, dest);
+}
+
 template <typename T>
 Array<T>
 Array<T>::index (const idx_vector& i) const
@@ -770,7 +878,7 @@ Array<T>::index (const idx_vector& i) const
           retval = Array<T> (rd);
 
           if (il != 0)
-            i.index (data (), n, retval.fortran_vec ());
+            index_gather (i, data (), n, retval.fortran_vec ());
         }
     }
 
@@ -816,7 +924,7 @@ Array<T>::index (const idx_vector& i, const idx_vector& j) const
               // Don't use resize to avoid useless initialization for POD types.
               retval = Array<T> (dim_vector (il, jl));
 
-              ii.index (data (), n, retval.fortran_vec ());
+              index_gather (ii, data (), n, retval.fortran_vec ());
             }
         }
       else
@@ -827,8 +935,21 @@ Array<T>::index (const idx_vector& i, const idx_vector& j) const
           const T* src = data ();
           T *dest = retval.fortran_vec ();
 
+          // Each column of the result is gathered independently.  The
+          // column offsets are computed first, because xelem is not
+          // thread-safe for masks.
+
+          OCTAVE_LOCAL_BUFFER (octave_idx_type, jofs, jl);
+
+          for (octave_idx_type k = 0; k < jl; k++)
+            jofs[k] = r * j.xelem (k);
+
+#if defined (HAVE_OPENMP)
+#  pragma omp parallel for if (is_plain_data<T>::value && jl > 1 \
+                               && il * jl > 65536)
+#endif
           for (octave_idx_type k = 0; k < jl; k++)
-            dest += i.index (src + r * j.xelem (k), r, dest);
+            i.index (src + jofs[k], r, dest + k * il);
         }
     }
 
@@ -1579,6 +1700,40 @@ template <typename T>
 Array<T>&
 Array<T>::insert (const Array<T>& a, octave_idx_type r, octave_idx_type c)
 {
+  // If A fits in this array, copy its columns directly.
+
+  int nd = std::max (ndims (), a.ndims ());
+  dim_vector dv = dimensions.redim (nd);
+  dim_vector adv = a.dims ().redim (nd);
+
+  bool fits = (r >= 0 && c >= 0
+               && r + adv(0) <= dv(0) && c + adv(1) <= dv(1));
+  for (int k = 2; fits && k < nd; k++)
+    fits = adv(k) == dv(k);
+
+  if (fits)
+    {
+      if (a.is_empty ())
+        return *this;
+
+      octave_idx_type nr = adv(0);
+      octave_idx_type nc = adv(1);
+      octave_idx_type npages = a.numel () / (nr * nc);
+      octave_idx_type page = dv(0) * dv(1);
+
+      const T *src = a.data ();
+      T *dest = fortran_vec () + r + c * dv(0);
+
+      if (nr == dv(0))
+        copy_blocks (src, nr * nc, dest, page, nr * nc, npages);
+      else
+        for (octave_idx_type p = 0; p < npages; p++)
+          copy_blocks (src + p * nr * nc, nr, dest + p * page, dv(0),
+                       nr, nc);
+
+      return *this;
+    }
+
   idx_vector i (r, r + a.rows ());
   idx_vector j (c, c + a.columns ());
   if (ndims () == 2 && a.ndims () == 2)
@@ -1670,40 +1825,10 @@ Array<T>::hermitian (T (*fcn) (const T&)) const
     {
       Array<T> result (dim_vector (nc, nr));
 
-      // Blocked transpose to attempt to avoid cache misses.
-
-      // Don't use OCTAVE_LOCAL_BUFFER here as it doesn't work with bool
-      // on some compilers.
-      T buf[64];
-
-      octave_idx_type ii = 0, jj;
-      for (jj = 0; jj < (nc - 8 + 1); jj += 8)
-        {
-          for (ii = 0; ii < (nr - 8 + 1); ii += 8)
-            {
-              // Copy to buffer
-              for (octave_idx_type j = jj, k = 0, idxj = jj * nr;
-                   j < jj + 8; j++, idxj += nr)
-                for (octave_idx_type i = ii; i < ii + 8; i++)
-                  buf[k++] = xelem (i + idxj);
-
-              // Copy from buffer
-              for (octave_idx_type i = ii, idxi = ii * nc; i < ii + 8;
-                   i++, idxi += nc)
-                for (octave_idx_type j = jj, k = i - ii; j < jj + 8;
-                     j++, k+=8)
-                  result.xelem (j + idxi) = fcn (buf[k]);
-            }
-
-          if (ii < nr)
-            for (octave_idx_type j = jj; j < jj + 8; j++)
-              for (octave_idx_type i = ii; i < nr; i++)
-                result.xelem (j, i) = fcn (xelem (i, j));
-        }
+      // Reuse the implementation used for permuting.
 
-      for (octave_idx_type j = jj; j < nc; j++)
-        for (octave_idx_type i = 0; i < nr; i++)
-          result.xelem (j, i) = fcn (xelem (i, j));
+      rec_permute_helper::blk_trans (data (), result.fortran_vec (), nr, nc,
+                                     fcn);
 
       return result;
     }
@@ -2337,15 +2462,6 @@ Array<T>::nth_element (const idx_vector& n, int dim) const
 
   octave_idx_type nn = n.length (ns);
 
-  dv(dim) = std::min (nn, ns);
-  dv.chop_trailing_singletons ();
-  dim = std::min (dv.ndims (), static_cast<octave_idx_type> (dim));
-
-  Array<T> m (dv);
-
-  if (m.is_empty ())
-    return m;
-
   sortmode mode = UNSORTED;
   octave_idx_type lo = 0;
 
@@ -2373,15 +2489,43 @@ Array<T>::nth_element (const idx_vector& n, int dim) const
       break;
     }
 
-  if (mode == UNSORTED)
-    (*current_liboctave_error_handler)
-      ("nth_element: n must be a scalar or a contiguous range");
+  // Any other set of indices is handled by selecting all of the distinct
+  // requested order statistics at once and gathering them afterwards.
+  bool multi = (mode == UNSORTED);
+
+  Array<octave_idx_type> nidx;
+  Array<octave_idx_type> kth;
 
   octave_idx_type up = lo + nn;
 
+  if (multi)
+    {
+      mode = ASCENDING;
+
+      nidx = n.as_array ();
+
+      kth = nidx;
+      octave_idx_type *pk = kth.fortran_vec ();
+      std::sort (pk, pk + nn);
+      octave_idx_type nk = std::unique (pk, pk + nn) - pk;
+      kth.resize1 (nk);
+
+      lo = (nk > 0 ? kth(0) : 0);
+      up = (nk > 0 ? kth(nk-1) + 1 : 0);
+    }
+
   if (lo < 0 || up > ns)
     (*current_liboctave_error_handler) ("nth_element: invalid element index");
 
+  dv(dim) = (multi ? nn : std::min (nn, ns));
+  dv.chop_trailing_singletons ();
+  dim = std::min (dv.ndims (), static_cast<octave_idx_type> (dim));
+
+  Array<T> m (dv);
+
+  if (m.is_empty ())
+    return m;
+
   octave_idx_type iter = numel () / ns;
   octave_idx_type stride = 1;
 
@@ -2391,78 +2535,76 @@ Array<T>::nth_element (const idx_vector& n, int dim) const
   T *v = m.fortran_vec ();
   const T *ov = data ();
 
-  OCTAVE_LOCAL_BUFFER (T, buf, ns);
+  const octave_idx_type *pn = nidx.data ();
+  const octave_idx_type *pk = kth.data ();
+  octave_idx_type nk = kth.numel ();
 
-  octave_sort<T> lsort;
-  lsort.set_compare (mode);
+  // Columns are independent, so large arrays are processed in parallel,
+  // each thread with its own work buffer.
 
-  for (octave_idx_type j = 0; j < iter; j++)
-    {
-      octave_idx_type kl = 0;
-      octave_idx_type ku = ns;
+#if defined (HAVE_OPENMP)
+#  pragma omp parallel if (iter > 1 && numel () > 65536)
+#endif
+  {
+    OCTAVE_LOCAL_BUFFER (T, buf, ns);
 
-      if (stride == 1)
-        {
-          // copy without NaNs.
-          // FIXME: impact on integer types noticeable?
-          for (octave_idx_type i = 0; i < ns; i++)
-            {
-              T tmp = ov[i];
-              if (sort_isnan<T> (tmp))
-                buf[--ku] = tmp;
-              else
-                buf[kl++] = tmp;
-            }
+    octave_sort<T> lsort;
+    lsort.set_compare (mode);
 
-          ov += ns;
-        }
-      else
-        {
-          octave_idx_type offset = j % stride;
-          // copy without NaNs.
-          // FIXME: impact on integer types noticeable?
-          for (octave_idx_type i = 0; i < ns; i++)
-            {
-              T tmp = ov[offset + i*stride];
-              if (sort_isnan<T> (tmp))
-                buf[--ku] = tmp;
-              else
-                buf[kl++] = tmp;
-            }
+#if defined (HAVE_OPENMP)
+#  pragma omp for
+#endif
+    for (octave_idx_type j = 0; j < iter; j++)
+      {
+        octave_idx_type offset = j % stride;
+        const T *src = ov + (j - offset) * ns + offset;
+        T *dst = v + (j - offset) * nn + offset;
 
-          if (offset == stride-1)
-            ov += ns*stride;
-        }
+        octave_idx_type kl = 0;
+        octave_idx_type ku = ns;
 
-      if (ku == ns)
-        lsort.nth_element (buf, ns, lo, up);
-      else if (mode == ASCENDING)
-        lsort.nth_element (buf, ku, lo, std::min (ku, up));
-      else
-        {
-          octave_idx_type nnan = ns - ku;
-          octave_idx_type zero = 0;
-          lsort.nth_element (buf, ku, std::max (lo - nnan, zero),
-                             std::max (up - nnan, zero));
-          std::rotate (buf, buf + ku, buf + ns);
-        }
+        // copy without NaNs.
+        // FIXME: impact on integer types noticeable?
+        for (octave_idx_type i = 0; i < ns; i++)
+          {
+            T tmp = src[i*stride];
+            if (sort_isnan<T> (tmp))
+              buf[--ku] = tmp;
+            else
+              buf[kl++] = tmp;
+          }
 
-      if (stride == 1)
-        {
-          for (octave_idx_type i = 0; i < nn; i++)
-            v[i] = buf[lo + i];
+        if (multi)
+          {
+            // NaNs sort last, so requests beyond the non-NaN elements
+            // are already in place.
+            octave_idx_type nkv = std::lower_bound (pk, pk + nk, ku) - pk;
 
-          v += nn;
-        }
-      else
-        {
-          octave_idx_type offset = j % stride;
-          for (octave_idx_type i = 0; i < nn; i++)
-            v[offset + stride * i] = buf[lo + i];
-          if (offset == stride-1)
-            v += nn*stride;
-        }
-    }
+            lsort.nth_element (buf, ku, pk, nkv);
+
+            for (octave_idx_type i = 0; i < nn; i++)
+              dst[i*stride] = buf[pn[i]];
+          }
+        else
+          {
+            if (ku == ns)
+              lsort.nth_element (buf, ns, lo, up);
+            else if (mode == ASCENDING)
+              lsort.nth_element (buf, ku, lo, std::min (ku, up));
+            else
+              {
+                octave_idx_type nnan = ns - ku;
+                octave_idx_type zero = 0;
+                lsort.nth_element (buf, ku, std::max (lo - nnan, zero),
+                                   std::max (up - nnan, zero));
+                std::rotate (buf, buf + ku, buf + ns);
+              }
+
+            for (octave_idx_type i = 0; i < nn; i++)
+              dst[i*stride] = buf[lo + i];
+          }
+      }
+  }
 
   return m;
 }
@@ -2696,8 +2838,20 @@ Array<T>::cat (int dim, octave_idx_type n, const Array<T> *array_list)
   if (retval.is_empty ())
     return retval;
 
+  // The result is an INNER-by-EXT-by-OUTER array, and each array fills
+  // a contiguous block of it for every index in the outer dimensions.
+
   int nidx = std::max (dv.ndims (), static_cast<octave_idx_type> (dim + 1));
-  Array<idx_vector> idxa (dim_vector (nidx, 1), idx_vector::colon);
+  dim_vector rdv = dv.redim (nidx);
+
+  octave_idx_type inner = 1;
+  for (int k = 0; k < dim; k++)
+    inner *= rdv(k);
+
+  octave_idx_type ext = rdv(dim);
+  octave_idx_type outer = retval.numel () / (inner * ext);
+
+  T *dest = retval.fortran_vec ();
   octave_idx_type l = 0;
 
   for (octave_idx_type i = 0; i < n; i++)
@@ -2713,17 +2867,12 @@ Array<T>::cat (int dim, octave_idx_type n, const Array<T> *array_list)
 
       octave_quit ();
 
-      octave_idx_type u;
-      if (dim < array_list[i].ndims ())
-        u = l + array_list[i].dims ()(dim);
-      else
-        u = l + 1;
-
-      idxa(dim) = idx_vector (l, u);
+      octave_idx_type len = array_list[i].numel () / outer;
 
-      retval.assign (idxa, array_list[i]);
+      copy_blocks (array_list[i].data (), len, dest + l, inner * ext,
+                   len, outer);
 
-      l = u;
+      l += len;
     }
 
   return retval;
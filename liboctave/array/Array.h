@@ -39,6 +39,7 @@ along with Octave; see the file COPYING.  If not, see
 #include "lo-error.h"
 #include "lo-traits.h"
 #include "lo-utils.h"
+#include "oct-mem-hook.h"
 #include "oct-sort.h"
 #include "quit.h"
 #include "oct-refcount.h"
@@ -140,6 +141,7 @@ protected:
     ArrayRep (T *d, octave_idx_type l)
       : data (new T [l]), len (l), count (1)
     {
+      octave::note_memory_allocated (len * sizeof (T));
       std::copy (d, d+l, data);
     }
 
@@ -147,27 +149,37 @@ protected:
     ArrayRep (U *d, octave_idx_type l)
       : data (new T [l]), len (l), count (1)
     {
+      octave::note_memory_allocated (len * sizeof (T));
       std::copy (d, d+l, data);
     }
 
     ArrayRep (void) : data (0), len (0), count (1) { }
 
     explicit ArrayRep (octave_idx_type n)
-      : data (new T [n]), len (n), count (1) { }
+      : data (new T [n]), len (n), count (1)
+    {
+      octave::note_memory_allocated (len * sizeof (T));
+    }
 
     explicit ArrayRep (octave_idx_type n, const T& val)
       : data (new T [n]), len (n), count (1)
     {
+      octave::note_memory_allocated (len * sizeof (T));
       std::fill_n (data, n, val);
     }
 
     ArrayRep (const ArrayRep& a)
       : data (new T [a.len]), len (a.len), count (1)
     {
+      octave::note_memory_allocated (len * sizeof (T));
       std::copy (a.data, a.data + a.len, data);
     }
 
-    ~ArrayRep (void) { delete [] data; }
+    ~ArrayRep (void)
+    {
+      octave::note_memory_released (len * sizeof (T));
+      delete [] data;
+    }
 
     octave_idx_type numel (void) const { return len; }
 
@@ -24,7 +24,9 @@ along with Octave; see the file COPYING.  If not, see
 #  include "config.h"
 #endif
 
+#include <algorithm>
 #include <cfloat>
+#include <cmath>
 
 #include <iostream>
 #include <limits>
@@ -207,6 +209,55 @@ Range::max (void) const
   return retval;
 }
 
+double
+Range::sum (void) const
+{
+  double retval = 0;
+
+  if (rng_numel > 0 && all_elements_are_ints ())
+    {
+      // All partial sums are integers no larger in magnitude than this
+      // bound.  If it can be represented exactly, so can all of them,
+      // and the closed form gives the same result as adding the
+      // elements in order.
+
+      double first = elem (0);
+      double last = elem (rng_numel - 1);
+
+      double bound = std::max (std::abs (first), std::abs (last)) * rng_numel;
+
+      // Adding to zero makes the sum of -0 be 0, as in the loop below.
+      if (bound <= 9007199254740992.0)
+        return retval + (first + last) * rng_numel / 2;
+    }
+
+  for (octave_idx_type i = 0; i < rng_numel; i++)
+    retval += elem (i);
+
+  return retval;
+}
+
+Matrix
+Range::cumsum (void) const
+{
+  Matrix retval (1, std::max (rng_numel, static_cast<octave_idx_type> (0)));
+
+  double *p = retval.fortran_vec ();
+
+  if (rng_numel > 0)
+    {
+      double acc = p[0] = elem (0);
+
+      for (octave_idx_type i = 1; i < rng_numel; i++)
+        {
+          acc += elem (i);
+          p[i] = acc;
+        }
+    }
+
+  return retval;
+}
+
 void
 Range::sort_internal (bool ascending)
 {
@@ -93,6 +93,12 @@ public:
   double min (void) const;
   double max (void) const;
 
+  // Same results as summing the elements of matrix_value () in order,
+  // but without creating it.
+
+  double sum (void) const;
+  Matrix cumsum (void) const;
+
   void sort_internal (bool ascending = true);
   void sort_internal (Array<octave_idx_type>& sidx, bool ascending = true);
 
@@ -181,7 +181,9 @@ Sparse<T>::SparseRep::change_length (octave_idx_type nz)
       delete [] d;
       d = new_data;
 
+      octave::note_memory_released (byte_size ());
       nzmx = nz;
+      octave::note_memory_allocated (byte_size ());
     }
 }
 
@@ -988,7 +990,9 @@ Sparse<T>::resize (octave_idx_type r, octave_idx_type c)
                      rep->c[rep->ncols]);
     }
 
+  octave::note_memory_released (rep->byte_size ());
   rep->ncols = dimensions(1) = c;
+  octave::note_memory_allocated (rep->byte_size ());
 
   rep->change_length (rep->nnz ());
 }
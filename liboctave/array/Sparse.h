@@ -38,6 +38,7 @@ along with Octave; see the file COPYING.  If not, see
 #include "dim-vector.h"
 #include "lo-error.h"
 #include "lo-utils.h"
+#include "oct-mem-hook.h"
 
 #include "oct-sort.h"
 
@@ -76,6 +77,7 @@ protected:
       : d (0), r (0), c (new octave_idx_type [1]), nzmx (0), nrows (0),
         ncols (0), count (1)
     {
+      octave::note_memory_allocated (byte_size ());
       c[0] = 0;
     }
 
@@ -83,6 +85,7 @@ protected:
       : d (0), r (0), c (new octave_idx_type [n+1]), nzmx (0), nrows (n),
         ncols (n), count (1)
     {
+      octave::note_memory_allocated (byte_size ());
       for (octave_idx_type i = 0; i < n + 1; i++)
         c[i] = 0;
     }
@@ -93,6 +96,7 @@ protected:
         c (new octave_idx_type [nc+1]), nzmx (nz), nrows (nr),
         ncols (nc), count (1)
     {
+      octave::note_memory_allocated (byte_size ());
       for (octave_idx_type i = 0; i < nc + 1; i++)
         c[i] = 0;
     }
@@ -102,13 +106,27 @@ protected:
         c (new octave_idx_type [a.ncols + 1]),
         nzmx (a.nzmx), nrows (a.nrows), ncols (a.ncols), count (1)
     {
+      octave::note_memory_allocated (byte_size ());
       octave_idx_type nz = a.nnz ();
       std::copy (a.d, a.d + nz, d);
       std::copy (a.r, a.r + nz, r);
       std::copy (a.c, a.c + ncols + 1, c);
     }
 
-    ~SparseRep (void) { delete [] d; delete [] r; delete [] c; }
+    ~SparseRep (void)
+    {
+      octave::note_memory_released (byte_size ());
+      delete [] d;
+      delete [] r;
+      delete [] c;
+    }
+
+    // Number of bytes allocated for the data, row and column arrays.
+    size_t byte_size (void) const
+    {
+      return (nzmx * (sizeof (T) + sizeof (octave_idx_type))
+              + (ncols + 1) * sizeof (octave_idx_type));
+    }
 
     octave_idx_type length (void) const { return nzmx; }
 
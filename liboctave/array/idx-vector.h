@@ -35,6 +35,7 @@ along with Octave; see the file COPYING.  If not, see
 #include <memory>
 
 #include "dim-vector.h"
+#include "lo-traits.h"
 #include "oct-inttypes-fwd.h"
 #include "oct-refcount.h"
 
@@ -671,8 +672,25 @@ public:
           idx_mask_rep * r = dynamic_cast<idx_mask_rep *> (rep);
           const bool *data = r->get_data ();
           octave_idx_type ext = r->extent (0);
-          for (octave_idx_type i = 0; i < ext; i++)
-            if (data[i]) *dest++ = src[i];
+          if (is_plain_data<T>::value)
+            {
+              // Avoid a branch for each element by copying every element
+              // up to the last true one, and advancing DEST only for the
+              // selected ones.  DEST does not overrun as long as a true
+              // element follows.
+              while (ext > 0 && ! data[ext-1])
+                ext--;
+              for (octave_idx_type i = 0, k = 0; i < ext; i++)
+                {
+                  dest[k] = src[i];
+                  k += data[i];
+                }
+            }
+          else
+            {
+              for (octave_idx_type i = 0; i < ext; i++)
+                if (data[i]) *dest++ = src[i];
+            }
         }
         break;
 
@@ -0,0 +1,307 @@
+/*
+
+Copyright (C) 2016 The Octave Project Developers
+
+This file is part of Octave.
+
+Octave is free software; you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+Octave is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Octave; see the file COPYING.  If not, see
+<http://www.gnu.org/licenses/>.
+
+*/
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "lo-ieee.h"
+#include "lo-mappers.h"
+#include "oct-kdtree.h"
+
+namespace octave
+{
+  namespace math
+  {
+    kdtree::kdtree (const Matrix& points)
+      : m_points (points), m_data (m_points.data ()),
+        m_dim (m_points.rows ()), m_n (m_points.columns ()), m_perm (),
+        m_split (m_n, 0)
+    {
+      m_perm.reserve (m_n);
+
+      for (octave_idx_type i = 0; i < m_n; i++)
+        {
+          const double *p = point (i);
+
+          bool ok = true;
+          for (octave_idx_type j = 0; j < m_dim; j++)
+            if (octave::math::isnan (p[j]))
+              {
+                ok = false;
+                break;
+              }
+
+          if (ok)
+            m_perm.push_back (i);
+        }
+
+      build (0, m_perm.size ());
+    }
+
+    octave_idx_type
+    kdtree::nearest (const double *q, double& dist) const
+    {
+      candidate best (std::numeric_limits<double>::infinity (), -1);
+
+      search_nearest (q, 0, m_perm.size (), best);
+
+      if (best.second < 0)
+        {
+          // Only possible for NaN coordinates, in the query or in all of
+          // the points.
+          dist = octave::numeric_limits<double>::NaN ();
+          return 0;
+        }
+
+      dist = std::sqrt (best.first);
+      return best.second;
+    }
+
+    void
+    kdtree::k_nearest (const double *q, octave_idx_type k,
+                       octave_idx_type *idx, double *dist) const
+    {
+      std::vector<candidate> heap;
+      heap.reserve (k);
+
+      if (k > 0)
+        search_k_nearest (q, 0, m_perm.size (), k, heap);
+
+      std::sort_heap (heap.begin (), heap.end ());
+
+      octave_idx_type nfound = heap.size ();
+
+      for (octave_idx_type i = 0; i < k; i++)
+        {
+          if (i < nfound)
+            {
+              idx[i] = heap[i].second;
+              dist[i] = std::sqrt (heap[i].first);
+            }
+          else
+            {
+              idx[i] = -1;
+              dist[i] = std::numeric_limits<double>::infinity ();
+            }
+        }
+    }
+
+    std::vector<octave_idx_type>
+    kdtree::within_radius (const double *q, double r) const
+    {
+      std::vector<octave_idx_type> found;
+
+      if (r >= 0)
+        search_radius (q, 0, m_perm.size (), r*r, found);
+
+      std::sort (found.begin (), found.end ());
+
+      return found;
+    }
+
+    double
+    kdtree::distance2 (const double *q, octave_idx_type i) const
+    {
+      const double *p = point (i);
+
+      double d2 = 0.0;
+      for (octave_idx_type j = 0; j < m_dim; j++)
+        {
+          double d = p[j] - q[j];
+          d2 += d * d;
+        }
+
+      return d2;
+    }
+
+    void
+    kdtree::build (octave_idx_type lo, octave_idx_type hi)
+    {
+      if (hi - lo <= leaf_size)
+        return;
+
+      // Split along the coordinate with the largest spread.
+
+      octave_idx_type s = 0;
+      double spread = -1.0;
+
+      for (octave_idx_type j = 0; j < m_dim; j++)
+        {
+          double pmin = point (m_perm[lo])[j];
+          double pmax = pmin;
+
+          for (octave_idx_type i = lo + 1; i < hi; i++)
+            {
+              double pj = point (m_perm[i])[j];
+              pmin = std::min (pmin, pj);
+              pmax = std::max (pmax, pj);
+            }
+
+          if (pmax - pmin > spread)
+            {
+              spread = pmax - pmin;
+              s = j;
+            }
+        }
+
+      octave_idx_type mid = lo + (hi - lo) / 2;
+
+      const double *data = m_data;
+      octave_idx_type dim = m_dim;
+
+      std::nth_element (m_perm.begin () + lo, m_perm.begin () + mid,
+                        m_perm.begin () + hi,
+                        [data, dim, s] (octave_idx_type a, octave_idx_type b)
+                        { return data[a*dim+s] < data[b*dim+s]; });
+
+      m_split[mid] = s;
+
+      build (lo, mid);
+      build (mid + 1, hi);
+    }
+
+    void
+    kdtree::search_nearest (const double *q, octave_idx_type lo,
+                            octave_idx_type hi, candidate& best) const
+    {
+      if (hi - lo <= leaf_size)
+        {
+          for (octave_idx_type i = lo; i < hi; i++)
+            {
+              candidate c (distance2 (q, m_perm[i]), m_perm[i]);
+              if (! octave::math::isnan (c.first) && c < best)
+                best = c;
+            }
+
+          return;
+        }
+
+      octave_idx_type mid = lo + (hi - lo) / 2;
+      octave_idx_type p = m_perm[mid];
+
+      candidate c (distance2 (q, p), p);
+      if (! octave::math::isnan (c.first) && c < best)
+        best = c;
+
+      double diff = q[m_split[mid]] - point (p)[m_split[mid]];
+
+      // Search the side containing Q first.  The other side can only
+      // hold a closer point, or an equally close one with a lower
+      // index, if the splitting plane is close enough.
+
+      if (diff < 0)
+        {
+          search_nearest (q, lo, mid, best);
+          if (diff * diff <= best.first)
+            search_nearest (q, mid + 1, hi, best);
+        }
+      else
+        {
+          search_nearest (q, mid + 1, hi, best);
+          if (diff * diff <= best.first)
+            search_nearest (q, lo, mid, best);
+        }
+    }
+
+    void
+    kdtree::search_k_nearest (const double *q, octave_idx_type lo,
+                              octave_idx_type hi, octave_idx_type k,
+                              std::vector<candidate>& heap) const
+    {
+      // HEAP is a max-heap holding the best K candidates found so far.
+
+      octave_idx_type mid = lo + (hi - lo) / 2;
+      bool leaf = (hi - lo <= leaf_size);
+
+      for (octave_idx_type i = (leaf ? lo : mid); i < (leaf ? hi : mid + 1); i++)
+        {
+          candidate c (distance2 (q, m_perm[i]), m_perm[i]);
+
+          if (octave::math::isnan (c.first))
+            continue;
+
+          if (static_cast<octave_idx_type> (heap.size ()) < k)
+            {
+              heap.push_back (c);
+              std::push_heap (heap.begin (), heap.end ());
+            }
+          else if (c < heap.front ())
+            {
+              std::pop_heap (heap.begin (), heap.end ());
+              heap.back () = c;
+              std::push_heap (heap.begin (), heap.end ());
+            }
+        }
+
+      if (leaf)
+        return;
+
+      octave_idx_type p = m_perm[mid];
+      double diff = q[m_split[mid]] - point (p)[m_split[mid]];
+
+      octave_idx_type near_lo = (diff < 0 ? lo : mid + 1);
+      octave_idx_type near_hi = (diff < 0 ? mid : hi);
+      octave_idx_type far_lo = (diff < 0 ? mid + 1 : lo);
+      octave_idx_type far_hi = (diff < 0 ? hi : mid);
+
+      search_k_nearest (q, near_lo, near_hi, k, heap);
+
+      if (static_cast<octave_idx_type> (heap.size ()) < k
+          || diff * diff <= heap.front ().first)
+        search_k_nearest (q, far_lo, far_hi, k, heap);
+    }
+
+    void
+    kdtree::search_radius (const double *q, octave_idx_type lo,
+                           octave_idx_type hi, double r2,
+                           std::vector<octave_idx_type>& found) const
+    {
+      if (hi - lo <= leaf_size)
+        {
+          for (octave_idx_type i = lo; i < hi; i++)
+            if (distance2 (q, m_perm[i]) <= r2)
+              found.push_back (m_perm[i]);
+
+          return;
+        }
+
+      octave_idx_type mid = lo + (hi - lo) / 2;
+      octave_idx_type p = m_perm[mid];
+
+      if (distance2 (q, p) <= r2)
+        found.push_back (p);
+
+      double diff = q[m_split[mid]] - point (p)[m_split[mid]];
+
+      if (diff <= 0 || diff * diff <= r2)
+        search_radius (q, lo, mid, r2, found);
+
+      if (diff >= 0 || diff * diff <= r2)
+        search_radius (q, mid + 1, hi, r2, found);
+    }
+  }
+}
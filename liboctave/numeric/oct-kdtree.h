@@ -0,0 +1,125 @@
+/*
+
+Copyright (C) 2016 The Octave Project Developers
+
+This file is part of Octave.
+
+Octave is free software; you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+Octave is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Octave; see the file COPYING.  If not, see
+<http://www.gnu.org/licenses/>.
+
+*/
+
+#if ! defined (octave_oct_kdtree_h)
+#define octave_oct_kdtree_h 1
+
+#include "octave-config.h"
+
+#include <utility>
+#include <vector>
+
+#include "dMatrix.h"
+
+namespace octave
+{
+  namespace math
+  {
+    // A k-d tree over a set of points, for nearest neighbor, k nearest
+    // neighbor, and fixed radius searches with Euclidean distance.  The
+    // points are the columns of the matrix given to the constructor.
+    // Points with NaN coordinates are left out.  All queries are const
+    // and may be run concurrently.
+
+    class
+    OCTAVE_API
+    kdtree
+    {
+    public:
+
+      kdtree (const Matrix& points);
+
+      // No copying!
+
+      kdtree (const kdtree&) = delete;
+
+      kdtree& operator = (const kdtree&) = delete;
+
+      ~kdtree (void) = default;
+
+      octave_idx_type dims (void) const { return m_dim; }
+
+      octave_idx_type numel (void) const { return m_n; }
+
+      // Return the index of the point closest to Q and set DIST to its
+      // distance.  Ties are resolved in favor of the lowest index.
+      octave_idx_type nearest (const double *q, double& dist) const;
+
+      // Store the indices of the K points closest to Q in IDX and their
+      // distances in DIST, both in order of increasing distance.  If
+      // there are fewer than K points, the remaining entries of IDX are
+      // set to -1 and those of DIST to Inf.
+      void k_nearest (const double *q, octave_idx_type k,
+                      octave_idx_type *idx, double *dist) const;
+
+      // Return the indices of all points within distance R of Q, in
+      // increasing order.
+      std::vector<octave_idx_type> within_radius (const double *q,
+                                                  double r) const;
+
+    private:
+
+      // Search candidates are kept as (squared distance, index) pairs,
+      // compared lexicographically so that ties go to the lowest index.
+      typedef std::pair<double, octave_idx_type> candidate;
+
+      const double * point (octave_idx_type i) const
+      { return m_data + i * m_dim; }
+
+      double distance2 (const double *q, octave_idx_type i) const;
+
+      void build (octave_idx_type lo, octave_idx_type hi);
+
+      void search_nearest (const double *q, octave_idx_type lo,
+                           octave_idx_type hi, candidate& best) const;
+
+      void search_k_nearest (const double *q, octave_idx_type lo,
+                             octave_idx_type hi, octave_idx_type k,
+                             std::vector<candidate>& heap) const;
+
+      void search_radius (const double *q, octave_idx_type lo,
+                          octave_idx_type hi, double r2,
+                          std::vector<octave_idx_type>& found) const;
+
+      // Ranges with at most this many points are searched linearly.
+      static const octave_idx_type leaf_size = 8;
+
+      Matrix m_points;
+
+      const double *m_data;
+
+      octave_idx_type m_dim;
+
+      octave_idx_type m_n;
+
+      // Points ordered so that each subrange [lo, hi) is split at its
+      // midpoint MID, with coordinate m_split(MID) of the points in
+      // [lo, MID) not greater, and in (MID, hi) not less, than that of
+      // point m_perm[MID].
+      std::vector<octave_idx_type> m_perm;
+
+      std::vector<octave_idx_type> m_split;
+    };
+  }
+}
+
+#endif
@@ -25,6 +25,11 @@ along with Octave; see the file COPYING.  If not, see
 
 #include "octave-config.h"
 
+#include <complex>
+#include <type_traits>
+
+#include "oct-inttypes-fwd.h"
+
 // Ideas for these classes taken from C++ Templates, The Complete
 // Guide by David Vandevoorde and Nicolai M. Josuttis, Addison-Wesley
 // (2003).
@@ -107,6 +112,34 @@ public:
   enum { no = ! yes };
 };
 
+// Determine whether copying a T only copies plain data, without side
+// effects like the reference counting of octave_value.  Such elements
+// may be copied speculatively, or by several threads at once.
+
+template <typename T>
+class is_plain_data
+{
+public:
+
+  static const bool value = std::is_arithmetic<T>::value;
+};
+
+template <typename T>
+class is_plain_data<std::complex<T> >
+{
+public:
+
+  static const bool value = is_plain_data<T>::value;
+};
+
+template <typename T>
+class is_plain_data<octave_int<T> >
+{
+public:
+
+  static const bool value = true;
+};
+
 // Define typename ref_param<T>::type as T const& if T is a class
 // type.  Otherwise, define it to be T.
 
@@ -24,6 +24,7 @@ UTIL_INC = \
   liboctave/util/oct-inttypes.h \
   liboctave/util/oct-inttypes-fwd.h \
   liboctave/util/oct-locbuf.h \
+  liboctave/util/oct-mem-hook.h \
   liboctave/util/oct-mutex.h \
   liboctave/util/oct-refcount.h \
   liboctave/util/oct-rl-edit.h \
@@ -36,6 +37,7 @@ UTIL_INC = \
   liboctave/util/singleton-cleanup.h \
   liboctave/util/sparse-sort.h \
   liboctave/util/sparse-util.h \
+  liboctave/util/str-array.h \
   liboctave/util/str-vec.h \
   liboctave/util/sun-utils.h \
   liboctave/util/unwind-prot.h \
@@ -66,6 +68,7 @@ UTIL_SRC = \
   liboctave/util/oct-glob.cc \
   liboctave/util/oct-inttypes.cc \
   liboctave/util/oct-locbuf.cc \
+  liboctave/util/oct-mem-hook.cc \
   liboctave/util/oct-mutex.cc \
   liboctave/util/oct-string.cc \
   liboctave/util/oct-shlib.cc \
@@ -74,6 +77,7 @@ UTIL_SRC = \
   liboctave/util/singleton-cleanup.cc \
   liboctave/util/sparse-sort.cc \
   liboctave/util/sparse-util.cc \
+  liboctave/util/str-array.cc \
   liboctave/util/str-vec.cc \
   liboctave/util/unwind-prot.cc \
   liboctave/util/url-transfer.cc \
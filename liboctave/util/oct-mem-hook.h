@@ -0,0 +1,62 @@
+/*
+
+Copyright (C) 2016 The Octave Project Developers
+
+This file is part of Octave.
+
+Octave is free software; you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+Octave is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Octave; see the file COPYING.  If not, see
+<http://www.gnu.org/licenses/>.
+
+*/
+
+#if ! defined (octave_oct_mem_hook_h)
+#define octave_oct_mem_hook_h 1
+
+#include "octave-config.h"
+
+#include <atomic>
+#include <cstddef>
+
+namespace octave
+{
+  // Function called with the number of bytes of array data allocated
+  // (positive) or released (negative).  It is null unless some client,
+  // such as the profiler, is tracking memory use.  Arrays are allocated
+  // on any thread, so the hook is called on any thread, and it must
+  // check for itself which events it records.
+
+  typedef void (*memory_event_fcn) (std::ptrdiff_t bytes);
+
+  extern OCTAVE_API std::atomic<memory_event_fcn> memory_event_hook;
+
+  inline void
+  note_memory_allocated (std::size_t bytes)
+  {
+    memory_event_fcn f = memory_event_hook.load (std::memory_order_relaxed);
+
+    if (f)
+      f (static_cast<std::ptrdiff_t> (bytes));
+  }
+
+  inline void
+  note_memory_released (std::size_t bytes)
+  {
+    memory_event_fcn f = memory_event_hook.load (std::memory_order_relaxed);
+
+    if (f)
+      f (- static_cast<std::ptrdiff_t> (bytes));
+  }
+}
+
+#endif
@@ -1949,6 +1949,50 @@ octave_sort<T>::nth_element (T *data, octave_idx_type nel,
         nth_element (data, nel, lo, up, std::ptr_fun (compare));
 }
 
+template <typename T>
+template <typename Comp>
+void
+octave_sort<T>::nth_element (T *data, octave_idx_type lo, octave_idx_type up,
+                             const octave_idx_type *kth, octave_idx_type nk,
+                             Comp comp)
+{
+  // Place the middle requested element, which partitions data[lo..up-1]
+  // around it, then handle the requests on either side the same way.
+  // This costs O(N*log(NK)) instead of a full sort.
+  while (nk > 0)
+    {
+      octave_idx_type mid = nk / 2;
+      octave_idx_type k = kth[mid];
+
+      std::nth_element (data + lo, data + k, data + up, comp);
+
+      nth_element (data, lo, k, kth, mid, comp);
+
+      lo = k + 1;
+      kth += mid + 1;
+      nk -= mid + 1;
+    }
+}
+
+template <typename T>
+void
+octave_sort<T>::nth_element (T *data, octave_idx_type nel,
+                             const octave_idx_type *kth, octave_idx_type nk)
+{
+#if defined (INLINE_ASCENDING_SORT)
+  if (compare == ascending_compare)
+    nth_element (data, 0, nel, kth, nk, std::less<T> ());
+  else
+#endif
+#if defined (INLINE_DESCENDING_SORT)
+    if (compare == descending_compare)
+      nth_element (data, 0, nel, kth, nk, std::greater<T> ());
+    else
+#endif
+      if (compare)
+        nth_element (data, 0, nel, kth, nk, std::ptr_fun (compare));
+}
+
 template <typename T>
 bool
 octave_sort<T>::ascending_compare (typename ref_param<T>::type x,
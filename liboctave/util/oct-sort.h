@@ -167,6 +167,11 @@ public:
   void nth_element (T *data, octave_idx_type nel,
                     octave_idx_type lo, octave_idx_type up = -1);
 
+  // Rearranges the array so that the elements with the nk indices
+  // kth[0..nk-1], which must be increasing, are in their correct place.
+  void nth_element (T *data, octave_idx_type nel,
+                    const octave_idx_type *kth, octave_idx_type nk);
+
   static bool ascending_compare (typename ref_param<T>::type,
                                  typename ref_param<T>::type);
 
@@ -334,6 +339,11 @@ private:
   void nth_element (T *data, octave_idx_type nel,
                     octave_idx_type lo, octave_idx_type up,
                     Comp comp);
+
+  template <typename Comp>
+  void nth_element (T *data, octave_idx_type lo, octave_idx_type up,
+                    const octave_idx_type *kth, octave_idx_type nk,
+                    Comp comp);
 };
 
 template <typename T>
@@ -25,13 +25,18 @@ along with Octave; see the file COPYING.  If not, see
 
 #include "oct-string.h"
 
+#include <algorithm>
 #include <cctype>
+#include <cstdlib>
 #include <cstring>
+#include <iterator>
 
 #include <string>
 
 #include <Array.h>
 
+#include "lo-ieee.h"
+
 template <typename T>
 static bool
 str_data_cmp (const typename T::value_type* a, const typename T::value_type* b,
@@ -147,7 +152,7 @@ octave::string::strncmp (const T& str_a, const T& str_b,
                          const typename T::size_type n)
 {
   return (numel (str_a) >= n && numel (str_b) >= n
-          && str_data_cmpi<T> (str_a.data (), str_b.data (), n));
+          && str_data_cmp<T> (str_a.data (), str_b.data (), n));
 }
 
 template<typename T>
@@ -156,7 +161,7 @@ octave::string::strncmp (const T& str_a, const typename T::value_type* str_b,
                          const typename T::size_type n)
 {
   return (numel (str_a) >= n && strlen<T> (str_b) >= n
-          && str_data_cmpi<T> (str_a.data (), str_b, n));
+          && str_data_cmp<T> (str_a.data (), str_b, n));
 }
 
 
@@ -179,6 +184,317 @@ octave::string::strncmpi (const T& str_a, const typename T::value_type* str_b,
 }
 
 
+// Scanner for str2double.  P points to the next character to read and
+// END to the end of the string; neither needs to be NUL terminated.
+
+static inline bool
+is_space (const char *p, const char *end)
+{
+  return p < end && std::isspace (static_cast<unsigned char> (*p));
+}
+
+static inline void
+skip_spaces (const char *& p, const char *end)
+{
+  while (is_space (p, end))
+    p++;
+}
+
+static inline bool
+is_digit (const char *p, const char *end)
+{
+  return p < end && *p >= '0' && *p <= '9';
+}
+
+static inline bool
+is_imag_unit (const char *p, const char *end)
+{
+  return p < end && (*p == 'i' || *p == 'j');
+}
+
+// Read a decimal number of the form [+-]d[.d][(e|E)[+-]d] as the C++
+// stream extraction operator does.  In particular, an incomplete
+// exponent or a value that overflows is an error.
+
+static bool
+scan_decimal (const char *& p, const char *end, double& num)
+{
+  const char *q = p;
+
+  if (q < end && (*q == '+' || *q == '-'))
+    q++;
+
+  bool have_digits = false;
+
+  while (is_digit (q, end))
+    {
+      q++;
+      have_digits = true;
+    }
+
+  if (q < end && *q == '.')
+    {
+      q++;
+
+      while (is_digit (q, end))
+        {
+          q++;
+          have_digits = true;
+        }
+    }
+
+  if (! have_digits)
+    return false;
+
+  if (q < end && (*q == 'e' || *q == 'E'))
+    {
+      q++;
+
+      if (q < end && (*q == '+' || *q == '-'))
+        q++;
+
+      if (! is_digit (q, end))
+        return false;
+
+      while (is_digit (q, end))
+        q++;
+    }
+
+  // strtod needs a terminated copy of the token.  Only unusually long
+  // tokens need memory from the heap.
+
+  char buf[64];
+  std::string tmp;
+  const char *token = buf;
+
+  std::size_t len = q - p;
+
+  if (len < sizeof (buf))
+    {
+      std::copy (p, q, buf);
+      buf[len] = '\0';
+    }
+  else
+    {
+      tmp.assign (p, q);
+      token = tmp.c_str ();
+    }
+
+  num = std::strtod (token, 0);
+
+  if (lo_ieee_isinf (num))
+    return false;
+
+  p = q;
+
+  return true;
+}
+
+static bool
+single_num (const char *& p, const char *end, double& num)
+{
+  skip_spaces (p, end);
+
+  if (p == end)
+    return false;
+
+  if (std::toupper (*p) == 'I')
+    {
+      // It's infinity.
+      if (end - p >= 3 && std::tolower (p[1]) == 'n'
+          && std::tolower (p[2]) == 'f')
+        {
+          num = octave::numeric_limits<double>::Inf ();
+          p += 3;
+          return true;
+        }
+
+      return false;
+    }
+  else if (*p == 'N')
+    {
+      // It's NA or NaN.
+      if (end - p >= 2 && p[1] == 'A')
+        {
+          num = octave_NA;
+          p += 2;
+          return true;
+        }
+      else if (end - p >= 3 && p[1] == 'a' && p[2] == 'N')
+        {
+          num = octave::numeric_limits<double>::NaN ();
+          p += 3;
+          return true;
+        }
+
+      return false;
+    }
+  else
+    return scan_decimal (p, end, num);
+}
+
+static bool
+extract_num (const char *& p, const char *end, double& num, bool& imag,
+             bool& have_sign)
+{
+  have_sign = imag = false;
+
+  // Skip leading spaces.
+  skip_spaces (p, end);
+
+  bool negative = false;
+
+  // Accept leading sign.
+  if (p < end && (*p == '+' || *p == '-'))
+    {
+      have_sign = true;
+      negative = *p == '-';
+      p++;
+    }
+
+  // Skip spaces after sign.
+  skip_spaces (p, end);
+
+  // Imaginary number (i*num or just i), or maybe 'inf'.
+  if (p < end && *p == 'i')
+    {
+      if (p + 1 == end)
+        {
+          // just 'i' and string is finished.  Return immediately.
+          imag = true;
+          num = negative ? -1.0 : 1.0;
+          p++;
+          return true;
+        }
+      else if (std::tolower (p[1]) != 'n')
+        imag = true;
+    }
+  else if (p < end && *p == 'j')
+    imag = true;
+
+  if (imag)
+    {
+      // It's i*num or just i.
+      p++;
+      skip_spaces (p, end);
+
+      if (p < end && *p == '*')
+        {
+          // Multiplier follows, we extract it as a number.
+          p++;
+          if (! single_num (p, end, num))
+            return false;
+        }
+      else
+        num = 1.0;
+    }
+  else
+    {
+      // It's num, num*i, or numi.
+      if (! single_num (p, end, num))
+        return false;
+
+      // Skip spaces after number.
+      skip_spaces (p, end);
+
+      if (p < end && *p == '*')
+        {
+          p++;
+
+          // Skip spaces after operator.
+          skip_spaces (p, end);
+
+          if (! is_imag_unit (p, end))
+            return false;
+
+          imag = true;
+          p++;
+        }
+      else if (is_imag_unit (p, end))
+        {
+          imag = true;
+          p++;
+        }
+    }
+
+  // Skip trailing spaces.
+  skip_spaces (p, end);
+
+  if (negative)
+    num = -num;
+
+  return true;
+}
+
+static inline void
+set_component (Complex& c, double num, bool imag)
+{
+#if defined (HAVE_CXX_COMPLEX_SETTERS)
+  if (imag)
+    c.imag (num);
+  else
+    c.real (num);
+#elif defined (HAVE_CXX_COMPLEX_REFERENCE_ACCESSORS)
+  if (imag)
+    c.imag () = num;
+  else
+    c.real () = num;
+#else
+  if (imag)
+    c = Complex (c.real (), num);
+  else
+    c = Complex (num, c.imag ());
+#endif
+}
+
+Complex
+octave::string::str2double (const char *str, std::size_t len)
+{
+  const char *p = str;
+  const char *end = str + len;
+
+  // FIXME: removing all commas doesn't allow actual parsing.
+  //        Example: "1,23.45" is wrong, but passes Octave.
+  std::string tmp;
+
+  if (std::find (p, end, ',') != end)
+    {
+      tmp.reserve (len);
+      std::remove_copy (p, end, std::back_inserter (tmp), ',');
+
+      p = tmp.data ();
+      end = p + tmp.length ();
+    }
+
+  Complex val (0.0, 0.0);
+
+  double num;
+  bool i1, i2, s1, s2;
+
+  if (! extract_num (p, end, num, i1, s1))
+    val = octave::numeric_limits<double>::NaN ();
+  else
+    {
+      set_component (val, num, i1);
+
+      if (p != end)
+        {
+          if (! extract_num (p, end, num, i2, s2) || i1 == i2 || ! s2)
+            val = octave::numeric_limits<double>::NaN ();
+          else
+            set_component (val, num, i2);
+        }
+    }
+
+  return val;
+}
+
+Complex
+octave::string::str2double (const std::string& str)
+{
+  return str2double (str.data (), str.length ());
+}
+
 // Instantiations we need
 #define INSTANTIATE_OCTAVE_STRING(T)                                          \
   template bool octave::string::strcmp<T> (const T&, const T&);               \
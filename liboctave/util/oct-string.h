@@ -24,6 +24,12 @@ along with Octave; see the file COPYING.  If not, see
 
 #include "octave-config.h"
 
+#include <cstddef>
+
+#include <string>
+
+#include "oct-cmplx.h"
+
 namespace octave
 {
   //! Octave string utility functions.
@@ -120,6 +126,20 @@ namespace octave
     template <typename T>
     bool strncmpi (const T& str_a, const typename T::value_type* str_b,
                    const typename T::size_type n);
+
+    //! Convert a string to a real or complex number.
+    /*!
+        Accepts the formats of the Octave function str2double, such as
+        "a + bi", "a + b*i", or "i*b + a", and the values Inf, NaN, and
+        NA.  Returns NaN if the string can not be converted.
+
+        The characters are scanned in place, without stream objects
+        or temporary allocations.
+    */
+    extern OCTAVE_API Complex
+    str2double (const char *str, std::size_t len);
+
+    extern OCTAVE_API Complex str2double (const std::string& str);
   }
 }
 
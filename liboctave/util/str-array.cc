@@ -0,0 +1,153 @@
+/*
+
+Copyright (C) 2016 The Octave Project Developers
+
+This file is part of Octave.
+
+Octave is free software; you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+Octave is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Octave; see the file COPYING.  If not, see
+<http://www.gnu.org/licenses/>.
+
+*/
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <algorithm>
+#include <string>
+
+#include "lo-error.h"
+#include "str-array.h"
+
+namespace octave
+{
+  static void
+  check_offsets (const dim_vector& dv, octave_idx_type nchars,
+                 const Array<octave_idx_type>& offsets)
+  {
+    octave_idx_type n = offsets.numel ();
+
+    if (n != dv.numel () + 1 || offsets(0) != 0 || offsets(n-1) != nchars)
+      (*current_liboctave_error_handler)
+        ("string_array: invalid character offsets");
+  }
+
+  string_array::string_array (const dim_vector& dv, const Array<char>& chars,
+                              const Array<octave_idx_type>& offsets)
+    : m_dims (dv), m_chars (chars), m_offsets (offsets)
+  {
+    check_offsets (m_dims, m_chars.numel (), m_offsets);
+  }
+
+  string_array::string_array (const dim_vector& dv, const std::string& chars,
+                              const Array<octave_idx_type>& offsets)
+    : m_dims (dv), m_chars (dim_vector (chars.length (), 1)),
+      m_offsets (offsets)
+  {
+    check_offsets (m_dims, m_chars.numel (), m_offsets);
+
+    std::copy (chars.begin (), chars.end (), m_chars.fortran_vec ());
+  }
+
+  string_array::string_array (const Array<std::string>& strs)
+    : m_dims (strs.dims ()), m_chars (),
+      m_offsets (dim_vector (strs.numel () + 1, 1))
+  {
+    octave_idx_type n = strs.numel ();
+
+    octave_idx_type nchars = 0;
+    m_offsets.xelem (0) = 0;
+    for (octave_idx_type i = 0; i < n; i++)
+      {
+        nchars += strs.xelem (i).length ();
+        m_offsets.xelem (i+1) = nchars;
+      }
+
+    m_chars.clear (dim_vector (nchars, 1));
+
+    char *dest = m_chars.fortran_vec ();
+    for (octave_idx_type i = 0; i < n; i++)
+      dest = std::copy (strs.xelem (i).begin (), strs.xelem (i).end (), dest);
+  }
+
+  string_array
+  string_array::reshape (const dim_vector& new_dims) const
+  {
+    if (new_dims.numel () != numel ())
+      {
+        std::string dims_str = m_dims.str ();
+        std::string new_dims_str = new_dims.str ();
+
+        (*current_liboctave_error_handler)
+          ("reshape: can't reshape %s array to %s array",
+           dims_str.c_str (), new_dims_str.c_str ());
+      }
+
+    string_array retval = *this;
+    retval.m_dims = new_dims;
+
+    return retval;
+  }
+
+  string_array
+  string_array::index (const Array<octave_idx_type>& elems) const
+  {
+    octave_idx_type n = elems.numel ();
+
+    Array<octave_idx_type> offsets (dim_vector (n + 1, 1));
+
+    octave_idx_type nchars = 0;
+    offsets.xelem (0) = 0;
+    for (octave_idx_type k = 0; k < n; k++)
+      {
+        nchars += length (elems.xelem (k));
+        offsets.xelem (k+1) = nchars;
+      }
+
+    // Selecting all elements in order shares the character buffer.
+    if (nchars == m_chars.numel () && n == numel ())
+      {
+        bool identity = true;
+        for (octave_idx_type k = 0; k < n && identity; k++)
+          identity = (elems.xelem (k) == k);
+
+        if (identity)
+          return string_array (elems.dims (), m_chars, m_offsets);
+      }
+
+    Array<char> chars (dim_vector (nchars, 1));
+
+    char *dest = chars.fortran_vec ();
+    for (octave_idx_type k = 0; k < n; k++)
+      {
+        octave_idx_type i = elems.xelem (k);
+        dest = std::copy (data (i), data (i) + length (i), dest);
+      }
+
+    return string_array (elems.dims (), chars, offsets);
+  }
+
+  Array<std::string>
+  string_array::cellstr_value (void) const
+  {
+    octave_idx_type n = numel ();
+
+    Array<std::string> retval (m_dims);
+
+    for (octave_idx_type i = 0; i < n; i++)
+      retval.xelem (i) = elem (i);
+
+    return retval;
+  }
+}
@@ -0,0 +1,110 @@
+/*
+
+Copyright (C) 2016 The Octave Project Developers
+
+This file is part of Octave.
+
+Octave is free software; you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+Octave is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Octave; see the file COPYING.  If not, see
+<http://www.gnu.org/licenses/>.
+
+*/
+
+#if ! defined (octave_str_array_h)
+#define octave_str_array_h 1
+
+#include "octave-config.h"
+
+#include <string>
+
+#include "Array.h"
+#include "dim-vector.h"
+
+namespace octave
+{
+  // An N-dimensional array of strings kept in a single character
+  // buffer.  Element I consists of the characters from offset I up to
+  // offset I+1, so creating, copying, and indexing the array does not
+  // allocate memory for each element as Array<std::string> does.
+
+  class
+  OCTAVE_API
+  string_array
+  {
+  public:
+
+    string_array (void)
+      : m_dims (), m_chars (), m_offsets (dim_vector (1, 1), 0) { }
+
+    // OFFSETS must have one more element than DV, start at 0, be
+    // nondecreasing, and end at the number of elements of CHARS.
+    string_array (const dim_vector& dv, const Array<char>& chars,
+                  const Array<octave_idx_type>& offsets);
+
+    string_array (const dim_vector& dv, const std::string& chars,
+                  const Array<octave_idx_type>& offsets);
+
+    explicit string_array (const Array<std::string>& strs);
+
+    string_array (const string_array&) = default;
+
+    string_array& operator = (const string_array&) = default;
+
+    ~string_array (void) = default;
+
+    dim_vector dims (void) const { return m_dims; }
+
+    octave_idx_type numel (void) const { return m_offsets.numel () - 1; }
+
+    bool is_empty (void) const { return numel () == 0; }
+
+    // Pointer to the first character of element I.  The characters are
+    // not null-terminated.
+    const char * data (octave_idx_type i) const
+    { return m_chars.data () + m_offsets.xelem (i); }
+
+    octave_idx_type length (octave_idx_type i) const
+    { return m_offsets.xelem (i+1) - m_offsets.xelem (i); }
+
+    std::string elem (octave_idx_type i) const
+    { return std::string (data (i), length (i)); }
+
+    std::string operator () (octave_idx_type i) const { return elem (i); }
+
+    const Array<char>& chars (void) const { return m_chars; }
+
+    const Array<octave_idx_type>& offsets (void) const { return m_offsets; }
+
+    size_t byte_size (void) const
+    { return m_chars.byte_size () + m_offsets.byte_size (); }
+
+    string_array reshape (const dim_vector& new_dims) const;
+
+    // Return the array with the dimensions of ELEMS whose element K is
+    // element ELEMS(K) of this array.  The indices are zero-based and
+    // are not checked.
+    string_array index (const Array<octave_idx_type>& elems) const;
+
+    Array<std::string> cellstr_value (void) const;
+
+  private:
+
+    dim_vector m_dims;
+
+    Array<char> m_chars;
+
+    Array<octave_idx_type> m_offsets;
+  };
+}
+
+#endif
@@ -30,6 +30,8 @@ along with Octave; see the file COPYING.  If not, see
 
 #include <stdio.h>
 
+#include "vasnprintf.h"
+
 #include "vasprintf-wrapper.h"
 
 int
@@ -38,3 +40,13 @@ octave_vasprintf_wrapper (char **buf, const char *fmt, va_list args)
   return vasprintf (buf, fmt, args);
 }
 
+// Format into BUF, which holds *LEN bytes, if the result fits, or into
+// newly allocated memory otherwise.  On return, *LEN is the length of
+// the result, without the terminating NUL.
+
+char *
+octave_vasnprintf_wrapper (char *buf, size_t *len, const char *fmt,
+                           va_list args)
+{
+  return vasnprintf (buf, len, fmt, args);
+}
@@ -25,8 +25,10 @@ along with Octave; see the file COPYING.  If not, see
 
 #if defined __cplusplus
 #  include <cstdarg>
+#  include <cstddef>
 #else
 #  include <stdarg.h>
+#  include <stddef.h>
 #endif
 
 #if defined __cplusplus
@@ -36,6 +38,10 @@ extern "C" {
 extern int
 octave_vasprintf_wrapper (char **buf, const char *fmt, va_list args);
 
+extern char *
+octave_vasnprintf_wrapper (char *buf, size_t *len, const char *fmt,
+                           va_list args);
+
 #if defined __cplusplus
 }
 #endif
@@ -1885,6 +1885,31 @@ AC_DEFUN([OCTAVE_CXX_FLAG], [
   fi
 ])
 dnl
+dnl Check if the C++ compiler and runtime support thread_local variables,
+dnl including thread_local objects with destructors.
+dnl
+AC_DEFUN([OCTAVE_CXX_THREAD_LOCAL], [
+  AC_CACHE_CHECK([whether C++ supports thread_local variables],
+    [octave_cv_cxx_thread_local],
+    [AC_LANG_PUSH(C++)
+    AC_LINK_IFELSE([AC_LANG_PROGRAM([[
+        struct S { ~S (void) { } };
+        static thread_local int n = 0;
+        static thread_local S s;
+        ]], [[
+        n++;
+        (void) &s;
+      ]])],
+      octave_cv_cxx_thread_local=yes,
+      octave_cv_cxx_thread_local=no)
+    AC_LANG_POP(C++)
+  ])
+  if test $octave_cv_cxx_thread_local = yes; then
+    AC_DEFINE(OCTAVE_HAVE_THREAD_LOCAL, 1,
+      [Define to 1 if C++ supports thread_local variables.])
+  fi
+])
+dnl
 dnl Allow the user disable support for command line editing using GNU
 dnl readline.
 dnl
@@ -0,0 +1,245 @@
+## Copyright (C) 2016 The Octave Project Developers
+##
+## This file is part of Octave.
+##
+## Octave is free software; you can redistribute it and/or modify it
+## under the terms of the GNU General Public License as published by
+## the Free Software Foundation; either version 3 of the License, or
+## (at your option) any later version.
+##
+## Octave is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU General Public License for more details.
+##
+## You should have received a copy of the GNU General Public License
+## along with Octave; see the file COPYING.  If not, see
+## <http://www.gnu.org/licenses/>.
+
+## -*- texinfo -*-
+## @deftypefn  {} {@var{m} =} matfile (@var{filename})
+## @deftypefnx {} {@var{m} =} matfile (@var{filename}, "Writable", @var{tf})
+## Access the variables in the data file @var{filename} without loading
+## them into memory.
+##
+## Variables are read and written as fields of the returned object
+## @var{m}.  Indexing a field reads only the selected elements, and
+## assigning to an indexed field changes only those elements in the file:
+##
+## @example
+## @group
+## m = matfile ("data.mat", "Writable", true);
+## rows = m.X(1000:2000, :);
+## m.X(1, :) = 0;
+## m.Y = rand (10);
+## @end group
+## @end example
+##
+## Partial reads and writes are supported for numeric and logical arrays
+## in HDF5 files (@code{save -hdf5}), Octave binary files
+## (@code{save -binary}), and uncompressed MATLAB v6 files
+## (@code{save -v6}).  Other variables, and variables in compressed files,
+## are read and written as a whole.  Only HDF5 files allow existing
+## variables to grow or change type.
+##
+## If @var{filename} has no extension, @file{.mat} is appended.  The file
+## is writable if @var{tf} is true, or if it does not exist yet; a new file
+## is created on the first assignment, in HDF5 format if Octave supports it.
+##
+## @code{end} cannot be used in indices; use @code{size (@var{m},
+## @var{name})} to find the dimensions of variable @var{name} instead.
+## The names of the variables are returned by @code{who (@var{m})}, and
+## the file name and access mode by @code{@var{m}.Properties}.
+## @seealso{load, save}
+## @end deftypefn
+
+function m = matfile (filename, varargin)
+
+  if (nargin == 1 && isa (filename, "matfile"))
+    m = filename;   # Copy constructor
+    return;
+  endif
+
+  if (nargin != 1 && nargin != 3)
+    print_usage ();
+  endif
+
+  if (! ischar (filename) || ! isrow (filename))
+    error ("matfile: FILENAME must be a string");
+  endif
+
+  [~, ~, ext] = fileparts (filename);
+  if (isempty (ext))
+    filename = [filename ".mat"];
+  endif
+
+  filename = make_absolute_filename (filename);
+
+  [~, err] = stat (filename);
+  writable = (err != 0);
+
+  if (nargin == 3)
+    if (! ischar (varargin{1}) || ! strcmpi (varargin{1}, "Writable"))
+      error ('matfile: unknown property, expected "Writable"');
+    endif
+    writable = logical (varargin{2});
+  endif
+
+  p.Properties.Source = filename;
+  p.Properties.Writable = writable;
+
+  m = class (p, "matfile");
+
+endfunction
+
+
+%!shared x, f
+%! x = rand (5, 6);
+%! f = [tempname() ".mat"];
+
+%!test
+%! unwind_protect
+%!   save ("-binary", f, "x");
+%!   m = matfile (f);
+%!   assert (m.Properties.Writable, false);
+%!   assert (m.x, x);
+%!   assert (m.x(2:4, :), x(2:4, :));
+%!   assert (m.x(:, [5 2]), x(:, [5 2]));
+%!   assert (m.x(7:9), x(7:9));
+%!   assert (m.x(:), x(:));
+%!   assert (m.x(2, 3), x(2, 3));
+%!   assert (m.x(2:3, 1:2)(2), x(3, 1));
+%! unwind_protect_cleanup
+%!   unlink (f);
+%! end_unwind_protect
+
+%!test
+%! unwind_protect
+%!   y = int16 (magic (4));
+%!   z = complex (x, 1);
+%!   save ("-v6", f, "x", "y", "z");
+%!   m = matfile (f, "Writable", true);
+%!   assert (m.y([1 4], 2:3), y([1 4], 2:3));
+%!   assert (m.z(2, :), z(2, :));
+%!   m.y(2:3, [1 4]) = [10 20; 30 40];
+%!   y(2:3, [1 4]) = [10 20; 30 40];
+%!   m.z(:, 2) = 0;
+%!   z(:, 2) = 0;
+%!   fail ("m.y(1) = NaN", "cannot be stored in its data type");
+%!   fail ("m.y(1) = 32768", "cannot be stored in its data type");
+%!   fail ("m.y(1) = 0.5", "cannot be stored in its data type");
+%!   m.w = {1, "two"};
+%!   s = load (f);
+%!   assert (s, struct ("x", x, "y", y, "z", z, "w", {{1, "two"}}));
+%!   assert (sort (who (m)), {"w"; "x"; "y"; "z"});
+%!   assert (size (m, "y"), [4, 4]);
+%! unwind_protect_cleanup
+%!   unlink (f);
+%! end_unwind_protect
+
+%!test
+%! unwind_protect
+%!   save ("-binary", f, "x");
+%!   m = matfile (f, "Writable", true);
+%!   m.x(3, :) = 1:6;
+%!   m.x(1) = -1;
+%!   y = x;
+%!   y(3, :) = 1:6;
+%!   y(1) = -1;
+%!   assert (load (f).x, y);
+%!   fail ("m.x(7, 1) = 1", "use an HDF5 file");
+%! unwind_protect_cleanup
+%!   unlink (f);
+%! end_unwind_protect
+
+%!test
+%! unwind_protect
+%!   a = {1, "two"; int8(3), {4}};
+%!   b = struct ("p", {1, 2, 3});
+%!   c = ["ab"; "cd"; "ef"];
+%!   d = sparse ([1 0 2; 0 0 3]);
+%!   e = single (2.5);
+%!   g = int16 (-4);
+%!   h = true;
+%!   r = 1:5;
+%!   save ("-binary", f, "a", "b", "c", "d", "e", "g", "h", "r", "x");
+%!   m = matfile (f);
+%!   assert (size (m, "a"), [2, 2]);
+%!   assert (size (m, "b"), [1, 3]);
+%!   assert (size (m, "c"), [3, 2]);
+%!   assert (size (m, "d"), [2, 3]);
+%!   assert (size (m, "r"), [1, 5]);
+%!   assert (m.x(2:3, 4), x(2:3, 4));
+%!   assert (m.a, a);
+%!   assert (m.b, b);
+%!   assert (m.c, c);
+%!   assert (m.d, d);
+%!   assert (m.e, e);
+%!   assert (m.g, g);
+%!   assert (m.h, h);
+%!   assert (m.r, r);
+%! unwind_protect_cleanup
+%!   unlink (f);
+%! end_unwind_protect
+
+%!test
+%! unwind_protect
+%!   y = zeros (1e4, 1);
+%!   save ("-binary", f, "x", "y");
+%!   m = matfile (f, "Writable", true);
+%!   fail ("m.x(2:3, 1:3) = ones (3, 2)", "nonconformant");
+%!   m.x(1:6) = ones (2, 3);
+%!   m.x(2, 2:4) = [7; 8; 9];
+%!   z = x;
+%!   z(1:6) = 1;
+%!   z(2, 2:4) = [7, 8, 9];
+%!   assert (m.x, z);
+%!   m.y(5) = 7;
+%!   assert (m.y(5), 7);
+%!   fail ("m.y(5) = 0.5", "stores its double values as uint8 integers");
+%!   y(5) = 7;
+%!   assert (load (f).y, y);
+%! unwind_protect_cleanup
+%!   unlink (f);
+%! end_unwind_protect
+
+%!testif HAVE_ZLIB
+%! unwind_protect
+%!   s = struct ();
+%!   for i = 1:50
+%!     s.(sprintf ("v%02d", i)) = x + i;
+%!   endfor
+%!   save ("-v7", f, "-struct", "s");
+%!   m = matfile (f);
+%!   assert (numel (who (m)), 50);
+%!   assert (m.v01, x + 1);
+%!   assert (m.v37(2, 3:4), x(2, 3:4) + 37);
+%!   assert (m.v50(:, 6), x(:, 6) + 50);
+%!   assert (size (m, "v25"), [5, 6]);
+%! unwind_protect_cleanup
+%!   unlink (f);
+%! end_unwind_protect
+
+%!testif HAVE_HDF5
+%! unwind_protect
+%!   m = matfile (f);
+%!   assert (m.Properties.Writable, true);
+%!   m.a = x;
+%!   m.b = true (3, 2);
+%!   assert (m.a(4:5, [2 6]), x(4:5, [2 6]));
+%!   m.a(6, :) = 1;
+%!   m.b(2, 2) = false;
+%!   y = x;
+%!   y(6, :) = 1;
+%!   s = load (f);
+%!   assert (s.a, y);
+%!   assert (s.b, logical ([1 1; 1 0; 1 1]));
+%! unwind_protect_cleanup
+%!   unlink (f);
+%! end_unwind_protect
+
+## Test input validation
+%!error matfile ()
+%!error matfile ("a.mat", "Writable")
+%!error <FILENAME must be a string> matfile (1)
+%!error <unknown property> matfile ("a.mat", "Readable", true)
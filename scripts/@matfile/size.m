@@ -0,0 +1,68 @@
+## Copyright (C) 2016 The Octave Project Developers
+##
+## This file is part of Octave.
+##
+## Octave is free software; you can redistribute it and/or modify it
+## under the terms of the GNU General Public License as published by
+## the Free Software Foundation; either version 3 of the License, or
+## (at your option) any later version.
+##
+## Octave is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU General Public License for more details.
+##
+## You should have received a copy of the GNU General Public License
+## along with Octave; see the file COPYING.  If not, see
+## <http://www.gnu.org/licenses/>.
+
+## -*- texinfo -*-
+## @deftypefn  {} {@var{sz} =} size (@var{m})
+## @deftypefnx {} {@var{sz} =} size (@var{m}, @var{name})
+## @deftypefnx {} {@var{dim_sz} =} size (@var{m}, @var{name}, @var{n})
+## @deftypefnx {} {[@var{rows}, @var{cols}, @dots{}, @var{dim_N_sz}] =} size (@dots{})
+## Return the dimensions of the variable @var{name} in the file of the
+## matfile object @var{m}, without reading the variable if possible.
+##
+## Without @var{name}, return the dimensions of @var{m} itself.
+## @seealso{matfile, size}
+## @end deftypefn
+
+function varargout = size (m, name, n)
+
+  if (nargin < 1 || nargin > 3)
+    print_usage ();
+  endif
+
+  if (nargin == 1)
+    sz = [1, 1];
+  else
+    info = __matfile_info__ (m.Properties.Source);
+    k = find (strcmp (name, {info.name}), 1);
+    if (isempty (k))
+      error ("matfile: variable '%s' not found in %s", name,
+             m.Properties.Source);
+    endif
+    sz = info(k).size;
+    if (isempty (sz))
+      sz = size (__matfile_read__ (m.Properties.Source, name));
+    endif
+  endif
+
+  if (nargin == 3)
+    sz(end+1:n) = 1;
+    sz = sz(n);
+  endif
+
+  if (nargout <= 1)
+    varargout = {sz};
+  else
+    sz(end+1:nargout) = 1;
+    varargout = num2cell ([sz(1:nargout-1), prod(sz(nargout:end))]);
+  endif
+
+endfunction
+
+
+## Tests are in matfile.m
+%!assert (1)
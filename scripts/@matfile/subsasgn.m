@@ -0,0 +1,68 @@
+## Copyright (C) 2016 The Octave Project Developers
+##
+## This file is part of Octave.
+##
+## Octave is free software; you can redistribute it and/or modify it
+## under the terms of the GNU General Public License as published by
+## the Free Software Foundation; either version 3 of the License, or
+## (at your option) any later version.
+##
+## Octave is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU General Public License for more details.
+##
+## You should have received a copy of the GNU General Public License
+## along with Octave; see the file COPYING.  If not, see
+## <http://www.gnu.org/licenses/>.
+
+## -*- texinfo -*-
+## @deftypefn {} {@var{m} =} subsasgn (@var{m}, @var{s}, @var{val})
+## Write a variable, or part of it, to the file of the matfile object
+## @var{m}.
+## @seealso{matfile}
+## @end deftypefn
+
+function m = subsasgn (m, s, val)
+
+  if (! strcmp (s(1).type, "."))
+    error ("matfile: variables must be accessed as fields, as in M.NAME");
+  endif
+
+  name = s(1).subs;
+
+  if (strcmp (name, "Properties"))
+    if (numel (s) != 2 || ! strcmp (s(2).type, ".")
+        || ! strcmp (s(2).subs, "Writable"))
+      error ("matfile: only Properties.Writable can be changed");
+    endif
+    m.Properties.Writable = logical (val);
+    return;
+  endif
+
+  if (! m.Properties.Writable)
+    error ('matfile: %s is not writable; use matfile (FILENAME, "Writable", true)',
+           m.Properties.Source);
+  endif
+
+  file = m.Properties.Source;
+
+  if (numel (s) == 1)
+    __matfile_write__ (file, name, val);
+  elseif (numel (s) == 2 && strcmp (s(2).type, "()"))
+    ## Only the indexed elements are written.
+    __matfile_write__ (file, name, val, s(2).subs{:});
+  else
+    if (any (strcmp (name, who (m))))
+      tmp = __matfile_read__ (file, name);
+    else
+      tmp = [];
+    endif
+    __matfile_write__ (file, name, subsasgn (tmp, s(2:end), val));
+  endif
+
+endfunction
+
+
+## Tests are in matfile.m
+%!assert (1)
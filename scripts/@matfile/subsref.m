@@ -0,0 +1,54 @@
+## Copyright (C) 2016 The Octave Project Developers
+##
+## This file is part of Octave.
+##
+## Octave is free software; you can redistribute it and/or modify it
+## under the terms of the GNU General Public License as published by
+## the Free Software Foundation; either version 3 of the License, or
+## (at your option) any later version.
+##
+## Octave is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU General Public License for more details.
+##
+## You should have received a copy of the GNU General Public License
+## along with Octave; see the file COPYING.  If not, see
+## <http://www.gnu.org/licenses/>.
+
+## -*- texinfo -*-
+## @deftypefn {} {@var{val} =} subsref (@var{m}, @var{s})
+## Read a variable, or part of it, from the file of the matfile object
+## @var{m}.
+## @seealso{matfile}
+## @end deftypefn
+
+function val = subsref (m, s)
+
+  if (! strcmp (s(1).type, "."))
+    error ("matfile: variables must be accessed as fields, as in M.NAME");
+  endif
+
+  name = s(1).subs;
+
+  if (strcmp (name, "Properties"))
+    val = m.Properties;
+    s(1) = [];
+  elseif (numel (s) > 1 && strcmp (s(2).type, "()"))
+    ## Only the indexed elements are read.
+    val = __matfile_read__ (m.Properties.Source, name, s(2).subs{:});
+    s(1:2) = [];
+  else
+    val = __matfile_read__ (m.Properties.Source, name);
+    s(1) = [];
+  endif
+
+  if (! isempty (s))
+    val = subsref (val, s);
+  endif
+
+endfunction
+
+
+## Tests are in matfile.m
+%!assert (1)
@@ -0,0 +1,47 @@
+## Copyright (C) 2016 The Octave Project Developers
+##
+## This file is part of Octave.
+##
+## Octave is free software; you can redistribute it and/or modify it
+## under the terms of the GNU General Public License as published by
+## the Free Software Foundation; either version 3 of the License, or
+## (at your option) any later version.
+##
+## Octave is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU General Public License for more details.
+##
+## You should have received a copy of the GNU General Public License
+## along with Octave; see the file COPYING.  If not, see
+## <http://www.gnu.org/licenses/>.
+
+## -*- texinfo -*-
+## @deftypefn  {} {} who (@var{m})
+## @deftypefnx {} {@var{names} =} who (@var{m})
+## List the variables in the file of the matfile object @var{m}.
+## @seealso{matfile, who}
+## @end deftypefn
+
+function names = who (m)
+
+  [~, err] = stat (m.Properties.Source);
+  if (err != 0)
+    vars = {};
+  else
+    info = __matfile_info__ (m.Properties.Source);
+    vars = {info.name}(:);
+  endif
+
+  if (nargout == 0)
+    printf ("Variables in the file %s:\n\n", m.Properties.Source);
+    printf ("%s\n", list_in_columns (vars));
+  else
+    names = vars;
+  endif
+
+endfunction
+
+
+## Tests are in matfile.m
+%!assert (1)
@@ -332,22 +332,36 @@ function A = accumarray (subs, vals, sz = [], func = [], fillval = [], issparse
         vals = vals(:);
       endif
 
-      ## Sort indices.
-      [subs, idx] = sort (subs);
-      ## Identify runs.
-      jdx = find (subs(1:n-1) != subs(2:n));
-      if (n != 0) # bug #47287
-        jdx = [jdx; n];
-      endif
-      vals = mat2cell (vals(idx), diff ([0; jdx]));
-      ## Optimize the case when function is @(x) {x}, i.e., we just want
-      ## to collect the values to cells.
-      persistent simple_cell_str = func2str (@(x) {x});
-      if (! strcmp (func2str (func), simple_cell_str))
-        vals = cellfun (func, vals);
+      op = "";
+      if (n != 0)
+        op = native_reduction (func, vals);
       endif
 
-      subs = subs(jdx);
+      if (! isempty (op))
+        ## Common reductions are computed in a single pass, without
+        ## sorting the subscripts or splitting the values into cells.
+        if (any (strcmp (op, {"any", "all"})) && ! islogical (vals))
+          vals = (vals != 0);
+        endif
+        [vals, subs] = __accumarray_reduce__ (subs, vals, op);
+      else
+        ## Sort indices.
+        [subs, idx] = sort (subs);
+        ## Identify runs.
+        jdx = find (subs(1:n-1) != subs(2:n));
+        if (n != 0) # bug #47287
+          jdx = [jdx; n];
+        endif
+        vals = mat2cell (vals(idx), diff ([0; jdx]));
+        ## Optimize the case when function is @(x) {x}, i.e., we just want
+        ## to collect the values to cells.
+        persistent simple_cell_str = func2str (@(x) {x});
+        if (! strcmp (func2str (func), simple_cell_str))
+          vals = cellfun (func, vals);
+        endif
+
+        subs = subs(jdx);
+      endif
 
       if (isempty (sz))
         sz = max (subs);
@@ -373,6 +387,44 @@ function A = accumarray (subs, vals, sz = [], func = [], fillval = [], issparse
 
 endfunction
 
+## Return the name of the reduction performed by __accumarray_reduce__
+## that is equivalent to FUNC for values like VALS, or "" if there is none.
+function op = native_reduction (func, vals)
+
+  persistent first_str = func2str (@(x) x(1));
+  persistent last_str = func2str (@(x) x(end));
+
+  op = "";
+  isrealfloat = isfloat (vals) && isreal (vals);
+  isarray = isnumeric (vals) || islogical (vals) || ischar (vals);
+
+  if (func == @numel || func == @length)
+    op = "numel";
+  elseif (! isarray)
+    return;
+  elseif (func == @mean && isrealfloat)
+    op = "mean";
+  elseif (func == @prod && isrealfloat)
+    op = "prod";
+  elseif (func == @var && isrealfloat)
+    op = "var";
+  elseif (func == @std && isrealfloat)
+    op = "std";
+  elseif (func == @any && ! ischar (vals))
+    op = "any";
+  elseif (func == @all && ! ischar (vals))
+    op = "all";
+  else
+    fstr = func2str (func);
+    if (strcmp (fstr, first_str))
+      op = "first";
+    elseif (strcmp (fstr, last_str))
+      op = "last";
+    endif
+  endif
+
+endfunction
+
 
 %!assert (accumarray ([1; 2; 4; 2; 4], 101:105), [101; 206; 0; 208])
 %!assert (accumarray ([1 1 1; 2 1 2; 2 3 2; 2 1 2; 2 3 2], 101:105),
@@ -400,6 +452,23 @@ endfunction
 %!assert (accumarray ([1; 2], [3; 4], [1, 2], @min, [], 0), [3, 4])
 %!assert (accumarray ([1; 2], [3; 4], [1, 2], @min, [], 1), sparse ([3, 4]))
 
+%!assert (accumarray ([1 1; 2 1; 2 3; 2 1; 2 3], 101:105, [2 4], @mean, NaN),
+%!        [101 NaN NaN NaN; 103 NaN 104 NaN])
+%!assert (accumarray ([1; 2; 2; 4; 2], [1 2 NaN 3 6], [], @any),
+%!        [true; true; false; true])
+%!assert (accumarray ([3; 1; 3; 1], "abcd", [3 1], @(x) x(end), "-"),
+%!        ["d"; "-"; "c"])
+
+%!test
+%! subs = ceil (rand (2000, 2)*10);
+%! vals = rand (2000, 1);
+%! funcs = {@mean, @prod, @numel, @std, @var, @(x) x(1), @(x) x(end)};
+%! for idx = 1:numel (funcs)
+%!   fcn = funcs{idx};
+%!   assert (accumarray (subs, vals, [], fcn),
+%!           accumarray (subs, vals, [], @(x) fcn (x)), 4*eps);
+%! endfor
+
 %!test
 %! A = accumarray ([1 1; 2 1; 2 3; 2 1; 2 3], 101:105, [2,4], @(x) {x});
 %! assert (A{2},[102; 104]);
@@ -76,6 +76,31 @@ PKG_ADD_FILES += scripts/@ftp/PKG_ADD
 DIRSTAMP_FILES += scripts/@ftp/$(octave_dirstamp)
 ####################### end include scripts/@ftp/module.mk #####################
 
+## include scripts/@matfile/module.mk
+## See the comment for scripts/@ftp/module.mk above.
+scripts_EXTRA_DIST += scripts/@matfile/module.mk
+###################### include scripts/@matfile/module.mk ######################
+FCN_FILE_DIRS += scripts/@matfile
+
+scripts_@matfile_FCN_FILES = \
+  scripts/@matfile/display.m \
+  scripts/@matfile/matfile.m \
+  scripts/@matfile/size.m \
+  scripts/@matfile/subsasgn.m \
+  scripts/@matfile/subsref.m \
+  scripts/@matfile/who.m
+
+scripts_@matfiledir = $(fcnfiledir)/@matfile
+
+scripts_@matfile_DATA = $(scripts_@matfile_FCN_FILES)
+
+FCN_FILES += $(scripts_@matfile_FCN_FILES)
+
+PKG_ADD_FILES += scripts/@matfile/PKG_ADD
+
+DIRSTAMP_FILES += scripts/@matfile/$(octave_dirstamp)
+##################### end include scripts/@matfile/module.mk ###################
+
 image_DATA += $(SCRIPTS_IMAGES)
 
 GEN_FCN_FILES_IN = $(GEN_FCN_FILES:.m=.in.m)
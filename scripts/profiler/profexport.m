@@ -21,8 +21,12 @@
 ## @deftypefnx {} {} profexport (@var{dir}, @var{data})
 ## @deftypefnx {} {} profexport (@var{dir}, @var{name})
 ## @deftypefnx {} {} profexport (@var{dir}, @var{name}, @var{data})
+## @deftypefnx {} {} profexport ("-collapsed", @var{file})
+## @deftypefnx {} {} profexport ("-collapsed", @var{file}, @var{data})
+## @deftypefnx {} {} profexport ("-callgrind", @var{file})
+## @deftypefnx {} {} profexport ("-callgrind", @var{file}, @var{data})
 ##
-## Export profiler data as HTML.
+## Export profiler data as HTML or in a format for external tools.
 ##
 ## Export the profiling data in @var{data} into a series of HTML files in
 ## the folder @var{dir}.  The initial file will be
@@ -34,6 +38,18 @@
 ## The input @var{data} is the structure returned by @code{profile ("info")}.
 ## If unspecified, @code{profexport} will use the current profile dataset.
 ##
+## With the option @qcode{"-collapsed"}, the call tree is written to
+## @var{file} in the collapsed stack format read by flame graph tools.
+## Each line holds the semicolon separated names of the functions on a call
+## path followed by the time spent at that level in microseconds.
+##
+## With the option @qcode{"-callgrind"}, the profile is written to @var{file}
+## in the format read by callgrind_annotate and KCachegrind.  Times are
+## given in microseconds, and are attributed to individual lines of user
+## functions where line data is available.  The cost of a line includes the
+## built-in functions and operators it calls, which are then not listed as
+## separate calls.
+##
 ## @seealso{profshow, profexplore, profile}
 ## @end deftypefn
 
@@ -50,6 +66,25 @@ function profexport (dir, name = "", data)
     error ("profexport: DIR must be a string");
   endif
 
+  if (any (strcmp (dir, {"-collapsed", "-callgrind"})))
+    if (nargin < 2)
+      print_usage ();
+    endif
+    file = name;
+    if (! ischar (file))
+      error ("profexport: FILE must be a string");
+    endif
+    if (nargin < 3)
+      data = profile ("info");
+    endif
+    if (strcmp (dir, "-collapsed"))
+      __writeCollapsed (file, data);
+    else
+      __writeCallgrind (file, data);
+    endif
+    return;
+  endif
+
   if (nargin == 1)
     data = profile ("info");
   elseif (nargin == 2)
@@ -267,6 +302,104 @@ function str = __hierarchicalParents (parents)
 
 endfunction
 
+################################################################################
+## Write the call tree in collapsed stack format.
+
+function __writeCollapsed (file, data)
+
+  lines = __collapsedStacks ("", data.FunctionTable, data.Hierarchical);
+  __writeToFile (file, [lines{:}]);
+
+endfunction
+
+function lines = __collapsedStacks (prefix, funcs, nodes)
+
+  lines = {};
+  for i = 1 : numel (nodes)
+    cur = nodes(i);
+    stack = funcs(cur.Index).FunctionName;
+    if (! isempty (prefix))
+      stack = [prefix, ";", stack];
+    endif
+
+    lines{end+1} = sprintf ("%s %d\n", stack, round (1e6 * cur.SelfTime));
+    lines = [lines, __collapsedStacks(stack, funcs, cur.Children)];
+  endfor
+
+endfunction
+
+################################################################################
+## Write the profile in callgrind format.
+
+function __writeCallgrind (file, data)
+
+  funcs = data.FunctionTable;
+  nf = numel (funcs);
+
+  if (isfield (data, "LineTable"))
+    ltable = data.LineTable;
+  else
+    ltable = struct ("Index", {}, "Line", {}, "TotalTime", {});
+  endif
+  lidx = [ltable.Index];
+
+  ## Number of calls and inclusive time of each (caller, callee) pair, and
+  ## the self time of each function.
+  lined = false (nf, 1);
+  lined(lidx) = true;
+  [calls, incl, self] = __callPairs (zeros (nf), zeros (nf), zeros (nf, 1),
+                                     lined, 0, false, data.Hierarchical);
+
+  str = "events: Time\n";
+  for i = 1 : nf
+    str = [str, sprintf("\nfn=%s\n", funcs(i).FunctionName)];
+
+    own = ltable(lidx == i);
+    if (isempty (own))
+      str = [str, sprintf("0 %d\n", round (1e6 * self(i)))];
+    else
+      str = [str, sprintf("%d %d\n", [[own.Line]; ...
+                                       round(1e6 * [own.TotalTime])])];
+    endif
+
+    for j = find (calls(i,:))
+      str = [str, sprintf("cfn=%s\ncalls=%d 0\n0 %d\n", ...
+                          funcs(j).FunctionName, calls(i,j),
+                          round (1e6 * incl(i,j)))];
+    endfor
+  endfor
+
+  __writeToFile (file, str);
+
+endfunction
+
+## The line times of user functions include the time of the built-in
+## functions and operators called from them.  Such calls are not listed
+## separately, and their callees are listed as called from the line's
+## function, so that no time is counted twice.
+
+function [calls, incl, self] = __callPairs (calls, incl, self, lined,
+                                            parent, owned, nodes)
+
+  for i = 1 : numel (nodes)
+    cur = nodes(i);
+    if (owned && ! lined(cur.Index))
+      [calls, incl, self] = __callPairs (calls, incl, self, lined,
+                                         parent, true, cur.Children);
+    else
+      if (parent > 0)
+        calls(parent, cur.Index) += cur.NumCalls;
+        incl(parent, cur.Index) += cur.TotalTime;
+      endif
+      self(cur.Index) += cur.SelfTime;
+      [calls, incl, self] = __callPairs (calls, incl, self, lined,
+                                         cur.Index, lined(cur.Index),
+                                         cur.Children);
+    endif
+  endfor
+
+endfunction
+
 ################################################################################
 ## General helper functions.
 
@@ -308,10 +441,103 @@ endfunction
 %! profexport (dir, "Example Profile");
 %! open (fullfile (dir, "index.html"));
 
+%!test
+%! data.FunctionTable = struct ("FunctionName", {"f", "g"},
+%!                              "TotalTime", {3, 2});
+%! data.Hierarchical = struct ("Index", 1, "SelfTime", 1, "TotalTime", 3,
+%!                             "NumCalls", 2,
+%!                             "Children", struct ("Index", 2,
+%!                                                 "SelfTime", 2,
+%!                                                 "TotalTime", 2,
+%!                                                 "NumCalls", 4,
+%!                                                 "Children", []));
+%! data.LineTable = struct ("Index", {2, 2}, "Line", {3, 5},
+%!                          "TotalTime", {0.5, 1.5}, "NumCalls", {4, 4});
+%! file = tempname ();
+%! unwind_protect
+%!   profexport ("-collapsed", file, data);
+%!   assert (fileread (file), "f 1000000\nf;g 2000000\n");
+%!   profexport ("-callgrind", file, data);
+%!   assert (fileread (file),
+%!           ["events: Time\n\nfn=f\n0 1000000\n", ...
+%!            "cfn=g\ncalls=4 0\n0 2000000\n", ...
+%!            "\nfn=g\n3 500000\n5 1500000\n"]);
+%! unwind_protect_cleanup
+%!   unlink (file);
+%! end_unwind_protect
+
+## The self costs in the callgrind file add up to the total time
+%!test
+%! g = struct ("Index", 2, "SelfTime", 0.25, "TotalTime", 0.25,
+%!             "NumCalls", 1, "Children", []);
+%! f = struct ("Index", 1, "SelfTime", 0.5, "TotalTime", 1,
+%!             "NumCalls", 1, "Children", [g; g]);
+%! data.FunctionTable = struct ("FunctionName", {"f", "g", "h"},
+%!                              "TotalTime", {1, 0.5, 2});
+%! data.Hierarchical = [f; struct("Index", 3, "SelfTime", 1.5,
+%!                                "TotalTime", 2, "NumCalls", 1,
+%!                                "Children", g)];
+%! file = tempname ();
+%! unwind_protect
+%!   profexport ("-callgrind", file, data);
+%!   lines = strsplit (fileread (file), "\n");
+%! unwind_protect_cleanup
+%!   unlink (file);
+%! end_unwind_protect
+%! self = struct ();
+%! incl = 0;
+%! in_call = false;
+%! for k = 1:numel (lines)
+%!   l = lines{k};
+%!   if (strncmp (l, "fn=", 3))
+%!     fn = l(4:end);
+%!     self.(fn) = 0;
+%!   elseif (strncmp (l, "calls=", 6))
+%!     in_call = true;
+%!   elseif (! isempty (l) && isdigit (l(1)))
+%!     cost = sscanf (l, "%d %d")(2);
+%!     if (in_call)
+%!       incl += cost;
+%!       in_call = false;
+%!     else
+%!       self.(fn) += cost;
+%!     endif
+%!   endif
+%! endfor
+%! assert (self, struct ("f", 500000, "g", 750000, "h", 1500000));
+%! assert (self.f + self.g + self.h, 3000000);
+%! assert (incl, 750000);
+
+## Built-in functions called from lines are folded into the line costs
+%!test
+%! g = struct ("Index", 3, "SelfTime", 1, "TotalTime", 1,
+%!             "NumCalls", 2, "Children", []);
+%! b = struct ("Index", 2, "SelfTime", 0.5, "TotalTime", 1.5,
+%!             "NumCalls", 1, "Children", g);
+%! data.Hierarchical = struct ("Index", 1, "SelfTime", 0.25, "TotalTime", 1.75,
+%!                             "NumCalls", 1, "Children", b);
+%! data.FunctionTable = struct ("FunctionName", {"f", "cellfun", "g"},
+%!                              "TotalTime", {1.75, 1.5, 1});
+%! data.LineTable = struct ("Index", {1, 3}, "Line", {2, 4},
+%!                          "TotalTime", {0.75, 1}, "NumCalls", {1, 2});
+%! file = tempname ();
+%! unwind_protect
+%!   profexport ("-callgrind", file, data);
+%!   assert (fileread (file),
+%!           ["events: Time\n\nfn=f\n2 750000\n", ...
+%!            "cfn=g\ncalls=2 0\n0 1000000\n", ...
+%!            "\nfn=cellfun\n0 0\n", ...
+%!            "\nfn=g\n4 1000000\n"]);
+%! unwind_protect_cleanup
+%!   unlink (file);
+%! end_unwind_protect
+
 ## Test input validation
 %!error profexport ()
 %!error profexport (1)
 %!error profexport (1, 2, 3, 4)
 %!error <DIR must be a string> profexport (5)
 %!error <NAME must be a string> profexport ("dir", 5)
+%!error profexport ("-collapsed")
+%!error <FILE must be a string> profexport ("-collapsed", 5)
 
@@ -18,6 +18,7 @@
 
 ## -*- texinfo -*-
 ## @deftypefn  {} {} profile on
+## @deftypefnx {} {} profile on -memory
 ## @deftypefnx {} {} profile off
 ## @deftypefnx {} {} profile resume
 ## @deftypefnx {} {} profile clear
@@ -29,6 +30,16 @@
 ## @item profile on
 ## Start the profiler, clearing all previously collected data if there is any.
 ##
+## @item profile on -memory
+## Start the profiler and also record, for each line, the array memory
+## allocated and released while executing it and the peak amount of array
+## memory in use, counted from when memory profiling was started.  Memory
+## of arrays that existed before then is not counted, even when it is
+## released, so the amount in use is never negative.  Only arrays allocated
+## and released by the interpreter thread are recorded, not those of
+## worker threads, for example in parallel loops.  The option
+## @option{-memory} may also be given with @code{profile resume}.
+##
 ## @item profile off
 ## Stop profiling.  The collected data can later be retrieved and examined
 ## with @code{T = profile ("info")}.
@@ -53,7 +64,15 @@
 ## @code{Hierarchical} contains the hierarchical call tree.  Each node has an
 ## index into the @code{FunctionTable} identifying the function it corresponds
 ## to as well as data fields for number of calls and time spent at this level
-## in the call tree.
+## in the call tree.  Finally, the field @code{LineTable} lists the time spent
+## on each line of user functions and scripts.  This includes the time spent
+## in built-in functions and operators called from that line, but not the
+## time spent in other user functions and scripts, which is listed for their
+## own lines.  Each entry has an index into the
+## @code{FunctionTable}, the line number, the total time, and the number of
+## times the line was executed.  The fields @code{AllocatedBytes},
+## @code{FreedBytes}, and @code{PeakBytes} hold the memory statistics and are
+## zero unless memory profiling is enabled.
 ## @seealso{profshow, profexplore}
 ## @end table
 ## @end deftypefn
@@ -61,15 +80,27 @@
 ## Built-in profiler.
 ## Author: Daniel Kraft <d@domob.eu>
 
-function retval = profile (option)
+function retval = profile (option, memopt)
 
-  if (nargin != 1)
+  if (nargin < 1 || nargin > 2)
     print_usage ();
   endif
 
+  memory = false;
+  if (nargin == 2)
+    ## Accept both "profile on -memory" and "profile -memory on".
+    if (strcmp (option, "-memory"))
+      [option, memopt] = deal (memopt, option);
+    endif
+    if (! (strcmp (memopt, "-memory") && any (strcmp (option, {"on", "resume"}))))
+      print_usage ();
+    endif
+    memory = true;
+  endif
+
   switch (option)
     case "on"
-      __profiler_enable__ (true);
+      __profiler_enable__ (true, memory);
 
     case "off"
       __profiler_enable__ (false);
@@ -78,7 +109,7 @@ function retval = profile (option)
       __profiler_reset__ ();
 
     case "resume"
-      __profiler_enable__ (true);
+      __profiler_enable__ (true, memory);
 
     case "status"
       enabled = __profiler_enable__ ();
@@ -90,8 +121,9 @@ function retval = profile (option)
       retval = struct ("ProfilerStatus", enabled);
 
     case "info"
-      [flat, tree] = __profiler_data__ ();
-      retval = struct ("FunctionTable", flat, "Hierarchical", tree);
+      [flat, tree, lines] = __profiler_data__ ();
+      retval = struct ("FunctionTable", flat, "Hierarchical", tree,
+                       "LineTable", lines);
 
     otherwise
       warning ("profile: Unrecognized option '%s'", option);
@@ -128,25 +160,85 @@ endfunction
 %! info = profile ("info");
 %! assert (isstruct (info));
 %! assert (size (info), [1, 1]);
-%! assert (fieldnames (info), {"FunctionTable"; "Hierarchical"});
+%! assert (fieldnames (info), {"FunctionTable"; "Hierarchical"; "LineTable"});
 %! ftbl = info.FunctionTable;
 %! assert (fieldnames (ftbl), {"FunctionName"; "TotalTime"; "NumCalls"; "IsRecursive"; "Parents"; "Children"});
 %! hier = info.Hierarchical;
 %! assert (fieldnames (hier), {"Index"; "SelfTime"; "TotalTime"; "NumCalls"; "Children"});
+%! lines = info.LineTable;
+%! assert (fieldnames (lines), {"Index"; "Line"; "TotalTime"; "NumCalls"; ...
+%!                              "AllocatedBytes"; "FreedBytes"; "PeakBytes"});
+%! assert (! isempty (lines));
 %! profile ("clear");
 %! info = profile ("info");
 %! assert (isstruct (info));
 %! assert (size (info), [1, 1]);
-%! assert (fieldnames (info), {"FunctionTable"; "Hierarchical"});
+%! assert (fieldnames (info), {"FunctionTable"; "Hierarchical"; "LineTable"});
 %! ftbl = info.FunctionTable;
 %! assert (size (ftbl), [0, 1]);
 %! assert (fieldnames (ftbl), {"FunctionName"; "TotalTime"; "NumCalls"; "IsRecursive"; "Parents"; "Children"});
 %! hier = info.Hierarchical;
 %! assert (size (hier), [0, 1]);
 %! assert (fieldnames (hier), {"Index"; "SelfTime"; "TotalTime"; "NumCalls"; "Children"});
+%! assert (size (info.LineTable), [0, 1]);
+
+%!test
+%! profile ("clear");
+%! profile on -memory
+%! x = logm (rand (50) + 10 * eye (50));
+%! profile off;
+%! info = profile ("info");
+%! profile ("clear");
+%! lines = info.LineTable;
+%! assert (sum ([lines.AllocatedBytes]) > 0);
+
+## A line that allocates a matrix of 8e6 bytes, and one that frees it
+%!test
+%! profile ("clear");
+%! profile on -memory
+%! x = zeros (1000, 1000);
+%! clear x;
+%! profile off;
+%! info = profile ("info");
+%! profile ("clear");
+%! lines = info.LineTable;
+%! [alloc, i] = max ([lines.AllocatedBytes]);
+%! assert (alloc >= 8e6 && alloc < 8.1e6);
+%! assert (lines(i).PeakBytes >= 8e6);
+%! assert (max ([lines.FreedBytes]) >= 8e6);
+
+## The time spent in a built-in function is charged to the calling line
+%!test
+%! profile ("clear");
+%! profile on
+%! pause (0.2);
+%! profile off;
+%! info = profile ("info");
+%! profile ("clear");
+%! fcn = find (strcmp ({info.FunctionTable.FunctionName}, "pause"));
+%! assert (info.FunctionTable(fcn).TotalTime >= 0.2);
+%! assert (max ([info.LineTable.TotalTime]) >= 0.2);
+
+## Freeing an array created before profiling started does not hide
+## later allocations from the peak.
+%!test
+%! profile ("clear");
+%! x = zeros (1000, 1000);
+%! profile on -memory
+%! clear x;
+%! y = zeros (100, 1000);
+%! profile off;
+%! info = profile ("info");
+%! profile ("clear");
+%! lines = info.LineTable;
+%! assert (all ([lines.PeakBytes] >= 0));
+%! [alloc, i] = max ([lines.AllocatedBytes]);
+%! assert (alloc >= 8e5);
+%! assert (lines(i).PeakBytes >= 8e5);
 
 ## Test input validation
 %!error profile ()
 %!error profile ("on", 2)
+%!error profile ("off", "-memory")
 %!error profile ("INVALID_OPTION")
 
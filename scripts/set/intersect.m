@@ -70,27 +70,44 @@ function [c, ia, ib] = intersect (a, b, varargin)
       b = unique (b, varargin{:});
     endif
 
-    if (by_rows)
-      c = [a; b];
-      [c, ic] = sortrows (c);
-      ii = find (all (c(1:end-1,:) == c(2:end,:), 2));
-      c = c(ii,:);
-      len_a = rows (a);
+    if (strcmp (class (a), class (b)) && ! issparse (a) && ! issparse (b))
+      ## A and B are now sorted and free of repeats, so the intersection
+      ## consists of the members of A found in B, in order.
+      [tf, loc] = __ismember__ (a, b, by_rows);
+      if (by_rows)
+        c = a(tf,:);
+      else
+        c = a(tf);
+        c = c(:);
+      endif
+
+      if (nargout > 1)
+        ia = ja(tf);
+        ib = jb(loc(tf));
+      endif
     else
-      c = [a(:); b(:)];
-      [c, ic] = sort (c);         # [a(:);b(:)](ic) == c
-      if (iscellstr (c))
-        ii = find (strcmp (c(1:end-1), c(2:end)));
+      if (by_rows)
+        c = [a; b];
+        [c, ic] = sortrows (c);
+        ii = find (all (c(1:end-1,:) == c(2:end,:), 2));
+        c = c(ii,:);
+        len_a = rows (a);
       else
-        ii = find (c(1:end-1) == c(2:end));
+        c = [a(:); b(:)];
+        [c, ic] = sort (c);         # [a(:);b(:)](ic) == c
+        if (iscellstr (c))
+          ii = find (strcmp (c(1:end-1), c(2:end)));
+        else
+          ii = find (c(1:end-1) == c(2:end));
+        endif
+        c = c(ii);
+        len_a = length (a);
       endif
-      c = c(ii);
-      len_a = length (a);
-    endif
 
-    if (nargout > 1)
-      ia = ja(ic(ii));            # a(ia) == c
-      ib = jb(ic(ii+1) - len_a);  # b(ib) == c
+      if (nargout > 1)
+        ia = ja(ic(ii));            # a(ia) == c
+        ib = jb(ic(ii+1) - len_a);  # b(ib) == c
+      endif
     endif
 
     ## Adjust output orientation for Matlab compatibility
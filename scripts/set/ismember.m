@@ -92,7 +92,19 @@ function [tf, s_idx] = ismember (a, s, varargin)
 
   by_rows = nargin == 3;
 
-  if (! by_rows)
+  ## Arrays of the same class are matched through a hash table built from
+  ## S, which costs O(numel (A) + numel (S)) and needs no sorting.
+  ## lookup() compares complex values by magnitude, so those keep using it.
+  use_hash = (strcmp (class (a), class (s)) && ! issparse (a)
+              && ! issparse (s) && (iscellstr (a) || (isreal (a) && isreal (s))));
+
+  if (use_hash && ! (by_rows && (isempty (a) || isempty (s))))
+    if (nargout > 1)
+      [tf, s_idx] = __ismember__ (a, s, by_rows);
+    else
+      tf = __ismember__ (a, s, by_rows);
+    endif
+  elseif (! by_rows)
     s = s(:);
     ## Check sort status, because we expect the array will often be sorted.
     if (issorted (s))
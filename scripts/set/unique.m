@@ -120,6 +120,17 @@ function [y, i, j] = unique (x, varargin)
     return;
   endif
 
+  ## Full arrays are grouped by hashing, which only sorts the distinct
+  ## values.  Sparse arrays still take the sort-based path below.
+  if (! issparse (x))
+    if (nargout > 1)
+      [y, i, j] = __unique__ (x, optrows, optfirst);
+    else
+      y = __unique__ (x, optrows, optfirst);
+    endif
+    return;
+  endif
+
   if (optrows)
     if (nargout > 1)
       [y, i] = sortrows (y);
@@ -210,6 +221,12 @@ endfunction
 %! assert (j, [1;1;1]);
 %!
 %!test
+%! [a,i,j] = unique ([3,NaN,1,3,NaN], "first");
+%! assert (a, [1,3,NaN,NaN]);
+%! assert (i, [3,1,2,5]);
+%! assert (j, [2,3,1,2,4]);
+%!
+%!test
 %! A = [1,2,3;1,2,3];
 %! [a,i,j] = unique (A, "rows");
 %! assert (a, [1,2,3]);
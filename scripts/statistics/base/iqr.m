@@ -58,28 +58,28 @@ function y = iqr (x, dim)
     endif
   endif
 
-  ## This code is a bit heavy, but is needed until empirical_inv
-  ## can take a matrix, rather than just a vector argument.
   n = sz(dim);
-  sz(dim) = 1;
-  if (isa (x, "single"))
-    y = zeros (sz, "single");
+
+  if (nel == 0)
+    sz(dim) = 1;
+    if (isa (x, "single"))
+      y = zeros (sz, "single");
+    else
+      y = zeros (sz);
+    endif
+  elseif (n == 1)
+    error ("iqr: X must have more than one element along dimension DIM");
   else
-    y = zeros (sz);
+    ## The difference of integer values may saturate.
+    if (! isfloat (x))
+      x = double (x);
+    endif
+
+    ## The quartiles returned by empirical_inv are the order statistics
+    ## ceil (n/4) and ceil (3*n/4), which nth_element selects for all
+    ## columns at once.
+    y = diff (nth_element (x, [ceil(n/4), ceil(3*n/4)], dim), 1, dim);
   endif
-  stride = prod (sz(1:dim-1));
-  for i = 1 : nel / n;
-    offset = i;
-    offset2 = 0;
-    while (offset > stride)
-      offset -= stride;
-      offset2 += 1;
-    endwhile
-    offset += offset2 * stride * n;
-    rng = [0 : n-1] * stride + offset;
-
-    y(i) = diff (empirical_inv ([1/4, 3/4], x(rng)));
-  endfor
 
 endfunction
 
@@ -88,6 +88,16 @@ endfunction
 %!assert (iqr (single (1:101)), single (50))
 
 ## FIXME: iqr throws horrible error when running across a dimension that is 1.
+%!assert (iqr ([4 1 3 2 0; 8 6 7 5 9], 2), [2; 2])
+%!assert (iqr (int8 ([1 5 9 2])), 4)
+%!assert (iqr (int8 ([-100 -120 100 120])), 220)
+%!assert (iqr (uint8 ([0 255 0 255; 1 2 3 4])), [1, 253, 3, 251])
+%!assert (iqr (zeros (1, 0)), 0)
+%!assert (iqr (zeros (1, 0), 1), zeros (1, 0))
+%!assert (iqr (zeros (0, 3)), zeros (0, 1))
+%!assert (iqr (zeros (0, 3), 1), zeros (1, 3))
+%!assert (iqr (single (zeros (0, 2)), 1), single (zeros (1, 2)))
+
 %!test
 %! x = [1:100]';
 %! assert (iqr (x, 1), 50);
@@ -360,10 +360,16 @@ function inv = __quantile__ (x, p, method = 5)
   p = p(:);
 
   ## Save length and set shape of samples.
-  x = sort (x, 1);
   m = sum (! isnan (x));
   [xr, xc] = size (x);
 
+  ## Without NaNs, every column needs the same order statistics, which can
+  ## be selected in a single pass instead of sorting the whole array.
+  use_select = all (m == xr);
+  if (! use_select)
+    x = sort (x, 1);
+  endif
+
   ## Initialize output values.
   inv = Inf (class (x)) * (-(p < 0) + (p > 1));
   inv = repmat (inv, 1, xc);
@@ -386,12 +392,18 @@ function inv = __quantile__ (x, p, method = 5)
         switch (method)
           case 1
             p = max (ceil (kron (p, m)), 1);
+            if (use_select)
+              x = order_statistics (x, p);
+            endif
             inv(k,:) = x(p + pcd);
 
           case 2
             p = kron (p, m);
             p_lr = max (ceil (p), 1);
             p_rl = min (floor (p + 1), mm);
+            if (use_select)
+              x = order_statistics (x, [p_lr; p_rl]);
+            endif
             inv(k,:) = (x(p_lr + pcd) + x(p_rl + pcd))/2;
 
           case 3
@@ -399,6 +411,9 @@ function inv = __quantile__ (x, p, method = 5)
            ## http://support.sas.com/onlinedoc/913/getDoc/en/statug.hlp/stdize_sect14.htm
             t = max (kron (p, m), 1);
             t = roundb (t);
+            if (use_select)
+              x = order_statistics (x, t);
+            endif
             inv(k,:) = x(t + pcd);
         endswitch
 
@@ -438,6 +453,9 @@ function inv = __quantile__ (x, p, method = 5)
         ## Interval indices.
         pi = max (min (floor (p), mm-1), 1);
         pr = max (min (p - pi, 1), 0);
+        if (use_select)
+          x = order_statistics (x, [pi; pi+1]);
+        endif
         pi += pcd;
         inv(k,:) = (1-pr) .* x(pi) + pr .* x(pi+1);
     endswitch
@@ -445,3 +463,14 @@ function inv = __quantile__ (x, p, method = 5)
 
 endfunction
 
+## Place the order statistics with row indices IDX, which are the same for
+## every column, in those rows of each column of X, as sort would.  All
+## statistics needed must be requested in a single call, because the other
+## rows are overwritten.
+function x = order_statistics (x, idx)
+
+  idx = unique (idx(:));
+  x(idx,:) = nth_element (x, idx, 1);
+
+endfunction
+
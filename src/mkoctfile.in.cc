@@ -34,7 +34,9 @@ along with Octave; see the file COPYING.  If not, see
 #include <fstream>
 #include <sstream>
 #include <vector>
+#include <cstdio>
 #include <cstdlib>
+#include <cstdint>
 
 #if defined (CROSS)
 #  include <sys/types.h>
@@ -77,6 +79,12 @@ octave_wexitstatus_wrapper (int status)
   return WEXITSTATUS (status);
 }
 
+static pid_t
+octave_getpid_wrapper (void)
+{
+  return getpid ();
+}
+
 #endif
 
 static std::string
@@ -126,6 +134,8 @@ initialize (void)
 
   vars["SED"] = get_variable ("SED", %OCTAVE_CONF_SED%);
 
+  vars["MKOCTFILE_CACHE_DIR"] = get_variable ("MKOCTFILE_CACHE_DIR", "");
+
   vars["OCTINCLUDEDIR"]
     = get_variable ("OCTINCLUDEDIR",
                     subst_octave_home (%OCTAVE_CONF_OCTINCLUDEDIR%));
@@ -356,6 +366,13 @@ static std::string help_msg =
 "\n"
 "  -v, --verbose           Echo commands as they are executed.\n"
 "\n"
+"  If the environment variable MKOCTFILE_CACHE_DIR names an existing\n"
+"  directory, object files of C and C++ sources are also stored there,\n"
+"  keyed on a hash of the preprocessed source, the compiler flags, and\n"
+"  the compiler version.  Recompiling an unchanged file copies the stored\n"
+"  object file instead of running the compiler.  Fortran sources are\n"
+"  always compiled.\n"
+"\n"
 "  FILE                    Compile or link FILE.  Recognized file types are:\n"
 "\n"
 "                            .c    C source\n"
@@ -436,6 +453,185 @@ run_command (const std::string& cmd, bool printonly = false)
   return result;
 }
 
+// 128-bit FNV-1a hash, used to name the files in the object cache.
+
+class fnv_hash
+{
+public:
+
+  fnv_hash (void) : hi (0x6c62272e07bb0142ULL), lo (0x62b821756295c58dULL) { }
+
+  void add (const std::string& s)
+  {
+    for (const auto& c : s)
+      {
+        lo ^= static_cast<unsigned char> (c);
+
+        // Multiply by the FNV prime 2^88 + 0x13b, modulo 2^128.
+
+        uint64_t a = (lo & 0xffffffffULL) * 0x13b;
+        uint64_t b = (lo >> 32) * 0x13b;
+        uint64_t t = (a >> 32) + (b & 0xffffffffULL);
+
+        hi = hi * 0x13b + (b >> 32) + (t >> 32) + (lo << 24);
+        lo = (t << 32) | (a & 0xffffffffULL);
+      }
+
+    // Separate successive strings.
+    lo ^= 0xff;
+  }
+
+  std::string hex (void) const
+  {
+    char buf[33];
+
+    std::snprintf (buf, sizeof (buf), "%016llx%016llx",
+                   static_cast<unsigned long long> (hi),
+                   static_cast<unsigned long long> (lo));
+
+    return buf;
+  }
+
+private:
+
+  uint64_t hi;
+  uint64_t lo;
+};
+
+#if defined (OCTAVE_USE_WINDOWS_API)
+static const std::string null_device = "NUL";
+#else
+static const std::string null_device = "/dev/null";
+#endif
+
+// Return the standard output of CMD, or an empty string if it fails.
+
+static std::string
+command_output (const std::string& cmd)
+{
+  std::string retval;
+
+  FILE *fp = popen ((cmd + " 2>" + null_device).c_str (), "r");
+
+  if (! fp)
+    return retval;
+
+  char buf[8192];
+  size_t n;
+
+  while ((n = std::fread (buf, 1, sizeof (buf), fp)) > 0)
+    retval.append (buf, n);
+
+  int status = pclose (fp);
+
+  if (! octave_wifexited_wrapper (status)
+      || octave_wexitstatus_wrapper (status) != 0)
+    retval = "";
+
+  return retval;
+}
+
+static bool
+copy_file (const std::string& from, const std::string& to)
+{
+  std::ifstream is (from.c_str (), std::ios::in | std::ios::binary);
+
+  if (! is)
+    return false;
+
+  std::ofstream os (to.c_str (), std::ios::out | std::ios::binary);
+
+  os << is.rdbuf ();
+
+  os.close ();
+
+  return ! os.fail ();
+}
+
+static std::string
+compiler_version (const std::string& compiler)
+{
+  static std::map<std::string, std::string> versions;
+
+  auto p = versions.find (compiler);
+
+  if (p == versions.end ())
+    p = versions.insert (std::make_pair (compiler,
+                                         command_output (compiler
+                                                         + " --version"))).first;
+
+  return p->second;
+}
+
+// Return the name of the object cache entry for compiling SRC with
+// COMPILER and FLAGS, or an empty string if the source cannot be
+// preprocessed.  The source is preprocessed first so that changes to
+// included headers are noticed.
+
+static std::string
+object_cache_file (const std::string& compiler, const std::string& flags,
+                   const std::string& src)
+{
+  std::string text
+    = command_output (compiler + " -E " + flags + " " + quote_path (src));
+
+  if (text.empty ())
+    return "";
+
+  fnv_hash h;
+
+  h.add (version_msg);
+  h.add (compiler);
+  h.add (compiler_version (compiler));
+  h.add (flags);
+  h.add (text);
+
+  return vars["MKOCTFILE_CACHE_DIR"] + "/" + h.hex () + ".o";
+}
+
+// Run the compile command CMD, which compiles the C or C++ file SRC into
+// OBJ using COMPILER and FLAGS, unless an object file for the same input
+// is already in the object cache.
+
+static int
+compile_file (const std::string& cmd, const std::string& compiler,
+              const std::string& flags, const std::string& src,
+              const std::string& obj, bool printonly)
+{
+  if (printonly || vars["MKOCTFILE_CACHE_DIR"].empty ())
+    return run_command (cmd, printonly);
+
+  std::string cached = object_cache_file (compiler, flags, src);
+
+  if (cached.empty ())
+    return run_command (cmd);
+
+  if (copy_file (cached, obj))
+    {
+      if (debug)
+        std::cout << "mkoctfile: using " << cached << " for " << src
+                  << std::endl;
+
+      return 0;
+    }
+
+  int status = run_command (cmd);
+
+  if (status == 0)
+    {
+      // Write to a temporary file first so that concurrent builds never
+      // see a partial entry.
+
+      std::string tmp = cached + "." + std::to_string (octave_getpid_wrapper ());
+
+      if (! copy_file (obj, tmp)
+          || std::rename (tmp.c_str (), cached.c_str ()) != 0)
+        octave_unlink_wrapper (tmp.c_str ());
+    }
+
+  return status;
+}
+
 bool
 is_true (const std::string& s)
 {
@@ -754,10 +950,16 @@ main (int argc, char **argv)
             o = b + ".o";
           objfiles += (" " + o);
 
-          std::string cmd
-            = (vars["F77"] + " -c " + vars["FPICFLAG"] + " "
-               + vars["ALL_FFLAGS"] + " " + incflags + " " + defs + " "
-               + pass_on_options + " " + f + " -o " + o);
+          std::string flags
+            = (vars["FPICFLAG"] + " " + vars["ALL_FFLAGS"] + " " + incflags
+               + " " + defs + " " + pass_on_options);
+
+          std::string cmd = (vars["F77"] + " -c " + flags + " " + f
+                             + " -o " + o);
+
+          // Fortran sources are not cached.  Not every Fortran compiler
+          // can preprocess them, so a hash of the source would miss
+          // changes to the files they include.
 
           int status = run_command (cmd, printonly);
 
@@ -788,13 +990,16 @@ main (int argc, char **argv)
             o = b + ".o";
           objfiles += (" " + o);
 
-          std::string cmd
-            = (vars["CC"] + " -c " + vars["CPPFLAGS"] + " "
-               + vars["CPICFLAG"] + " " + vars["ALL_CFLAGS"] + " "
-               + pass_on_options + " " + incflags + " " + defs + " "
-               + quote_path (f) + " -o " + quote_path (o));
+          std::string flags
+            = (vars["CPPFLAGS"] + " " + vars["CPICFLAG"] + " "
+               + vars["ALL_CFLAGS"] + " " + pass_on_options + " "
+               + incflags + " " + defs);
 
-          int status = run_command (cmd, printonly);
+          std::string cmd = (vars["CC"] + " -c " + flags + " "
+                             + quote_path (f) + " -o " + quote_path (o));
+
+          int status = compile_file (cmd, vars["CC"], flags, f, o,
+                                     printonly);
 
           if (status)
             return status;
@@ -823,13 +1028,16 @@ main (int argc, char **argv)
             o = b + ".o";
           objfiles += (" " + o);
 
-          std::string cmd
-            = (vars["CXX"] + " -c " + vars["CPPFLAGS"] + " "
-               + vars["CXXPICFLAG"] + " " + vars["ALL_CXXFLAGS"] + " "
-               + pass_on_options + " " + incflags + " " + defs + " "
-               + quote_path (f) + " -o " + quote_path (o));
+          std::string flags
+            = (vars["CPPFLAGS"] + " " + vars["CXXPICFLAG"] + " "
+               + vars["ALL_CXXFLAGS"] + " " + pass_on_options + " "
+               + incflags + " " + defs);
 
-          int status = run_command (cmd, printonly);
+          std::string cmd = (vars["CXX"] + " -c " + flags + " "
+                             + quote_path (f) + " -o " + quote_path (o));
+
+          int status = compile_file (cmd, vars["CXX"], flags, f, o,
+                                     printonly);
 
           if (status)
             return status;
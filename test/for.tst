@@ -101,6 +101,37 @@
 %!   assert (i, {1 + 2*j; 2 + 2*j++});
 %! endfor
 
+%!test
+%! x = {};
+%! for i = {1, "a", [2 3]}
+%!   x(end+1) = i;
+%! endfor
+%! assert (x, {1, "a", [2 3]});
+%! assert (class (i), "cell");
+
+%!test
+%! x = [];
+%! for i = [1+2i, 3]
+%!   x(end+1) = i;
+%!   assert (isreal (i), i == 3);
+%! endfor
+%! assert (x, [1+2i, 3]);
+
+%!test
+%! for i = int8 ([1, 2])
+%! endfor
+%! assert (i, int8 (2));
+
+## The operand types of an expression in a loop body may change
+%!test
+%! v = {2, int8(2), single(2), true, 2i, [1 2], "a", {1}};
+%! r = {};
+%! for k = 1:numel (v) - 1
+%!   r{k} = v{k} + 1;
+%! endfor
+%! assert (r, {3, int8(3), single(3), 2, 1+2i, [2 3], 98});
+%! fail ("for k = 1:2, x = {1} + 1; endfor", "binary operator '\\+'");
+
 ## test parsing of single-quoted character string appearing at the
 ## beginning of a for loop
 %!test
@@ -586,3 +586,30 @@
 %! c = cell(1,1,1);
 %! c{1,1,1} = zeros(5, 2);
 %! c{1,1,1}(:, 1) = 1;
+
+## Logical masks, with and without trailing false elements
+%!test
+%! x = 1:10;
+%! m = logical ([1 0 1 1 0 1 1 1 0 0]);
+%! assert (x(m), [1 3 4 6 7 8]);
+%! assert (x(! m), [2 5 9 10]);
+%! assert (x(false (1, 10)), zeros (1, 0));
+%! assert (int8 (x)(m), int8 ([1 3 4 6 7 8]));
+%! assert (complex (x, -x)(m), complex ([1 3 4 6 7 8], -[1 3 4 6 7 8]));
+%! c = num2cell (x);
+%! assert (c(m), {1, 3, 4, 6, 7, 8});
+
+## Large index vectors and matrices indexed by two index vectors
+%!test
+%! x = rand (400, 300);
+%! i = randi (400, 1, 200);
+%! j = randi (300, 1, 500);
+%! y = x(i,j);
+%! assert (y(:,7), x(i,j(7)));
+%! assert (y(5,:), x(i(5),j));
+%! k = randi (numel (x), 1, 100000);
+%! assert (x(k)(end), x(k(end)));
+%! m = mod ((1:300) .^ 2, 7) < 3;
+%! y = x([i i],m);
+%! assert (y, x([i i],find (m)));
+%! assert (x(:,m)(:,end), x(:,find (m, 1, "last")));
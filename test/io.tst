@@ -220,6 +220,50 @@
 %!   unlink (h5file);
 %! end_unwind_protect
 
+%!testif HAVE_HDF5, HAVE_ZLIB
+%! x = rand (300, 200);
+%! y = single (complex (x(1:50, :), 1));
+%! z = (x > 0.5);
+%! w = int16 (zeros (1000, 10));
+%! h5file = tempname ();
+%! unwind_protect
+%!   save ("-hdf5", "-zip", h5file, "x", "y", "z", "w");
+%!   s = load (h5file);
+%!   assert (s, struct ("x", x, "y", y, "z", z, "w", w));
+%!   save ("-hdf5", "-chunked", h5file, "x");
+%!   assert (load (h5file).x, x);
+%! unwind_protect_cleanup
+%!   unlink (h5file);
+%! end_unwind_protect
+
+%!test
+%! ## Selective loads from indexed files
+%! s = struct ();
+%! for k = 1:50
+%!   s.(sprintf ("v%02d", k)) = k * ones (k, 2);
+%! endfor
+%! s.c = {1, "two"};
+%! fmts = {"-binary", "-v6", "-v7"};
+%! fname = tempname ();
+%! unwind_protect
+%!   for k = 1:numel (fmts)
+%!     save (fmts{k}, fname, "-struct", "s");
+%!     for n = 1:2
+%!       t = load (fname, "v4*", "c", "v07");
+%!       assert (fieldnames (t), {"v07"; "v40"; "v41"; "v42"; "v43"; ...
+%!                                "v44"; "v45"; "v46"; "v47"; "v48"; ...
+%!                                "v49"; "c"});
+%!       assert (t.v07, s.v07);
+%!       assert (t.v45, s.v45);
+%!       assert (t.c, s.c);
+%!       t = load (fname, "nosuchvar", "v12");
+%!       assert (t, struct ("v12", s.v12));
+%!     endfor
+%!   endfor
+%! unwind_protect_cleanup
+%!   unlink (fname);
+%! end_unwind_protect
+
 %!test
 %!
 %! STR.scalar_fld = 1;
@@ -735,3 +779,11 @@
 %!assert (sprintf ("a %s b", []), "a  b")
 %!assert (sprintf ("a %s b", ''), "a  b")
 %!assert (sprintf ("a %s b", ' '), "a   b")
+
+## Conversions longer than the internal formatting buffer
+%!assert (sprintf ("%300d", 7), [repmat(" ", 1, 299), "7"])
+%!assert (sprintf ("%.300f", 0.5), ["0.5", repmat("0", 1, 299)])
+%!assert (sprintf ("%g|%f|%d|%e", pi, -pi, 42, 1e-300),
+%!        "3.14159|-3.141593|42|1.000000e-300")
+%!assert (sprintf ("%d,", single ([1.5, NaN, -Inf, 3])), "1.5,NaN,-Inf,3,")
+%!assert (sprintf ("%5.1f|", [true, int8(-3)]), "  1.0| -3.0|")
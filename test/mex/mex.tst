@@ -0,0 +1,120 @@
+## Copyright (C) 2017 The Octave Project Developers
+##
+## This file is part of Octave.
+##
+## Octave is free software; you can redistribute it and/or modify it
+## under the terms of the GNU General Public License as published by
+## the Free Software Foundation; either version 3 of the License, or
+## (at your option) any later version.
+##
+## Octave is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU General Public License for more details.
+##
+## You should have received a copy of the GNU General Public License
+## along with Octave; see the file COPYING.  If not, see
+## <http://www.gnu.org/licenses/>.
+
+%!function ok = have_mkoctfile ()
+%!  ok = exist (fullfile (__octave_config_info__ ("bindir"),
+%!                        sprintf ("mkoctfile-%s%s", OCTAVE_VERSION,
+%!                                 __octave_config_info__ ("EXEEXT"))),
+%!              "file");
+%!endfunction
+
+%!function d = build_mex (name)
+%!  src = canonicalize_file_name ([name ".c"]);
+%!  d = tempname ();
+%!  mkdir (d);
+%!  ## Build in D, which also receives the intermediate object file.
+%!  olddir = cd (d);
+%!  unwind_protect
+%!    [~, status] = mkoctfile ("--mex", "-o", name, src);
+%!  unwind_protect_cleanup
+%!    cd (olddir);
+%!  end_unwind_protect
+%!  assert (status, 0);
+%!  addpath (d);
+%!endfunction
+
+%!function remove_mex (d)
+%!  rmpath (d);
+%!  confirm_recursive_rmdir (false, "local");
+%!  rmdir (d, "s");
+%!endfunction
+
+## mxRealloc of the data of an array created by mxCreateNumericMatrix
+%!test
+%! if (have_mkoctfile ())
+%!   d = build_mex ("mexrealloc");
+%!   unwind_protect
+%!     assert (mexrealloc ("double", 5), 1:10);
+%!     assert (mexrealloc ("double", 1000), 1:2000);
+%!     assert (mexrealloc ("int32", 5), int32 (1:10));
+%!   unwind_protect_cleanup
+%!     remove_mex (d);
+%!   end_unwind_protect
+%! endif
+
+## Typed data accessors with interleaved complex storage
+%!test
+%! if (have_mkoctfile ())
+%!   d = build_mex ("mexdata");
+%!   unwind_protect
+%!     x = reshape (1:24, 2, 3, 4);
+%!     z = complex (x, -2*x);
+%!     [y, ok] = mexdata ("doubles", x);
+%!     assert (y, 2*x);
+%!     assert (ok);
+%!     [y, ok] = mexdata ("singles", single (x));
+%!     assert (y, single (2*x));
+%!     assert (ok);
+%!     [y, ok] = mexdata ("complexdoubles", z);
+%!     assert (y, conj (z));
+%!     assert (ok);
+%!     [y, ok] = mexdata ("complexsingles", single (z));
+%!     assert (y, single (conj (z)));
+%!     assert (ok);
+%!     [y, ok] = mexdata ("mixed", z(:,:,1));
+%!     assert (y, conj (z(:,:,1)));
+%!     assert (ok);
+%!     ## Inputs are not changed by the accessors.
+%!     assert (x, reshape (1:24, 2, 3, 4));
+%!     assert (z, complex (x, -2*x));
+%!   unwind_protect_cleanup
+%!     remove_mex (d);
+%!   end_unwind_protect
+%! endif
+
+## Typed data setters, duplicates, and outputs returned without a copy
+%!test
+%! if (have_mkoctfile ())
+%!   d = build_mex ("mexdata");
+%!   unwind_protect
+%!     x = magic (4);
+%!     z = complex (x, x');
+%!     [y, ok] = mexdata ("setdoubles", x);
+%!     assert (y, x + 1);
+%!     assert (ok);
+%!     [y, ok] = mexdata ("setcomplexdoubles", z);
+%!     assert (y, complex (x', x));
+%!     assert (ok);
+%!     [y, ok] = mexdata ("duplicate", x);
+%!     assert (y, -x);
+%!     assert (x, magic (4));
+%!     assert (ok);
+%!     [y, ok] = mexdata ("reshape", x);
+%!     assert (y, 2*x(:).');
+%!     assert (ok);
+%!     ## The output of a large array is shared with the MEX array, so
+%!     ## changing it later must not affect other values.
+%!     y = mexdata ("doubles", ones (1000));
+%!     y2 = y;
+%!     y2(1) = 0;
+%!     assert (y(1), 2);
+%!     assert (nnz (y2 == 2), 1e6 - 1);
+%!   unwind_protect_cleanup
+%!     remove_mex (d);
+%!   end_unwind_protect
+%! endif
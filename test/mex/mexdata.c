@@ -0,0 +1,237 @@
+#include <string.h>
+
+#include "mex.h"
+
+/* Exercise the typed data accessors on the input X according to MODE
+   and return the result in a new array.  The second output is 1 if the
+   accessors that should fail for X returned NULL or 0.  */
+
+static mxArray *
+scale_doubles (const mxArray *x, int *ok)
+{
+  mwSize n = mxGetNumberOfElements (x);
+  mwIndex i;
+  const mxDouble *px = mxGetDoubles (x);
+  mxArray *y = mxCreateNumericArray (mxGetNumberOfDimensions (x),
+                                     mxGetDimensions (x),
+                                     mxDOUBLE_CLASS, mxREAL);
+  mxDouble *py = mxGetDoubles (y);
+
+  for (i = 0; i < n; i++)
+    py[i] = 2 * px[i];
+
+  *ok = (mxGetComplexDoubles (x) == NULL && mxGetSingles (x) == NULL);
+
+  return y;
+}
+
+static mxArray *
+scale_singles (const mxArray *x, int *ok)
+{
+  mwSize n = mxGetNumberOfElements (x);
+  mwIndex i;
+  const mxSingle *px = mxGetSingles (x);
+  mxArray *y = mxCreateNumericArray (mxGetNumberOfDimensions (x),
+                                     mxGetDimensions (x),
+                                     mxSINGLE_CLASS, mxREAL);
+  mxSingle *py = mxGetSingles (y);
+
+  for (i = 0; i < n; i++)
+    py[i] = 2 * px[i];
+
+  *ok = (mxGetComplexSingles (x) == NULL && mxGetDoubles (x) == NULL);
+
+  return y;
+}
+
+static mxArray *
+conj_doubles (const mxArray *x, int *ok)
+{
+  mwSize n = mxGetNumberOfElements (x);
+  mwIndex i;
+  const mxComplexDouble *px = mxGetComplexDoubles (x);
+  mxArray *y = mxCreateNumericArray (mxGetNumberOfDimensions (x),
+                                     mxGetDimensions (x),
+                                     mxDOUBLE_CLASS, mxCOMPLEX);
+  mxComplexDouble *py = mxGetComplexDoubles (y);
+
+  for (i = 0; i < n; i++)
+    {
+      py[i].real = px[i].real;
+      py[i].imag = -px[i].imag;
+    }
+
+  *ok = (mxGetDoubles (x) == NULL && mxGetComplexSingles (x) == NULL);
+
+  return y;
+}
+
+static mxArray *
+conj_singles (const mxArray *x, int *ok)
+{
+  mwSize n = mxGetNumberOfElements (x);
+  mwIndex i;
+  const mxComplexSingle *px = mxGetComplexSingles (x);
+  mxArray *y = mxCreateNumericArray (mxGetNumberOfDimensions (x),
+                                     mxGetDimensions (x),
+                                     mxSINGLE_CLASS, mxCOMPLEX);
+  mxComplexSingle *py = mxGetComplexSingles (y);
+
+  for (i = 0; i < n; i++)
+    {
+      py[i].real = px[i].real;
+      py[i].imag = -px[i].imag;
+    }
+
+  *ok = (mxGetSingles (x) == NULL && mxGetComplexDoubles (x) == NULL);
+
+  return y;
+}
+
+/* Fill interleaved storage, then switch to the separate real and
+   imaginary parts and negate the imaginary part through mxGetPi.  */
+
+static mxArray *
+mixed_doubles (const mxArray *x, int *ok)
+{
+  mwSize n = mxGetNumberOfElements (x);
+  mwIndex i;
+  const mxComplexDouble *px = mxGetComplexDoubles (x);
+  mxArray *y = mxCreateDoubleMatrix (mxGetM (x), mxGetN (x), mxCOMPLEX);
+  mxComplexDouble *py = mxGetComplexDoubles (y);
+  double *pi;
+
+  for (i = 0; i < n; i++)
+    py[i] = px[i];
+
+  pi = mxGetPi (y);
+
+  for (i = 0; i < n; i++)
+    pi[i] = -pi[i];
+
+  *ok = (pi != NULL && mxGetPr (y) != NULL);
+
+  return y;
+}
+
+/* Replace the data of new arrays with memory from mxMalloc.  */
+
+static mxArray *
+set_doubles (const mxArray *x, int *ok)
+{
+  mwSize n = mxGetNumberOfElements (x);
+  mwIndex i;
+  mxArray *y = mxCreateDoubleMatrix (0, 0, mxREAL);
+  mxArray *z = mxCreateNumericMatrix (1, 1, mxINT32_CLASS, mxREAL);
+  mxDouble *py = (mxDouble *) mxMalloc (n * sizeof (mxDouble));
+  mxComplexDouble *pz = (mxComplexDouble *) mxMalloc (sizeof (mxComplexDouble));
+
+  for (i = 0; i < n; i++)
+    py[i] = mxGetDoubles (x)[i] + 1;
+
+  *ok = mxSetDoubles (y, py);
+  mxSetM (y, mxGetM (x));
+  mxSetN (y, mxGetN (x));
+
+  *ok = *ok && ! mxSetDoubles (z, py) && ! mxSetComplexDoubles (z, pz)
+        && ! mxSetComplexDoubles (y, pz);
+
+  mxFree (pz);
+  mxDestroyArray (z);
+
+  return y;
+}
+
+static mxArray *
+set_complex_doubles (const mxArray *x, int *ok)
+{
+  mwSize n = mxGetNumberOfElements (x);
+  mwIndex i;
+  const mxComplexDouble *px = mxGetComplexDoubles (x);
+  mxArray *y = mxCreateDoubleMatrix (mxGetM (x), mxGetN (x), mxCOMPLEX);
+  mxComplexDouble *py
+    = (mxComplexDouble *) mxMalloc (n * sizeof (mxComplexDouble));
+
+  for (i = 0; i < n; i++)
+    {
+      py[i].real = px[i].imag;
+      py[i].imag = px[i].real;
+    }
+
+  *ok = mxSetComplexDoubles (y, py) && ! mxSetDoubles (y, NULL);
+
+  return y;
+}
+
+/* Modify a duplicate of the input, which must leave the input alone.  */
+
+static mxArray *
+duplicate (const mxArray *x, int *ok)
+{
+  mwSize n = mxGetNumberOfElements (x);
+  mwIndex i;
+  mxArray *y = mxDuplicateArray (x);
+  mxDouble *py = mxGetDoubles (y);
+
+  for (i = 0; i < n; i++)
+    py[i] = -py[i];
+
+  *ok = (mxGetDoubles (x) != py);
+
+  return y;
+}
+
+/* Return a new array after a reshape with mxSetM and mxSetN.  */
+
+static mxArray *
+reshape (const mxArray *x, int *ok)
+{
+  mxArray *y = scale_doubles (x, ok);
+
+  mxSetM (y, 1);
+  mxSetN (y, mxGetNumberOfElements (x));
+
+  return y;
+}
+
+void
+mexFunction (int nlhs, mxArray* plhs[],
+             int nrhs, const mxArray* prhs[])
+{
+  char *mode;
+  int ok = 0;
+
+  if (nrhs != 2 || ! mxIsChar (prhs[0]))
+    mexErrMsgTxt ("usage: [Y, OK] = mexdata (MODE, X)");
+
+  mode = mxArrayToString (prhs[0]);
+
+  if (strcmp (mode, "doubles") == 0)
+    plhs[0] = scale_doubles (prhs[1], &ok);
+  else if (strcmp (mode, "singles") == 0)
+    plhs[0] = scale_singles (prhs[1], &ok);
+  else if (strcmp (mode, "complexdoubles") == 0)
+    plhs[0] = conj_doubles (prhs[1], &ok);
+  else if (strcmp (mode, "complexsingles") == 0)
+    plhs[0] = conj_singles (prhs[1], &ok);
+  else if (strcmp (mode, "mixed") == 0)
+    plhs[0] = mixed_doubles (prhs[1], &ok);
+  else if (strcmp (mode, "setdoubles") == 0)
+    plhs[0] = set_doubles (prhs[1], &ok);
+  else if (strcmp (mode, "setcomplexdoubles") == 0)
+    plhs[0] = set_complex_doubles (prhs[1], &ok);
+  else if (strcmp (mode, "duplicate") == 0)
+    plhs[0] = duplicate (prhs[1], &ok);
+  else if (strcmp (mode, "reshape") == 0)
+    plhs[0] = reshape (prhs[1], &ok);
+  else
+    {
+      mxFree (mode);
+      mexErrMsgTxt ("mexdata: unknown MODE");
+    }
+
+  mxFree (mode);
+
+  if (nlhs > 1)
+    plhs[1] = mxCreateLogicalScalar (ok);
+}
@@ -0,0 +1,60 @@
+#include <string.h>
+
+#include "mex.h"
+
+/* Grow a new array of class CLASS from N to 2*N elements with
+   mxRealloc and fill it with 1:2*N.  */
+
+void
+mexFunction (int nlhs, mxArray* plhs[],
+             int nrhs, const mxArray* prhs[])
+{
+  mwSize n;
+  mwIndex i;
+  mxClassID id;
+  char *cls;
+  void *data;
+
+  if (nrhs != 2 || ! mxIsChar (prhs[0]))
+    mexErrMsgTxt ("usage: mexrealloc (CLASS, N)");
+
+  cls = mxArrayToString (prhs[0]);
+  id = (strcmp (cls, "int32") == 0 ? mxINT32_CLASS : mxDOUBLE_CLASS);
+  mxFree (cls);
+
+  n = mxGetScalar (prhs[1]);
+
+  plhs[0] = mxCreateNumericMatrix (1, n, id, mxREAL);
+
+  if (id == mxINT32_CLASS)
+    {
+      int *v = (int *) mxGetData (plhs[0]);
+
+      for (i = 0; i < n; i++)
+        v[i] = i + 1;
+
+      v = (int *) mxRealloc (v, 2 * n * sizeof (int));
+
+      for (i = n; i < 2 * n; i++)
+        v[i] = i + 1;
+
+      data = v;
+    }
+  else
+    {
+      double *v = mxGetPr (plhs[0]);
+
+      for (i = 0; i < n; i++)
+        v[i] = i + 1;
+
+      v = (double *) mxRealloc (v, 2 * n * sizeof (double));
+
+      for (i = n; i < 2 * n; i++)
+        v[i] = i + 1;
+
+      data = v;
+    }
+
+  mxSetData (plhs[0], data);
+  mxSetN (plhs[0], 2 * n);
+}
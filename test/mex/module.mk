@@ -0,0 +1,6 @@
+mex_TEST_FILES = \
+  test/mex/mex.tst \
+  test/mex/mexdata.c \
+  test/mex/mexrealloc.c
+
+TEST_FILES += $(mex_TEST_FILES)
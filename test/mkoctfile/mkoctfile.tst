@@ -0,0 +1,116 @@
+## Copyright (C) 2017 The Octave Project Developers
+##
+## This file is part of Octave.
+##
+## Octave is free software; you can redistribute it and/or modify it
+## under the terms of the GNU General Public License as published by
+## the Free Software Foundation; either version 3 of the License, or
+## (at your option) any later version.
+##
+## Octave is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU General Public License for more details.
+##
+## You should have received a copy of the GNU General Public License
+## along with Octave; see the file COPYING.  If not, see
+## <http://www.gnu.org/licenses/>.
+
+%!function ok = have_mkoctfile ()
+%!  ok = exist (fullfile (__octave_config_info__ ("bindir"),
+%!                        sprintf ("mkoctfile-%s%s", OCTAVE_VERSION,
+%!                                 __octave_config_info__ ("EXEEXT"))),
+%!              "file");
+%!endfunction
+
+%!function hit = compile_cached (src, obj, varargin)
+%!  [out, status] = mkoctfile ("-v", "-c", varargin{:}, src, "-o", obj);
+%!  assert (status, 0);
+%!  hit = ! isempty (strfind (out, "mkoctfile: using "));
+%!endfunction
+
+%!function build_oct (d, src, varargin)
+%!  ## Build in D, which also receives the intermediate object file.
+%!  olddir = cd (d);
+%!  unwind_protect
+%!    [~, status] = mkoctfile (varargin{:}, "-o", "octcounter", src);
+%!  unwind_protect_cleanup
+%!    cd (olddir);
+%!  end_unwind_protect
+%!  assert (status, 0);
+%!endfunction
+
+%!function write_file (name, str)
+%!  fid = fopen (name, "w");
+%!  fputs (fid, str);
+%!  fclose (fid);
+%!endfunction
+
+## Object cache hits, misses, and invalidation by headers and flags
+%!test
+%! if (have_mkoctfile ())
+%!   d = tempname ();
+%!   mkdir (d);
+%!   cache = fullfile (d, "cache");
+%!   mkdir (cache);
+%!   old_cache = getenv ("MKOCTFILE_CACHE_DIR");
+%!   unwind_protect
+%!     setenv ("MKOCTFILE_CACHE_DIR", cache);
+%!     src = fullfile (d, "cachetest.c");
+%!     hdr = fullfile (d, "cachetest.h");
+%!     obj = fullfile (d, "cachetest.o");
+%!     write_file (src, "#include \"cachetest.h\"\nint cachetest (void) { return VALUE; }\n");
+%!     write_file (hdr, "#define VALUE 1\n");
+%!     assert (compile_cached (src, obj), false);
+%!     assert (numel (glob (fullfile (cache, "*.o"))), 1);
+%!     unlink (obj);
+%!     assert (compile_cached (src, obj), true);
+%!     assert (exist (obj, "file"), 2);
+%!     ## A change to an included header is a new entry.
+%!     write_file (hdr, "#define VALUE 2\n");
+%!     assert (compile_cached (src, obj), false);
+%!     assert (compile_cached (src, obj), true);
+%!     ## So are different flags.
+%!     assert (compile_cached (src, obj, "-DEXTRA"), false);
+%!     assert (compile_cached (src, obj, "-DEXTRA"), true);
+%!     assert (numel (glob (fullfile (cache, "*.o"))), 3);
+%!     ## Without the cache directory, the compiler always runs.
+%!     unsetenv ("MKOCTFILE_CACHE_DIR");
+%!     assert (compile_cached (src, obj), false);
+%!   unwind_protect_cleanup
+%!     if (isempty (old_cache))
+%!       unsetenv ("MKOCTFILE_CACHE_DIR");
+%!     else
+%!       setenv ("MKOCTFILE_CACHE_DIR", old_cache);
+%!     endif
+%!     confirm_recursive_rmdir (false, "local");
+%!     rmdir (d, "s");
+%!   end_unwind_protect
+%! endif
+
+## An .oct file stays open after its functions are cleared, so its
+## static state is kept, until the file changes on disk.
+%!test
+%! if (have_mkoctfile () && ! ispc ())
+%!   src = canonicalize_file_name ("octcounter.cc");
+%!   d = tempname ();
+%!   mkdir (d);
+%!   unwind_protect
+%!     build_oct (d, src);
+%!     addpath (d);
+%!     assert (octcounter (), 1);
+%!     assert (octcounter (), 2);
+%!     clear octcounter;
+%!     assert (octcounter (), 3);
+%!     clear octcounter;
+%!     ## File time stamps have a resolution of one second.
+%!     pause (1.1);
+%!     build_oct (d, src, "-DSTART=10");
+%!     assert (octcounter (), 11);
+%!   unwind_protect_cleanup
+%!     clear octcounter;
+%!     rmpath (d);
+%!     confirm_recursive_rmdir (false, "local");
+%!     rmdir (d, "s");
+%!   end_unwind_protect
+%! endif
@@ -0,0 +1,5 @@
+mkoctfile_TEST_FILES = \
+  test/mkoctfile/mkoctfile.tst \
+  test/mkoctfile/octcounter.cc
+
+TEST_FILES += $(mkoctfile_TEST_FILES)
@@ -0,0 +1,16 @@
+#include <octave/oct.h>
+
+#if ! defined (START)
+#  define START 0
+#endif
+
+// Return the number of calls so far, plus START.  The count is kept in a
+// static variable, which lives as long as the .oct file is open.
+
+DEFUN_DLD (octcounter, , ,
+           "Return the number of calls")
+{
+  static int count = START;
+
+  return octave_value (++count);
+}
@@ -58,6 +58,8 @@ include test/classdef-multiple-inheritance/module.mk
 include test/classes/module.mk
 include test/ctor-vs-method/module.mk
 include test/fcn-handle-derived-resolution/module.mk
+include test/mex/module.mk
+include test/mkoctfile/module.mk
 include test/nest/module.mk
 include test/publish/module.mk
 
@@ -116,3 +116,60 @@
 %!assert (sort (r, "descend"), [9 7 5 3 1])
 %!assert (sort (rrev, "ascend"), [2 4 6 8 10])
 
+
+## Test operations that keep ranges or avoid converting them to matrices
+
+%!shared r
+%! r = 1:5;
+
+%!assert (r / 2, [0.5 1 1.5 2 2.5])
+%!assert (r ./ 4, [0.25 0.5 0.75 1 1.25])
+%!assert (2 .* r, [2 4 6 8 10])
+%!assert (r + (0:-1:-4), ones (1, 5))
+%!assert (r - (1:5), zeros (1, 5))
+%!assert (typeinfo (r + (5:-1:1)), "range")
+%!assert (typeinfo ((2:2:10) / 2), "range")
+%!assert (typeinfo (3 .* r), "range")
+%!error <nonconformant> (1:3) + (1:4)
+
+## Results that a range can't represent exactly are matrices
+%!assert (typeinfo (r / 2), "matrix")
+%!assert (typeinfo (r / -1), "matrix")
+%!assert (typeinfo (r .* 0.5), "matrix")
+%!assert (typeinfo (r + (0:0.5:2)), "matrix")
+%!assert ((0:10) / 10, full (0:10) / 10)
+%!assert (((0:10) / 10)(4), 0.3)
+%!assert ((0:10) ./ 3, full (0:10) ./ 3)
+%!assert ((0:10) .* 0.1, full (0:10) .* 0.1)
+%!assert (0.1 .* (0:10), 0.1 .* full (0:10))
+%!assert ((0:0.1:1) + (1:11), full (0:0.1:1) + full (1:11))
+%!assert ((1:11) - (0:0.1:1), full (1:11) - full (0:0.1:1))
+%!assert ((0:2^52:2^53) + (0:2^52:2^53), full (0:2^52:2^53) * 2)
+
+%!assert (r > 2, logical ([0 0 1 1 1]))
+%!assert (3 <= r, logical ([0 0 1 1 1]))
+%!assert (r == 3, logical ([0 0 1 0 0]))
+%!assert (r != NaN, true (1, 5))
+%!assert (r < NaN, false (1, 5))
+
+%!assert (sum (1:100), 5050)
+%!assert (sum (-5:0), -15)
+%!assert (sum (1:0), 0)
+%!assert (sum (r, 1), r)
+%!assert (sum (0.1:0.1:1), sum (full (0.1:0.1:1)))
+%!assert (signbit (sum (-0:1:-0)), false)
+%!assert (cumsum (1:4), [1 3 6 10])
+%!assert (cumsum (1:0), zeros (1, 0))
+%!assert (cumsum (0.1:0.1:1), cumsum (full (0.1:0.1:1)))
+%!assert (mean (1:10), 5.5)
+
+%!test
+%! r = 0:2:20;
+%! assert (r(2:2:6), [2 6 10]);
+%! assert (typeinfo (r(2:2:6)), "range");
+%! assert (r(1, 3:5), [4 6 8]);
+%! assert (r(:, [2 1]), [2 0]);
+%! assert (r(1, [1 2; 3 4]), [0 4 2 6]);
+%! assert (r(1, zeros (2, 0)), zeros (1, 0));
+%!error <out of bound> (1:3)(1, 5)
+%!error <out of bound> (1:3)(2, 1)